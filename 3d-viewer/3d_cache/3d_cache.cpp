@@ -24,6 +24,7 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -50,9 +51,11 @@
 #include "3d_cache.h"
 #include "3d_info.h"
 #include "3d_plugin_manager.h"
+#include "3d_render_cache.h"
 #include "sg/scenegraph.h"
 #include "plugins/3dapi/ifsg_api.h"
 
+#include <core/parallel_for.h>
 #include <filename_resolver.h>
 #include <pgm_base.h>
 #include <project.h>
@@ -65,6 +68,11 @@
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
 
+// The plugins are not reentrant (some of them switch the locale while parsing) and the
+// scene graph names its nodes from global counters when writing a cache file.  Reading the
+// cache files only needs it to check their plugin tags.
+static std::mutex mutex3D_plugins;
+
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) noexcept
 {
@@ -76,14 +84,31 @@ static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) n
 }
 
 
-static bool checkTag( const char* aTag, void* aPluginMgrPtr )
+// data given to checkTag() by loadCacheData()
+struct CACHE_TAG_CHECK
+{
+    S3D_PLUGIN_MANAGER* plugins;
+    std::string*        pluginInfo;     // receives the tag of the cache file
+};
+
+
+static bool checkTag( const char* aTag, void* aTagCheckPtr )
 {
-    if( NULL == aTag || NULL == aPluginMgrPtr )
+    if( NULL == aTag || NULL == aTagCheckPtr )
         return false;
 
-    S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
+    CACHE_TAG_CHECK* check = (CACHE_TAG_CHECK*) aTagCheckPtr;
 
-    return pp->CheckTag( aTag );
+    {
+        std::lock_guard<std::mutex> lock( mutex3D_plugins );
+
+        if( !check->plugins->CheckTag( aTag ) )
+            return false;
+    }
+
+    // the tag is kept for the render data cache file
+    *check->pluginInfo = aTag;
+    return true;
 }
 
 
@@ -121,6 +146,16 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 }
 
 
+static FILE* openFile( const wxString& aFileName, bool aWrite )
+{
+    #ifdef _WIN32
+    return _wfopen( aFileName.wc_str(), aWrite ? L"wb" : L"rb" );
+    #else
+    return fopen( aFileName.ToUTF8(), aWrite ? "wb" : "rb" );
+    #endif
+}
+
+
 class S3D_CACHE_ENTRY
 {
 private:
@@ -137,16 +172,26 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName();
 
+    /// Release the scene and render data, e.g. when the file changed
+    void Clear();
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
+    bool          checked;      // the file was hashed once
+    bool          hasSHA1;      // sha1sum is valid; false on access issues
+    bool          sceneLoaded;  // sceneData was loaded, or could not be loaded
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    std::mutex    mutex;        // held while checking and loading the data
 };
 
 
 S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
+    checked = false;
+    hasSHA1 = false;
+    sceneLoaded = false;
     sceneData = NULL;
     renderData = NULL;
     memset( sha1sum, 0, 20 );
@@ -173,18 +218,36 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    hasSHA1 = true;
+    m_CacheBaseName.clear();
 }
 
 
 const wxString S3D_CACHE_ENTRY::GetCacheBaseName()
 {
-    if( m_CacheBaseName.empty() )
+    if( m_CacheBaseName.empty() && hasSHA1 )
         m_CacheBaseName = sha1ToWXString( sha1sum );
 
     return m_CacheBaseName;
 }
 
 
+void S3D_CACHE_ENTRY::Clear()
+{
+    if( NULL != sceneData )
+    {
+        S3D::DestroyNode( sceneData );
+        sceneData = NULL;
+    }
+
+    if( NULL != renderData )
+        S3D::Destroy3DModel( &renderData );
+
+    sceneLoaded = false;
+    pluginInfo.clear();
+}
+
+
 S3D_CACHE::S3D_CACHE()
 {
     m_FNResolver = new FILENAME_RESOLVER;
@@ -195,28 +258,28 @@ S3D_CACHE::S3D_CACHE()
 
 S3D_CACHE::~S3D_CACHE()
 {
-    COMMON_SETTINGS* commonSettings = Pgm().GetCommonSettings();
-
     FlushCache();
 
-    // We'll delete ".3dc" cache files older than this many days
-    int clearCacheInterval = commonSettings->m_System.clear_3d_cache_interval;
+    // The cache directory is left as it is when there is no program, e.g. in the tools
+    if( PgmOrNull() )
+    {
+        // We'll delete ".3dc" and ".3dr" cache files older than this many days
+        int clearCacheInterval =
+                PgmOrNull()->GetCommonSettings()->m_System.clear_3d_cache_interval;
 
-    // An interval of zero means the user doesn't want to ever clear the cache
+        // An interval of zero means the user doesn't want to ever clear the cache
 
-    if( clearCacheInterval > 0 )
-        CleanCacheDir( clearCacheInterval );
+        if( clearCacheInterval > 0 )
+            CleanCacheDir( clearCacheInterval );
+    }
 
     delete m_FNResolver;
     delete m_Plugins;
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
     wxString full3Dpath = m_FNResolver->ResolvePath( aModelFile );
 
     if( full3Dpath.empty() )
@@ -227,135 +290,102 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    S3D_CACHE_ENTRY* ep = getEntry( full3Dpath );
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    std::lock_guard<std::mutex> lock( ep->mutex );
 
-    if( mi != m_CacheMap.end() )
-    {
-        wxFileName fname( full3Dpath );
+    checkCache( full3Dpath, ep );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+    return loadScene( full3Dpath, ep );
+}
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
+{
+    return load( aModelFile );
+}
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+S3D_CACHE_ENTRY* S3D_CACHE::getEntry( const wxString& aFileName )
+{
+    // only the map is locked; the entries are loaded under their own lock so that
+    // different models can be loaded at the same time
+    std::lock_guard<std::mutex> lock( mutex3D_cache );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
-            }
-        }
+    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+    mi = m_CacheMap.find( aFileName );
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+    if( mi != m_CacheMap.end() )
+        return mi->second;
 
-        return mi->second->sceneData;
-    }
+    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+    m_CacheList.push_back( ep );
+    m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( aFileName, ep ) );
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return ep;
 }
 
 
-SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
+void S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
 {
-    return load( aModelFile );
-}
+    wxFileName fname( aFileName );
 
+    if( aCacheItem->checked )
+    {
+        // Only check if file exists. If not, it will use the same model in cache.
+        if( !fname.FileExists() || fname.GetModificationTime() == aCacheItem->modTime )
+            return;
+    }
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
-{
-    if( aCachePtr )
-        *aCachePtr = NULL;
+    unsigned char hashSum[20];
+    bool          hashed = getSHA1( aFileName, hashSum );
 
-    unsigned char sha1sum[20];
+    aCacheItem->modTime = fname.GetModificationTime();
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !aCacheItem->checked )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
+        // the entry is kept without a hash to prevent further attempts at loading the file
+        aCacheItem->checked = true;
 
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
+        if( hashed )
+            aCacheItem->SetSHA1( hashSum );
 
-        }
+        return;
+    }
 
-        return NULL;
+    if( hashed && ( !aCacheItem->hasSHA1 || !isSHA1Same( hashSum, aCacheItem->sha1sum ) ) )
+    {
+        aCacheItem->SetSHA1( hashSum );
+        aCacheItem->Clear();
     }
+}
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+SCENEGRAPH* S3D_CACHE::loadScene( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( aCacheItem->sceneLoaded )
+        return aCacheItem->sceneData;
 
-        m_CacheList.pop_back();
-        delete ep;
+    // without a hash digest or a configured cache file directory, the file is not loaded
+    if( !aCacheItem->hasSHA1 || m_CacheDir.empty() )
         return NULL;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    aCacheItem->sceneLoaded = true;
 
-    ep->SetSHA1( sha1sum );
+    wxString cachename = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dc" );
 
-    wxString bname = ep->GetCacheBaseName();
-    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return aCacheItem->sceneData;
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    std::lock_guard<std::mutex> lock( mutex3D_plugins );
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 
-    return ep->sceneData;
+    return aCacheItem->sceneData;
 }
 
 
@@ -377,11 +407,7 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
         return false;
     }
 
-    #ifdef _WIN32
-    FILE* fp = _wfopen( aFileName.wc_str(), L"rb" );
-    #else
-    FILE* fp = fopen( aFileName.ToUTF8(), "rb" );
-    #endif
+    FILE* fp = openFile( aFileName, false );
 
     if( NULL == fp )
         return false;
@@ -447,7 +473,9 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    CACHE_TAG_CHECK tagCheck = { m_Plugins, &aCacheItem->pluginInfo };
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &tagCheck, checkTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
@@ -510,6 +538,41 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dr" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    aCacheItem->renderData = S3D::ReadRenderCache( fname, aCacheItem->pluginInfo,
+            [&]( const std::string& aTag )
+            {
+                std::lock_guard<std::mutex> lock( mutex3D_plugins );
+                return m_Plugins->CheckTag( aTag.c_str() );
+            } );
+
+    return aCacheItem->renderData != NULL;
+}
+
+
+bool S3D_CACHE::saveRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( NULL == aCacheItem->renderData || bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    return S3D::WriteRenderCache( m_CacheDir + bname + wxT( ".3dr" ), *aCacheItem->renderData,
+                                  aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -663,35 +726,61 @@ void S3D_CACHE::ClosePlugins()
 
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
-    S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    wxString full3Dpath = m_FNResolver->ResolvePath( aModelFileName );
 
-    if( !sp )
-        return NULL;
-
-    if( !cp )
+    if( full3Dpath.empty() )
     {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
-
+        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [3D model] could not find model '%s'\n",
+                    __FILE__, __FUNCTION__, __LINE__, aModelFileName );
         return NULL;
     }
 
+    S3D_CACHE_ENTRY* cp = getEntry( full3Dpath );
+
+    std::lock_guard<std::mutex> lock( cp->mutex );
+
+    checkCache( full3Dpath, cp );
+
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // the scene data is not needed when the render data is in the cache directory
+    if( loadRenderData( cp ) )
+        return cp->renderData;
+
+    SCENEGRAPH* sp = loadScene( full3Dpath, cp );
+
+    if( !sp )
+        return NULL;
+
+    cp->renderData = S3D::GetModel( sp );
+
+    if( cp->renderData )
+        saveRenderData( cp );
 
-    return mp;
+    return cp->renderData;
 }
 
+
+void S3D_CACHE::PrefetchModels( const std::vector<wxString>& aModelFiles )
+{
+    std::vector<wxString> files( aModelFiles );
+
+    std::sort( files.begin(), files.end() );
+    files.erase( std::unique( files.begin(), files.end() ), files.end() );
+
+    ParallelFor( files.size(),
+            [&]( size_t aFileId )
+            {
+                GetModel( files[aFileId] );
+            } );
+}
+
+
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
+    wxArrayString fileList; // Holds list of ".3dc" and ".3dr" files found in cache directory
     size_t        numFilesFound = 0;
 
     wxFileName thisFile;
@@ -707,8 +796,9 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the cache files in the cache directory
+        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dc" ) );
+        numFilesFound += dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dr" ) );
 
         for( unsigned int i = 0; i < numFilesFound; i++ )
         {
@@ -34,6 +34,7 @@
 #include "kicad_string.h"
 #include <list>
 #include <map>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
@@ -68,18 +69,23 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
-    /** Find or create cache entry for file name
+    /**
+     * Find or create the cache entry for a file name; the entry is only created, its data
+     * is loaded by the caller while holding the lock of the entry.
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * @param[in]   aFileName   file name (full path)
+     * @return      the cache entry of the file
+     */
+    S3D_CACHE_ENTRY* getEntry( const wxString& aFileName );
+
+    /**
+     * Check the hash of a file when it is first used or after it was modified; the data of
+     * the cache entry is released if the file content changed.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
-     * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the (locked) cache entry of the file
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    void checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -92,14 +98,23 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    // load the scene data of a (locked) cache entry from the cache file or the plugins
+    SCENEGRAPH* loadScene( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // load render data from a ".3dr" cache file
+    bool loadRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a ".3dr" cache file
+    bool saveRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // the real load function
+    SCENEGRAPH* load( const wxString& aModelFile );
 
 public:
     S3D_CACHE();
@@ -184,13 +199,26 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Load the render data of several models on as many threads as available, so that the
+     * following calls to GetModel() find them in the cache.
+     *
+     * Only the hashing, the conversion to render data and the ".3dr" files are handled in
+     * parallel: the plugins are not reentrant, so the models not found in the cache files
+     * are still parsed one at a time.
+     *
+     * @param aModelFiles is the list of the partial or full paths to the models; it may
+     *                    contain duplicates.
+     */
+    void PrefetchModels( const std::vector<wxString>& aModelFiles );
+
     /**
      * Function Delete up old cache files in cache directory
      *
-     * Deletes ".3dc" files in the cache directory that are older than
+     * Deletes ".3dc" and ".3dr" files in the cache directory that are older than
      * "aNumDaysOld".
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files
+     * @param aNumDaysOld is age threshold to delete cache files
      */
     void CleanCacheDir( int aNumDaysOld );
 };
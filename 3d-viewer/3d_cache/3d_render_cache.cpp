@@ -0,0 +1,283 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include "3d_render_cache.h"
+#include "plugins/3dapi/ifsg_api.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+// The files are not portable; the header rejects the files written with another layout.
+#define RENDER_CACHE_MAGIC      "K3DR"
+#define RENDER_CACHE_VERSION    1
+#define RENDER_CACHE_BYTE_ORDER 0x01020304
+
+// flags of the optional arrays of a mesh
+#define RENDER_CACHE_TEXCOORDS  0x01
+#define RENDER_CACHE_COLORS     0x02
+
+
+struct RENDER_CACHE_HEADER
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint16_t materialSize;      // sizeof( SMATERIAL )
+    uint16_t vectorSize;        // sizeof( SFVEC3F )
+    uint32_t pluginInfoSize;    // length of the PluginName:Version string following the header
+    uint32_t materialsSize;
+    uint32_t meshesSize;
+};
+
+
+struct RENDER_CACHE_MESH
+{
+    uint32_t vertexSize;
+    uint32_t faceIdxSize;
+    uint32_t materialIdx;
+    uint32_t flags;
+};
+
+
+template <typename T>
+static bool readArray( wxFFile& aFile, T* aArray, size_t aCount )
+{
+    return aCount == 0 || aFile.Read( aArray, sizeof( T ) * aCount ) == sizeof( T ) * aCount;
+}
+
+
+template <typename T>
+static bool writeArray( wxFFile& aFile, const T* aArray, size_t aCount )
+{
+    return aCount == 0 || aFile.Write( aArray, sizeof( T ) * aCount ) == sizeof( T ) * aCount;
+}
+
+
+bool S3D::WriteRenderCache( const wxString& aFileName, const S3DMODEL& aModel,
+                            const std::string& aPluginInfo )
+{
+    if( aPluginInfo.empty() || aPluginInfo.size() >= 256 )
+        return false;
+
+    wxString tmpname = wxFileName::CreateTempFileName( aFileName );
+
+    if( tmpname.empty() )
+        return false;
+
+    wxFFile file( tmpname, wxT( "wb" ) );
+
+    if( !file.IsOpened() )
+    {
+        wxRemoveFile( tmpname );
+        return false;
+    }
+
+    RENDER_CACHE_HEADER header;
+
+    memcpy( header.magic, RENDER_CACHE_MAGIC, 4 );
+    header.version = RENDER_CACHE_VERSION;
+    header.byteOrder = RENDER_CACHE_BYTE_ORDER;
+    header.materialSize = sizeof( SMATERIAL );
+    header.vectorSize = sizeof( SFVEC3F );
+    header.pluginInfoSize = aPluginInfo.size();
+    header.materialsSize = aModel.m_MaterialsSize;
+    header.meshesSize = aModel.m_MeshesSize;
+
+    std::vector<RENDER_CACHE_MESH> meshes( aModel.m_MeshesSize );
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+
+        meshes[i].vertexSize = mesh.m_VertexSize;
+        meshes[i].faceIdxSize = mesh.m_FaceIdxSize;
+        meshes[i].materialIdx = mesh.m_MaterialIdx;
+        meshes[i].flags = ( mesh.m_Texcoords ? RENDER_CACHE_TEXCOORDS : 0 )
+                          | ( mesh.m_Color ? RENDER_CACHE_COLORS : 0 );
+    }
+
+    bool ok = writeArray( file, &header, 1 )
+              && writeArray( file, aPluginInfo.data(), header.pluginInfoSize )
+              && writeArray( file, meshes.data(), meshes.size() )
+              && writeArray( file, aModel.m_Materials, aModel.m_MaterialsSize );
+
+    for( unsigned int i = 0; ok && i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+
+        ok = writeArray( file, mesh.m_Positions, mesh.m_VertexSize )
+             && writeArray( file, mesh.m_Normals, mesh.m_VertexSize )
+             && writeArray( file, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+
+        if( ok && mesh.m_Texcoords )
+            ok = writeArray( file, mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( ok && mesh.m_Color )
+            ok = writeArray( file, mesh.m_Color, mesh.m_VertexSize );
+    }
+
+    ok &= file.Close();
+
+    if( !ok || !wxRenameFile( tmpname, aFileName, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] could not write render cache '%s'",
+                    aFileName );
+        wxRemoveFile( tmpname );
+        return false;
+    }
+
+    return true;
+}
+
+
+S3DMODEL* S3D::ReadRenderCache( const wxString& aFileName, std::string& aPluginInfo,
+                                const std::function<bool( const std::string& )>& aCheckTag )
+{
+    wxFFile file;
+
+    if( !wxFileName::FileExists( aFileName ) || !file.Open( aFileName, wxT( "rb" ) ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot open file '%s'", aFileName );
+        return NULL;
+    }
+
+    RENDER_CACHE_HEADER header;
+    std::string         pluginInfo;
+
+    bool ok = readArray( file, &header, 1 )
+              && !memcmp( header.magic, RENDER_CACHE_MAGIC, 4 )
+              && header.version == RENDER_CACHE_VERSION
+              && header.byteOrder == RENDER_CACHE_BYTE_ORDER
+              && header.materialSize == sizeof( SMATERIAL )
+              && header.vectorSize == sizeof( SFVEC3F )
+              && header.pluginInfoSize < 256;
+
+    if( ok )
+    {
+        pluginInfo.resize( header.pluginInfoSize );
+        ok = readArray( file, &pluginInfo[0], header.pluginInfoSize ) && aCheckTag( pluginInfo );
+    }
+
+    std::vector<RENDER_CACHE_MESH> meshes;
+
+    if( ok )
+    {
+        meshes.resize( header.meshesSize );
+        ok = readArray( file, meshes.data(), meshes.size() );
+    }
+
+    // check the sizes against the file before allocating anything, a damaged file must not
+    // cause huge allocations
+    if( ok )
+    {
+        uint64_t size = sizeof( header ) + header.pluginInfoSize
+                        + (uint64_t) header.materialsSize * sizeof( SMATERIAL )
+                        + (uint64_t) header.meshesSize * sizeof( RENDER_CACHE_MESH );
+
+        for( const RENDER_CACHE_MESH& mesh : meshes )
+        {
+            size += (uint64_t) mesh.vertexSize * 2 * sizeof( SFVEC3F );
+            size += (uint64_t) mesh.faceIdxSize * sizeof( unsigned int );
+
+            if( mesh.flags & RENDER_CACHE_TEXCOORDS )
+                size += (uint64_t) mesh.vertexSize * sizeof( SFVEC2F );
+
+            if( mesh.flags & RENDER_CACHE_COLORS )
+                size += (uint64_t) mesh.vertexSize * sizeof( SFVEC3F );
+
+            ok &= mesh.materialIdx < header.materialsSize;
+        }
+
+        ok &= file.Length() == (wxFileOffset) size;
+    }
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid or outdated render cache '%s'",
+                    aFileName );
+        return NULL;
+    }
+
+    S3DMODEL* model = S3D::New3DModel();
+
+    model->m_MaterialsSize = header.materialsSize;
+    model->m_Materials = new SMATERIAL[header.materialsSize];
+    model->m_MeshesSize = header.meshesSize;
+    model->m_Meshes = new SMESH[header.meshesSize];
+
+    ok = readArray( file, model->m_Materials, header.materialsSize );
+
+    for( unsigned int i = 0; i < header.meshesSize; ++i )
+    {
+        SMESH& mesh = model->m_Meshes[i];
+
+        S3D::Init3DMesh( mesh );
+
+        if( !ok )
+            continue;
+
+        mesh.m_VertexSize = meshes[i].vertexSize;
+        mesh.m_FaceIdxSize = meshes[i].faceIdxSize;
+        mesh.m_MaterialIdx = meshes[i].materialIdx;
+        mesh.m_Positions = new SFVEC3F[mesh.m_VertexSize];
+        mesh.m_Normals = new SFVEC3F[mesh.m_VertexSize];
+        mesh.m_FaceIdx = new unsigned int[mesh.m_FaceIdxSize];
+
+        ok = readArray( file, mesh.m_Positions, mesh.m_VertexSize )
+             && readArray( file, mesh.m_Normals, mesh.m_VertexSize )
+             && readArray( file, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+
+        if( ok && ( meshes[i].flags & RENDER_CACHE_TEXCOORDS ) )
+        {
+            mesh.m_Texcoords = new SFVEC2F[mesh.m_VertexSize];
+            ok = readArray( file, mesh.m_Texcoords, mesh.m_VertexSize );
+        }
+
+        if( ok && ( meshes[i].flags & RENDER_CACHE_COLORS ) )
+        {
+            mesh.m_Color = new SFVEC3F[mesh.m_VertexSize];
+            ok = readArray( file, mesh.m_Color, mesh.m_VertexSize );
+        }
+
+        for( unsigned int j = 0; ok && j < mesh.m_FaceIdxSize; ++j )
+            ok = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+    }
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid render cache '%s'", aFileName );
+        S3D::Destroy3DModel( &model );
+        return NULL;
+    }
+
+    aPluginInfo = pluginInfo;
+    return model;
+}
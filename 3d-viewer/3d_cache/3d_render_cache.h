@@ -0,0 +1,72 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_render_cache.h
+ * reads and writes the ".3dr" files which cache the render data of the 3D models
+ */
+
+#ifndef RENDER_CACHE_3D_H
+#define RENDER_CACHE_3D_H
+
+#include <functional>
+#include <string>
+
+#include "plugins/3dapi/c3dmodel.h"
+#include <wx/string.h>
+
+
+namespace S3D
+{
+    /**
+     * Write the render data of a model to a ".3dr" file.
+     *
+     * The arrays are written as they are laid out in memory, so that they are read back with
+     * a single read each.  The file is written under a temporary name and then renamed, so
+     * that it is never read while it is incomplete.
+     *
+     * @param aFileName is the full path of the file.
+     * @param aModel is the render data.
+     * @param aPluginInfo is the PluginName:Version tag of the plugin which loaded the model.
+     * @return true if the file was written.
+     */
+    bool WriteRenderCache( const wxString& aFileName, const S3DMODEL& aModel,
+                           const std::string& aPluginInfo );
+
+    /**
+     * Read the render data of a model from a ".3dr" file.
+     *
+     * Files written with another data layout, damaged files and files with data which does
+     * not fit the model (e.g. face indices past the vertices) are rejected.
+     *
+     * @param aFileName is the full path of the file.
+     * @param aPluginInfo receives the PluginName:Version tag of the file.
+     * @param aCheckTag is called with the tag of the file before its data is read, and returns
+     *                  false if the file was written with a plugin which is not current.
+     * @return the render data, to be freed with S3D::Destroy3DModel(), or NULL.
+     */
+    S3DMODEL* ReadRenderCache( const wxString& aFileName, std::string& aPluginInfo,
+                               const std::function<bool( const std::string& )>& aCheckTag );
+}
+
+#endif  // RENDER_CACHE_3D_H
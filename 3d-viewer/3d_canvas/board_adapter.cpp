@@ -30,6 +30,7 @@
 #include "../3d_rendering/ccamera.h"
 #include "board_adapter.h"
 #include <3d_rendering/3d_render_raytracing/shapes2D/cpolygon2d.h>
+#include <3d_viewer/3d_viewer_settings.h>
 #include <board.h>
 #include <3d_math.h>
 #include "3d_fastmath.h"
@@ -535,3 +536,106 @@ SFVEC4F BOARD_ADAPTER::GetColor( COLOR4D aColor ) const
 {
     return SFVEC4F( aColor.r, aColor.g, aColor.b, aColor.a );
 }
+
+
+void BOARD_ADAPTER::LoadSettings( const EDA_3D_VIEWER_SETTINGS& aCfg )
+{
+    wxASSERT( m_colors );
+
+    auto set_color =
+            [] ( const COLOR4D& aColor, SFVEC4F& aTarget )
+            {
+                aTarget.r = aColor.r;
+                aTarget.g = aColor.g;
+                aTarget.b = aColor.b;
+                aTarget.a = aColor.a;
+            };
+
+    set_color( m_colors->GetColor( LAYER_3D_BACKGROUND_BOTTOM ), m_BgColorBot );
+    set_color( m_colors->GetColor( LAYER_3D_BACKGROUND_TOP ),    m_BgColorTop );
+    set_color( m_colors->GetColor( LAYER_3D_BOARD ),             m_BoardBodyColor );
+    set_color( m_colors->GetColor( LAYER_3D_COPPER ),            m_CopperColor );
+    set_color( m_colors->GetColor( LAYER_3D_SILKSCREEN_BOTTOM ), m_SilkScreenColorBot );
+    set_color( m_colors->GetColor( LAYER_3D_SILKSCREEN_TOP ),    m_SilkScreenColorTop );
+    set_color( m_colors->GetColor( LAYER_3D_SOLDERMASK ),        m_SolderMaskColorBot );
+    set_color( m_colors->GetColor( LAYER_3D_SOLDERMASK ),        m_SolderMaskColorTop );
+    set_color( m_colors->GetColor( LAYER_3D_SOLDERPASTE ),       m_SolderPasteColor );
+
+    m_raytrace_lightColorCamera = GetColor( aCfg.m_Render.raytrace_lightColorCamera );
+    m_raytrace_lightColorTop = GetColor( aCfg.m_Render.raytrace_lightColorTop );
+    m_raytrace_lightColorBottom = GetColor( aCfg.m_Render.raytrace_lightColorBottom );
+
+    m_raytrace_lightColor.resize( aCfg.m_Render.raytrace_lightColor.size() );
+    m_raytrace_lightSphericalCoords.resize( aCfg.m_Render.raytrace_lightColor.size() );
+
+    for( size_t i = 0; i < aCfg.m_Render.raytrace_lightColor.size(); ++i )
+    {
+        m_raytrace_lightColor[i] = GetColor( aCfg.m_Render.raytrace_lightColor[i] );
+
+        SFVEC2F sphericalCoord =
+                SFVEC2F( ( aCfg.m_Render.raytrace_lightElevation[i] + 90.0f ) / 180.0f,
+                         aCfg.m_Render.raytrace_lightAzimuth[i] / 180.0f );
+
+        sphericalCoord.x = glm::clamp( sphericalCoord.x, 0.0f, 1.0f );
+        sphericalCoord.y = glm::clamp( sphericalCoord.y, 0.0f, 2.0f );
+
+        m_raytrace_lightSphericalCoords[i] = sphericalCoord;
+    }
+
+#define TRANSFER_SETTING( flag, field ) SetFlag( flag, aCfg.m_Render.field )
+
+    TRANSFER_SETTING( FL_USE_REALISTIC_MODE,      realistic );
+    TRANSFER_SETTING( FL_SUBTRACT_MASK_FROM_SILK, subtract_mask_from_silk );
+
+    // OpenGL options
+    TRANSFER_SETTING( FL_RENDER_OPENGL_COPPER_THICKNESS,          opengl_copper_thickness );
+    TRANSFER_SETTING( FL_RENDER_OPENGL_SHOW_MODEL_BBOX,           opengl_show_model_bbox );
+    TRANSFER_SETTING( FL_RENDER_OPENGL_AA_DISABLE_ON_MOVE,        opengl_AA_disableOnMove );
+    TRANSFER_SETTING( FL_RENDER_OPENGL_THICKNESS_DISABLE_ON_MOVE, opengl_thickness_disableOnMove );
+    TRANSFER_SETTING( FL_RENDER_OPENGL_VIAS_DISABLE_ON_MOVE,      opengl_vias_disableOnMove );
+    TRANSFER_SETTING( FL_RENDER_OPENGL_HOLES_DISABLE_ON_MOVE,     opengl_holes_disableOnMove );
+
+    // Raytracing options
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_SHADOWS,             raytrace_shadows );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_BACKFLOOR,           raytrace_backfloor );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_REFRACTIONS,         raytrace_refractions );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_REFLECTIONS,         raytrace_reflections );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_POST_PROCESSING,     raytrace_post_processing );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_ANTI_ALIASING,       raytrace_anti_aliasing );
+    TRANSFER_SETTING( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, raytrace_procedural_textures );
+
+    TRANSFER_SETTING( FL_AXIS,                            show_axis );
+    TRANSFER_SETTING( FL_FP_ATTRIBUTES_NORMAL,            show_footprints_normal );
+    TRANSFER_SETTING( FL_FP_ATTRIBUTES_NORMAL_INSERT,     show_footprints_insert );
+    TRANSFER_SETTING( FL_FP_ATTRIBUTES_VIRTUAL,           show_footprints_virtual );
+    TRANSFER_SETTING( FL_ZONE,                            show_zones );
+    TRANSFER_SETTING( FL_ADHESIVE,                        show_adhesive );
+    TRANSFER_SETTING( FL_SILKSCREEN,                      show_silkscreen );
+    TRANSFER_SETTING( FL_SOLDERMASK,                      show_soldermask );
+    TRANSFER_SETTING( FL_SOLDERPASTE,                     show_solderpaste );
+    TRANSFER_SETTING( FL_COMMENTS,                        show_comments );
+    TRANSFER_SETTING( FL_ECO,                             show_eco );
+    TRANSFER_SETTING( FL_SHOW_BOARD_BODY,                 show_board_body );
+    TRANSFER_SETTING( FL_CLIP_SILK_ON_VIA_ANNULUS,        clip_silk_on_via_annulus );
+    TRANSFER_SETTING( FL_RENDER_PLATED_PADS_AS_PLATED,    renderPlatedPadsAsPlated );
+
+#undef TRANSFER_SETTING
+
+    GridSet( static_cast<GRID3D_TYPE>( aCfg.m_Render.grid_type ) );
+    AntiAliasingSet( static_cast<ANTIALIASING_MODE>( aCfg.m_Render.opengl_AA_mode ) );
+
+    m_opengl_selectionColor = GetColor( aCfg.m_Render.opengl_selection_color );
+
+    m_raytrace_nrsamples_shadows = aCfg.m_Render.raytrace_nrsamples_shadows;
+    m_raytrace_nrsamples_reflections = aCfg.m_Render.raytrace_nrsamples_reflections;
+    m_raytrace_nrsamples_refractions = aCfg.m_Render.raytrace_nrsamples_refractions;
+
+    m_raytrace_spread_shadows = aCfg.m_Render.raytrace_spread_shadows;
+    m_raytrace_spread_reflections = aCfg.m_Render.raytrace_spread_reflections;
+    m_raytrace_spread_refractions = aCfg.m_Render.raytrace_spread_refractions;
+
+    m_raytrace_recursivelevel_refractions = aCfg.m_Render.raytrace_recursivelevel_refractions;
+    m_raytrace_recursivelevel_reflections = aCfg.m_Render.raytrace_recursivelevel_reflections;
+
+    MaterialModeSet( static_cast<MATERIAL_MODE>( aCfg.m_Render.material_mode ) );
+}
@@ -48,6 +48,7 @@
 #include <reporter.h>
 
 class COLOR_SETTINGS;
+class EDA_3D_VIEWER_SETTINGS;
 
 /// A type that stores a container of 2d objects for each layer id
 typedef std::map< PCB_LAYER_ID, CBVHCONTAINER2D *> MAP_CONTAINER_2D;
@@ -140,6 +141,13 @@ class BOARD_ADAPTER
         m_colors = aSettings;
     }
 
+    /**
+     * @brief LoadSettings - Take the 3D colors from the color settings and the render options
+     * from the 3D viewer settings.  The render engine is left unchanged.
+     * @param aCfg: the 3D viewer settings
+     */
+    void LoadSettings( const EDA_3D_VIEWER_SETTINGS& aCfg );
+
     /**
      * @brief InitSettings - Function to be called by the render when it need to
      * reload the settings for the board.
@@ -936,6 +936,27 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER* aStatusReporter )
         return;
     }
 
+    // Load the models not yet in our cache map on several threads, the loop below then gets
+    // them from the cache
+    std::vector<wxString> modelFiles;
+
+    for( FOOTPRINT* footprint : m_boardAdapter.GetBoard()->Footprints() )
+    {
+        for( const FP_3DMODEL& model : footprint->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty()
+                    && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+            {
+                modelFiles.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    if( aStatusReporter && !modelFiles.empty() )
+        aStatusReporter->Report( _( "Loading 3D models" ) );
+
+    m_boardAdapter.Get3DCacheManager()->PrefetchModels( modelFiles );
+
     // Go for all footprints
     for( FOOTPRINT* footprint : m_boardAdapter.GetBoard()->Footprints() )
     {
@@ -72,7 +72,9 @@
 
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
+#include <atomic>
 #include <cstdlib>
+#include <thread>
 #include <vector>
 
 #include <stack>
@@ -130,6 +132,34 @@ struct BVHBuildNode
 };
 
 
+struct BVHBuildTask
+{
+    int start, end;
+    BVHBuildNode **node;    ///< Where the root of the subtree goes
+};
+
+
+/// State of a build; each thread building subtrees has its own.
+struct BVHBuildContext
+{
+    BVHBuildContext() : totalNodes( 0 ), deferSize( 0 ), deferred( nullptr ) {}
+
+    int totalNodes;
+    std::vector<void *> allocations;
+
+    /// When not null, subtrees of deferSize primitives or less are left to other threads
+    int deferSize;
+    std::vector<BVHBuildTask> *deferred;
+};
+
+
+/// Subtrees shared between threads are not smaller than this
+#define BVH_MIN_PARALLEL_SUBTREE 2048
+
+/// Node buffers start on a cache line boundary, so that each line holds two nodes
+#define BVH_NODES_ALIGNMENT 64
+
+
 struct MortonPrimitive
 {
     int primitiveIndex;
@@ -234,9 +264,11 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
 
 CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
                       int aMaxPrimsInNode,
-                      SPLITMETHOD aSplitMethod ) :
+                      SPLITMETHOD aSplitMethod,
+                      unsigned int aThreadCount ) :
     m_maxPrimsInNode( std::min( 255, aMaxPrimsInNode ) ),
-    m_splitMethod( aSplitMethod )
+    m_splitMethod( aSplitMethod ),
+    m_threadCount( aThreadCount )
 {
     if( aObjectContainer.GetList().empty() )
     {
@@ -278,19 +310,29 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
+    {
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+    }
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+    {
+        root = parallelBuild( primitiveInfo, &totalNodes );
+
+        // Leaves refer to ranges of the sorted primitive info
+        for( const BVHPrimitiveInfo &info : primitiveInfo )
+            orderedPrims.push_back( m_primitives[ info.primitiveNumber ] );
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
     m_primitives.swap( orderedPrims );
 
     // Compute representation of depth-first traversal of BVH tree
-    m_nodes = static_cast<LinearBVHNode *>( malloc( sizeof( LinearBVHNode ) *
-                                                    totalNodes ) );
-    m_addresses_pointer_to_mm_free.push_back( m_nodes );
+    void *nodesBuffer = malloc( sizeof( LinearBVHNode ) * totalNodes + BVH_NODES_ALIGNMENT - 1 );
+    m_addresses_pointer_to_mm_free.push_back( nodesBuffer );
+
+    m_nodes = reinterpret_cast<LinearBVHNode *>(
+            ( reinterpret_cast<uintptr_t>( nodesBuffer ) + BVH_NODES_ALIGNMENT - 1 )
+            & ~static_cast<uintptr_t>( BVH_NODES_ALIGNMENT - 1 ) );
 
     for( int i = 0; i < totalNodes; ++i )
     {
@@ -423,13 +465,77 @@ struct BucketInfo
 };
 
 
+BVHBuildNode *CBVH_PBRT::parallelBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                                        int *totalNodes )
+{
+    const int nPrimitives = primitiveInfo.size();
+
+    size_t threadCount = m_threadCount;
+
+    if( threadCount == 0 )
+        threadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    // Split the upper levels here; enough subtrees are left to keep all threads busy
+    BVHBuildContext           topContext;
+    std::vector<BVHBuildTask> tasks;
+
+    if( threadCount > 1 && nPrimitives >= 2 * BVH_MIN_PARALLEL_SUBTREE )
+    {
+        topContext.deferred  = &tasks;
+        topContext.deferSize = std::max<int>( BVH_MIN_PARALLEL_SUBTREE,
+                                              nPrimitives / ( 8 * threadCount ) );
+    }
+
+    BVHBuildNode *root = recursiveBuild( primitiveInfo, 0, nPrimitives, topContext );
+
+    // The largest subtrees go first, so that threads do not wait for a late one
+    std::sort( tasks.begin(), tasks.end(),
+               []( const BVHBuildTask &a, const BVHBuildTask &b )
+               {
+                   return ( a.end - a.start ) > ( b.end - b.start );
+               } );
+
+    std::vector<BVHBuildContext> contexts( std::min( threadCount, tasks.size() ) );
+    std::vector<std::thread>     threads;
+    std::atomic<size_t>          nextTask( 0 );
+
+    // Subtrees sort disjoint ranges of primitiveInfo, and fill their own slots
+    for( size_t i = 0; i < contexts.size(); ++i )
+    {
+        threads.emplace_back( [&, i]()
+                {
+                    for( size_t t = nextTask++; t < tasks.size(); t = nextTask++ )
+                    {
+                        *tasks[t].node = recursiveBuild( primitiveInfo, tasks[t].start,
+                                                         tasks[t].end, contexts[i] );
+                    }
+                } );
+    }
+
+    for( std::thread &thread : threads )
+        thread.join();
+
+    contexts.push_back( topContext );
+
+    *totalNodes = 0;
+
+    for( const BVHBuildContext &context : contexts )
+    {
+        *totalNodes += context.totalNodes;
+        m_addresses_pointer_to_mm_free.insert( m_addresses_pointer_to_mm_free.end(),
+                                               context.allocations.begin(),
+                                               context.allocations.end() );
+    }
+
+    return root;
+}
+
+
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          BVHBuildContext &context ) const
 {
-    wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
     wxASSERT( end   >= 0 );
     wxASSERT( start != end );
@@ -437,11 +543,11 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     wxASSERT( start <= (int)primitiveInfo.size() );
     wxASSERT( end   <= (int)primitiveInfo.size() );
 
-    (*totalNodes)++;
+    context.totalNodes++;
 
     // !TODO: implement an memory Arena
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    context.allocations.push_back( node );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -462,16 +568,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
-
-        for( int i = start; i < end; ++i )
-        {
-            int primitiveNr = primitiveInfo[i].primitiveNumber;
-            wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-        }
-
-        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+        node->InitLeaf( start, nPrimitives, bounds );
     }
     else
     {
@@ -491,23 +588,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
-
-            for( int i = start; i < end; ++i )
-            {
-                int primitiveNr = primitiveInfo[i].primitiveNumber;
-
-                wxASSERT( (primitiveNr >= 0) &&
-                          (primitiveNr < (int)m_primitives.size()) );
-
-                const COBJECT *obj = static_cast<const COBJECT *>( m_primitives[ primitiveNr ] );
-
-                wxASSERT( obj != NULL );
-
-                orderedPrims.push_back( obj );
-            }
-
-            node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+            node->InitLeaf( start, nPrimitives, bounds );
         }
         else
         {
@@ -660,18 +741,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
-
-                        for( int i = start; i < end; ++i )
-                        {
-                            const int primitiveNr = primitiveInfo[i].primitiveNumber;
-
-                            wxASSERT( primitiveNr < (int)m_primitives.size() );
-
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-                        }
-
-                        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+                        node->InitLeaf( start, nPrimitives, bounds );
 
                         return node;
                     }
@@ -680,17 +750,22 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
             }
             }
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
+            // The children are built later when they are left to other threads, so the
+            // bounds are the ones of the primitives rather than of the children
+            node->bounds = bounds;
+            node->splitAxis = dim;
+            node->nPrimitives = 0;
+
+            auto buildChild = [&]( int aStart, int aEnd, BVHBuildNode **aChild )
+            {
+                if( context.deferred && ( aEnd - aStart ) <= context.deferSize )
+                    context.deferred->push_back( { aStart, aEnd, aChild } );
+                else
+                    *aChild = recursiveBuild( primitiveInfo, aStart, aEnd, context );
+            };
+
+            buildChild( start, mid, &node->children[0] );
+            buildChild( mid, end, &node->children[1] );
         }
     }
 
@@ -76,6 +76,7 @@
 
 // Forward Declarations
 struct BVHBuildNode;
+struct BVHBuildContext;
 struct BVHPrimitiveInfo;
 struct MortonPrimitive;
 
@@ -97,6 +98,8 @@ struct LinearBVHNode
     uint8_t  pad[1];       ///< ensure 32 byte total size
 };
 
+static_assert( sizeof( LinearBVHNode ) == 32, "Two LinearBVHNode must fit in a cache line" );
+
 
 enum class SPLITMETHOD
 {
@@ -110,8 +113,12 @@ enum class SPLITMETHOD
 class  CBVH_PBRT : public CGENERICACCELERATOR
 {
 public:
+    /**
+     * @param aThreadCount is the number of threads sharing the build of subtrees (not used by
+     *                     HLBVH), 0 for one thread per core.
+     */
     CBVH_PBRT( const CGENERICCONTAINER& aObjectContainer, int aMaxPrimsInNode = 4,
-            SPLITMETHOD aSplitMethod = SPLITMETHOD::SAH );
+            SPLITMETHOD aSplitMethod = SPLITMETHOD::SAH, unsigned int aThreadCount = 0 );
 
     ~CBVH_PBRT();
 
@@ -123,11 +130,17 @@ public:
 
 private:
 
+    /**
+     * Build the tree top-down, then the subtrees below a size threshold on several threads.
+     * Leaves refer to ranges of \a primitiveInfo, which is sorted along the way.
+     */
+    BVHBuildNode *parallelBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                                 int *totalNodes );
+
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  BVHBuildContext &context ) const;
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -154,6 +167,7 @@ private:
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
+    unsigned int        m_threadCount;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode       *m_nodes;
 
@@ -28,10 +28,12 @@
  */
 
 #include "ccontainer2d.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
 #include <vector>
 #include <mutex>
-#include <boost/range/algorithm/partition.hpp>
-#include <boost/range/algorithm/nth_element.hpp>
 #include <wx/debug.h>
 
 
@@ -169,8 +171,6 @@ CBVHCONTAINER2D::CBVHCONTAINER2D() : CGENERICCONTAINER2D( OBJECT2D_TYPE::BVHCONT
 {
     m_isInitialized = false;
     m_bbox.Reset();
-    m_elements_to_delete.clear();
-    m_Tree = NULL;
 }
 
 /*
@@ -254,14 +254,10 @@ void CBVHCONTAINER2D::Clear()
 
 void CBVHCONTAINER2D::destroy()
 {
-    for( std::list<BVH_CONTAINER_NODE_2D *>::iterator ii = m_elements_to_delete.begin();
-         ii != m_elements_to_delete.end();
-         ++ii )
-    {
-        delete *ii;
-    }
-    m_elements_to_delete.clear();
-    m_Tree = nullptr;
+    m_nodes.clear();
+    m_nodes.shrink_to_fit();
+    m_leafObjects.clear();
+    m_leafObjects.shrink_to_fit();
     m_isInitialized = false;
 }
 
@@ -274,133 +270,301 @@ CBVHCONTAINER2D::~CBVHCONTAINER2D()
 
 #define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
 
+/// Number of buckets used to estimate the surface area heuristic
+#define BVH_CONTAINER2D_SAH_BUCKETS 12
 
-void CBVHCONTAINER2D::BuildBVH()
+/// Subtrees smaller than that are not worth a thread
+#define BVH_CONTAINER2D_MIN_PARALLEL_SUBTREE 1024
+
+
+namespace
 {
-    if( m_isInitialized )
-        destroy();
 
-    m_isInitialized = true;
+struct BVH_BUILD_OBJECT_2D
+{
+    const COBJECT2D *m_object;
+    CBBOX2D          m_bbox;
+    SFVEC2F          m_centroid;
+};
 
-    if( m_objects.empty() )
+
+/// Temporary node, flattened once the whole tree is built
+struct BVH_BUILD_NODE_2D
+{
+    CBBOX2D            m_BBox;
+    BVH_BUILD_NODE_2D *m_Children[2];
+    int                m_first;
+    int                m_count;         ///< 0 for an interior node
+};
+
+
+/// A subtree left to the worker threads
+struct BVH_BUILD_TASK_2D
+{
+    int                 m_start;
+    int                 m_end;
+    BVH_BUILD_NODE_2D **m_node;
+};
+
+
+struct BVH_BUILD_CONTEXT_2D
+{
+    std::deque<BVH_BUILD_NODE_2D>   m_nodes;
+
+    /// Subtrees up to this size are deferred to m_deferred, when it is set
+    int                             m_deferSize = 0;
+    std::vector<BVH_BUILD_TASK_2D> *m_deferred = nullptr;
+};
+
+
+/**
+ * Split the objects using the surface area heuristic, estimated on buckets of the centroids.
+ * The perimeter is the 2D equivalent of the surface.
+ *
+ * @return the index of the first object of the second half.
+ */
+int splitSAH( std::vector<BVH_BUILD_OBJECT_2D> &aObjects, int aStart, int aEnd,
+              const CBBOX2D &aCentroidBounds )
+{
+    const unsigned int dim = aCentroidBounds.MaxDimension();
+    const float        minCentroid = aCentroidBounds.Min()[dim];
+    const float        extent = aCentroidBounds.Max()[dim] - minCentroid;
+
+    // All the centroids are at the same place, just cut the list in two
+    if( extent <= 0.0f )
+        return ( aStart + aEnd ) / 2;
+
+    auto bucketOf = [&]( const BVH_BUILD_OBJECT_2D &aObject ) -> int
+                    {
+                        int b = (int)( BVH_CONTAINER2D_SAH_BUCKETS *
+                                       ( ( aObject.m_centroid[dim] - minCentroid ) / extent ) );
+
+                        return std::min( std::max( b, 0 ), BVH_CONTAINER2D_SAH_BUCKETS - 1 );
+                    };
+
+    int     counts[BVH_CONTAINER2D_SAH_BUCKETS] = {};
+    CBBOX2D bounds[BVH_CONTAINER2D_SAH_BUCKETS];
+
+    for( CBBOX2D &bbox : bounds )
+        bbox.Reset();
+
+    for( int i = aStart; i < aEnd; ++i )
     {
-        return;
+        const int b = bucketOf( aObjects[i] );
+
+        counts[b]++;
+        bounds[b].Union( aObjects[i].m_bbox );
     }
 
-    m_Tree = new BVH_CONTAINER_NODE_2D;
+    // Sweep from the right to get the cost of the right side of each split, then from the
+    // left to add the cost of the left side
+    float   cost[BVH_CONTAINER2D_SAH_BUCKETS - 1];
+    CBBOX2D side;
+    int     count = 0;
 
-    m_elements_to_delete.push_back( m_Tree );
-    m_Tree->m_BBox = m_bbox;
+    side.Reset();
 
-    for( LIST_OBJECT2D::const_iterator ii = m_objects.begin();
-         ii != m_objects.end();
-         ++ii )
+    for( int b = BVH_CONTAINER2D_SAH_BUCKETS - 1; b > 0; --b )
     {
-        m_Tree->m_LeafList.push_back( static_cast<const COBJECT2D *>(*ii) );
+        if( counts[b] )
+        {
+            side.Union( bounds[b] );
+            count += counts[b];
+        }
+
+        cost[b - 1] = count ? count * side.Perimeter() : 0.0f;
     }
 
-    recursiveBuild_MIDDLE_SPLIT( m_Tree );
-}
+    side.Reset();
+    count = 0;
+
+    int   bestSplit = -1;
+    float bestCost = 0.0f;
 
+    for( int b = 0; b < BVH_CONTAINER2D_SAH_BUCKETS - 1; ++b )
+    {
+        if( counts[b] )
+        {
+            side.Union( bounds[b] );
+            count += counts[b];
+        }
 
-// Based on a blog post by VADIM KRAVCENKO
-// http://www.vadimkravcenko.com/bvh-tree-building
-// Implements:
+        // A split must leave objects on both sides
+        if( count == 0 || count == aEnd - aStart )
+            continue;
 
-// "Split in the middle of the longest Axis"
-// "Creates a binary tree with Top-Down approach.
-//  Fastest BVH building, but least [speed] accuracy."
+        cost[b] += count * side.Perimeter();
 
-static bool sortByCentroid_X( const COBJECT2D *a, const COBJECT2D *b )
-{
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
+        if( bestSplit < 0 || cost[b] < bestCost )
+        {
+            bestSplit = b;
+            bestCost = cost[b];
+        }
+    }
+
+    if( bestSplit < 0 )
+        return ( aStart + aEnd ) / 2;
+
+    auto midIter = std::partition( aObjects.begin() + aStart, aObjects.begin() + aEnd,
+                                   [&]( const BVH_BUILD_OBJECT_2D &aObject )
+                                   {
+                                       return bucketOf( aObject ) <= bestSplit;
+                                   } );
+
+    return midIter - aObjects.begin();
 }
 
-static bool sortByCentroid_Y( const COBJECT2D *a, const COBJECT2D *b )
+
+BVH_BUILD_NODE_2D *buildNode( std::vector<BVH_BUILD_OBJECT_2D> &aObjects, int aStart, int aEnd,
+                              BVH_BUILD_CONTEXT_2D &aContext )
 {
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
+    wxASSERT( aEnd > aStart );
+
+    aContext.m_nodes.emplace_back();
+
+    BVH_BUILD_NODE_2D *node = &aContext.m_nodes.back();
+    CBBOX2D            centroidBounds;
+
+    node->m_BBox.Reset();
+    centroidBounds.Reset();
+
+    for( int i = aStart; i < aEnd; ++i )
+    {
+        node->m_BBox.Union( aObjects[i].m_bbox );
+        centroidBounds.Union( aObjects[i].m_centroid );
+    }
+
+    wxASSERT( node->m_BBox.IsInitialized() == true );
+
+    if( aEnd - aStart <= BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
+    {
+        // It is a Leaf
+        node->m_Children[0] = nullptr;
+        node->m_Children[1] = nullptr;
+        node->m_first = aStart;
+        node->m_count = aEnd - aStart;
+
+        return node;
+    }
+
+    int mid = splitSAH( aObjects, aStart, aEnd, centroidBounds );
+
+    wxASSERT( ( mid > aStart ) && ( mid < aEnd ) );
+
+    node->m_first = aStart;
+    node->m_count = 0;
+
+    auto buildChild =
+            [&]( int aChildStart, int aChildEnd, BVH_BUILD_NODE_2D **aChild )
+            {
+                if( aContext.m_deferred && aChildEnd - aChildStart <= aContext.m_deferSize )
+                    aContext.m_deferred->push_back( { aChildStart, aChildEnd, aChild } );
+                else
+                    *aChild = buildNode( aObjects, aChildStart, aChildEnd, aContext );
+            };
+
+    buildChild( aStart, mid, &node->m_Children[0] );
+    buildChild( mid, aEnd, &node->m_Children[1] );
+
+    return node;
 }
 
-static bool sortByCentroid_Z( const COBJECT2D *a, const COBJECT2D *b )
+
+void flattenNode( const BVH_BUILD_NODE_2D *aNode, std::vector<BVH_CONTAINER_NODE_2D> &aNodes )
 {
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
+    const size_t index = aNodes.size();
+
+    aNodes.push_back( { aNode->m_BBox, aNode->m_first, aNode->m_count } );
+
+    if( aNode->m_count == 0 )
+    {
+        flattenNode( aNode->m_Children[0], aNodes );
+        aNodes[index].m_Offset = aNodes.size();
+        flattenNode( aNode->m_Children[1], aNodes );
+    }
 }
 
-void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent )
+} // namespace
+
+
+void CBVHCONTAINER2D::BuildBVH( unsigned int aThreadCount )
 {
-    wxASSERT( aNodeParent != NULL );
-    wxASSERT( aNodeParent->m_BBox.IsInitialized() == true );
-    wxASSERT( aNodeParent->m_LeafList.size() > 0 );
+    if( m_isInitialized )
+        destroy();
 
-    if( aNodeParent->m_LeafList.size() > BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
+    m_isInitialized = true;
+
+    if( m_objects.empty() )
     {
-        // Create Leaf Nodes
-        BVH_CONTAINER_NODE_2D *leftNode  = new BVH_CONTAINER_NODE_2D;
-        BVH_CONTAINER_NODE_2D *rightNode = new BVH_CONTAINER_NODE_2D;
-        m_elements_to_delete.push_back( leftNode );
-        m_elements_to_delete.push_back( rightNode );
-
-        leftNode->m_BBox.Reset();
-        rightNode->m_BBox.Reset();
-        leftNode->m_LeafList.clear();
-        rightNode->m_LeafList.clear();
-
-        // Decide wich axis to split
-        const unsigned int axis_to_split = aNodeParent->m_BBox.MaxDimension();
-
-        // Divide the objects
-        switch( axis_to_split )
-        {
-            case 0: aNodeParent->m_LeafList.sort( sortByCentroid_X ); break;
-            case 1: aNodeParent->m_LeafList.sort( sortByCentroid_Y ); break;
-            case 2: aNodeParent->m_LeafList.sort( sortByCentroid_Z ); break;
-        }
+        return;
+    }
 
-        unsigned int i = 0;
+    std::vector<BVH_BUILD_OBJECT_2D> objects;
+    objects.reserve( m_objects.size() );
 
-        for( CONST_LIST_OBJECT2D::const_iterator ii = aNodeParent->m_LeafList.begin();
-             ii != aNodeParent->m_LeafList.end();
-             ++ii )
-        {
-            const COBJECT2D *object = static_cast<const COBJECT2D *>(*ii);
+    for( const COBJECT2D *object : m_objects )
+        objects.push_back( { object, object->GetBBox(), object->GetCentroid() } );
 
-            if( i < (aNodeParent->m_LeafList.size() / 2 ) )
-            {
-                leftNode->m_BBox.Union( object->GetBBox() );
-                leftNode->m_LeafList.push_back( object );
-            }
-            else
-            {
-                rightNode->m_BBox.Union( object->GetBBox() );
-                rightNode->m_LeafList.push_back( object );
-            }
+    const int nObjects = objects.size();
+    size_t    threadCount = aThreadCount;
 
-            i++;
-        }
+    if( threadCount == 0 )
+        threadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
 
-        wxASSERT( leftNode->m_LeafList.size() > 0 );
-        wxASSERT( rightNode->m_LeafList.size() > 0 );
-        wxASSERT( ( leftNode->m_LeafList.size() + rightNode->m_LeafList.size() ) ==
-                  aNodeParent->m_LeafList.size() );
+    // Split the upper levels here; enough subtrees are left to keep all threads busy
+    BVH_BUILD_CONTEXT_2D           topContext;
+    std::vector<BVH_BUILD_TASK_2D> tasks;
 
-        aNodeParent->m_Children[0] = leftNode;
-        aNodeParent->m_Children[1] = rightNode;
-        aNodeParent->m_LeafList.clear();
+    if( threadCount > 1 && nObjects >= 2 * BVH_CONTAINER2D_MIN_PARALLEL_SUBTREE )
+    {
+        topContext.m_deferred  = &tasks;
+        topContext.m_deferSize = std::max<int>( BVH_CONTAINER2D_MIN_PARALLEL_SUBTREE,
+                                                nObjects / ( 8 * threadCount ) );
+    }
 
-        recursiveBuild_MIDDLE_SPLIT( leftNode );
-        recursiveBuild_MIDDLE_SPLIT( rightNode );
+    BVH_BUILD_NODE_2D *root = buildNode( objects, 0, nObjects, topContext );
 
-        wxASSERT( aNodeParent->m_LeafList.size() == 0 );
-    }
-    else
+    // The largest subtrees go first, so that threads do not wait for a late one
+    std::sort( tasks.begin(), tasks.end(),
+               []( const BVH_BUILD_TASK_2D &a, const BVH_BUILD_TASK_2D &b )
+               {
+                   return ( a.m_end - a.m_start ) > ( b.m_end - b.m_start );
+               } );
+
+    std::vector<BVH_BUILD_CONTEXT_2D> contexts( std::min( threadCount, tasks.size() ) );
+    std::vector<std::thread>          threads;
+    std::atomic<size_t>               nextTask( 0 );
+
+    // Subtrees partition disjoint ranges of objects, and fill their own slots
+    for( size_t i = 0; i < contexts.size(); ++i )
     {
-        // It is a Leaf
-        aNodeParent->m_Children[0] = NULL;
-        aNodeParent->m_Children[1] = NULL;
+        threads.emplace_back( [&, i]()
+                {
+                    for( size_t t = nextTask++; t < tasks.size(); t = nextTask++ )
+                    {
+                        *tasks[t].m_node = buildNode( objects, tasks[t].m_start, tasks[t].m_end,
+                                                      contexts[i] );
+                    }
+                } );
     }
 
-    wxASSERT( aNodeParent != NULL );
-    wxASSERT( aNodeParent->m_BBox.IsInitialized() == true );
+    for( std::thread &thread : threads )
+        thread.join();
+
+    size_t totalNodes = topContext.m_nodes.size();
+
+    for( const BVH_BUILD_CONTEXT_2D &context : contexts )
+        totalNodes += context.m_nodes.size();
+
+    m_nodes.reserve( totalNodes );
+    flattenNode( root, m_nodes );
+
+    wxASSERT( m_nodes.size() == totalNodes );
+
+    m_leafObjects.reserve( objects.size() );
+
+    for( const BVH_BUILD_OBJECT_2D &object : objects )
+        m_leafObjects.push_back( object.m_object );
 }
 
 
@@ -408,30 +572,29 @@ bool CBVHCONTAINER2D::IntersectAny( const RAYSEG2D &aSegRay ) const
 {
     wxASSERT( m_isInitialized == true );
 
-    if( m_Tree )
-        return recursiveIntersectAny( m_Tree, aSegRay );
+    if( !m_nodes.empty() )
+        return recursiveIntersectAny( 0, aSegRay );
 
     return false;
 }
 
 
-bool CBVHCONTAINER2D::recursiveIntersectAny( const BVH_CONTAINER_NODE_2D *aNode,
+bool CBVHCONTAINER2D::recursiveIntersectAny( int aNode,
                                              const RAYSEG2D &aSegRay ) const
 {
-    wxASSERT( aNode != NULL );
+    const BVH_CONTAINER_NODE_2D &node = m_nodes[aNode];
 
-    if( aNode->m_BBox.Inside( aSegRay.m_Start ) ||
-        aNode->m_BBox.Inside( aSegRay.m_End ) ||
-        aNode->m_BBox.Intersect( aSegRay ) )
+    if( node.m_BBox.Inside( aSegRay.m_Start ) ||
+        node.m_BBox.Inside( aSegRay.m_End ) ||
+        node.m_BBox.Intersect( aSegRay ) )
     {
-        if( !aNode->m_LeafList.empty() )
+        if( node.m_Count > 0 )
         {
-            wxASSERT( aNode->m_Children[0] == NULL );
-            wxASSERT( aNode->m_Children[1] == NULL );
-
             // Leaf
-            for( const COBJECT2D *obj : aNode->m_LeafList )
+            for( int i = node.m_Offset; i < node.m_Offset + node.m_Count; ++i )
             {
+                const COBJECT2D *obj = m_leafObjects[i];
+
                 if( obj->IsPointInside( aSegRay.m_Start ) ||
                     obj->IsPointInside( aSegRay.m_End ) ||
                     obj->Intersect( aSegRay, nullptr, nullptr ) )
@@ -440,13 +603,10 @@ bool CBVHCONTAINER2D::recursiveIntersectAny( const BVH_CONTAINER_NODE_2D *aNode,
         }
         else
         {
-            wxASSERT( aNode->m_Children[0] != NULL );
-            wxASSERT( aNode->m_Children[1] != NULL );
-
             // Node
-            if( recursiveIntersectAny( aNode->m_Children[0], aSegRay ) )
+            if( recursiveIntersectAny( aNode + 1, aSegRay ) )
                 return true;
-            if( recursiveIntersectAny( aNode->m_Children[1], aSegRay ) )
+            if( recursiveIntersectAny( node.m_Offset, aSegRay ) )
                 return true;
         }
     }
@@ -462,31 +622,27 @@ void CBVHCONTAINER2D::GetListObjectsIntersects( const CBBOX2D &aBBox,
 
     aOutList.clear();
 
-    if( m_Tree )
-        recursiveGetListObjectsIntersects( m_Tree, aBBox, aOutList );
+    if( !m_nodes.empty() )
+        recursiveGetListObjectsIntersects( 0, aBBox, aOutList );
 }
 
 
-void CBVHCONTAINER2D::recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
+void CBVHCONTAINER2D::recursiveGetListObjectsIntersects( int aNode,
                                                          const CBBOX2D & aBBox,
                                                          CONST_LIST_OBJECT2D &aOutList ) const
 {
-    wxASSERT( aNode != NULL );
     wxASSERT( aBBox.IsInitialized() == true );
 
-    if( aNode->m_BBox.Intersects( aBBox ) )
+    const BVH_CONTAINER_NODE_2D &node = m_nodes[aNode];
+
+    if( node.m_BBox.Intersects( aBBox ) )
     {
-        if( !aNode->m_LeafList.empty() )
+        if( node.m_Count > 0 )
         {
-            wxASSERT( aNode->m_Children[0] == NULL );
-            wxASSERT( aNode->m_Children[1] == NULL );
-
             // Leaf
-            for( CONST_LIST_OBJECT2D::const_iterator ii = aNode->m_LeafList.begin();
-                 ii != aNode->m_LeafList.end();
-                 ++ii )
+            for( int i = node.m_Offset; i < node.m_Offset + node.m_Count; ++i )
             {
-                const COBJECT2D *obj = static_cast<const COBJECT2D *>(*ii);
+                const COBJECT2D *obj = m_leafObjects[i];
 
                 if( obj->Intersects( aBBox ) )
                     aOutList.push_back( obj );
@@ -494,12 +650,9 @@ void CBVHCONTAINER2D::recursiveGetListObjectsIntersects( const BVH_CONTAINER_NOD
         }
         else
         {
-            wxASSERT( aNode->m_Children[0] != NULL );
-            wxASSERT( aNode->m_Children[1] != NULL );
-
             // Node
-            recursiveGetListObjectsIntersects( aNode->m_Children[0], aBBox, aOutList );
-            recursiveGetListObjectsIntersects( aNode->m_Children[1], aBBox, aOutList );
+            recursiveGetListObjectsIntersects( aNode + 1, aBBox, aOutList );
+            recursiveGetListObjectsIntersects( node.m_Offset, aBBox, aOutList );
         }
     }
 }
@@ -33,6 +33,7 @@
 #include "../shapes2D/cobject2d.h"
 #include <list>
 #include <mutex>
+#include <vector>
 
 typedef std::list<COBJECT2D *> LIST_OBJECT2D;
 typedef std::list<const COBJECT2D *> CONST_LIST_OBJECT2D;
@@ -101,13 +102,19 @@ public:
 };
 
 
+/**
+ * A node of the flattened BVH.  Nodes are stored depth-first, so the first child of an
+ * interior node is the next one.
+ */
 struct BVH_CONTAINER_NODE_2D
 {
-    CBBOX2D                 m_BBox;
-    BVH_CONTAINER_NODE_2D   *m_Children[2];
+    CBBOX2D m_BBox;
+
+    /// Index of the second child of an interior node, or of the first object of a leaf
+    int     m_Offset;
 
-    /// Store the list of objects if that node is a Leaf
-    CONST_LIST_OBJECT2D     m_LeafList;
+    /// Number of objects of a leaf, 0 for an interior node
+    int     m_Count;
 };
 
 
@@ -117,21 +124,26 @@ public:
     CBVHCONTAINER2D();
     ~CBVHCONTAINER2D();
 
-    void BuildBVH();
+    /**
+     * Build the hierarchy of the objects (binned SAH).
+     * @param aThreadCount is the number of threads sharing the build of subtrees, 0 for one
+     *                     thread per core.
+     */
+    void BuildBVH( unsigned int aThreadCount = 0 );
 
     void Clear() override;
 
 private:
     bool m_isInitialized;
-    std::list<BVH_CONTAINER_NODE_2D *> m_elements_to_delete;
-    BVH_CONTAINER_NODE_2D   *m_Tree;
+
+    std::vector<BVH_CONTAINER_NODE_2D> m_nodes;         ///< Depth-first, root first
+    std::vector<const COBJECT2D *>     m_leafObjects;   ///< Objects of the leaves, in order
 
     void destroy();
-    void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent );
-    void recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
+    void recursiveGetListObjectsIntersects( int aNode,
                                             const CBBOX2D & aBBox,
                                             CONST_LIST_OBJECT2D &aOutList ) const;
-    bool recursiveIntersectAny( const BVH_CONTAINER_NODE_2D *aNode,
+    bool recursiveIntersectAny( int aNode,
                                 const RAYSEG2D &aSegRay ) const;
 
 public:
@@ -34,6 +34,7 @@
 #include "shapes3D/clayeritem.h"
 #include "shapes3D/ccylinder.h"
 #include "shapes3D/ctriangle.h"
+#include "shapes3D/cinstance.h"
 #include "shapes2D/citemlayercsg2d.h"
 #include "shapes2D/cring2d.h"
 #include "shapes2D/cpolygon2d.h"
@@ -487,6 +488,7 @@ void C3D_RENDER_RAYTRACING::Reload( REPORTER* aStatusReporter,
 
     m_object_container.Clear();
     m_containerWithObjectsToDelete.Clear();
+    m_instanced_models.clear();
 
     setupMaterials();
 
@@ -1104,7 +1106,7 @@ void C3D_RENDER_RAYTRACING::Reload( REPORTER* aStatusReporter,
     }
     m_accelerator = 0;
 
-    m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::MIDDLE );
+    m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::SAH );
 
     if( aStatusReporter )
     {
@@ -1399,6 +1401,31 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSkipMaterialInformation )
 {
+    // Without a cache manager (no project, e.g. when rendering from the command line) the
+    // footprints are rendered without their models
+    if( !m_boardAdapter.Get3DCacheManager() )
+        return;
+
+    // Load the models on several threads, the loop below then gets them from the cache
+    std::vector<wxString> modelFiles;
+
+    for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
+    {
+        if( !m_boardAdapter.ShouldFPBeDisplayed( (FOOTPRINT_ATTR_T) fp->GetAttributes() ) )
+            continue;
+
+        for( const FP_3DMODEL& model : fp->Models() )
+        {
+            if( ( static_cast<float>( model.m_Opacity ) > FLT_EPSILON )
+                    && model.m_Show && !model.m_Filename.empty() )
+            {
+                modelFiles.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    m_boardAdapter.Get3DCacheManager()->PrefetchModels( modelFiles );
+
     // Go for all footprints
     for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
     {
@@ -1631,115 +1658,145 @@ void C3D_RENDER_RAYTRACING::add_3D_models( CCONTAINER &aDstContainer, const S3DM
     if( (a3DModel->m_Materials != NULL) && (a3DModel->m_Meshes != NULL) &&
         (a3DModel->m_MaterialsSize > 0) && (a3DModel->m_MeshesSize > 0) )
     {
+        // The triangles of a model are shared by all the footprints using it.  They are kept
+        // scaled to 3D units, so the procedural textures keep their size.  A mirroring
+        // transformation reverses the winding of the triangles, so they are not shared with
+        // the other placements.
+        const float unitScale = m_boardAdapter.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
+        const bool  isMirrored = glm::determinant( glm::mat3( aModelMatrix ) ) < 0.0f;
 
-        MODEL_MATERIALS *materialVector = NULL;
+        INSTANCED_MODEL &instancedModel =
+                m_instanced_models[std::make_tuple( a3DModel, aFPOpacity, isMirrored )];
 
-        if( !aSkipMaterialInformation )
+        if( !instancedModel.m_accelerator )
         {
-            materialVector = get_3D_model_material( a3DModel );
+            add_3D_model_triangles( instancedModel.m_triangles, a3DModel, unitScale, aFPOpacity,
+                                    aSkipMaterialInformation, isMirrored );
+
+            instancedModel.m_accelerator.reset( new CBVH_PBRT( instancedModel.m_triangles ) );
         }
 
-        const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+        if( instancedModel.m_triangles.GetList().empty() )
+            return;
 
-        for( unsigned int mesh_i = 0;
-             mesh_i < a3DModel->m_MeshesSize;
-             ++mesh_i )
-        {
-            const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
-
-            // Validate the mesh pointers
-            wxASSERT( mesh.m_Positions != NULL );
-            wxASSERT( mesh.m_FaceIdx != NULL );
-            wxASSERT( mesh.m_Normals != NULL );
-            wxASSERT( mesh.m_FaceIdxSize > 0 );
-            wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
-
-
-            if( (mesh.m_Positions != NULL) &&
-                (mesh.m_Normals != NULL) &&
-                (mesh.m_FaceIdx != NULL) &&
-                (mesh.m_FaceIdxSize > 0) &&
-                (mesh.m_VertexSize > 0) &&
-                ((mesh.m_FaceIdxSize % 3) == 0) &&
-                (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
-            {
-                float fpTransparency;
-                const CBLINN_PHONG_MATERIAL *blinn_material;
+        const glm::mat4 instanceMatrix = glm::scale( aModelMatrix,
+                                                     SFVEC3F( 1.0f / unitScale ) );
 
-                if( !aSkipMaterialInformation )
-                {
-                    blinn_material = &(*materialVector)[mesh.m_MaterialIdx];
+        CINSTANCE *instance = new CINSTANCE( instancedModel.m_accelerator.get(),
+                                             instancedModel.m_triangles.GetBBox(),
+                                             instanceMatrix );
 
-                    fpTransparency = 1.0f - (( 1.0f - blinn_material->GetTransparency() ) * aFPOpacity );
-                }
+        instance->SetBoardItem( aBoardItem );
 
-                // Add all face triangles
-                for( unsigned int faceIdx = 0;
-                     faceIdx < mesh.m_FaceIdxSize;
-                     faceIdx += 3 )
-                {
-                    const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
-                    const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
-                    const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
+        aDstContainer.Add( instance );
+    }
+}
 
-                    wxASSERT( idx0 < mesh.m_VertexSize );
-                    wxASSERT( idx1 < mesh.m_VertexSize );
-                    wxASSERT( idx2 < mesh.m_VertexSize );
 
-                    if( ( idx0 < mesh.m_VertexSize ) &&
-                        ( idx1 < mesh.m_VertexSize ) &&
-                        ( idx2 < mesh.m_VertexSize ) )
-                    {
-                        const SFVEC3F &v0 = mesh.m_Positions[idx0];
-                        const SFVEC3F &v1 = mesh.m_Positions[idx1];
-                        const SFVEC3F &v2 = mesh.m_Positions[idx2];
+void C3D_RENDER_RAYTRACING::add_3D_model_triangles( CCONTAINER &aDstContainer,
+                                                    const S3DMODEL *a3DModel, float aScale,
+                                                    float aFPOpacity,
+                                                    bool aSkipMaterialInformation,
+                                                    bool aReverseWinding )
+{
+    MODEL_MATERIALS *materialVector = NULL;
 
-                        const SFVEC3F &n0 = mesh.m_Normals[idx0];
-                        const SFVEC3F &n1 = mesh.m_Normals[idx1];
-                        const SFVEC3F &n2 = mesh.m_Normals[idx2];
+    if( !aSkipMaterialInformation )
+    {
+        materialVector = get_3D_model_material( a3DModel );
+    }
+
+    for( unsigned int mesh_i = 0;
+         mesh_i < a3DModel->m_MeshesSize;
+         ++mesh_i )
+    {
+        const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
+
+        // Validate the mesh pointers
+        wxASSERT( mesh.m_Positions != NULL );
+        wxASSERT( mesh.m_FaceIdx != NULL );
+        wxASSERT( mesh.m_Normals != NULL );
+        wxASSERT( mesh.m_FaceIdxSize > 0 );
+        wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
+
+
+        if( (mesh.m_Positions != NULL) &&
+            (mesh.m_Normals != NULL) &&
+            (mesh.m_FaceIdx != NULL) &&
+            (mesh.m_FaceIdxSize > 0) &&
+            (mesh.m_VertexSize > 0) &&
+            ((mesh.m_FaceIdxSize % 3) == 0) &&
+            (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
+        {
+            float fpTransparency;
+            const CBLINN_PHONG_MATERIAL *blinn_material;
 
-                        // Transform vertex with the model matrix
-                        const SFVEC3F vt0 = SFVEC3F( aModelMatrix * glm::vec4( v0, 1.0f) );
-                        const SFVEC3F vt1 = SFVEC3F( aModelMatrix * glm::vec4( v1, 1.0f) );
-                        const SFVEC3F vt2 = SFVEC3F( aModelMatrix * glm::vec4( v2, 1.0f) );
+            if( !aSkipMaterialInformation )
+            {
+                blinn_material = &(*materialVector)[mesh.m_MaterialIdx];
 
-                        const SFVEC3F nt0 = glm::normalize( SFVEC3F( normalMatrix * n0 ) );
-                        const SFVEC3F nt1 = glm::normalize( SFVEC3F( normalMatrix * n1 ) );
-                        const SFVEC3F nt2 = glm::normalize( SFVEC3F( normalMatrix * n2 ) );
+                fpTransparency = 1.0f - (( 1.0f - blinn_material->GetTransparency() ) * aFPOpacity );
+            }
 
-                        CTRIANGLE *newTriangle = new  CTRIANGLE( vt0, vt2, vt1,
-                                                                 nt0, nt2, nt1 );
+            // Add all face triangles
+            for( unsigned int faceIdx = 0;
+                 faceIdx < mesh.m_FaceIdxSize;
+                 faceIdx += 3 )
+            {
+                const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
+                const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
+                const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
 
-                        newTriangle->SetBoardItem( aBoardItem );
+                wxASSERT( idx0 < mesh.m_VertexSize );
+                wxASSERT( idx1 < mesh.m_VertexSize );
+                wxASSERT( idx2 < mesh.m_VertexSize );
 
-                        aDstContainer.Add( newTriangle );
+                if( ( idx0 < mesh.m_VertexSize ) &&
+                    ( idx1 < mesh.m_VertexSize ) &&
+                    ( idx2 < mesh.m_VertexSize ) )
+                {
+                    const SFVEC3F vt0 = mesh.m_Positions[idx0] * aScale;
+                    const SFVEC3F vt1 = mesh.m_Positions[idx1] * aScale;
+                    const SFVEC3F vt2 = mesh.m_Positions[idx2] * aScale;
 
-                        if( !aSkipMaterialInformation )
-                        {
-                            newTriangle->SetMaterial( blinn_material );
-                            newTriangle->SetModelTransparency( fpTransparency );
+                    const SFVEC3F nt0 = glm::normalize( mesh.m_Normals[idx0] );
+                    const SFVEC3F nt1 = glm::normalize( mesh.m_Normals[idx1] );
+                    const SFVEC3F nt2 = glm::normalize( mesh.m_Normals[idx2] );
 
-                            if( mesh.m_Color == NULL )
-                            {
-                                const SFVEC3F diffuseColor =
-                                    a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
+                    CTRIANGLE *newTriangle;
 
-                                if( m_boardAdapter.MaterialModeGet() == MATERIAL_MODE::CAD_MODE )
-                                    newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
-                                else
-                                    newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
-                            }
+                    if( aReverseWinding )
+                        newTriangle = new CTRIANGLE( vt0, vt1, vt2, nt0, nt1, nt2 );
+                    else
+                        newTriangle = new CTRIANGLE( vt0, vt2, vt1, nt0, nt2, nt1 );
+
+                    aDstContainer.Add( newTriangle );
+
+                    if( !aSkipMaterialInformation )
+                    {
+                        newTriangle->SetMaterial( blinn_material );
+                        newTriangle->SetModelTransparency( fpTransparency );
+
+                        if( mesh.m_Color == NULL )
+                        {
+                            const SFVEC3F diffuseColor =
+                                a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
+
+                            if( m_boardAdapter.MaterialModeGet() == MATERIAL_MODE::CAD_MODE )
+                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
                             else
-                            {
-                                if( m_boardAdapter.MaterialModeGet() == MATERIAL_MODE::CAD_MODE )
-                                    newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
-                                                           ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
-                                                           ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
-                                else
-                                    newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
-                                                           ConvertSRGBToLinear( mesh.m_Color[idx1] ),
-                                                           ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
-                            }
+                                newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
+                        }
+                        else
+                        {
+                            if( m_boardAdapter.MaterialModeGet() == MATERIAL_MODE::CAD_MODE )
+                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
+                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
+                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
+                            else
+                                newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
+                                                       ConvertSRGBToLinear( mesh.m_Color[idx1] ),
+                                                       ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
                         }
                     }
                 }
@@ -366,6 +366,70 @@ void C3D_RENDER_RAYTRACING::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 }
 
 
+wxImage C3D_RENDER_RAYTRACING::RenderToImage( const wxSize& aSize, REPORTER* aStatusReporter )
+{
+    wxCHECK_MSG( aSize.x >= RAYTRACING_MIN_IMAGE_SIZE && aSize.y >= RAYTRACING_MIN_IMAGE_SIZE,
+                 wxImage(), wxT( "Image too small to raytrace" ) );
+
+    m_windowSize = aSize;
+    m_camera.SetCurWindowSize( aSize );
+
+    if( m_reloadRequested )
+        Reload( aStatusReporter, nullptr, false );
+
+    m_oldWindowsSize = m_windowSize;
+    initialize_block_positions();
+
+    // Same layout as the PBO: RGBA, bottom row first
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    // Run all the stages from the start
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( buffer.data(), aStatusReporter );
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    wxImage        image( aSize.x, aSize.y, false );
+    unsigned char* data = image.GetData();
+
+    // The buffer does not cover the borders of the window, which show the background
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const float   posYfactor = (float) y / (float) std::max( aSize.y - 1, 1 );
+        const SFVEC3F bgColor = SFVEC3F( m_boardAdapter.m_BgColorTop ) * ( 1.0f - posYfactor )
+                                + SFVEC3F( m_boardAdapter.m_BgColorBot ) * posYfactor;
+
+        const CCOLORRGB color( bgColor );
+        unsigned char*  row = data + y * aSize.x * 3;
+
+        for( int x = 0; x < aSize.x; ++x, row += 3 )
+            std::copy( color.c, color.c + 3, row );
+    }
+
+    for( unsigned int y = 0; y < m_realBufferSize.y; ++y )
+    {
+        const int imageY = aSize.y - 1 - (int) ( m_yoffset + y );
+
+        if( imageY < 0 || imageY >= aSize.y )
+            continue;
+
+        const GLubyte *ptr = &buffer[ y * m_realBufferSize.x * 4 ];
+
+        for( unsigned int x = 0; x < m_realBufferSize.x; ++x, ptr += 4 )
+        {
+            const int imageX = m_xoffset + x;
+
+            if( imageX >= 0 && imageX < aSize.x )
+                std::copy( ptr, ptr + 3, data + ( imageY * aSize.x + imageX ) * 3 );
+        }
+    }
+
+    return image;
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
                                                REPORTER* aStatusReporter )
 {
@@ -499,6 +563,8 @@ static void HITINFO_PACKET_init( HITINFO_PACKET *aHitPacket )
         aHitPacket[i].m_hitresult = false;
         aHitPacket[i].m_HitInfo.m_HitNormal = SFVEC3F( 0.0f );
         aHitPacket[i].m_HitInfo.m_ShadowFactor = 1.0f;
+        aHitPacket[i].m_HitInfo.pHitInstancedObject = nullptr;
+        aHitPacket[i].m_HitInfo.m_UV = SFVEC2F( 0.0f );
     }
 }
 
@@ -1055,6 +1121,8 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                 {
                     packet.m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
                     packet.m_HitInfo.m_acc_node_info = 0;
+                    packet.m_HitInfo.pHitInstancedObject = nullptr;
+                    packet.m_HitInfo.m_UV = SFVEC2F( 0.0f );
                     packet.m_hitresult = false;
                 }
 
@@ -1227,6 +1295,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                                 (hitPacket[ iLT ].m_HitInfo.pHitObject == hitPacket[ iRT ].m_HitInfo.pHitObject) )
                             {
                                 hitInfoLRT.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                                hitInfoLRT.pHitInstancedObject =
+                                        hitPacket[ iLT ].m_HitInfo.pHitInstancedObject;
+                                hitInfoLRT.m_UV = ( hitPacket[ iLT ].m_HitInfo.m_UV +
+                                                    hitPacket[ iRT ].m_HitInfo.m_UV ) * 0.5f;
                                 hitInfoLRT.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
                                                       hitPacket[ iRT ].m_HitInfo.m_tHit ) * 0.5f;
                                 hitInfoLRT.m_HitNormal =
@@ -1304,6 +1376,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                                   hitPacket[ iLB ].m_HitInfo.pHitObject ) )
                             {
                                 hitInfoLTB.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                                hitInfoLTB.pHitInstancedObject =
+                                        hitPacket[ iLT ].m_HitInfo.pHitInstancedObject;
+                                hitInfoLTB.m_UV = ( hitPacket[ iLT ].m_HitInfo.m_UV +
+                                                    hitPacket[ iLB ].m_HitInfo.m_UV ) * 0.5f;
                                 hitInfoLTB.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
                                                       hitPacket[ iLB ].m_HitInfo.m_tHit ) * 0.5f;
                                 hitInfoLTB.m_HitNormal =
@@ -1377,6 +1453,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                               hitPacket[ iRB ].m_HitInfo.pHitObject ) )
                         {
                             hitInfoRTB.pHitObject = hitPacket[ iRT ].m_HitInfo.pHitObject;
+                            hitInfoRTB.pHitInstancedObject =
+                                    hitPacket[ iRT ].m_HitInfo.pHitInstancedObject;
+                            hitInfoRTB.m_UV = ( hitPacket[ iRT ].m_HitInfo.m_UV +
+                                                hitPacket[ iRB ].m_HitInfo.m_UV ) * 0.5f;
 
                             hitInfoRTB.m_tHit = ( hitPacket[ iRT ].m_HitInfo.m_tHit +
                                                   hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
@@ -1451,6 +1531,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                               hitPacket[ iRB ].m_HitInfo.pHitObject ) )
                         {
                             hitInfoLRB.pHitObject = hitPacket[ iLB ].m_HitInfo.pHitObject;
+                            hitInfoLRB.pHitInstancedObject =
+                                    hitPacket[ iLB ].m_HitInfo.pHitInstancedObject;
+                            hitInfoLRB.m_UV = ( hitPacket[ iLB ].m_HitInfo.m_UV +
+                                                hitPacket[ iRB ].m_HitInfo.m_UV ) * 0.5f;
 
                             hitInfoLRB.m_tHit = ( hitPacket[ iLB ].m_HitInfo.m_tHit +
                                                   hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
@@ -1663,7 +1747,10 @@ SFVEC3F C3D_RENDER_RAYTRACING::shadeHit( const SFVEC3F &aBgColor,
                                          unsigned int aRecursiveLevel,
                                          bool is_testShadow ) const
 {
-    const CMATERIAL *objMaterial = aHitInfo.pHitObject->GetMaterial();
+    // Instances are shaded with the object that was hit inside them
+    const COBJECT *hitObject = aHitInfo.pHitObject->GetShadedObject( aHitInfo );
+
+    const CMATERIAL *objMaterial = hitObject->GetMaterial();
     wxASSERT( objMaterial != NULL );
 
     SFVEC3F outColor = objMaterial->GetEmissiveColor() + objMaterial->GetAmbientColor();
@@ -1675,7 +1762,7 @@ SFVEC3F C3D_RENDER_RAYTRACING::shadeHit( const SFVEC3F &aBgColor,
 
     hitPoint += aHitInfo.m_HitNormal * m_boardAdapter.GetNonCopperLayerThickness3DU() * 0.6f;
 
-    const SFVEC3F diffuseColorObj = aHitInfo.pHitObject->GetDiffuseColor( aHitInfo );
+    const SFVEC3F diffuseColorObj = hitObject->GetDiffuseColor( aHitInfo );
 
     const LIST_LIGHT &lightList = m_lights.GetList();
 
@@ -1867,7 +1954,7 @@ SFVEC3F C3D_RENDER_RAYTRACING::shadeHit( const SFVEC3F &aBgColor,
         // Refractions
         // /////////////////////////////////////////////////////////////////////
 
-        const float objTransparency = aHitInfo.pHitObject->GetModelTransparency();
+        const float objTransparency = hitObject->GetModelTransparency();
 
         if( ( objTransparency > 0.0f ) &&
             m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_REFRACTIONS ) &&
@@ -2082,7 +2169,9 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
 
-    opengl_init_pbo();
+    // Nothing to allocate when rendering to an image
+    if( m_is_opengl_initialized )
+        opengl_init_pbo();
 }
 
 BOARD_ITEM *C3D_RENDER_RAYTRACING::IntersectBoardItem( const RAY &aRay )
@@ -40,6 +40,14 @@
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <memory>
+#include <tuple>
+
+#include <wx/image.h>
+
+/// The smallest image rendered by C3D_RENDER_RAYTRACING::RenderToImage(), in pixels on each
+/// axis: the block positions are laid out with a margin of a preview block in the window
+#define RAYTRACING_MIN_IMAGE_SIZE ( 4 * RAYPACKET_DIM + 5 )
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -47,6 +55,17 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+/// The triangles of a 3D model shared by all the footprints using it, and their BVH
+struct INSTANCED_MODEL
+{
+    CCONTAINER                           m_triangles;
+    std::unique_ptr<CGENERICACCELERATOR> m_accelerator;
+};
+
+/// Maps a S3DMODEL pointer, its opacity and whether it is mirrored with its shared triangles
+typedef std::map< std::tuple<const S3DMODEL *, float, bool>, INSTANCED_MODEL >
+        MAP_INSTANCED_MODELS;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -73,6 +92,18 @@ public:
 
     BOARD_ITEM *IntersectBoardItem( const RAY &aRay );
 
+    /**
+     * Render the board into a CPU framebuffer, without OpenGL.
+     *
+     * The camera is set to the image size and the board is loaded if a reload was requested.
+     * The blocks are traced on all cores, then post processed if enabled.
+     *
+     * @param aSize is the image size, in pixels, at least #RAYTRACING_MIN_IMAGE_SIZE on each axis.
+     * @param aStatusReporter reports the progress, can be nullptr.
+     * @return the rendered image, or an invalid image if \a aSize is too small.
+     */
+    wxImage RenderToImage( const wxSize& aSize, REPORTER* aStatusReporter = nullptr );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -213,12 +244,21 @@ private:
                         float aFPOpacity,
                         bool aSkipMaterialInformation,
                         BOARD_ITEM *aBoardItem );
+    void add_3D_model_triangles( CCONTAINER &aDstContainer,
+                                 const S3DMODEL *a3DModel,
+                                 float aScale,
+                                 float aFPOpacity,
+                                 bool aSkipMaterialInformation,
+                                 bool aReverseWinding );
 
     MODEL_MATERIALS *get_3D_model_material( const S3DMODEL *a3DModel );
 
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
 
+    /// Stores the triangles of the 3D models, instanced by the footprints
+    MAP_INSTANCED_MODELS m_instanced_models;
+
     void initialize_block_positions();
 
     void render( GLubyte* ptrPBO, REPORTER* aStatusReporter );
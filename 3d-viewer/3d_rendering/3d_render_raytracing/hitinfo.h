@@ -43,6 +43,8 @@ struct HITINFO
     float   m_tHit;                     ///< ( 4) distance
 
     const COBJECT *pHitObject;          ///< ( 4) Object that was hitted
+    const COBJECT *pHitInstancedObject; ///< ( 4) Object hitted inside pHitObject if it is an
+                                        ///<      instance (CINSTANCE)
     SFVEC2F m_UV;                       ///< ( 8) 2-D texture coordinates
     unsigned int m_acc_node_info;       ///< ( 4) The acc stores here the node that it hits
 
@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.cpp
+ * @brief
+ */
+
+#include "cinstance.h"
+
+
+CINSTANCE::CINSTANCE( const CGENERICACCELERATOR *aObjects, const CBBOX &aObjectsBBox,
+                      const glm::mat4 &aTransform ) :
+        COBJECT( OBJECT3D_TYPE::INSTANCE ),
+        m_objects( aObjects )
+{
+    m_invTransform = glm::inverse( aTransform );
+    m_normalMatrix = glm::transpose( glm::mat3( m_invTransform ) );
+
+    m_bbox.Reset();
+    m_bbox.Set( aObjectsBBox );
+    m_bbox.ApplyTransformationAA( aTransform );
+    m_bbox.ScaleNextUp();
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+float CINSTANCE::toObjectSpace( const RAY &aRay, RAY &aObjectRay ) const
+{
+    const SFVEC3F origin = SFVEC3F( m_invTransform * glm::vec4( aRay.m_Origin, 1.0f ) );
+    const SFVEC3F dir = glm::mat3( m_invTransform ) * aRay.m_Dir;
+    const float   scale = glm::length( dir );
+
+    aObjectRay.Init( origin, dir / scale );
+
+    return scale;
+}
+
+
+bool CINSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    if( !m_bbox.Intersect( aRay ) )
+        return false;
+
+    RAY objectRay;
+    const float scale = toObjectSpace( aRay, objectRay );
+
+    HITINFO objectHitInfo;
+    objectHitInfo.m_tHit = aHitInfo.m_tHit * scale;
+    objectHitInfo.m_acc_node_info = 0;
+
+    if( !m_objects->Intersect( objectRay, objectHitInfo ) )
+        return false;
+
+    aHitInfo.m_tHit = objectHitInfo.m_tHit / scale;
+    aHitInfo.m_HitPoint = aRay.at( aHitInfo.m_tHit );
+    aHitInfo.m_HitNormal = glm::normalize( m_normalMatrix * objectHitInfo.m_HitNormal );
+    aHitInfo.m_UV = objectHitInfo.m_UV;
+
+    aHitInfo.pHitObject = this;
+    aHitInfo.pHitInstancedObject = objectHitInfo.pHitObject;
+
+    return true;
+}
+
+
+bool CINSTANCE::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    if( !m_bbox.Intersect( aRay ) )
+        return false;
+
+    RAY objectRay;
+    const float scale = toObjectSpace( aRay, objectRay );
+
+    return m_objects->IntersectP( objectRay, aMaxDistance * scale );
+}
+
+
+bool CINSTANCE::Intersects( const CBBOX &aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F CINSTANCE::GetDiffuseColor( const HITINFO &aHitInfo ) const
+{
+    return aHitInfo.pHitInstancedObject->GetDiffuseColor( aHitInfo );
+}
+
+
+const COBJECT *CINSTANCE::GetShadedObject( const HITINFO &aHitInfo ) const
+{
+    return aHitInfo.pHitInstancedObject;
+}
@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.h
+ * @brief
+ */
+
+#ifndef _CINSTANCE_H_
+#define _CINSTANCE_H_
+
+#include "cobject.h"
+#include "../accelerators/caccelerator.h"
+
+/**
+ * An instance places objects shared with other instances, e.g. the triangles of a 3D model
+ * used by many footprints.  The shared objects and their acceleration structure are stored
+ * once; rays are transformed to their space to be intersected.
+ *
+ * Hits are reported on the instance, the object hit inside it is given by the hit info.
+ */
+class  CINSTANCE : public COBJECT
+{
+
+public:
+    /**
+     * @param aObjects are the shared objects.
+     * @param aObjectsBBox is the bounding box of \a aObjects.
+     * @param aTransform transforms the shared objects to the instance.
+     */
+    CINSTANCE( const CGENERICACCELERATOR *aObjects, const CBBOX &aObjectsBBox,
+               const glm::mat4 &aTransform );
+
+    // Imported from COBJECT
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    bool IntersectP( const RAY &aRay, float aMaxDistance ) const override;
+    bool Intersects( const CBBOX &aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
+    const COBJECT *GetShadedObject( const HITINFO &aHitInfo ) const override;
+
+private:
+    /**
+     * Transform a ray to the space of the shared objects.
+     *
+     * @return the ratio of the distances along \a aObjectRay to the ones along \a aRay.
+     */
+    float toObjectSpace( const RAY &aRay, RAY &aObjectRay ) const;
+
+    const CGENERICACCELERATOR *m_objects;
+    glm::mat4 m_invTransform;
+    glm::mat3 m_normalMatrix;
+};
+
+
+#endif // _CINSTANCE_H_
@@ -44,6 +44,7 @@ enum class OBJECT3D_TYPE
     XYPLANE,
     ROUNDSEG,
     TRIANGLE,
+    INSTANCE,
     MAX
 };
 
@@ -81,6 +82,12 @@ public:
 
     virtual SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const = 0;
 
+    /**
+     * @return the object giving the material and the colors of a hit on this object: itself,
+     *         but for instances of shared objects which give the object hit inside them.
+     */
+    virtual const COBJECT *GetShadedObject( const HITINFO &aHitInfo ) const { return this; }
+
     virtual ~COBJECT() {}
 
     /** Function Intersects
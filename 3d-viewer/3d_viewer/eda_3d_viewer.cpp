@@ -455,101 +455,10 @@ void EDA_3D_VIEWER::LoadSettings( APP_SETTINGS_BASE *aCfg )
 
     wxLogTrace( m_logTrace, "EDA_3D_VIEWER::LoadSettings" );
 
-    COLOR_SETTINGS* colors = Pgm().GetSettingsManager().GetColorSettings();
-
-    auto set_color =
-            [] ( const COLOR4D& aColor, SFVEC4F& aTarget )
-            {
-                aTarget.r = aColor.r;
-                aTarget.g = aColor.g;
-                aTarget.b = aColor.b;
-                aTarget.a = aColor.a;
-            };
-
-    set_color( colors->GetColor( LAYER_3D_BACKGROUND_BOTTOM ), m_boardAdapter.m_BgColorBot );
-    set_color( colors->GetColor( LAYER_3D_BACKGROUND_TOP ),    m_boardAdapter.m_BgColorTop );
-    set_color( colors->GetColor( LAYER_3D_BOARD ),             m_boardAdapter.m_BoardBodyColor );
-    set_color( colors->GetColor( LAYER_3D_COPPER ),            m_boardAdapter.m_CopperColor );
-    set_color( colors->GetColor( LAYER_3D_SILKSCREEN_BOTTOM ), m_boardAdapter.m_SilkScreenColorBot );
-    set_color( colors->GetColor( LAYER_3D_SILKSCREEN_TOP ),    m_boardAdapter.m_SilkScreenColorTop );
-    set_color( colors->GetColor( LAYER_3D_SOLDERMASK ),        m_boardAdapter.m_SolderMaskColorBot );
-    set_color( colors->GetColor( LAYER_3D_SOLDERMASK ),        m_boardAdapter.m_SolderMaskColorTop );
-    set_color( colors->GetColor( LAYER_3D_SOLDERPASTE ),       m_boardAdapter.m_SolderPasteColor );
-
     if( cfg )
     {
-        m_boardAdapter.m_raytrace_lightColorCamera = m_boardAdapter.GetColor( cfg->m_Render.raytrace_lightColorCamera );
-        m_boardAdapter.m_raytrace_lightColorTop = m_boardAdapter.GetColor( cfg->m_Render.raytrace_lightColorTop );
-        m_boardAdapter.m_raytrace_lightColorBottom = m_boardAdapter.GetColor( cfg->m_Render.raytrace_lightColorBottom );
-
-        m_boardAdapter.m_raytrace_lightColor.resize( cfg->m_Render.raytrace_lightColor.size() );
-        m_boardAdapter.m_raytrace_lightSphericalCoords.resize( cfg->m_Render.raytrace_lightColor.size() );
-
-        for( size_t i = 0; i < cfg->m_Render.raytrace_lightColor.size(); ++i )
-        {
-            m_boardAdapter.m_raytrace_lightColor[i] = m_boardAdapter.GetColor( cfg->m_Render.raytrace_lightColor[i] );
-
-            SFVEC2F sphericalCoord = SFVEC2F( ( cfg->m_Render.raytrace_lightElevation[i] + 90.0f ) / 180.0f,
-                                                cfg->m_Render.raytrace_lightAzimuth[i] / 180.0f );
-
-            sphericalCoord.x = glm::clamp( sphericalCoord.x, 0.0f, 1.0f );
-            sphericalCoord.y = glm::clamp( sphericalCoord.y, 0.0f, 2.0f );
-
-            m_boardAdapter.m_raytrace_lightSphericalCoords[i] = sphericalCoord;
-        }
-
-#define TRANSFER_SETTING( flag, field ) m_boardAdapter.SetFlag( flag, cfg->m_Render.field )
-
-        TRANSFER_SETTING( FL_USE_REALISTIC_MODE,      realistic );
-        TRANSFER_SETTING( FL_SUBTRACT_MASK_FROM_SILK, subtract_mask_from_silk );
-
-        // OpenGL options
-        TRANSFER_SETTING( FL_RENDER_OPENGL_COPPER_THICKNESS,          opengl_copper_thickness );
-        TRANSFER_SETTING( FL_RENDER_OPENGL_SHOW_MODEL_BBOX,           opengl_show_model_bbox );
-        TRANSFER_SETTING( FL_RENDER_OPENGL_AA_DISABLE_ON_MOVE,        opengl_AA_disableOnMove );
-        TRANSFER_SETTING( FL_RENDER_OPENGL_THICKNESS_DISABLE_ON_MOVE, opengl_thickness_disableOnMove );
-        TRANSFER_SETTING( FL_RENDER_OPENGL_VIAS_DISABLE_ON_MOVE,      opengl_vias_disableOnMove );
-        TRANSFER_SETTING( FL_RENDER_OPENGL_HOLES_DISABLE_ON_MOVE,     opengl_holes_disableOnMove );
-
-        // Raytracing options
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_SHADOWS,             raytrace_shadows );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_BACKFLOOR,           raytrace_backfloor );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_REFRACTIONS,         raytrace_refractions );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_REFLECTIONS,         raytrace_reflections );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_POST_PROCESSING,     raytrace_post_processing );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_ANTI_ALIASING,       raytrace_anti_aliasing );
-        TRANSFER_SETTING( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, raytrace_procedural_textures );
-
-        TRANSFER_SETTING( FL_AXIS,                            show_axis );
-        TRANSFER_SETTING( FL_FP_ATTRIBUTES_NORMAL,            show_footprints_normal );
-        TRANSFER_SETTING( FL_FP_ATTRIBUTES_NORMAL_INSERT,     show_footprints_insert );
-        TRANSFER_SETTING( FL_FP_ATTRIBUTES_VIRTUAL,           show_footprints_virtual );
-        TRANSFER_SETTING( FL_ZONE,                            show_zones );
-        TRANSFER_SETTING( FL_ADHESIVE,                        show_adhesive );
-        TRANSFER_SETTING( FL_SILKSCREEN,                      show_silkscreen );
-        TRANSFER_SETTING( FL_SOLDERMASK,                      show_soldermask );
-        TRANSFER_SETTING( FL_SOLDERPASTE,                     show_solderpaste );
-        TRANSFER_SETTING( FL_COMMENTS,                        show_comments );
-        TRANSFER_SETTING( FL_ECO,                             show_eco );
-        TRANSFER_SETTING( FL_SHOW_BOARD_BODY,                 show_board_body );
-        TRANSFER_SETTING( FL_CLIP_SILK_ON_VIA_ANNULUS,        clip_silk_on_via_annulus );
-        TRANSFER_SETTING( FL_RENDER_PLATED_PADS_AS_PLATED,    renderPlatedPadsAsPlated );
-
-        m_boardAdapter.GridSet( static_cast<GRID3D_TYPE>( cfg->m_Render.grid_type ) );
-        m_boardAdapter.AntiAliasingSet( static_cast<ANTIALIASING_MODE>( cfg->m_Render.opengl_AA_mode ) );
-
-        m_boardAdapter.m_opengl_selectionColor = m_boardAdapter.GetColor( cfg->m_Render.opengl_selection_color );
-
-        m_boardAdapter.m_raytrace_nrsamples_shadows = cfg->m_Render.raytrace_nrsamples_shadows;
-        m_boardAdapter.m_raytrace_nrsamples_reflections = cfg->m_Render.raytrace_nrsamples_reflections;
-        m_boardAdapter.m_raytrace_nrsamples_refractions = cfg->m_Render.raytrace_nrsamples_refractions;
-
-        m_boardAdapter.m_raytrace_spread_shadows = cfg->m_Render.raytrace_spread_shadows;
-        m_boardAdapter.m_raytrace_spread_reflections = cfg->m_Render.raytrace_spread_reflections;
-        m_boardAdapter.m_raytrace_spread_refractions = cfg->m_Render.raytrace_spread_refractions;
-
-        m_boardAdapter.m_raytrace_recursivelevel_refractions = cfg->m_Render.raytrace_recursivelevel_refractions;
-        m_boardAdapter.m_raytrace_recursivelevel_reflections = cfg->m_Render.raytrace_recursivelevel_reflections;
+        m_boardAdapter.SetColorSettings( Pgm().GetSettingsManager().GetColorSettings() );
+        m_boardAdapter.LoadSettings( *cfg );
 
         // When opening the 3D viewer, we use the opengl mode, not the ray tracing engine
         // because the ray tracing is very time consumming, and can be seen as not working
@@ -563,12 +472,8 @@ void EDA_3D_VIEWER::LoadSettings( APP_SETTINGS_BASE *aCfg )
         m_boardAdapter.RenderEngineSet( RENDER_ENGINE::OPENGL_LEGACY );
 #endif
 
-        m_boardAdapter.MaterialModeSet( static_cast<MATERIAL_MODE>( cfg->m_Render.material_mode ) );
-
         m_canvas->AnimationEnabledSet( cfg->m_Camera.animation_enabled );
         m_canvas->MovingSpeedMultiplierSet( cfg->m_Camera.moving_speed_multiplier );
-
-#undef TRANSFER_SETTING
     }
 }
 
@@ -141,8 +141,18 @@ static const wxChar DebugZoneFiller[] = wxT( "DebugZoneFiller" );
 
 static const wxChar DebugPDFWriter[] = wxT( "DebugPDFWriter" );
 
+/**
+ * zlib compression level of the PDF page streams, from 0 (none) to 9 (best).
+ */
+static const wxChar PDFCompressionLevel[] = wxT( "PDFCompressionLevel" );
+
 static const wxChar SkipBoundingBoxFpLoad[] = wxT( "SkipBoundingBoxFpLoad" );
 
+/**
+ * Write and use binary snapshots of the board files, to reload unchanged boards faster.
+ */
+static const wxChar BoardSnapshots[] = wxT( "BoardSnapshots" );
+
 } // namespace KEYS
 
 
@@ -240,8 +250,10 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_DebugZoneFiller           = false;
     m_DebugPDFWriter            = false;
+    m_PDFCompressionLevel       = 9;        // wxZ_BEST_COMPRESSION
 
     m_SkipBoundingBoxOnFpLoad   = false;
+    m_BoardSnapshots            = false;
 
     loadFromConfigFile();
 }
@@ -323,9 +335,15 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DebugPDFWriter,
                                                 &m_DebugPDFWriter, false ) );
 
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::PDFCompressionLevel,
+                                               &m_PDFCompressionLevel, 9, 0, 9 ) );
+
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::SkipBoundingBoxFpLoad,
                                                 &m_SkipBoundingBoxOnFpLoad, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::BoardSnapshots,
+                                                &m_BoardSnapshots, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( PARAM_CFG* param : configParams )
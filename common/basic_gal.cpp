@@ -39,10 +39,12 @@
 
 using namespace KIGFX;
 
-KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
+// Each thread has its own basic GAL (and options), so texts can be plotted or converted to
+// segments from several threads
+thread_local KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
 
 // the basic GAL doesn't get an external display option object
-BASIC_GAL basic_gal( basic_displayOptions );
+thread_local BASIC_GAL basic_gal( basic_displayOptions );
 
 
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
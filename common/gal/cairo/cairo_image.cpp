@@ -0,0 +1,48 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/cairo/cairo_image.h>
+
+#include <stdexcept>
+
+using namespace KIGFX;
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth,
+                                  int aHeight ) :
+        CAIRO_GAL_BASE( aDisplayOptions )
+{
+    // The base class destroys the surface and the context, even if we throw
+    surface = cairo_image_surface_create( GAL_FORMAT, aWidth, aHeight );
+
+    if( cairo_surface_status( surface ) != CAIRO_STATUS_SUCCESS )
+        throw std::runtime_error( "Could not create Cairo surface" );
+
+    context = currentContext = cairo_create( surface );
+
+    if( cairo_status( context ) != CAIRO_STATUS_SUCCESS )
+        throw std::runtime_error( "Could not create Cairo context" );
+
+    SetScreenSize( VECTOR2I( aWidth, aHeight ) );
+    resetContext();
+}
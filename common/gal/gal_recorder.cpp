@@ -0,0 +1,439 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/gal_recorder.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+using namespace KIGFX;
+
+
+/**
+ * Recorders don't draw a grid or use any other display option, they all share the defaults.
+ * They are only created and destroyed on the main thread, which keeps the observer list safe.
+ */
+static GAL_DISPLAY_OPTIONS& recorderOptions()
+{
+    static GAL_DISPLAY_OPTIONS options;
+    return options;
+}
+
+
+GAL_RECORDER::GAL_RECORDER( GAL& aTarget ) :
+        GAL( recorderOptions() ),
+        m_isOpenGl( aTarget.IsOpenGlEngine() ),
+        m_isCairo( aTarget.IsCairoEngine() )
+{
+    SetDepthRange( VECTOR2D( aTarget.GetMinDepth(), aTarget.GetMaxDepth() ) );
+    SetLookAtPoint( aTarget.GetLookAtPoint() );
+    SetZoomFactor( aTarget.GetZoomFactor() );
+    SetRotation( aTarget.GetRotation() );
+    SetFlip( aTarget.IsFlippedX(), aTarget.IsFlippedY() );
+    SetWorldScreenMatrix( aTarget.GetWorldScreenMatrix() );
+
+    screenWorldMatrix = aTarget.GetScreenWorldMatrix();
+    worldScale = aTarget.GetWorldScale();
+    screenSize = aTarget.GetScreenPixelSize();
+}
+
+
+void GAL_RECORDER::StartRecording()
+{
+    m_recording.clear();
+
+    bool    isFill = isFillEnabled;
+    bool    isStroke = isStrokeEnabled;
+    COLOR4D fill = fillColor;
+    COLOR4D stroke = strokeColor;
+    float   width = lineWidth;
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetIsFill( isFill );
+                aGal.SetIsStroke( isStroke );
+                aGal.SetFillColor( fill );
+                aGal.SetStrokeColor( stroke );
+                aGal.SetLineWidth( width );
+            } );
+}
+
+
+GAL_RECORDER::RECORDING GAL_RECORDER::FinishRecording()
+{
+    RECORDING recording;
+    recording.swap( m_recording );
+
+    return recording;
+}
+
+
+void GAL_RECORDER::Replay( const RECORDING& aRecording, GAL& aTarget )
+{
+    for( const std::function<void( GAL& )>& call : aRecording )
+        call( aTarget );
+}
+
+
+void GAL_RECORDER::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawLine( aStartPoint, aEndPoint );
+            } );
+}
+
+
+void GAL_RECORDER::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                double aWidth )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawSegment( aStartPoint, aEndPoint, aWidth );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolyline( aPointList );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    std::vector<VECTOR2D> points( aPointList, aPointList + aListSize );
+
+    m_recording.emplace_back(
+            [points]( GAL& aGal )
+            {
+                aGal.DrawPolyline( points.data(), (int) points.size() );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolyline( aLineChain );
+            } );
+}
+
+
+void GAL_RECORDER::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawCircle( aCenterPoint, aRadius );
+            } );
+}
+
+
+void GAL_RECORDER::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                            double aEndAngle )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawArc( aCenterPoint, aRadius, aStartAngle, aEndAngle );
+            } );
+}
+
+
+void GAL_RECORDER::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                   double aStartAngle, double aEndAngle, double aWidth )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawArcSegment( aCenterPoint, aRadius, aStartAngle, aEndAngle, aWidth );
+            } );
+}
+
+
+void GAL_RECORDER::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawRectangle( aStartPoint, aEndPoint );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolygon( aPointList );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    std::vector<VECTOR2D> points( aPointList, aPointList + aListSize );
+
+    m_recording.emplace_back(
+            [points]( GAL& aGal )
+            {
+                aGal.DrawPolygon( points.data(), (int) points.size() );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    if( !aPolySet.IsTriangulationUpToDate() )
+    {
+        // The GALs draw an untriangulated set outline by outline.  Painters pass temporary
+        // sets here (e.g. pad shapes), so keep only the outlines instead of the whole set
+        for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+            DrawPolygon( aPolySet.COutline( ii ) );
+
+        return;
+    }
+
+    // Triangulated sets are caches owned by the items (zone fills, graphic polygons)
+    const SHAPE_POLY_SET* polySet = &aPolySet;
+
+    m_recording.emplace_back(
+            [polySet]( GAL& aGal )
+            {
+                aGal.DrawPolygon( *polySet );
+            } );
+}
+
+
+void GAL_RECORDER::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawPolygon( aPolySet );
+            } );
+}
+
+
+void GAL_RECORDER::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                              const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                              double aFilterValue )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.DrawCurve( aStartPoint, aControlPointA, aControlPointB, aEndPoint,
+                                aFilterValue );
+            } );
+}
+
+
+void GAL_RECORDER::DrawBitmap( const BITMAP_BASE& aBitmap )
+{
+    const BITMAP_BASE* bitmap = &aBitmap;
+
+    m_recording.emplace_back(
+            [bitmap]( GAL& aGal )
+            {
+                aGal.DrawBitmap( *bitmap );
+            } );
+}
+
+
+void GAL_RECORDER::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                               double aRotationAngle )
+{
+    // Bitmap text is drawn by the target, with the text attributes in effect now
+    VECTOR2D            glyphSize = GetGlyphSize();
+    EDA_TEXT_HJUSTIFY_T hJustify = GetHorizontalJustify();
+    EDA_TEXT_VJUSTIFY_T vJustify = GetVerticalJustify();
+    bool                bold = IsFontBold();
+    bool                italic = IsFontItalic();
+    bool                underlined = IsFontUnderlined();
+    bool                mirrored = IsTextMirrored();
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetGlyphSize( glyphSize );
+                aGal.SetHorizontalJustify( hJustify );
+                aGal.SetVerticalJustify( vJustify );
+                aGal.SetFontBold( bold );
+                aGal.SetFontItalic( italic );
+                aGal.SetFontUnderlined( underlined );
+                aGal.SetTextMirrored( mirrored );
+                aGal.BitmapText( aText, aPosition, aRotationAngle );
+            } );
+}
+
+
+void GAL_RECORDER::SetIsFill( bool aIsFillEnabled )
+{
+    GAL::SetIsFill( aIsFillEnabled );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetIsFill( aIsFillEnabled );
+            } );
+}
+
+
+void GAL_RECORDER::SetIsStroke( bool aIsStrokeEnabled )
+{
+    GAL::SetIsStroke( aIsStrokeEnabled );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetIsStroke( aIsStrokeEnabled );
+            } );
+}
+
+
+void GAL_RECORDER::SetFillColor( const COLOR4D& aColor )
+{
+    GAL::SetFillColor( aColor );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetFillColor( aColor );
+            } );
+}
+
+
+void GAL_RECORDER::SetStrokeColor( const COLOR4D& aColor )
+{
+    GAL::SetStrokeColor( aColor );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetStrokeColor( aColor );
+            } );
+}
+
+
+void GAL_RECORDER::SetLineWidth( float aLineWidth )
+{
+    GAL::SetLineWidth( aLineWidth );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetLineWidth( aLineWidth );
+            } );
+}
+
+
+void GAL_RECORDER::SetLayerDepth( double aLayerDepth )
+{
+    GAL::SetLayerDepth( aLayerDepth );
+
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetLayerDepth( aLayerDepth );
+            } );
+}
+
+
+void GAL_RECORDER::SetNegativeDrawMode( bool aSetting )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.SetNegativeDrawMode( aSetting );
+            } );
+}
+
+
+void GAL_RECORDER::Transform( const MATRIX3x3D& aTransformation )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Transform( aTransformation );
+            } );
+}
+
+
+void GAL_RECORDER::Rotate( double aAngle )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Rotate( aAngle );
+            } );
+}
+
+
+void GAL_RECORDER::Translate( const VECTOR2D& aTranslation )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Translate( aTranslation );
+            } );
+}
+
+
+void GAL_RECORDER::Scale( const VECTOR2D& aScale )
+{
+    m_recording.emplace_back(
+            [=]( GAL& aGal )
+            {
+                aGal.Scale( aScale );
+            } );
+}
+
+
+void GAL_RECORDER::Save()
+{
+    m_recording.emplace_back(
+            []( GAL& aGal )
+            {
+                aGal.Save();
+            } );
+}
+
+
+void GAL_RECORDER::Restore()
+{
+    m_recording.emplace_back(
+            []( GAL& aGal )
+            {
+                aGal.Restore();
+            } );
+}
@@ -31,6 +31,10 @@
 #include <math/util.h>      // for KiROUND
 #include <wx/string.h>
 #include <gr_text.h>
+#include <hash_eda.h>
+
+#include <mutex>
+#include <unordered_map>
 
 
 using namespace KIGFX;
@@ -45,6 +49,53 @@ const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
 GLYPH_LIST*         g_newStrokeFontGlyphs = nullptr;     ///< Glyph list
 std::vector<BOX2D>* g_newStrokeFontGlyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+static std::mutex   g_newStrokeFontLock;                 ///< Guards the loading of the glyphs
+
+
+namespace
+{
+
+/// The text attributes a line layout depends on
+struct LINE_LAYOUT_KEY
+{
+    std::string         m_text;
+    VECTOR2D            m_glyphSize;
+    float               m_lineWidth;
+    bool                m_italic;
+    bool                m_mirrored;
+    bool                m_underlined;
+    EDA_TEXT_HJUSTIFY_T m_hJustify;
+
+    bool operator==( const LINE_LAYOUT_KEY& aOther ) const
+    {
+        return m_text == aOther.m_text && m_glyphSize == aOther.m_glyphSize
+               && m_lineWidth == aOther.m_lineWidth && m_italic == aOther.m_italic
+               && m_mirrored == aOther.m_mirrored && m_underlined == aOther.m_underlined
+               && m_hJustify == aOther.m_hJustify;
+    }
+};
+
+
+struct LINE_LAYOUT_KEY_HASH
+{
+    std::size_t operator()( const LINE_LAYOUT_KEY& aKey ) const
+    {
+        return hash_val( aKey.m_text, aKey.m_glyphSize.x, aKey.m_glyphSize.y, aKey.m_lineWidth,
+                         aKey.m_italic, aKey.m_mirrored, aKey.m_underlined,
+                         static_cast<int>( aKey.m_hJustify ) );
+    }
+};
+
+} // namespace
+
+
+/// Number of line layouts kept before the cache is emptied
+static const size_t LINE_LAYOUT_CACHE_SIZE = 65536;
+
+/// Layouts of the lines drawn lately, shared by all fonts (there is only one set of glyphs)
+static std::unordered_map<LINE_LAYOUT_KEY, std::shared_ptr<const STROKE_TEXT_LINE>,
+                          LINE_LAYOUT_KEY_HASH> s_lineLayouts;
+static std::mutex                             s_lineLayoutsLock;
 
 
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
@@ -55,6 +106,9 @@ STROKE_FONT::STROKE_FONT( GAL* aGal ) :
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
+    // Fonts can be loaded by the basic GAL of any thread
+    std::lock_guard<std::mutex> lock( g_newStrokeFontLock );
+
     if( g_newStrokeFontGlyphs )
     {
         m_glyphs = g_newStrokeFontGlyphs;
@@ -268,6 +322,53 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
 
 void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 {
+    std::shared_ptr<const STROKE_TEXT_LINE> layout = getLineLayout( aText );
+
+    for( const STROKE_TEXT_LINE::STROKE& stroke : layout->m_strokes )
+    {
+        const VECTOR2D* points = &layout->m_points[stroke.m_first];
+
+        if( stroke.m_isLine )
+            m_gal->DrawLine( points[0], points[1] );
+        else
+            m_gal->DrawPolyline( points, (int) stroke.m_count );
+    }
+}
+
+
+std::shared_ptr<const STROKE_TEXT_LINE> STROKE_FONT::getLineLayout( const UTF8& aText ) const
+{
+    LINE_LAYOUT_KEY key{ aText, m_gal->GetGlyphSize(), m_gal->GetLineWidth(),
+                         m_gal->IsFontItalic(), m_gal->IsTextMirrored(),
+                         m_gal->IsFontUnderlined(), m_gal->GetHorizontalJustify() };
+
+    {
+        std::lock_guard<std::mutex> lock( s_lineLayoutsLock );
+
+        auto it = s_lineLayouts.find( key );
+
+        if( it != s_lineLayouts.end() )
+            return it->second;
+    }
+
+    // Laid out outside of the lock; another thread may do the same work, which is harmless
+    auto layout = std::make_shared<const STROKE_TEXT_LINE>( layoutSingleLineText( aText ) );
+
+    std::lock_guard<std::mutex> lock( s_lineLayoutsLock );
+
+    // Layouts in use are shared, so the cache can simply be emptied when it grows too large
+    if( s_lineLayouts.size() >= LINE_LAYOUT_CACHE_SIZE )
+        s_lineLayouts.clear();
+
+    s_lineLayouts.emplace( std::move( key ), layout );
+
+    return layout;
+}
+
+
+STROKE_TEXT_LINE STROKE_FONT::layoutSingleLineText( const UTF8& aText ) const
+{
+    STROKE_TEXT_LINE layout;
     double      xOffset;
     double      yOffset;
     VECTOR2D    baseGlyphSize( m_gal->GetGlyphSize() );
@@ -280,31 +381,31 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     VECTOR2D textSize = computeTextLineSize( aText );
     double half_thickness = m_gal->GetLineWidth()/2;
 
-    // Context needs to be saved before any transformations
-    m_gal->Save();
+    // Origin of the line, as given by the justification
+    VECTOR2D origin;
 
     // First adjust: the text X position is corrected by half_thickness
     // because when the text with thickness is draw, its full size is textSize,
     // but the position of lines is half_thickness to textSize - half_thickness
     // so we must translate the coordinates by half_thickness on the X axis
     // to place the text inside the 0 to textSize X area.
-    m_gal->Translate( VECTOR2D( half_thickness, 0 ) );
+    origin.x += half_thickness;
 
     // Adjust the text position to the given horizontal justification
     switch( m_gal->GetHorizontalJustify() )
     {
     case GR_TEXT_HJUSTIFY_CENTER:
-        m_gal->Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
+        origin.x -= textSize.x / 2.0;
         break;
 
     case GR_TEXT_HJUSTIFY_RIGHT:
         if( !m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            origin.x -= textSize.x;
         break;
 
     case GR_TEXT_HJUSTIFY_LEFT:
         if( m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            origin.x -= textSize.x;
         break;
 
     default:
@@ -332,9 +433,6 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     bool     in_super_or_subscript = false;
     VECTOR2D glyphSize = baseGlyphSize;
 
-    // Allocate only once (for performance)
-    std::vector<VECTOR2D> ptListScaled;
-
     yOffset = 0;
 
     for( UTF8::uni_iter chIt = aText.ubegin(), end = aText.uend(); chIt < end; ++chIt )
@@ -441,7 +539,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
             VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
 
-            m_gal->DrawLine( startOverbar, endOverbar );
+            layout.addLine( origin + startOverbar, origin + endOverbar );
         }
         else
         {
@@ -454,13 +552,12 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startUnderline( xOffset, - vOffset );
             VECTOR2D endUnderline( xOffset + glyphSize.x * bbox.GetEnd().x, - vOffset );
 
-            m_gal->DrawLine( startUnderline, endUnderline );
+            layout.addLine( origin + startUnderline, origin + endUnderline );
         }
 
         for( const std::vector<VECTOR2D>* ptList : *glyph )
         {
-            int ptCount = 0;
-            ptListScaled.clear();
+            layout.m_strokes.push_back( { layout.m_points.size(), ptList->size(), false } );
 
             for( const VECTOR2D& pt : *ptList )
             {
@@ -476,17 +573,14 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                         scaledPt.x -= scaledPt.y * STROKE_FONT::ITALIC_TILT;
                 }
 
-                ptListScaled.push_back( scaledPt );
-                ptCount++;
+                layout.m_points.push_back( origin + scaledPt );
             }
-
-            m_gal->DrawPolyline( &ptListScaled[0], ptCount );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
 
-    m_gal->Restore();
+    return layout;
 }
 
 
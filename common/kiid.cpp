@@ -30,9 +30,15 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/functional/hash.hpp>
 
+#include <mutex>
+
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The generator is not thread safe, and items can be created on several threads (e.g. when
+// loading files in parallel)
+static std::mutex randomGeneratorMutex;
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator    nilGenerator;
@@ -40,6 +46,14 @@ static boost::uuids::nil_generator    nilGenerator;
 // Global nil reference
 KIID niluuid( 0 );
 
+
+static boost::uuids::uuid newRandomUuid()
+{
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+
+    return randomGenerator();
+}
+
 // For static initialization
 KIID& NilUuid()
 {
@@ -48,7 +62,7 @@ KIID& NilUuid()
 }
 
 
-KIID::KIID() : m_uuid( randomGenerator() ), m_cached_timestamp( 0 )
+KIID::KIID() : m_uuid( newRandomUuid() ), m_cached_timestamp( 0 )
 {
 }
 
@@ -87,7 +101,7 @@ KIID::KIID( const wxString& aString ) : m_uuid(), m_cached_timestamp( 0 )
         {
             // Failed to parse string representation; best we can do is assign a new
             // random one.
-            m_uuid = randomGenerator();
+            m_uuid = newRandomUuid();
         }
     }
 }
@@ -189,7 +203,7 @@ void KIID::ConvertTimestampToUuid()
         return;
 
     m_cached_timestamp = 0;
-    m_uuid             = randomGenerator();
+    m_uuid             = newRandomUuid();
 }
 
 
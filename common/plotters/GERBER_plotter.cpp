@@ -27,6 +27,7 @@
 #include <fill_type.h>
 #include <kicad_string.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <geometry/shape_line_chain.h>
 #include <macros.h>
 #include <math/util.h>      // for KiROUND
 #include <render_settings.h>
@@ -38,6 +39,7 @@
 #include "gbr_plotter_aperture_macros.h"
 
 #include <gbr_metadata.h>
+#include <hash_eda.h>
 
 // if GBR_USE_MACROS is defined, pads having a shape that is not a Gerber primitive
 // will use a macro when possible
@@ -360,21 +362,41 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int aWidth, void* aData )
 }
 
 
+static size_t hashAperture( const wxSize& aSize, int aRadius, double aRotDegree,
+                            APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
+    return hash_val( (int) aType, aSize.x, aSize.y, aRadius, aRotDegree, aApertureAttribute );
+}
+
+
+static size_t hashAperture( const std::vector<wxPoint>& aCorners, double aRotDegree,
+                            APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
+    size_t seed = hash_val( (int) aType, aRotDegree, aApertureAttribute );
+
+    for( const wxPoint& corner : aCorners )
+        hash_combine( seed, corner.x, corner.y );
+
+    return seed;
+}
+
+
 int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, double aRotDegree,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    size_t hash = hashAperture( aSize, aRadius, aRotDegree, aType, aApertureAttribute );
 
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
+    auto candidates = m_apertureIndex.equal_range( hash );
+
+    for( auto it = candidates.first; it != candidates.second; ++it )
     {
-        APERTURE* tool = &m_apertures[idx];
-        last_D_code = tool->m_DCode;
+        APERTURE* tool = &m_apertures[it->second];
 
         if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
             (tool->m_Radius == aRadius) && (tool->m_Rotation == aRotDegree) &&
             (tool->m_ApertureAttribute == aApertureAttribute) )
-            return idx;
+            return it->second;
     }
 
     // Allocate a new aperture
@@ -383,10 +405,11 @@ int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, doubl
     new_tool.m_Type  = aType;
     new_tool.m_Radius  = aRadius;
     new_tool.m_Rotation  = aRotDegree;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = m_apertures.empty() ? FIRST_DCODE_VALUE : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex.emplace( hash, m_apertures.size() - 1 );
 
     return m_apertures.size() - 1;
 }
@@ -395,35 +418,20 @@ int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize, int aRadius, doubl
 int GERBER_PLOTTER::GetOrCreateAperture( const std::vector<wxPoint>& aCorners, double aRotDegree,
                          APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    size_t hash = hashAperture( aCorners, aRotDegree, aType, aApertureAttribute );
 
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
-    {
-        APERTURE* tool = &m_apertures[idx];
+    auto candidates = m_apertureIndex.equal_range( hash );
 
-       last_D_code = tool->m_DCode;
+    for( auto it = candidates.first; it != candidates.second; ++it )
+    {
+        APERTURE* tool = &m_apertures[it->second];
 
         if( (tool->m_Type == aType) &&
-            (tool->m_Corners.size() == aCorners.size() ) &&
+            (tool->m_Corners == aCorners ) &&
             (tool->m_Rotation == aRotDegree) &&
             (tool->m_ApertureAttribute == aApertureAttribute) )
-        {
-            // A candidate is found. the corner lists must be the same
-            bool is_same = true;
-
-            for( size_t ii = 0; ii < aCorners.size(); ii++ )
-            {
-                if( aCorners[ii] != tool->m_Corners[ii] )
-                {
-                    is_same = false;
-                    break;
-                }
-            }
-
-            if( is_same )
-                return idx;
-        }
+            return it->second;
     }
 
     // Allocate a new aperture
@@ -434,10 +442,11 @@ int GERBER_PLOTTER::GetOrCreateAperture( const std::vector<wxPoint>& aCorners, d
     new_tool.m_Type     = aType;
     new_tool.m_Radius   = 0;             // Not used
     new_tool.m_Rotation = aRotDegree;
-    new_tool.m_DCode    = last_D_code + 1;
+    new_tool.m_DCode = m_apertures.empty() ? FIRST_DCODE_VALUE : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
+    m_apertureIndex.emplace( hash, m_apertures.size() - 1 );
 
     return m_apertures.size() - 1;
 }
@@ -524,6 +533,9 @@ void GERBER_PLOTTER::writeApertureList()
     if( !m_useX2format )
         useX1StructuredComment = true;
 
+    // The free polygon macros already written, by hash of their corners
+    std::unordered_multimap<size_t, const APERTURE*> freePolyMacros;
+
     // Init
     for( APERTURE& tool : m_apertures )
     {
@@ -686,25 +698,43 @@ void GERBER_PLOTTER::writeApertureList()
 
             case APERTURE::AM_FREE_POLYGON:
             {
-                // Write aperture header
-                fprintf( m_outputFile, "%%%s%d*\n", "AMFp", tool.m_DCode );
-                fprintf( m_outputFile, "4,1,%d,", (int)tool.m_Corners.size() );
+                // Apertures having the same corners (and another rotation or attribute)
+                // use the same macro
+                const APERTURE* macro = nullptr;
+                size_t          hash = hashAperture( tool.m_Corners, 0.0, tool.m_Type, 0 );
+                auto            candidates = freePolyMacros.equal_range( hash );
+
+                for( auto it = candidates.first; it != candidates.second && !macro; ++it )
+                {
+                    if( it->second->m_Corners == tool.m_Corners )
+                        macro = it->second;
+                }
 
-                for( size_t ii = 0; ii <= tool.m_Corners.size(); ii++ )
+                if( !macro )
                 {
-                    int jj = ii;
+                    macro = &tool;
+                    freePolyMacros.emplace( hash, macro );
+
+                    // Write aperture header
+                    fprintf( m_outputFile, "%%%s%d*\n", "AMFp", tool.m_DCode );
+                    fprintf( m_outputFile, "4,1,%d,", (int)tool.m_Corners.size() );
+
+                    for( size_t ii = 0; ii <= tool.m_Corners.size(); ii++ )
+                    {
+                        int jj = ii;
 
-                    if( ii >= tool.m_Corners.size() )
-                        jj = 0;
+                        if( ii >= tool.m_Corners.size() )
+                            jj = 0;
 
-                fprintf( m_outputFile, "%#f,%#f,",
-                         tool.m_Corners[jj].x * fscale, -tool.m_Corners[jj].y * fscale );
+                        fprintf( m_outputFile, "%#f,%#f,",
+                                 tool.m_Corners[jj].x * fscale, -tool.m_Corners[jj].y * fscale );
+                    }
+                    // output rotation parameter
+                    fputs( "$1*%\n", m_outputFile );
                 }
-                // output rotation parameter
-                fputs( "$1*%\n", m_outputFile );
 
                 // Create specialized macro
-                sprintf( cbuf, "%s%d,", "Fp", tool.m_DCode );
+                sprintf( cbuf, "%s%d,", "Fp", macro->m_DCode );
                 buffer += cbuf;
 
                 // close outline and output rotation
@@ -822,6 +852,37 @@ void GERBER_PLOTTER::plotArc( const wxPoint& aCenter, double aStAngle, double aE
 }
 
 
+bool GERBER_PLOTTER::formatRegionAttributes( GBR_METADATA* aData )
+{
+    if( aData )
+    {
+        std::string attrib = aData->m_ApertureMetadata.FormatAttribute( !m_useX2format );
+
+        if( !attrib.empty() )
+        {
+            fputs( attrib.c_str(), m_outputFile );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void GERBER_PLOTTER::clearRegionAttributes()
+{
+    // Clear the TA attribute, to avoid the next item to inherit it:
+    if( m_useX2format )
+    {
+        fputs( "%TD.AperFunction*%\n", m_outputFile );
+    }
+    else
+    {
+        fputs( "G04 #@! TD.AperFunction*\n", m_outputFile );
+    }
+}
+
+
 void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList,
                                  void * aData )
 {
@@ -830,35 +891,109 @@ void GERBER_PLOTTER::PlotGerberRegion( const std::vector< wxPoint >& aCornerList
 
     GBR_METADATA* gbr_metadata = static_cast<GBR_METADATA*>( aData );
 
-    bool clearTA_AperFunction = false;     // true if a TA.AperFunction is used
+    bool clearTA_AperFunction = formatRegionAttributes( gbr_metadata );
 
-    if( gbr_metadata )
-    {
-        std::string attrib = gbr_metadata->m_ApertureMetadata.FormatAttribute( !m_useX2format );
+    PlotPoly( aCornerList, FILL_TYPE::FILLED_SHAPE, 0, gbr_metadata );
 
-        if( !attrib.empty() )
-        {
-            fputs( attrib.c_str(), m_outputFile );
-            clearTA_AperFunction = true;
-        }
-    }
+    if( clearTA_AperFunction )
+        clearRegionAttributes();
+}
 
-    PlotPoly( aCornerList, FILL_TYPE::FILLED_SHAPE, 0, gbr_metadata );
 
-    // Clear the TA attribute, to avoid the next item to inherit it:
+void GERBER_PLOTTER::PlotGerberRegion( const SHAPE_LINE_CHAIN& aPoly, void * aData )
+{
+    if( aPoly.PointCount() <= 2 )
+        return;
+
+    GBR_METADATA* gbr_metadata = static_cast<GBR_METADATA*>( aData );
+
+    bool clearTA_AperFunction = formatRegionAttributes( gbr_metadata );
+
+    if( gbr_metadata )
+        formatNetAttribute( &gbr_metadata->m_NetlistMetadata );
+
+    fputs( "G36*\n", m_outputFile );
+    plotChainInRegion( aPoly );
+    fputs( "G37*\n", m_outputFile );
+
     if( clearTA_AperFunction )
+        clearRegionAttributes();
+}
+
+
+void GERBER_PLOTTER::plotChainInRegion( const SHAPE_LINE_CHAIN& aPoly )
+{
+    bool    ccw = aPoly.Area() > 0.0;
+    bool    started = false;
+    wxPoint first;
+
+    auto penTo =
+            [&]( const wxPoint& aPos )
+            {
+                if( started )
+                {
+                    LineTo( aPos );
+                }
+                else
+                {
+                    MoveTo( aPos );
+                    fputs( "G01*\n", m_outputFile );      // Set linear interpolation.
+                    first = aPos;
+                    started = true;
+                }
+            };
+
+    for( int ii = 0; ii < aPoly.PointCount(); ++ii )
     {
-        if( m_useX2format )
+        ssize_t arcIndex = aPoly.ArcIndex( ii );
+        int     last = ii;
+
+        if( aPoly.isArc( ii ) )
         {
-            fputs( "%TD.AperFunction*%\n", m_outputFile );
+            while( last + 1 < aPoly.PointCount() && aPoly.ArcIndex( last + 1 ) == arcIndex )
+                last++;
         }
+
+        penTo( (wxPoint) aPoly.CPoint( ii ) );
+
+        // The ends of the run stay where they are, and an arc needs at least 2 segments
+        // between them
+        if( last - ii < 4 )
+            continue;
+
+        SHAPE_ARC arc = aPoly.ArcInside( ii + 1, last - 1, ccw );
+        wxPoint   start( arc.GetP0() );
+
+        penTo( start );
+
+        // The direction is given by the half arc from the start to the mid point, in device
+        // coordinates (which can be mirrored)
+        DPOINT devCenter = userToDeviceCoordinates( (wxPoint) arc.GetCenter() );
+        DPOINT devStart = userToDeviceCoordinates( start ) - devCenter;
+        DPOINT devMid = userToDeviceCoordinates( (wxPoint) arc.GetArcMid() ) - devCenter;
+        DPOINT devEnd = userToDeviceCoordinates( (wxPoint) arc.GetP1() );
+
+        fprintf( m_outputFile, "G75*\n" );        // Multiquadrant (360 degrees) mode
+
+        if( devStart.x * devMid.y - devStart.y * devMid.x > 0 )
+            fprintf( m_outputFile, "G03*\n" );    // Active circular interpolation, CCW
         else
-        {
-            fputs( "G04 #@! TD.AperFunction*\n", m_outputFile );
-        }
+            fprintf( m_outputFile, "G02*\n" );    // Active circular interpolation, CW
+
+        fprintf( m_outputFile, "X%dY%dI%dJ%dD01*\n",
+                 KiROUND( devEnd.x ), KiROUND( devEnd.y ),
+                 KiROUND( -devStart.x ), KiROUND( -devStart.y ) );
+
+        fprintf( m_outputFile, "G01*\n" );        // Back to linear interpolation
+
+        ii = last - 1;
     }
+
+    if( started )
+        FinishTo( first );
 }
 
+
 void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
                                FILL_TYPE aFill, int aWidth, void * aData )
 {
@@ -1432,7 +1567,8 @@ void GERBER_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
                                      OUTLINE_MODE aTraceMode, void* aData )
 
 {
-    // A Pad custom is plotted as polygon (a region in Gerber language).
+    // A Pad custom is plotted as polygon (a region in Gerber language), or flashed
+    // using a free polygon aperture macro.
     GBR_METADATA gbr_metadata;
 
     if( aData )
@@ -1448,6 +1584,25 @@ void GERBER_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 
     std::vector< wxPoint > cornerList;
 
+    if( aTraceMode == FILLED && !m_gerberDisableApertMacros && polyshape.OutlineCount() == 1
+            && polyshape.HoleCount( 0 ) == 0 )
+    {
+        // The shape is given relative to the pad position, so the pads having the same
+        // shape share the same aperture
+        const SHAPE_LINE_CHAIN& poly = polyshape.COutline( 0 );
+
+        for( int ii = 0; ii < poly.PointCount(); ++ii )
+            cornerList.emplace_back( poly.CPoint( ii ).x - aPadPos.x,
+                                     poly.CPoint( ii ).y - aPadPos.y );
+
+        selectAperture( cornerList, 0.0, APERTURE::AM_FREE_POLYGON,
+                        gbr_metadata.GetApertureAttrib() );
+        formatNetAttribute( &gbr_metadata.m_NetlistMetadata );
+
+        emitDcode( userToDeviceCoordinates( aPadPos ), 3 );
+        return;
+    }
+
     for( int cnt = 0; cnt < polyshape.OutlineCount(); ++cnt )
     {
         SHAPE_LINE_CHAIN& poly = polyshape.Outline( cnt );
@@ -31,6 +31,9 @@
 #include <algorithm>
 #include <wx/zstream.h>
 #include <wx/mstream.h>
+#include <wx/wfstream.h>
+#include <chrono>
+#include <thread>
 #include <render_settings.h>
 #include <advanced_config.h>
 
@@ -491,24 +494,11 @@ int PDF_PLOTTER::startPdfStream( int handle )
 {
     wxASSERT( m_outputFile );
     wxASSERT( !workFile );
-    handle = startPdfObject( handle );
 
-    // This is guaranteed to be handle+1 but needs to be allocated since
-    // you could allocate more object during stream preparation
-    streamLengthHandle = allocPdfObject();
+    if( handle < 0 )
+        handle = allocPdfObject();
 
-    if( ADVANCED_CFG::GetCfg().m_DebugPDFWriter )
-    {
-        fprintf( m_outputFile,
-                 "<< /Length %d 0 R >>\n" // Length is deferred
-                 "stream\n", handle + 1 );
-    }
-    else
-    {
-        fprintf( m_outputFile,
-                 "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-                 "stream\n", handle + 1 );
-    }
+    streamLengthHandle = allocPdfObject();
 
     // Open a temporary file to accumulate the stream
     workFilename = wxFileName::CreateTempFileName( "" );
@@ -518,70 +508,124 @@ int PDF_PLOTTER::startPdfStream( int handle )
 }
 
 
+/**
+ * DEFLATE (or just read, if \a aLevel is negative) a stream accumulated in a temporary file,
+ * then junk the file.  The file is read by chunks, only the compressed stream is kept in
+ * memory.
+ */
+static std::string compressPdfStream( const wxString& aFilename, int aLevel )
+{
+    wxMemoryOutputStream memos;
+
+    {
+        wxFFileInputStream input( aFilename, wxT( "rb" ) );
+
+        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
+         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
+         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
+         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
+         *                    8, Z_DEFAULT_STRATEGY );
+         */
+        std::unique_ptr<wxZlibOutputStream> zos;
+
+        if( aLevel >= 0 )
+            zos = std::make_unique<wxZlibOutputStream>( memos, aLevel, wxZLIB_ZLIB );
+
+        wxOutputStream&   output = zos ? static_cast<wxOutputStream&>( *zos ) : memos;
+        std::vector<char> buffer( 65536 );
+
+        while( input.IsOk() && !input.Eof() )
+        {
+            input.Read( buffer.data(), buffer.size() );
+            output.Write( buffer.data(), input.LastRead() );
+        }
+    }   // flush the zip stream using zos destructor
+
+    ::wxRemoveFile( aFilename );
+
+    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+
+    return std::string( static_cast<const char*>( sb->GetBufferStart() ), sb->Tell() );
+}
+
+
 void PDF_PLOTTER::closePdfStream()
 {
     wxASSERT( workFile );
 
-    long stream_len = ftell( workFile );
-
-    if( stream_len < 0 )
+    if( ftell( workFile ) < 0 )
     {
         wxASSERT( false );
         return;
     }
 
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
-
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
-
-    // We are done with the temporary file, junk it
+    // We are done with the temporary file, it is compressed on a worker thread
     fclose( workFile );
     workFile = 0;
-    ::wxRemoveFile( workFilename );
 
-    unsigned out_count;
+    int level = m_compressionLevel >= 0 ? m_compressionLevel
+                                        : ADVANCED_CFG::GetCfg().m_PDFCompressionLevel;
 
     if( ADVANCED_CFG::GetCfg().m_DebugPDFWriter )
+        level = -1;
+
+    PDF_STREAM stream;
+    stream.m_Handle = pageStreamHandle;
+    stream.m_LengthHandle = streamLengthHandle;
+    stream.m_Data = std::async( std::launch::async, compressPdfStream, workFilename,
+                                std::min( level, 9 ) );
+
+    m_pendingStreams.push_back( std::move( stream ) );
+
+    writePdfStreams( false );
+}
+
+
+void PDF_PLOTTER::writePdfStreams( bool aWaitAll )
+{
+    wxASSERT( !workFile );
+
+    size_t maxPending = aWaitAll ? 0 : std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    while( !m_pendingStreams.empty() )
     {
-        out_count = stream_len;
-        fwrite( inbuf, out_count, 1, m_outputFile );
-    }
-    else
-    {
-        // NULL means memos owns the memory, but provide a hint on optimum size needed.
-        wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+        PDF_STREAM& stream = m_pendingStreams.front();
 
+        if( m_pendingStreams.size() <= maxPending
+                && stream.m_Data.wait_for( std::chrono::seconds( 0 ) )
+                        != std::future_status::ready )
         {
-            /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-             * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-             * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-             * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-             *                    8, Z_DEFAULT_STRATEGY );
-             */
+            break;
+        }
 
-            wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+        std::string data = stream.m_Data.get();
 
-            zos.Write( inbuf, stream_len );
-        }   // flush the zip stream using zos destructor
+        startPdfObject( stream.m_Handle );
 
-        wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+        if( ADVANCED_CFG::GetCfg().m_DebugPDFWriter )
+        {
+            fprintf( m_outputFile,
+                     "<< /Length %d 0 R >>\n" // Length is deferred
+                     "stream\n", stream.m_LengthHandle );
+        }
+        else
+        {
+            fprintf( m_outputFile,
+                     "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
+                     "stream\n", stream.m_LengthHandle );
+        }
 
-        out_count = sb->Tell();
-        fwrite( sb->GetBufferStart(), 1, out_count, m_outputFile );
-    }
+        fwrite( data.data(), 1, data.size(), m_outputFile );
+        fputs( "endstream\n", m_outputFile );
+        closePdfObject();
 
-    delete[] inbuf;
-    fputs( "endstream\n", m_outputFile );
-    closePdfObject();
+        // Writing the deferred length as an indirect object
+        startPdfObject( stream.m_LengthHandle );
+        fprintf( m_outputFile, "%u\n", (unsigned) data.size() );
+        closePdfObject();
 
-    // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( m_outputFile, "%u\n", out_count );
-    closePdfObject();
+        m_pendingStreams.pop_front();
+    }
 }
 
 
@@ -686,6 +730,9 @@ bool PDF_PLOTTER::EndPlot()
     // Close the current page (often the only one)
     ClosePage();
 
+    // And write the page streams still being compressed
+    writePdfStreams( true );
+
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
        is *very* involved! */
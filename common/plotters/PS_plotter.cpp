@@ -142,9 +142,8 @@ void PSLIKE_PLOTTER::FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
 void PSLIKE_PLOTTER::FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
                                    double aPadOrient, OUTLINE_MODE aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     wxSize size( aSize );
-    cornerList.clear();
 
     if( aTraceMode == FILLED )
         SetCurrentLineWidth( 0 );
@@ -261,8 +260,7 @@ void PSLIKE_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
                                      double aPadOrient, OUTLINE_MODE aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    std::vector< wxPoint > cornerList;
 
     for( int ii = 0; ii < 4; ii++ )
         cornerList.push_back( aCorners[ii] );
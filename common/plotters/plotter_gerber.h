@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 #include <math/box2.h>
 #include <eda_item.h>       // FILL_TYPE
@@ -182,6 +183,13 @@ public:
     void PlotGerberRegion( const std::vector< wxPoint >& aCornerList,
                            void * aData = NULL );
 
+    /**
+     * Plot a Gerber region from a closed line chain, like the above.  The arcs of the chain
+     * are plotted as circular interpolations, kept inside the chain (see
+     * SHAPE_LINE_CHAIN::ArcInside()).
+     */
+    void PlotGerberRegion( const SHAPE_LINE_CHAIN& aPoly, void * aData = NULL );
+
     /**
      * Change the plot polarity and begin a new layer
      * Used to 'scratch off' silk screen away from solder mask
@@ -254,6 +262,11 @@ public:
     int GetOrCreateAperture( const std::vector<wxPoint>& aCorners, double aRotDegree,
                     APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
 
+    /**
+     * @return the count of apertures (D codes) created for the plot
+     */
+    int GetApertureCount() const { return (int) m_apertures.size(); }
+
 protected:
     /** Plot a round rect (a round rect shape in fact) as a Gerber region
      * using lines and arcs for corners
@@ -279,6 +292,19 @@ protected:
     void plotArc( const wxPoint& aCenter, double aStAngle, double aEndAngle,
                       int aRadius, bool aPlotInRegion );
 
+    /**
+     * Plot the arcs and lines of a closed line chain as the outline of a region (the G36 ... G37
+     * sequence is not created).
+     */
+    void plotChainInRegion( const SHAPE_LINE_CHAIN& aPoly );
+
+    /**
+     * Write the TA.AperFunction attribute of a region, if aData contains one.
+     * @return true if the attribute was written, and must be cleared by clearRegionAttributes().
+     */
+    bool formatRegionAttributes( GBR_METADATA* aData );
+    void clearRegionAttributes();
+
     /**
      * Pick an existing aperture or create a new one, matching the
      * size, type and attributes.
@@ -352,6 +378,10 @@ protected:
 
     std::vector<APERTURE> m_apertures;  // The list of available apertures
     int     m_currentApertureIdx;       // The index of the current aperture in m_apertures
+
+    // Indexes in m_apertures, by hash of the aperture parameters, to find quickly an existing
+    // aperture: one is searched for each flashed pad
+    std::unordered_multimap<size_t, int> m_apertureIndex;
     bool    m_hasApertureRoundRect;     // true is at least one round rect aperture is in use
     bool    m_hasApertureRotOval;       // true is at least one oval rotated aperture is in use
     bool    m_hasApertureRotRect;       // true is at least one rect. rotated aperture is in use
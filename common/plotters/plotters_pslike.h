@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <deque>
+#include <future>
+#include <string>
 #include <vector>
 #include <math/box2.h>
 #include <eda_item.h>       // FILL_TYPE
@@ -201,7 +204,8 @@ public:
             fontResDictHandle( 0 ),
             pageStreamHandle( 0 ),
             streamLengthHandle( 0 ),
-            workFile( nullptr )
+            workFile( nullptr ),
+            m_compressionLevel( -1 )
     {
     }
 
@@ -215,6 +219,12 @@ public:
         return wxString( wxT( "pdf" ) );
     }
 
+    /**
+     * Set the zlib compression level of the page streams, from 0 (none, fastest) to 9 (best,
+     * slowest).  The default is given by the advanced config.
+     */
+    void SetCompressionLevel( int aLevel ) { m_compressionLevel = aLevel; }
+
     /**
      * Open or create the plot file aFullFilename
      *
@@ -348,18 +358,36 @@ protected:
     void closePdfObject();
 
     /**
-     * Starts a PDF stream (for the page). Returns the object handle opened
+     * Starts a PDF stream (for the page). Returns the object handle allocated
      * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
      * can contain a lot of things, but for the moment we only handle page
      * content.
+     * The stream is built in a temporary file, the object is written when the stream
+     * is compressed.
      */
     int startPdfStream(int handle = -1);
 
     /**
-     * Finish the current PDF stream (writes the deferred length, too)
+     * Finish the current PDF stream.  It is compressed on a worker thread, and written
+     * (with its deferred length) by writePdfStreams().
      */
     void closePdfStream();
 
+    /**
+     * Write the compressed streams, in the order they were closed.
+     * @param aWaitAll = true to wait for all the streams, false to write the ones already
+     * compressed and to wait only to keep the count of streams in memory bounded
+     */
+    void writePdfStreams( bool aWaitAll );
+
+    /// A stream being compressed
+    struct PDF_STREAM
+    {
+        int                      m_Handle;       ///< Handle of the stream object
+        int                      m_LengthHandle; ///< Handle of the deferred stream length
+        std::future<std::string> m_Data;         ///< The compressed stream
+    };
+
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
@@ -368,6 +396,8 @@ protected:
     wxString workFilename;
     FILE* workFile;  	         /// Temporary file to construct the stream before zipping
     std::vector<long> xrefTable; /// The PDF xref offset table
+    std::deque<PDF_STREAM> m_pendingStreams; /// Streams closed but not yet written
+    int   m_compressionLevel;    /// zlib compression level, -1 to use the advanced config
 };
 
 
@@ -23,6 +23,7 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
@@ -195,6 +196,24 @@ FILE_LINE_READER::~FILE_LINE_READER()
 }
 
 
+long int FILE_LINE_READER::FileLength()
+{
+    long int pos = ftell( m_fp );
+
+    fseek( m_fp, 0, SEEK_END );
+    long int length = ftell( m_fp );
+    fseek( m_fp, pos, SEEK_SET );
+
+    return length;
+}
+
+
+long int FILE_LINE_READER::CurPos()
+{
+    return ftell( m_fp );
+}
+
+
 char* FILE_LINE_READER::ReadLine()
 {
     m_length = 0;
@@ -413,15 +432,18 @@ int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... )
 
     va_start( args, fmt );
 
+    static const char spaces[] = "                                ";
+
     int result = 0;
     int total  = 0;
 
-    for( int i=0; i<nestLevel;  ++i )
+    // Write the indentation by chunks instead of formatting it space by space
+    for( int indent = nestLevel * NESTWIDTH; total < indent; total += result )
     {
-        // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+        result = std::min<int>( indent - total, sizeof( spaces ) - 1 );
 
-        total += result;
+        // no error checking needed, an exception indicates an error.
+        write( spaces, result );
     }
 
     // no error checking needed, an exception indicates an error.
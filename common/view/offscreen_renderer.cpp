@@ -0,0 +1,232 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <view/offscreen_renderer.h>
+
+#include <gal/cairo/cairo_image.h>
+#include <macros.h>
+#include <painter.h>
+#include <view/view.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace KIGFX;
+
+
+OFFSCREEN_RENDERER::OFFSCREEN_RENDERER( const VIEW& aView, const PAINTER& aPainter ) :
+        m_view( aView ),
+        m_painter( aPainter ),
+        m_width( 0 ),
+        m_height( 0 ),
+        m_tileSize( 512 ),
+        m_threadCount( 0 ),
+        m_image( nullptr )
+{
+}
+
+
+OFFSCREEN_RENDERER::~OFFSCREEN_RENDERER()
+{
+    if( m_image )
+        cairo_surface_destroy( m_image );
+}
+
+
+std::unique_ptr<VIEW> OFFSCREEN_RENDERER::makeView( GAL* aGal, PAINTER* aPainter ) const
+{
+    std::unique_ptr<VIEW> view = m_view.DataReference();
+
+    if( m_view.GetGAL() )
+        aGal->SetWorldUnitLength( m_view.GetGAL()->GetWorldUnitLength() );
+
+    view->SetGAL( aGal );
+    view->SetPainter( aPainter );
+    view->SetScaleLimits( 10e9, 0.0001 );
+    view->SetMirror( m_view.IsMirroredX(), false );
+    view->SetPrintMode( 1 );
+
+    for( int layer = 0; layer < VIEW::VIEW_MAX_LAYERS; ++layer )
+    {
+        view->SetLayerTarget( layer, TARGET_NONCACHED );
+
+        if( !m_layers.empty() )
+            view->SetLayerVisible( layer, false );
+    }
+
+    for( size_t ii = 0; ii < m_layers.size(); ++ii )
+    {
+        view->SetLayerVisible( m_layers[ii], true );
+        view->SetLayerOrder( m_layers[ii], (int) ii );
+    }
+
+    return view;
+}
+
+
+bool OFFSCREEN_RENDERER::Render()
+{
+    if( m_image )
+    {
+        cairo_surface_destroy( m_image );
+        m_image = nullptr;
+    }
+
+    wxCHECK( m_width > 0 && m_height > 0 && m_tileSize > 0, false );
+    wxCHECK( m_viewport.GetWidth() > 0 && m_viewport.GetHeight() > 0, false );
+
+    // The image is laid out on a GAL that draws nothing
+    GAL                      layoutGal( m_options );
+    std::unique_ptr<PAINTER> layoutPainter( m_painter.Clone( &layoutGal ) );
+
+    if( !layoutPainter )
+        return false;
+
+    layoutGal.SetScreenSize( VECTOR2I( m_width, m_height ) );
+
+    std::unique_ptr<VIEW> layoutView = makeView( &layoutGal, layoutPainter.get() );
+    layoutView->SetViewport( m_viewport );
+
+    std::vector<VECTOR2I> tileOrigins;
+    std::vector<VECTOR2D> tileCenters;
+
+    for( int y = 0; y < m_height; y += m_tileSize )
+    {
+        for( int x = 0; x < m_width; x += m_tileSize )
+        {
+            VECTOR2D center( x + m_tileSize / 2.0, y + m_tileSize / 2.0 );
+
+            tileOrigins.emplace_back( x, y );
+            tileCenters.push_back( layoutView->ToWorld( center ) );
+        }
+    }
+
+    size_t threadCount = m_threadCount > 0 ? m_threadCount : std::thread::hardware_concurrency();
+    threadCount = std::max<size_t>( std::min( threadCount, tileOrigins.size() ), 1 );
+
+    // Painters may fill lazy caches of the items they draw (pad shapes, etc.), and an item can
+    // span several tiles.  Run the painter once over the whole image on this thread first, so
+    // that the tiles only read the items.
+    if( threadCount > 1 )
+    {
+        GAL_DRAWING_CONTEXT ctx( &layoutGal );
+        layoutView->Redraw();
+    }
+
+    m_image = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, m_width, m_height );
+
+    if( cairo_surface_status( m_image ) != CAIRO_STATUS_SUCCESS )
+    {
+        cairo_surface_destroy( m_image );
+        m_image = nullptr;
+        return false;
+    }
+
+    // GALs subscribe to the display options, so they are created and destroyed on this thread
+    std::vector<std::unique_ptr<CAIRO_IMAGE_GAL>> gals;
+    std::vector<std::unique_ptr<PAINTER>>         painters;
+    std::vector<std::unique_ptr<VIEW>>            views;
+
+    try
+    {
+        for( size_t ii = 0; ii < threadCount; ++ii )
+        {
+            gals.push_back( std::make_unique<CAIRO_IMAGE_GAL>( m_options, m_tileSize,
+                                                                m_tileSize ) );
+            painters.emplace_back( m_painter.Clone( gals.back().get() ) );
+            views.push_back( makeView( gals.back().get(), painters.back().get() ) );
+
+            // Same scale as the layout, so tiles line up on pixels
+            views.back()->SetScale( layoutView->GetScale() );
+
+            if( RENDER_SETTINGS* settings = painters.back()->GetSettings() )
+                gals.back()->SetClearColor( settings->GetBackgroundColor() );
+        }
+    }
+    catch( const std::runtime_error& )
+    {
+        cairo_surface_destroy( m_image );
+        m_image = nullptr;
+        return false;
+    }
+
+    cairo_t*            imageCtx = cairo_create( m_image );
+    std::mutex          imageLock;
+    std::atomic<size_t> nextTile( 0 );
+
+    auto renderTiles =
+            [&]( size_t aThread )
+            {
+                CAIRO_IMAGE_GAL* gal = gals[aThread].get();
+                VIEW*            view = views[aThread].get();
+
+                for( size_t tile = nextTile++; tile < tileOrigins.size(); tile = nextTile++ )
+                {
+                    view->SetCenter( tileCenters[tile] );
+
+                    {
+                        GAL_DRAWING_CONTEXT ctx( gal );
+                        view->Redraw();
+                    }
+
+                    cairo_surface_flush( gal->GetSurface() );
+
+                    std::lock_guard<std::mutex> lock( imageLock );
+
+                    cairo_set_source_surface( imageCtx, gal->GetSurface(), tileOrigins[tile].x,
+                                              tileOrigins[tile].y );
+                    cairo_paint( imageCtx );
+                }
+            };
+
+    if( threadCount > 1 )
+    {
+        std::vector<std::thread> threads;
+
+        for( size_t ii = 0; ii < threadCount; ++ii )
+            threads.emplace_back( renderTiles, ii );
+
+        for( std::thread& thread : threads )
+            thread.join();
+    }
+    else
+    {
+        renderTiles( 0 );
+    }
+
+    cairo_destroy( imageCtx );
+    cairo_surface_flush( m_image );
+
+    return true;
+}
+
+
+bool OFFSCREEN_RENDERER::SaveImage( const wxString& aFileName ) const
+{
+    wxCHECK( m_image, false );
+
+    return cairo_surface_write_to_png( m_image, TO_UTF8( aFileName ) ) == CAIRO_STATUS_SUCCESS;
+}
@@ -23,6 +23,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <numeric>
+#include <thread>
 
 #include <eda_item.h>
 #include <layers_id_colors_and_visibility.h>
@@ -34,6 +37,7 @@
 #include <view/view_overlay.h>
 
 #include <gal/definitions.h>
+#include <gal/gal_recorder.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
@@ -53,6 +57,7 @@ public:
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
+        m_dirtyIndex( -1 ),
         m_groups( nullptr ),
         m_groupsSize( 0 ) {}
 
@@ -90,6 +95,7 @@ private:
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
+    int     m_dirtyIndex;       ///< Index in VIEW::m_dirtyItems of m_view, or -1 if not there
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -334,6 +340,12 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     if( !aItem->m_viewPrivData )
         aItem->m_viewPrivData = new VIEW_ITEM_DATA;
 
+    // Flags left from another view would keep the item off our update list
+    aItem->m_viewPrivData->clearUpdateFlags();
+
+    if( aItem->m_viewPrivData->m_view != this )
+        aItem->m_viewPrivData->m_dirtyIndex = -1;
+
     aItem->m_viewPrivData->m_view = this;
     aItem->m_viewPrivData->m_drawPriority = aDrawPriority;
 
@@ -368,11 +380,22 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     auto item = std::find( m_allItems->begin(), m_allItems->end(), aItem );
 
     if( item != m_allItems->end() )
-    {
         m_allItems->erase( item );
-        viewData->clearUpdateFlags();
+
+    if( viewData->m_dirtyIndex >= 0 )
+    {
+        // Swap with the last dirty item, so that removing many items stays linear
+        VIEW_ITEM* last = m_dirtyItems.back();
+
+        m_dirtyItems[viewData->m_dirtyIndex] = last;
+        last->viewPrivData()->m_dirtyIndex = viewData->m_dirtyIndex;
+        m_dirtyItems.pop_back();
+
+        viewData->m_dirtyIndex = -1;
     }
 
+    viewData->clearUpdateFlags();
+
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
 
@@ -720,7 +743,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
 
         viewData->reorderGroups( aReorderMap );
 
-        viewData->m_requiredUpdate |= COLOR;
+        markForUpdate( item, COLOR );
     }
 
     UpdateItems();
@@ -1092,6 +1115,14 @@ void VIEW::Clear()
     r.SetMaximum();
     m_allItems->clear();
 
+    for( VIEW_ITEM* item : m_dirtyItems )
+    {
+        item->viewPrivData()->clearUpdateFlags();
+        item->viewPrivData()->m_dirtyIndex = -1;
+    }
+
+    m_dirtyItems.clear();
+
     for( VIEW_LAYER& layer : m_layers )
         layer.items->RemoveAll();
 
@@ -1188,7 +1219,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<std::pair<int, VIEW_ITEM*>>& aGeometryUpdates )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1212,7 +1244,7 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
-    // Iterate through layers used by the item and recache it immediately
+    // Iterate through layers used by the item and queue it for recaching
     for( int i = 0; i < layers_count; ++i )
     {
         int layerId = layers[i];
@@ -1220,7 +1252,7 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         if( IsCached( layerId ) )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
-                updateItemGeometry( aItem, layerId );
+                aGeometryUpdates.emplace_back( layerId, aItem );
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
         }
@@ -1267,7 +1299,83 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 }
 
 
-void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
+/// Below this number of groups to rebuild per thread, painting them on worker threads
+/// costs more than it saves
+static const size_t PARALLEL_RECACHE_MIN_ITEMS = 500;
+
+
+void VIEW::recordItemGeometry( const std::vector<std::pair<int, VIEW_ITEM*>>& aGeometryUpdates,
+                               std::vector<GAL_RECORDER::RECORDING>& aRecordings )
+{
+    size_t threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                           aGeometryUpdates.size() / PARALLEL_RECACHE_MIN_ITEMS );
+
+    if( threadCount < 2 )
+        return;
+
+    // Each item is drawn by a single thread, as painters may fill caches of the items they draw
+    std::vector<size_t> itemStarts;
+
+    for( size_t ii = 0; ii < aGeometryUpdates.size(); ++ii )
+    {
+        if( ii == 0 || aGeometryUpdates[ii].second != aGeometryUpdates[ii - 1].second )
+            itemStarts.push_back( ii );
+    }
+
+    itemStarts.push_back( aGeometryUpdates.size() );
+
+    // Recorders subscribe to display options, so they are set up on this thread
+    std::vector<std::unique_ptr<GAL_RECORDER>> recorders;
+    std::vector<std::unique_ptr<PAINTER>>      painters;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+    {
+        recorders.push_back( std::make_unique<GAL_RECORDER>( *m_gal ) );
+        painters.emplace_back( m_painter->Clone( recorders.back().get() ) );
+
+        if( !painters.back() )
+            return;
+    }
+
+    aRecordings.resize( aGeometryUpdates.size() );
+
+    std::atomic<size_t>      nextItem( 0 );
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+    {
+        GAL_RECORDER* recorder = recorders[ii].get();
+        PAINTER*      painter = painters[ii].get();
+
+        threads.emplace_back(
+                [&, recorder, painter]()
+                {
+                    for( size_t item = nextItem++; item + 1 < itemStarts.size(); item = nextItem++ )
+                    {
+                        for( size_t jj = itemStarts[item]; jj < itemStarts[item + 1]; ++jj )
+                        {
+                            int layer = aGeometryUpdates[jj].first;
+
+                            recorder->SetLayerDepth( m_layers.at( layer ).renderingOrder );
+                            recorder->StartRecording();
+
+                            // Items the painter doesn't know are drawn later, by the view
+                            if( painter->Draw( aGeometryUpdates[jj].second, layer ) )
+                                aRecordings[jj] = recorder->FinishRecording();
+                            else
+                                recorder->FinishRecording();
+                        }
+                    }
+                } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+}
+
+
+void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer,
+                               const GAL_RECORDER::RECORDING* aRecording )
 {
     auto viewData = aItem->viewPrivData();
     wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
@@ -1276,11 +1384,6 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     if( !viewData )
         return;
 
-    VIEW_LAYER& l = m_layers.at( aLayer );
-
-    m_gal->SetTarget( l.target );
-    m_gal->SetLayerDepth( l.renderingOrder );
-
     // Redraw the item from scratch
     int group = viewData->getGroup( aLayer );
 
@@ -1290,7 +1393,9 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     group = m_gal->BeginGroup();
     viewData->setGroup( aLayer, group );
 
-    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+    if( aRecording )
+        GAL_RECORDER::Replay( *aRecording, *m_gal );
+    else if( !m_painter->Draw( aItem, aLayer ) )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
     m_gal->EndGroup();
@@ -1393,23 +1498,64 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
-    if( m_gal->IsVisible() )
+    if( !m_gal->IsVisible() || m_dirtyItems.empty() )
+        return;
+
+    GAL_UPDATE_CONTEXT ctx( m_gal );
+
+    // Items marked while we are updating are left for the next call
+    std::vector<VIEW_ITEM*> dirtyItems;
+    dirtyItems.swap( m_dirtyItems );
+
+    for( VIEW_ITEM* item : dirtyItems )
+        item->viewPrivData()->m_dirtyIndex = -1;
+
+    std::vector<std::pair<int, VIEW_ITEM*>> geometryUpdates;
+
+    for( VIEW_ITEM* item : dirtyItems )
     {
-        GAL_UPDATE_CONTEXT ctx( m_gal );
+        auto viewData = item->viewPrivData();
 
-        for( VIEW_ITEM* item : *m_allItems )
+        if( !viewData || viewData->m_requiredUpdate == NONE )
+            continue;
+
+        invalidateItem( item, viewData->m_requiredUpdate, geometryUpdates );
+    }
+
+    // Painting large batches is shared between threads; the results are committed below
+    std::vector<GAL_RECORDER::RECORDING> recordings;
+    recordItemGeometry( geometryUpdates, recordings );
+
+    // Rebuild the cached groups layer by layer, so the target and depth are set only once
+    std::vector<size_t> order( geometryUpdates.size() );
+    std::iota( order.begin(), order.end(), 0 );
+
+    std::stable_sort( order.begin(), order.end(),
+                      [&]( size_t a, size_t b )
+                      {
+                          return geometryUpdates[a].first < geometryUpdates[b].first;
+                      } );
+
+    int currentLayer = -1;
+
+    for( size_t ii : order )
+    {
+        const std::pair<int, VIEW_ITEM*>& update = geometryUpdates[ii];
+
+        if( update.first != currentLayer )
         {
-            auto viewData = item->viewPrivData();
+            currentLayer = update.first;
 
-            if( !viewData )
-                continue;
+            const VIEW_LAYER& l = m_layers.at( currentLayer );
 
-            if( viewData->m_requiredUpdate != NONE )
-            {
-                invalidateItem( item, viewData->m_requiredUpdate );
-                viewData->m_requiredUpdate = NONE;
-            }
+            m_gal->SetTarget( l.target );
+            m_gal->SetLayerDepth( l.renderingOrder );
         }
+
+        if( !recordings.empty() && !recordings[ii].empty() )
+            updateItemGeometry( update.second, update.first, &recordings[ii] );
+        else
+            updateItemGeometry( update.second, update.first );
     }
 }
 
@@ -1418,12 +1564,8 @@ void VIEW::UpdateAllItems( int aUpdateFlags )
 {
     for( VIEW_ITEM* item : *m_allItems )
     {
-        auto viewData = item->viewPrivData();
-
-        if( !viewData )
-            continue;
-
-        viewData->m_requiredUpdate |= aUpdateFlags;
+        if( item->viewPrivData() )
+            markForUpdate( item, aUpdateFlags );
     }
 }
 
@@ -1433,15 +1575,8 @@ void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
 {
     for( VIEW_ITEM* item : *m_allItems )
     {
-        if( aCondition( item ) )
-        {
-            auto viewData = item->viewPrivData();
-
-            if( !viewData )
-                continue;
-
-            viewData->m_requiredUpdate |= aUpdateFlags;
-        }
+        if( aCondition( item ) && item->viewPrivData() )
+            markForUpdate( item, aUpdateFlags );
     }
 }
 
@@ -1512,13 +1647,29 @@ void VIEW::Update( const VIEW_ITEM* aItem ) const
 
 void VIEW::Update( const VIEW_ITEM* aItem, int aUpdateFlags ) const
 {
-    VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
-
-    if( !viewData )
+    if( !aItem->viewPrivData() )
         return;
 
     assert( aUpdateFlags != NONE );
 
+    markForUpdate( aItem, aUpdateFlags );
+}
+
+
+void VIEW::markForUpdate( const VIEW_ITEM* aItem, int aUpdateFlags ) const
+{
+    VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
+
+    // The item goes on the list of the view it belongs to, which isn't necessarily this one
+    // (see DataReference()).
+    if( viewData->m_dirtyIndex < 0 && viewData->m_view )
+    {
+        std::vector<VIEW_ITEM*>& dirtyItems = viewData->m_view->m_dirtyItems;
+
+        viewData->m_dirtyIndex = dirtyItems.size();
+        dirtyItems.push_back( const_cast<VIEW_ITEM*>( aItem ) );
+    }
+
     viewData->m_requiredUpdate |= aUpdateFlags;
 }
 
@@ -132,25 +132,27 @@ EESCHEMA_SETTINGS* eeconfig()
  */
 static LIB_PART* dummy()
 {
-    static LIB_PART* part;
+    // Built on first use; the initialization of a local static is thread-safe
+    static LIB_PART* part =
+            []()
+            {
+                LIB_PART* part = new LIB_PART( wxEmptyString );
 
-    if( !part )
-    {
-        part = new LIB_PART( wxEmptyString );
+                LIB_RECTANGLE* square = new LIB_RECTANGLE( part );
 
-        LIB_RECTANGLE* square = new LIB_RECTANGLE( part );
+                square->MoveTo( wxPoint( Mils2iu( -200 ), Mils2iu( 200 ) ) );
+                square->SetEndPosition( wxPoint( Mils2iu( 200 ), Mils2iu( -200 ) ) );
 
-        square->MoveTo( wxPoint( Mils2iu( -200 ), Mils2iu( 200 ) ) );
-        square->SetEndPosition( wxPoint( Mils2iu( 200 ), Mils2iu( -200 ) ) );
+                LIB_TEXT* text = new LIB_TEXT( part );
 
-        LIB_TEXT* text = new LIB_TEXT( part );
+                text->SetTextSize( wxSize( Mils2iu( 150 ), Mils2iu( 150 ) ) );
+                text->SetText( wxString( wxT( "??" ) ) );
 
-        text->SetTextSize( wxSize( Mils2iu( 150 ), Mils2iu( 150 ) ) );
-        text->SetText( wxString( wxT( "??" ) ) );
+                part->AddDrawItem( square );
+                part->AddDrawItem( text );
 
-        part->AddDrawItem( square );
-        part->AddDrawItem( text );
-    }
+                return part;
+            }();
 
     return part;
 }
@@ -162,6 +164,15 @@ SCH_PAINTER::SCH_PAINTER( GAL* aGal ) :
 { }
 
 
+PAINTER* SCH_PAINTER::Clone( GAL* aGal ) const
+{
+    SCH_PAINTER* painter = new SCH_PAINTER( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
 #define HANDLE_ITEM( type_id, type_name ) \
     case type_id: draw( (type_name *) item, aLayer ); break
 
@@ -1674,10 +1685,13 @@ void SCH_PAINTER::draw( SCH_SHEET *aSheet, int aLayer )
             default: break;
             }
 
-            sheetPin->SetTextPos( offset_pos );
+            // Offset the drawing rather than the pin, as other painters may be drawing the
+            // same sheet (see Clone())
+            m_gal->Save();
+            m_gal->Translate( offset_pos - initial_pos );
             draw( static_cast<SCH_HIERLABEL*>( sheetPin ), aLayer );
+            m_gal->Restore();
             m_gal->DrawLine( offset_pos, initial_pos );
-            sheetPin->SetTextPos( initial_pos );
         }
     }
 
@@ -138,6 +138,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM*, int ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
     /// @copydoc PAINTER::ApplySettings()
     virtual void ApplySettings( const RENDER_SETTINGS* aSettings ) override
     {
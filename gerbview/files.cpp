@@ -22,8 +22,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <memory>
+#include <vector>
+
 #include <wx/wfstream.h>
 #include <wx/zipstrm.h>
+#include <core/parallel_for.h>
+#include <locale_io.h>
 #include <reporter.h>
 #include <dialogs/html_messagebox.h>
 #include <gerbview_frame.h>
@@ -195,6 +200,47 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
 }
 
 
+/**
+ * Read Gerber files on several threads.
+ *
+ * @param aFiles is the list of the files to read; the empty names are skipped.
+ * @param aProgress is refreshed while the files are read, if not null.
+ * @return the images of the files, in the same order, or nullptr for the files that could
+ *         not be read.
+ */
+static std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> loadGerberImages(
+        const std::vector<wxString>& aFiles, WX_PROGRESS_REPORTER* aProgress )
+{
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images( aFiles.size() );
+
+    // Switching the locale is not thread safe: it is switched here once for all the files,
+    // the LOCALE_IO of each file is then nested in this one and does nothing
+    LOCALE_IO toggleIo;
+
+    ParallelFor( aFiles.size(),
+            [&]( size_t aFileId )
+            {
+                if( aFiles[aFileId].IsEmpty() )
+                    return;
+
+                // The layer is set when the image is added to the layers
+                std::unique_ptr<GERBER_FILE_IMAGE> image =
+                        std::make_unique<GERBER_FILE_IMAGE>( 0 );
+
+                if( image->LoadGerberFile( aFiles[aFileId] ) )
+                    images[aFileId] = std::move( image );
+            },
+            0,
+            [&]()
+            {
+                if( aProgress )
+                    aProgress->KeepRefreshing();
+            } );
+
+    return images;
+}
+
+
 bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
                                             const wxArrayString& aFilenameList,
                                             const std::vector<int>* aFileType )
@@ -213,6 +259,35 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
     // Create progress dialog (only used if more than 1 file to load
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
 
+    if( aFilenameList.GetCount() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 1, false );
+        progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
+        progress->Report( _( "Loading Gerber files..." ) );
+    }
+
+    // Read the Gerber files on several threads first; the loop below adds them to the layers.
+    // The drill files are read by the loop.
+    std::vector<wxString> gerberFiles( aFilenameList.GetCount() );
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        filename = aFilenameList[ii];
+
+        if( !filename.IsAbsolute() )
+            filename.SetPath( aPath );
+
+        if( ( !aFileType || (*aFileType)[ii] != 1 ) && filename.FileExists()
+                && filename.GetExt() != GerberJobFileExtension.c_str() )
+        {
+            gerberFiles[ii] = filename.GetFullPath();
+        }
+    }
+
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> gerberImages =
+            loadGerberImages( gerberFiles, progress.get() );
+
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
         filename = aFilenameList[ii];
@@ -234,15 +309,7 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
 
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
+        if( progress )
         {
             progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
                                             aFilenameList.GetCount(), m_lastFileName ) );
@@ -270,7 +337,7 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
                 success = false;
                 reporter.Report( txt, RPT_SEVERITY_ERROR );
             }
-            else if( Read_GERBER_File( filename.GetFullPath() ) )
+            else if( Read_GERBER_File( filename.GetFullPath(), gerberImages[ii].release() ) )
             {
                 UpdateFileHistory( m_lastFileName );
 
@@ -37,8 +37,19 @@
 
 #include <wx/msgdlg.h>
 
+// The net attributes of the items created without attributes
+static const std::shared_ptr<const GBR_NETLIST_METADATA>& noNetAttributes()
+{
+    static const std::shared_ptr<const GBR_NETLIST_METADATA> noAttributes =
+            std::make_shared<GBR_NETLIST_METADATA>();
+
+    return noAttributes;
+}
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
-    EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
+    EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T ),
+    m_netAttributes( noNetAttributes() )
 {
     m_GerberImageFile = aGerberImageFile;
     m_Shape         = GBR_SEGMENT;
@@ -62,19 +73,6 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 }
 
 
-void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
-{
-    m_netAttributes = aNetAttributes;
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
-}
-
-
 int GERBER_DRAW_ITEM::GetLayer() const
 {
     // returns the layer this item is on, or 0 if the m_GerberImageFile is NULL.
@@ -715,41 +713,41 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_
     aList.emplace_back( _( "AB axis" ), msg, DARKRED );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( m_netAttributes->m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( m_netAttributes->m_Netname.IsEmpty() )
             net_msg << "<no net>";
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( m_netAttributes->m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
-        if( m_netAttributes.m_PadPinFunction.IsEmpty() )
+        if( m_netAttributes->m_PadPinFunction.IsEmpty() )
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue() );
         else
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s  Fct %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue(),
-                                m_netAttributes.m_PadPinFunction.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue(),
+                                m_netAttributes->m_PadPinFunction.GetValue() );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << m_netAttributes->m_Cmpref;
     }
 
     aList.emplace_back( net_msg, cmp_pad_msg, DARKCYAN );
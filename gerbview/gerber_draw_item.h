@@ -36,6 +36,8 @@
 #include <dcode.h>
 #include <geometry/shape_poly_set.h>
 
+#include <memory>
+
 class GERBER_FILE_IMAGE;
 class GBR_LAYOUT;
 class D_CODE;
@@ -113,16 +115,22 @@ private:
     wxRealPoint m_drawScale;                // A and B scaling factor
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_netAttributes;
+                                            ///< the string given by a %TO attribute set in aperture
                                             ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+                                            ///< a dynamic object attribute, but shared by all the
+                                            ///< items created with the same attributes
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
     ~GERBER_DRAW_ITEM();
 
-    void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    void SetNetAttributes( const std::shared_ptr<const GBR_NETLIST_METADATA>& aNetAttributes )
+    {
+        m_netAttributes = aNetAttributes;
+    }
+
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return *m_netAttributes; }
 
     /**
      * Function GetLayer
@@ -396,12 +396,31 @@ void GERBER_FILE_IMAGE::RemoveAttribute( X2_ATTRIBUTE& aAttribute )
      */
     wxString cmd = aAttribute.GetPrm( 0 );
     m_NetAttributeDict.ClearAttribute( &cmd );
+    m_currentNetAttributes.reset();
 
     if( cmd.IsEmpty() || cmd == ".AperFunction" )
         m_AperFunction.Clear();
 }
 
 
+const std::shared_ptr<const GBR_NETLIST_METADATA>& GERBER_FILE_IMAGE::GetCurrentNetAttributes()
+{
+    if( m_currentNetAttributes )
+        return m_currentNetAttributes;
+
+    m_currentNetAttributes = std::make_shared<GBR_NETLIST_METADATA>( m_NetAttributeDict );
+
+    if( ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+        ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+        m_ComponentsList.insert( std::make_pair( m_NetAttributeDict.m_Cmpref, 0 ) );
+
+    if( ( m_NetAttributeDict.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+        m_NetnamesList.insert( std::make_pair( m_NetAttributeDict.m_Netname, 0 ) );
+
+    return m_currentNetAttributes;
+}
+
+
 SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
 {
     KICAD_T        stype;
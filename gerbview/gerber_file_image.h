@@ -25,6 +25,7 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -191,6 +192,9 @@ private:
                                                                 // -1 = negative items are
                                                                 // 0 = no negative items found
                                                                 // 1 = have negative items found
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_currentNetAttributes; // a copy of m_NetAttributeDict
+                                                                // shared by the items, created when
+                                                                // needed after a change
     /**
      * test for an end of line
      * if a end of line is found:
@@ -424,6 +428,14 @@ public:
      */
     void RemoveAttribute( X2_ATTRIBUTE& aAttribute );
 
+    /**
+     * Return the current net attributes (m_NetAttributeDict), to be given to the new items.
+     * They are copied once and shared by the items created until they are changed by a
+     * %TO or a %TD command; the component and net names are added to m_ComponentsList and
+     * m_NetnamesList at the same time.
+     */
+    const std::shared_ptr<const GBR_NETLIST_METADATA>& GetCurrentNetAttributes();
+
     ///> @copydoc EDA_ITEM::Visit()
     SEARCH_RESULT Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] ) override;
 
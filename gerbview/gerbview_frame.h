@@ -468,7 +468,16 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * Read a Gerber file in the active layer.
+     * @param GERBER_FullFileName is the file name with full path.
+     * @param aImage is the image of the file when it was already loaded, or nullptr to load
+     *               it; the frame takes ownership of the image.
+     * @return true if the file was read successfully.
+     */
+    bool Read_GERBER_File( const wxString& GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aImage = nullptr );
 
     /**
      * function LoadExcellonFiles
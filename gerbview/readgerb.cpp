@@ -37,7 +37,8 @@
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                      GERBER_FILE_IMAGE* aImage )
 {
     wxString msg;
 
@@ -50,11 +51,21 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    bool success = true;
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    if( aImage )
+    {
+        gerber = aImage;
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
+
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -111,8 +122,10 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
+
+// size of the read buffer of the file: the lines are read from memory, the file itself is
+// read by large blocks
+#define GERBER_FILE_BUFZ ( 1024 * 1024 )
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -129,8 +142,15 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     if( m_Current_File == 0 )
         return false;
 
+    setvbuf( m_Current_File, nullptr, _IOFBF, GERBER_FILE_BUFZ );
+
     m_FileName = aFullFileName;
 
+    // A large buffer to store one line.  It is not a static buffer, several files can be
+    // loaded at the same time (see GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles())
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*             lineBuffer = buffer.data();
+
     LOCALE_IO toggleIo;
 
     wxString msg;
@@ -110,7 +110,7 @@ void fillFlashedGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     aGbrItem->m_DCode = Dcode_index;
     aGbrItem->SetLayerPolarity( aLayerNegative );
     aGbrItem->m_Flashed = true;
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetCurrentNetAttributes() );
 
     switch( aAperture )
     {
@@ -169,7 +169,7 @@ void fillLineGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     aGbrItem->m_DCode = Dcode_index;
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetCurrentNetAttributes() );
 }
 
 
@@ -214,7 +214,7 @@ void fillArcGBRITEM(  GERBER_DRAW_ITEM* aGbrItem, int Dcode_index,
     aGbrItem->m_Flashed = false;
 
     if( aGbrItem->m_GerberImageFile )
-        aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+        aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetCurrentNetAttributes() );
 
     if( aMultiquadrant )
         center = aStart + aRelCenter;
@@ -337,7 +337,7 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -345,7 +345,7 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
                      aStart, aEnd, rel_center, wxSize(0, 0),
                      aClockwise, aMultiquadrant, aLayerNegative );
 
-    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->m_NetAttributeDict );
+    aGbrItem->SetNetAttributes( aGbrItem->m_GerberImageFile->GetCurrentNetAttributes() );
 
     wxPoint   center;
     center = dummyGbrItem.m_ArcCentre;
@@ -629,7 +629,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
 
                 if( gbritem->m_GerberImageFile )
                 {
-                    gbritem->SetNetAttributes( gbritem->m_GerberImageFile->m_NetAttributeDict );
+                    gbritem->SetNetAttributes( gbritem->m_GerberImageFile->GetCurrentNetAttributes() );
                     gbritem->m_AperFunction = gbritem->m_GerberImageFile->m_AperFunction;
                 }
             }
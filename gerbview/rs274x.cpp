@@ -425,6 +425,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
         X2_ATTRIBUTE dummy;
 
         dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        m_currentNetAttributes.reset();
 
         if( dummy.GetAttribute() == ".N" )
         {
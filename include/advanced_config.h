@@ -144,11 +144,22 @@ public:
      */
     bool m_DebugPDFWriter;
 
+    /**
+     * The zlib compression level of the PDF page streams, from 0 (none, fastest) to 9 (best,
+     * slowest).
+     */
+    int m_PDFCompressionLevel;
+
     /**
      * Skip bounding box calculation when loading footprints
      */
     bool m_SkipBoundingBoxOnFpLoad;
 
+    /**
+     * Write a binary snapshot next to each board file loaded, and load unchanged boards from it.
+     */
+    bool m_BoardSnapshots;
+
 private:
     ADVANCED_CFG();
 
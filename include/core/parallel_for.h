@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef INCLUDE_CORE_PARALLEL_FOR_H_
+#define INCLUDE_CORE_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+/**
+ * Call \a aFunc( i ) for each i in [0, \a aCount) on several threads, and return once all the
+ * calls are done.
+ *
+ * The indices are handed out one at a time, in increasing order.  An exception thrown by
+ * \a aFunc is rethrown once all the threads are finished.
+ *
+ * @param aCount is the number of calls.
+ * @param aFunc is called with each index, from any of the threads.
+ * @param aThreadCount is the maximum number of threads, or 0 for one per core.  With a single
+ *                     thread, \a aFunc is called from the calling thread.
+ * @param aWaitFunc is called every 10 ms while waiting for the threads, e.g. to keep a progress
+ *                  reporter refreshed, if not empty.
+ */
+template <typename Func>
+void ParallelFor( size_t aCount, Func&& aFunc, size_t aThreadCount = 0,
+                  const std::function<void()>& aWaitFunc = nullptr )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    size_t parallelThreadCount = std::min( aThreadCount, aCount );
+
+    if( parallelThreadCount <= 1 )
+    {
+        for( size_t i = 0; i < aCount; ++i )
+            aFunc( i );
+
+        return;
+    }
+
+    std::atomic<size_t>            next( 0 );
+    std::vector<std::future<void>> returns( parallelThreadCount );
+
+    auto worker =
+            [&]()
+            {
+                for( size_t i = next++; i < aCount; i = next++ )
+                    aFunc( i );
+            };
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, worker );
+
+    for( std::future<void>& ret : returns )
+    {
+        if( aWaitFunc )
+        {
+            while( ret.wait_for( std::chrono::milliseconds( 10 ) ) != std::future_status::ready )
+                aWaitFunc();
+        }
+        else
+        {
+            ret.wait();
+        }
+    }
+
+    for( std::future<void>& ret : returns )
+        ret.get();
+}
+
+#endif // INCLUDE_CORE_PARALLEL_FOR_H_
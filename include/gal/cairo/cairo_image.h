@@ -0,0 +1,55 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CAIRO_IMAGE_H
+#define CAIRO_IMAGE_H
+
+#include <gal/cairo/cairo_gal.h>
+
+namespace KIGFX
+{
+/**
+ * A Cairo GAL drawing into an image surface held in memory.
+ *
+ * It needs neither a window nor a wxDC, so views can be rendered with it in command line
+ * tools and on worker threads (each thread using its own instance).
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * @param aWidth is the image width, in pixels.
+     * @param aHeight is the image height, in pixels.
+     * @throw std::runtime_error if the image could not be allocated.
+     */
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight );
+
+    /// @return the surface holding the image; flush it before reading its pixels.
+    cairo_surface_t* GetSurface() const
+    {
+        return surface;
+    }
+};
+} // namespace KIGFX
+
+#endif /* CAIRO_IMAGE_H */
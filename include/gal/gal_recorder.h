@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GAL_RECORDER_H_
+#define GAL_RECORDER_H_
+
+#include <functional>
+#include <vector>
+
+#include <gal/graphics_abstraction_layer.h>
+
+namespace KIGFX
+{
+
+/**
+ * A GAL that doesn't draw anything, but records the calls made on it so they can be replayed
+ * later on another GAL.
+ *
+ * It lets painters run on worker threads: each thread draws items into its own recorder and
+ * the recordings are replayed, in order, into the cached groups of the real GAL.  Text is laid
+ * out and stroked while recording, so only the resulting primitives are replayed.
+ */
+class GAL_RECORDER : public GAL
+{
+public:
+    typedef std::vector<std::function<void( GAL& )>> RECORDING;
+
+    /**
+     * @param aTarget is the GAL the recordings are meant for.  Its view (zoom, flip, world to
+     * screen transformation) and depth range are copied, so painters get the same answers as
+     * from the target.
+     */
+    GAL_RECORDER( GAL& aTarget );
+
+    bool IsOpenGlEngine() override { return m_isOpenGl; }
+
+    bool IsCairoEngine() override { return m_isCairo; }
+
+    /**
+     * Start a new recording.  The current attributes of the recorder are stored at its
+     * beginning, so replaying it doesn't depend on the state the target was left in.
+     */
+    void StartRecording();
+
+    /**
+     * @return the calls recorded since StartRecording().
+     */
+    RECORDING FinishRecording();
+
+    /**
+     * Replay a recording on aTarget.
+     */
+    static void Replay( const RECORDING& aRecording, GAL& aTarget );
+
+    // Drawing methods
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override;
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                  double aEndAngle ) override;
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override;
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+
+    /**
+     * A triangulated set is not copied, it has to outlive the recording.  Other sets are
+     * recorded as their outlines.
+     */
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+    void DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                    const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                    double aFilterValue = 0.0 ) override;
+
+    /// The bitmap is not copied, it has to outlive the recording
+    void DrawBitmap( const BITMAP_BASE& aBitmap ) override;
+
+    void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                     double aRotationAngle ) override;
+
+    // Attributes
+    void SetIsFill( bool aIsFillEnabled ) override;
+    void SetIsStroke( bool aIsStrokeEnabled ) override;
+    void SetFillColor( const COLOR4D& aColor ) override;
+    void SetStrokeColor( const COLOR4D& aColor ) override;
+    void SetLineWidth( float aLineWidth ) override;
+    void SetLayerDepth( double aLayerDepth ) override;
+    void SetNegativeDrawMode( bool aSetting ) override;
+
+    // Transformations
+    void Transform( const MATRIX3x3D& aTransformation ) override;
+    void Rotate( double aAngle ) override;
+    void Translate( const VECTOR2D& aTranslation ) override;
+    void Scale( const VECTOR2D& aScale ) override;
+    void Save() override;
+    void Restore() override;
+
+private:
+    RECORDING m_recording;
+    bool      m_isOpenGl;
+    bool      m_isCairo;
+};
+
+} // namespace KIGFX
+
+#endif /* GAL_RECORDER_H_ */
@@ -606,6 +606,16 @@ public:
         worldUnitLength = aWorldUnitLength;
     }
 
+    /**
+     * @brief Get the unit length.
+     *
+     * @return the length [inch] per one integer.
+     */
+    inline double GetWorldUnitLength() const
+    {
+        return worldUnitLength;
+    }
+
     inline void SetScreenSize( const VECTOR2I& aSize )
     {
         screenSize = aSize;
@@ -31,6 +31,8 @@
 
 #include <deque>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #include <utf8.h>
 
@@ -45,6 +47,30 @@ class GAL;
 typedef std::vector<std::vector<VECTOR2D>*> GLYPH;
 typedef std::vector<GLYPH*>                 GLYPH_LIST;
 
+/**
+ * A single line of text laid out with the stroke font, in the coordinates of the line: the
+ * polylines of the glyphs and the lines of overbars and underlines, in drawing order.
+ */
+struct STROKE_TEXT_LINE
+{
+    struct STROKE
+    {
+        size_t m_first;     ///< Index of the first point in m_points
+        size_t m_count;     ///< Number of points
+        bool   m_isLine;    ///< True for overbars and underlines, drawn as a single line
+    };
+
+    void addLine( const VECTOR2D& aStart, const VECTOR2D& aEnd )
+    {
+        m_strokes.push_back( { m_points.size(), 2, true } );
+        m_points.push_back( aStart );
+        m_points.push_back( aEnd );
+    }
+
+    std::vector<VECTOR2D> m_points;
+    std::vector<STROKE>   m_strokes;
+};
+
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -151,6 +177,16 @@ private:
      */
     void drawSingleLineText( const UTF8& aText );
 
+    /**
+     * Return the layout of a single line of text with the current text attributes of the GAL.
+     * The same texts are drawn, plotted and converted to polygons over and over, so layouts
+     * are cached; they are shared between threads and must not be modified.
+     */
+    std::shared_ptr<const STROKE_TEXT_LINE> getLineLayout( const UTF8& aText ) const;
+
+    /// Lay out a single line of text (uncached, see getLineLayout()).
+    STROKE_TEXT_LINE layoutSingleLineText( const UTF8& aText ) const;
+
     /**
      * @brief Returns number of lines for a given text.
      *
@@ -103,6 +103,20 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a painter drawing the same way (with the same settings) as this one, but on
+     * another GAL.  Painters able to draw unrelated items from several threads at once return
+     * a new instance; the VIEW then uses them to recache items on worker threads.
+     * @param aGal is the GAL the new painter draws on.
+     * @return a new painter (owned by the caller), or nullptr if the painter may be used only
+     * from the main thread.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
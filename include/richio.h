@@ -245,6 +245,16 @@ public:
         rewind( m_fp );
         m_lineNum = 0;
     }
+
+    /**
+     * @return the length of the file, in bytes.
+     */
+    long int FileLength();
+
+    /**
+     * @return the current position in the file, in bytes.
+     */
+    long int CurPos();
 };
 
 
@@ -0,0 +1,142 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef OFFSCREEN_RENDERER_H
+#define OFFSCREEN_RENDERER_H
+
+#include <gal/gal_display_options.h>
+#include <math/box2.h>
+
+#include <cairo.h>
+#include <memory>
+#include <vector>
+
+class wxString;
+
+namespace KIGFX
+{
+class GAL;
+class PAINTER;
+class VIEW;
+
+/**
+ * Renders the items of a #VIEW to a raster image, without any window.
+ *
+ * The image is split in tiles that are drawn in parallel, each thread using its own
+ * #CAIRO_IMAGE_GAL, a copy of the view (see VIEW::DataReference()) and a copy of the painter
+ * (see PAINTER::Clone()).  Items are drawn the way they are printed.
+ *
+ * The source view and its items are only read, so the view may belong to an open editor, but
+ * it must not be modified while rendering.
+ */
+class OFFSCREEN_RENDERER
+{
+public:
+    /**
+     * @param aView is the view holding the items to render.
+     * @param aPainter is the painter to draw them with, set up with the colors to use.  It has
+     *                 to support PAINTER::Clone().
+     */
+    OFFSCREEN_RENDERER( const VIEW& aView, const PAINTER& aPainter );
+
+    ~OFFSCREEN_RENDERER();
+
+    /**
+     * Set the layers to render, from the top-most to the bottom-most one.  The other layers
+     * are hidden.  By default, the visible layers of the view are rendered in its order.
+     */
+    void SetLayers( const std::vector<int>& aLayers )
+    {
+        m_layers = aLayers;
+    }
+
+    /**
+     * Set the area to render, in world units.  It is centered in the image and keeps its
+     * aspect ratio.
+     */
+    void SetViewport( const BOX2D& aViewport )
+    {
+        m_viewport = aViewport;
+    }
+
+    void SetImageSize( int aWidth, int aHeight )
+    {
+        m_width = aWidth;
+        m_height = aHeight;
+    }
+
+    /// Set the size (in pixels) of the square tiles rendered in parallel.
+    void SetTileSize( int aSize )
+    {
+        m_tileSize = aSize;
+    }
+
+    /// Set the number of rendering threads; 0 uses one thread per core.
+    void SetThreadCount( int aCount )
+    {
+        m_threadCount = aCount;
+    }
+
+    /**
+     * Render the image.
+     *
+     * @return false if the image could not be allocated or the painter cannot be cloned.
+     */
+    bool Render();
+
+    /// @return the last rendered image (ARGB32), or nullptr.  It is owned by the renderer.
+    cairo_surface_t* GetImage() const
+    {
+        return m_image;
+    }
+
+    /**
+     * Write the last rendered image to a PNG file.
+     *
+     * @return true on success.
+     */
+    bool SaveImage( const wxString& aFileName ) const;
+
+private:
+    /// Create a copy of the source view drawing with aGal and aPainter the layers to render.
+    std::unique_ptr<VIEW> makeView( GAL* aGal, PAINTER* aPainter ) const;
+
+    const VIEW&         m_view;
+    const PAINTER&      m_painter;
+
+    ///> Shared by the GALs of all tiles, which are only created and destroyed by Render()
+    GAL_DISPLAY_OPTIONS m_options;
+
+    std::vector<int>    m_layers;
+    BOX2D               m_viewport;
+    int                 m_width;
+    int                 m_height;
+    int                 m_tileSize;
+    int                 m_threadCount;
+
+    cairo_surface_t*    m_image;
+};
+
+} // namespace KIGFX
+
+#endif /* OFFSCREEN_RENDERER_H */
@@ -25,6 +25,7 @@
 #ifndef __VIEW_H
 #define __VIEW_H
 
+#include <functional>
 #include <vector>
 #include <set>
 #include <unordered_map>
@@ -608,7 +609,8 @@ public:
 
     /**
      * Function UpdateItems()
-     * Iterates through the list of items that asked for updating and updates them.
+     * Iterates through the list of items that asked for updating and updates them.  Only the
+     * items queued by Update() are visited; their GAL cache groups are rebuilt layer by layer.
      */
     void UpdateItems();
 
@@ -765,19 +767,44 @@ protected:
     ///* used by GAL)
     void clearGroupCache();
 
+    /**
+     * Adds update flags to an item and queues it for the next UpdateItems() of the view
+     * owning it, unless it was queued already.
+     */
+    void markForUpdate( const VIEW_ITEM* aItem, int aUpdateFlags ) const;
+
     /**
      * Function invalidateItem()
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aGeometryUpdates receives the (layer, item) pairs whose cached geometry has to be
+     * redrawn, so the redraws can be batched per layer.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<std::pair<int, VIEW_ITEM*>>& aGeometryUpdates );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
-    /// Updates all informations needed to draw an item
-    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
+    /**
+     * Draws items on worker threads, each of them with its own copy of the painter drawing on
+     * a GAL_RECORDER.  Nothing is done if the painter cannot be copied (see PAINTER::Clone())
+     * or if there are too few items to make it worthwhile.
+     *
+     * @param aGeometryUpdates are the (layer, item) pairs to draw, with all the layers of an
+     * item next to each other.
+     * @param aRecordings receives a recording for each entry of aGeometryUpdates.  Entries
+     * left empty have to be drawn by the painter of the view.
+     */
+    void recordItemGeometry( const std::vector<std::pair<int, VIEW_ITEM*>>& aGeometryUpdates,
+                             std::vector<std::vector<std::function<void( GAL& )>>>& aRecordings );
+
+    /// Updates all informations needed to draw an item.  The GAL target and layer depth
+    /// have to be set for aLayer already.  If aRecording is given, it is replayed instead of
+    /// asking the painter to draw the item.
+    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer,
+                             const std::vector<std::function<void( GAL& )>>* aRecording = nullptr );
 
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
@@ -806,6 +833,9 @@ protected:
     /// Flat list of all items
     std::shared_ptr<std::vector<VIEW_ITEM*>> m_allItems;
 
+    /// Items with pending update flags, in the order they were first marked
+    std::vector<VIEW_ITEM*> m_dirtyItems;
+
     /// Stores set of layers that are displayed on the top
     std::set<unsigned int> m_topLayers;
 
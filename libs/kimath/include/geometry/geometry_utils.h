@@ -62,7 +62,7 @@ int GetArcToSegmentCount( int aRadius, int aErrorMax, double aArcAngleDegree );
  * when converting them to polygons is not acceptable (the modification can break
  * calculations).
  * So one can disable the shape expansion within a particular scope by allocating
- * a DISABLE_ARC_CORRECTION.
+ * a DISABLE_ARC_CORRECTION.  This only affects the current thread.
  */
 class DISABLE_ARC_RADIUS_CORRECTION
 {
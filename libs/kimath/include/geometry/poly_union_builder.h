@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_UNION_BUILDER_H
+#define __POLY_UNION_BUILDER_H
+
+#include <deque>
+#include <vector>
+
+#include <geometry/geometry_utils.h>
+#include <geometry/shape_poly_set.h>
+#include <math/vector2d.h>
+#include <wx/gdicmn.h>
+
+
+/**
+ * POLY_UNION_BUILDER
+ *
+ * Accumulates a large number of (mostly small, mostly overlapping) shapes and computes their
+ * union in one go.
+ *
+ * Shapes are recorded as primitives in a flat buffer and are only converted to polygons when
+ * Build() is called.  The union is then computed hierarchically: primitives are sorted along
+ * a space-filling curve so that neighbouring shapes end up in the same bucket, each bucket is
+ * merged with a single Simplify() pass, and the buckets are then merged pairwise until one
+ * polygon set remains.  Buckets and pairs are independent, so both the conversion and the
+ * merging are spread over several threads.
+ *
+ * This is much cheaper than appending thousands of outlines to a single SHAPE_POLY_SET and
+ * running one huge boolean operation, and the merge tree only depends on the input (not on
+ * the thread count) so the result is deterministic.
+ */
+class POLY_UNION_BUILDER
+{
+public:
+    /**
+     * @param aError is the max error used when converting curves to segments.
+     * @param aErrorLoc indicates where the approximation error should be placed.
+     */
+    POLY_UNION_BUILDER( int aError, ERROR_LOC aErrorLoc );
+
+    void AddCircle( const wxPoint& aCenter, int aRadius );
+
+    /**
+     * Add a segment with rounded ends (an oblong, or a circle if start and end match).
+     */
+    void AddOval( const wxPoint& aStart, const wxPoint& aEnd, int aWidth );
+
+    /**
+     * Add a rectangle with optionally rounded and/or chamfered corners.  See
+     * TransformRoundChamferedRectToPolygon() for the meaning of the parameters.
+     */
+    void AddRoundChamferedRect( const wxPoint& aCenter, const wxSize& aSize, double aRotation,
+                                int aCornerRadius, double aChamferRatio = 0.0,
+                                int aChamferCorners = 0 );
+
+    /**
+     * Add an already polygonized shape (for anything which isn't one of the above).
+     */
+    void AddPolygon( const SHAPE_POLY_SET& aPoly );
+
+    void Clear();
+
+    int GetCount() const { return (int) m_primitives.size(); }
+
+    /**
+     * Compute the union of all added shapes.
+     *
+     * @param aResult receives the union (any previous content is replaced).
+     * @param aThreadCount is the maximum number of threads to use (1 for single-threaded).
+     */
+    void Build( SHAPE_POLY_SET& aResult, int aThreadCount = 1 );
+
+    ///> Number of primitives merged by a single Simplify() pass before the pairwise merging
+    static const int LEAF_BUCKET_SIZE = 32;
+
+private:
+    enum PRIMITIVE_TYPE
+    {
+        PT_CIRCLE,
+        PT_OVAL,
+        PT_ROUNDRECT,
+        PT_POLY
+    };
+
+    struct PRIMITIVE
+    {
+        PRIMITIVE_TYPE m_Type;
+        VECTOR2I       m_A;            ///< center, or start point for ovals
+        VECTOR2I       m_B;            ///< end point for ovals, size for rectangles
+        int            m_Width;        ///< radius, oval width or corner radius
+        int            m_Index;        ///< index in m_polys or m_rectParams (if any)
+    };
+
+    struct RECT_PARAMS
+    {
+        double m_Rotation;
+        double m_ChamferRatio;
+        int    m_ChamferCorners;
+    };
+
+    void addPrimitive( PRIMITIVE_TYPE aType, const VECTOR2I& aA, const VECTOR2I& aB, int aWidth,
+                       int aIndex );
+
+    VECTOR2I primitiveCenter( const PRIMITIVE& aPrimitive ) const;
+
+    void appendPrimitive( const PRIMITIVE& aPrimitive, SHAPE_POLY_SET& aBuffer ) const;
+
+    int                        m_error;
+    ERROR_LOC                  m_errorLoc;
+
+    std::vector<PRIMITIVE>     m_primitives;
+    std::vector<RECT_PARAMS>   m_rectParams;
+    std::deque<SHAPE_POLY_SET> m_polys;
+};
+
+#endif // __POLY_UNION_BUILDER_H
@@ -158,6 +158,16 @@ public:
             m_points.emplace_back( point.X, point.Y );
     }
 
+    /**
+     * Builds a closed line chain from a Clipper path whose Z values refer to arcs (see
+     * convertToClipper()).  Runs of points sharing an arc tag which still lie on that arc are
+     * recorded as arcs again; the points themselves are kept unchanged.
+     *
+     * @param aPath is the Clipper path.
+     * @param aArcBuffer holds the arcs referenced by the Z values of the path.
+     */
+    SHAPE_LINE_CHAIN( const ClipperLib::Path& aPath, const std::vector<SHAPE_ARC>& aArcBuffer );
+
     virtual ~SHAPE_LINE_CHAIN()
     {}
 
@@ -449,6 +459,36 @@ public:
 
     void Insert( size_t aVertex, const SHAPE_ARC& aArc );
 
+    /**
+     * Records the points in range [aStartIndex, aEndIndex] as an approximation of aArc.  The
+     * points themselves are not modified.  Any arc previously covering one of these points is
+     * converted to plain points.
+     *
+     * This is used by code generating its own arc approximation (e.g. for pads) so the arc
+     * survives boolean operations and inflation.
+     */
+    void MarkArc( int aStartIndex, int aEndIndex, const SHAPE_ARC& aArc );
+
+    /**
+     * Builds an arc following the points in range [aStartIndex, aEndIndex], which must be part
+     * of the same arc of the chain.  The points of an arc approximation are not exactly on a
+     * circle, so the radius is chosen to keep the arc inside the closed chain: the arc goes
+     * through the innermost point of an arc turning with the chain, and through the outermost
+     * one of an arc turning against it (e.g. a knockout).
+     *
+     * The ends of the arc move with its radius, so they can end up past a neighbouring shape
+     * at a cusp.  Callers keep the first and last points of a run as they are and build the arc
+     * on the points in between.
+     *
+     * @param aStartIndex is the first point of the arc.
+     * @param aEndIndex is the last point of the arc.
+     * @param aCounterClockwise tells the orientation of the chain (its Area() is positive).
+     * @param aMargin moves the arc further inside the chain, e.g. to account for the error of
+     *                a later approximation of the arc by segments.
+     */
+    SHAPE_ARC ArcInside( int aStartIndex, int aEndIndex, bool aCounterClockwise,
+                         int aMargin = 0 ) const;
+
     /**
      * Function Replace()
      *
@@ -601,6 +641,15 @@ public:
      */
     SHAPE_LINE_CHAIN& Simplify();
 
+    /**
+     * Return a copy of the line chain with fewer points, none of the removed points being
+     * further than aMaxError from it (Ramer-Douglas-Peucker).  Arcs are not kept: this is meant
+     * for drawing, not for editing.
+     *
+     * @param aMaxError is the maximum distance from a removed point to the new chain.
+     */
+    SHAPE_LINE_CHAIN Decimate( int aMaxError ) const;
+
     /**
      * Converts an arc to only a point chain by removing the arc and references
      *
@@ -613,6 +662,14 @@ public:
      */
     ClipperLib::Path convertToClipper( bool aRequiredOrientation ) const;
 
+    /**
+     * Creates a new Clipper path from the SHAPE_LINE_CHAIN in a given orientation.  The arcs of
+     * the chain are appended to aArcBuffer and the Z value of each point is set to the index of
+     * its arc in aArcBuffer plus one (0 for points which are not part of an arc).
+     */
+    ClipperLib::Path convertToClipper( bool aRequiredOrientation,
+                                       std::vector<SHAPE_ARC>& aArcBuffer ) const;
+
     /**
      * Find the segment nearest the given point.
      *
@@ -1310,7 +1310,7 @@ class SHAPE_POLY_SET : public SHAPE
     private:
         void fractureSingle( POLYGON& paths );
         void unfractureSingle ( POLYGON& path );
-        void importTree( ClipperLib::PolyTree* tree );
+        void importTree( ClipperLib::PolyTree* tree, const std::vector<SHAPE_ARC>& aArcBuffer );
 
         /** Function booleanOp
          * this is the engine to execute all polygon boolean transforms
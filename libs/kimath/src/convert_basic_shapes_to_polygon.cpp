@@ -49,6 +49,8 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aCornerBuffer, wxPoint aCenter,
     if( aErrorLoc == ERROR_OUTSIDE )
         radius += GetCircleToPolyCorrection( aError );
 
+    int first = aCornerBuffer.PointCount();
+
     for( int angle = 0; angle < 3600; angle += delta )
     {
         corner_position.x   = radius;
@@ -59,6 +61,15 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aCornerBuffer, wxPoint aCenter,
     }
 
     aCornerBuffer.SetClosed( true );
+
+    // Keep track of the circle so that it survives boolean operations
+    if( aCornerBuffer.PointCount() - first > 2 )
+    {
+        wxPoint start( aCenter.x + radius, aCenter.y );
+        wxPoint mid( aCenter.x - radius, aCenter.y );
+
+        aCornerBuffer.MarkArc( first, -1, SHAPE_ARC( start, mid, start, 0 ) );
+    }
 }
 
 
@@ -89,6 +100,16 @@ void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, i
     corner_position.y = 0;
     corner_position += aCenter;
     aCornerBuffer.Append( corner_position.x, corner_position.y );
+
+    // Keep track of the circle so that it survives boolean operations
+    SHAPE_LINE_CHAIN& outline = aCornerBuffer.Outline( aCornerBuffer.OutlineCount() - 1 );
+
+    if( outline.PointCount() > 2 )
+    {
+        wxPoint mid( aCenter.x - radius, aCenter.y );
+
+        outline.MarkArc( 0, -1, SHAPE_ARC( corner_position, mid, corner_position, 0 ) );
+    }
 }
 
 
@@ -146,6 +167,9 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     corner = wxPoint( seg_len, -radius );
     polyshape.Append( corner.x, corner.y );
 
+    SHAPE_LINE_CHAIN& outline = polyshape.Outline( 0 );
+    int               rightEnd = outline.PointCount() - 1;
+
     // add left rounded end:
     for( int angle = 0; angle < 1800; angle += delta )
     {
@@ -158,6 +182,18 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     corner = wxPoint( 0, radius );
     polyshape.Append( corner.x, corner.y );
 
+    // Keep track of both rounded ends so that they survive the clamping below (and any later
+    // boolean operation)
+    if( radius > 0 )
+    {
+        outline.MarkArc( 0, rightEnd, SHAPE_ARC( VECTOR2I( seg_len, radius ),
+                                                 VECTOR2I( seg_len + radius, 0 ),
+                                                 VECTOR2I( seg_len, -radius ), 0 ) );
+        outline.MarkArc( rightEnd + 1, -1, SHAPE_ARC( VECTOR2I( 0, -radius ),
+                                                      VECTOR2I( -radius, 0 ),
+                                                      VECTOR2I( 0, radius ), 0 ) );
+    }
+
     // Now trim the edges of the polygonal shape which will be slightly outside the
     // track width.
     SHAPE_POLY_SET bbox;
@@ -225,6 +261,18 @@ void TransformRoundRectToPolygon( SHAPE_POLY_SET& aCornerBuffer, const wxSize& a
     auto genArc =
             [&]( const wxPoint& aCenter, int aStart, int aEnd )
     {
+        SHAPE_LINE_CHAIN& chain = outline.Outline( 0 );
+        int               first = chain.PointCount();
+        wxPoint           start( -radius, 0 );
+        wxPoint           mid( -radius, 0 );
+        wxPoint           end( -radius, 0 );
+
+        RotatePoint( &start, aStart );
+        RotatePoint( &mid, ( aStart + aEnd ) / 2 );
+        RotatePoint( &end, aEnd );
+
+        outline.Append( start + aCenter );
+
         for( int angle = aStart + delta; angle < aEnd; angle += delta )
         {
             wxPoint pt( -radius, 0 );
@@ -232,22 +280,24 @@ void TransformRoundRectToPolygon( SHAPE_POLY_SET& aCornerBuffer, const wxSize& a
             pt += aCenter;
             outline.Append( pt.x, pt.y );
         }
+
+        outline.Append( end + aCenter );
+
+        // Keep track of the corner so that it survives the clamping below (and any later
+        // boolean operation)
+        if( chain.PointCount() - first > 2 )
+        {
+            chain.MarkArc( first, -1, SHAPE_ARC( start + aCenter, mid + aCenter,
+                                                 end + aCenter, 0 ) );
+        }
     };
 
     outline.NewOutline();
 
-    outline.Append( centers[0] + wxPoint( -radius, 0 ) );
     genArc( centers[0], 0, 900 );
-    outline.Append( centers[0] + wxPoint( 0, radius ) );
-    outline.Append( centers[1] + wxPoint( 0, radius ) );
     genArc( centers[1], 900, 1800 );
-    outline.Append( centers[1] + wxPoint( radius, 0 ) );
-    outline.Append( centers[2] + wxPoint( radius, 0 ) );
     genArc( centers[2], 1800, 2700 );
-    outline.Append( centers[2] + wxPoint( 0, -radius ) );
-    outline.Append( centers[3] + wxPoint( 0, -radius ) );
     genArc( centers[3], 2700, 3600 );
-    outline.Append( centers[3] + wxPoint( -radius, 0 ) );
 
     outline.Outline( 0 ).SetClosed( true );
 
@@ -71,8 +71,9 @@ int GetArcToSegmentCount( int aRadius, int aErrorMax, double aArcAngleDegree )
 // calculations).
 // So one can disable the shape expansion within a particular scope by allocating
 // a DISABLE_ARC_CORRECTION.
+// The scope is a thread: other threads can build polygons at the same time.
 
-static bool s_disable_arc_correction = false;
+static thread_local bool s_disable_arc_correction = false;
 
 DISABLE_ARC_RADIUS_CORRECTION::DISABLE_ARC_RADIUS_CORRECTION()
 {
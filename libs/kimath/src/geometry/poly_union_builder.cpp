@@ -0,0 +1,248 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <convert_basic_shapes_to_polygon.h>
+#include <core/parallel_for.h>
+#include <geometry/poly_union_builder.h>
+
+
+/**
+ * Interleave the bits of two 16-bit coordinates to get the position along a Z-order
+ * (Morton) curve.
+ */
+static uint32_t mortonKey( uint32_t aX, uint32_t aY )
+{
+    auto spread =
+            []( uint32_t v ) -> uint32_t
+            {
+                v &= 0x0000FFFF;
+                v = ( v | ( v << 8 ) ) & 0x00FF00FF;
+                v = ( v | ( v << 4 ) ) & 0x0F0F0F0F;
+                v = ( v | ( v << 2 ) ) & 0x33333333;
+                v = ( v | ( v << 1 ) ) & 0x55555555;
+                return v;
+            };
+
+    return spread( aX ) | ( spread( aY ) << 1 );
+}
+
+
+POLY_UNION_BUILDER::POLY_UNION_BUILDER( int aError, ERROR_LOC aErrorLoc ) :
+        m_error( aError ),
+        m_errorLoc( aErrorLoc )
+{
+}
+
+
+void POLY_UNION_BUILDER::addPrimitive( PRIMITIVE_TYPE aType, const VECTOR2I& aA,
+                                       const VECTOR2I& aB, int aWidth, int aIndex )
+{
+    PRIMITIVE prim;
+
+    prim.m_Type = aType;
+    prim.m_A = aA;
+    prim.m_B = aB;
+    prim.m_Width = aWidth;
+    prim.m_Index = aIndex;
+
+    m_primitives.push_back( prim );
+}
+
+
+void POLY_UNION_BUILDER::AddCircle( const wxPoint& aCenter, int aRadius )
+{
+    addPrimitive( PT_CIRCLE, aCenter, VECTOR2I( 0, 0 ), aRadius, -1 );
+}
+
+
+void POLY_UNION_BUILDER::AddOval( const wxPoint& aStart, const wxPoint& aEnd, int aWidth )
+{
+    addPrimitive( PT_OVAL, aStart, aEnd, aWidth, -1 );
+}
+
+
+void POLY_UNION_BUILDER::AddRoundChamferedRect( const wxPoint& aCenter, const wxSize& aSize,
+                                                double aRotation, int aCornerRadius,
+                                                double aChamferRatio, int aChamferCorners )
+{
+    m_rectParams.push_back( { aRotation, aChamferRatio, aChamferCorners } );
+
+    addPrimitive( PT_ROUNDRECT, aCenter, VECTOR2I( aSize.x, aSize.y ), aCornerRadius,
+                  (int) m_rectParams.size() - 1 );
+}
+
+
+void POLY_UNION_BUILDER::AddPolygon( const SHAPE_POLY_SET& aPoly )
+{
+    if( aPoly.OutlineCount() == 0 )
+        return;
+
+    m_polys.push_back( aPoly );
+
+    addPrimitive( PT_POLY, VECTOR2I( 0, 0 ), VECTOR2I( 0, 0 ), 0, (int) m_polys.size() - 1 );
+}
+
+
+void POLY_UNION_BUILDER::Clear()
+{
+    m_primitives.clear();
+    m_rectParams.clear();
+    m_polys.clear();
+}
+
+
+VECTOR2I POLY_UNION_BUILDER::primitiveCenter( const PRIMITIVE& aPrimitive ) const
+{
+    switch( aPrimitive.m_Type )
+    {
+    case PT_OVAL:
+        return ( aPrimitive.m_A + aPrimitive.m_B ) / 2;
+
+    case PT_POLY:
+        return m_polys[aPrimitive.m_Index].BBox().Centre();
+
+    default:
+        return aPrimitive.m_A;
+    }
+}
+
+
+void POLY_UNION_BUILDER::appendPrimitive( const PRIMITIVE& aPrimitive,
+                                          SHAPE_POLY_SET& aBuffer ) const
+{
+    switch( aPrimitive.m_Type )
+    {
+    case PT_CIRCLE:
+        TransformCircleToPolygon( aBuffer, (wxPoint) aPrimitive.m_A, aPrimitive.m_Width, m_error,
+                                  m_errorLoc );
+        break;
+
+    case PT_OVAL:
+        TransformOvalToPolygon( aBuffer, (wxPoint) aPrimitive.m_A, (wxPoint) aPrimitive.m_B,
+                                aPrimitive.m_Width, m_error, m_errorLoc );
+        break;
+
+    case PT_ROUNDRECT:
+    {
+        const RECT_PARAMS& params = m_rectParams[aPrimitive.m_Index];
+
+        TransformRoundChamferedRectToPolygon( aBuffer, (wxPoint) aPrimitive.m_A,
+                                              wxSize( aPrimitive.m_B.x, aPrimitive.m_B.y ),
+                                              params.m_Rotation, aPrimitive.m_Width,
+                                              params.m_ChamferRatio, params.m_ChamferCorners,
+                                              m_error, m_errorLoc );
+    }
+        break;
+
+    case PT_POLY:
+        aBuffer.Append( m_polys[aPrimitive.m_Index] );
+        break;
+    }
+}
+
+
+void POLY_UNION_BUILDER::Build( SHAPE_POLY_SET& aResult, int aThreadCount )
+{
+    aResult.RemoveAllContours();
+
+    if( m_primitives.empty() )
+        return;
+
+    // Order the primitives along a Z-order curve so that each bucket covers a compact area of
+    // the board.  Merging compact buckets keeps the intermediate results small.
+    std::vector<VECTOR2I> centers( m_primitives.size() );
+    BOX2I                 extents;
+
+    for( size_t ii = 0; ii < m_primitives.size(); ++ii )
+    {
+        centers[ii] = primitiveCenter( m_primitives[ii] );
+
+        if( ii == 0 )
+            extents = BOX2I( centers[ii], VECTOR2I( 0, 0 ) );
+        else
+            extents.Merge( centers[ii] );
+    }
+
+    double scale = 65535.0 / std::max<double>( 1.0, std::max( extents.GetWidth(),
+                                                              extents.GetHeight() ) );
+
+    std::vector<std::pair<uint32_t, int>> order( m_primitives.size() );
+
+    for( size_t ii = 0; ii < m_primitives.size(); ++ii )
+    {
+        uint32_t x = (uint32_t) ( ( (double) centers[ii].x - extents.GetX() ) * scale );
+        uint32_t y = (uint32_t) ( ( (double) centers[ii].y - extents.GetY() ) * scale );
+
+        order[ii] = std::make_pair( mortonKey( x, y ), (int) ii );
+    }
+
+    // Ties are broken by insertion order, which keeps the merge tree deterministic
+    std::sort( order.begin(), order.end() );
+
+    size_t bucketCount = ( order.size() + LEAF_BUCKET_SIZE - 1 ) / LEAF_BUCKET_SIZE;
+    std::vector<SHAPE_POLY_SET> level( bucketCount );
+
+    size_t threadCount = std::max( aThreadCount, 1 );
+
+    ParallelFor( bucketCount,
+            [&]( size_t aBucket )
+            {
+                size_t first = aBucket * LEAF_BUCKET_SIZE;
+                size_t last = std::min( first + LEAF_BUCKET_SIZE, order.size() );
+
+                for( size_t ii = first; ii < last; ++ii )
+                    appendPrimitive( m_primitives[order[ii].second], level[aBucket] );
+
+                level[aBucket].Simplify( SHAPE_POLY_SET::PM_FAST );
+            },
+            threadCount );
+
+    // Merge neighbouring buckets pairwise until only two are left
+    while( level.size() > 2 )
+    {
+        std::vector<SHAPE_POLY_SET> next( ( level.size() + 1 ) / 2 );
+
+        ParallelFor( next.size(),
+                [&]( size_t aPair )
+                {
+                    size_t a = aPair * 2;
+                    size_t b = a + 1;
+
+                    if( b < level.size() )
+                        next[aPair].BooleanAdd( level[a], level[b], SHAPE_POLY_SET::PM_FAST );
+                    else
+                        next[aPair] = level[a];
+                },
+                threadCount );
+
+        level.swap( next );
+    }
+
+    if( level.size() == 2 )
+        aResult.BooleanAdd( level[0], level[1], SHAPE_POLY_SET::PM_FAST );
+    else
+        aResult = level[0];
+}
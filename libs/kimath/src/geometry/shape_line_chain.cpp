@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <limits.h>          // for INT_MAX
+#include <limits>            // for numeric_limits
 #include <math.h>            // for hypot
 #include <string>            // for basic_string
 
@@ -33,6 +34,7 @@
 #include <math/box2.h>       // for BOX2I
 #include <math/util.h>  // for rescale
 #include <math/vector2d.h>   // for VECTOR2, VECTOR2I
+#include <trigo.h>           // for RAD2DEG
 
 class SHAPE;
 
@@ -62,6 +64,245 @@ ClipperLib::Path SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation )
 }
 
 
+ClipperLib::Path SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation,
+                                                     std::vector<SHAPE_ARC>& aArcBuffer ) const
+{
+    ClipperLib::Path c_path;
+    ssize_t          arcOffset = aArcBuffer.size();
+
+    c_path.reserve( PointCount() );
+
+    for( int i = 0; i < PointCount(); i++ )
+    {
+        const VECTOR2I& vertex = m_points[i];
+        ssize_t         arcIndex = m_shapes[i];
+        ClipperLib::cInt tag = arcIndex == SHAPE_IS_PT ? 0 : arcOffset + arcIndex + 1;
+
+        c_path.push_back( ClipperLib::IntPoint( vertex.x, vertex.y, tag ) );
+    }
+
+    aArcBuffer.insert( aArcBuffer.end(), m_arcs.begin(), m_arcs.end() );
+
+    if( Orientation( c_path ) != aRequiredOrientation )
+        ReversePath( c_path );
+
+    return c_path;
+}
+
+
+SHAPE_LINE_CHAIN::SHAPE_LINE_CHAIN( const ClipperLib::Path& aPath,
+                                    const std::vector<SHAPE_ARC>& aArcBuffer ) :
+        SHAPE_LINE_CHAIN( aPath )
+{
+    // Coarsest arc approximation we ever generate (see GetArcToSegmentCount()).  A longer edge
+    // is a cut through the arc, not a part of it.
+    const double maxStep = 360.0 / 8 + 0.5;
+
+    // Clipper moves points around by up to the approximation error when computing
+    // intersections, so allow for the sagitta of that coarsest approximation
+    const double radiusTolerance = 1.0 - cos( M_PI / 8 );
+
+    int count = PointCount();
+
+    if( count < 3 )
+        return;
+
+    // Edge ii (from point ii to point ii + 1) is an arc edge if both ends carry the same arc tag
+    // and still lie on that arc.  step[ii] is then its signed angle (in degrees) seen from the
+    // arc center; 0.0 marks a plain edge.
+    std::vector<double>   step( count, 0.0 );
+    std::vector<VECTOR2I> centers( count );
+    ClipperLib::cInt      lastTag = 0;
+    VECTOR2I              center;
+
+    for( int ii = 0; ii < count; ii++ )
+    {
+        const ClipperLib::IntPoint& a = aPath[ii];
+        const ClipperLib::IntPoint& b = aPath[( ii + 1 ) % count];
+
+        if( a.Z <= 0 || a.Z > (ClipperLib::cInt) aArcBuffer.size() || a.Z != b.Z )
+            continue;
+
+        if( a.Z != lastTag )
+        {
+            center = aArcBuffer[a.Z - 1].GetCenter();
+            lastTag = a.Z;
+        }
+
+        VECTOR2D da( (double) a.X - center.x, (double) a.Y - center.y );
+        VECTOR2D db( (double) b.X - center.x, (double) b.Y - center.y );
+        double   ra = da.EuclideanNorm();
+        double   rb = db.EuclideanNorm();
+
+        if( std::abs( ra - rb ) > std::max( ra, rb ) * radiusTolerance + 2.0 )
+            continue;
+
+        double angle = RAD2DEG( atan2( da.x * db.y - da.y * db.x, da.x * db.x + da.y * db.y ) );
+
+        if( angle != 0.0 && std::abs( angle ) <= maxStep )
+        {
+            step[ii] = angle;
+            centers[ii] = center;
+        }
+    }
+
+    std::vector<ClipperLib::cInt> tags( count );
+
+    for( int ii = 0; ii < count; ii++ )
+        tags[ii] = aPath[ii].Z;
+
+    // Consecutive arc edges from the same arc, turning the same way, form a run
+    auto linked =
+            [&]( int aPrev, int aNext )
+            {
+                return step[aPrev] != 0.0 && step[aNext] != 0.0
+                        && tags[aPrev] == tags[aNext]
+                        && ( step[aPrev] > 0 ) == ( step[aNext] > 0 );
+            };
+
+    // Intersection points lie on the chords of the approximation rather than on the arc, so
+    // the arc is taken through the outermost point of the run
+    auto arcStart =
+            [&]( int aFirst, int aPointCount ) -> VECTOR2I
+            {
+                const VECTOR2I& arcCenter = centers[aFirst];
+                double          radius = 0.0;
+
+                for( int ii = 0; ii < aPointCount; ii++ )
+                {
+                    VECTOR2D d( m_points[( aFirst + ii ) % count] - arcCenter );
+                    radius = std::max( radius, d.EuclideanNorm() );
+                }
+
+                VECTOR2D d( m_points[aFirst] - arcCenter );
+
+                return arcCenter + VECTOR2I( KiROUND( d.x * radius / d.EuclideanNorm() ),
+                                             KiROUND( d.y * radius / d.EuclideanNorm() ) );
+            };
+
+    int start = 0;
+
+    while( start < count && linked( ( start + count - 1 ) % count, start ) )
+        start++;
+
+    // Preferably start after a plain edge, so that the last run doesn't end on the first point
+    for( int ii = 0; ii < count && start < count; ii++ )
+    {
+        if( step[( ii + count - 1 ) % count] == 0.0 )
+        {
+            start = ii;
+            break;
+        }
+    }
+
+    if( start == count )
+    {
+        // Every edge belongs to the same arc: this is a complete circle
+        double sweep = 0.0;
+
+        for( double angle : step )
+            sweep += angle;
+
+        MarkArc( 0, count - 1, SHAPE_ARC( centers[0], arcStart( 0, count ), sweep ) );
+        return;
+    }
+
+    // Start the chain with a run, so that no arc wraps around its end
+    std::rotate( m_points.begin(), m_points.begin() + start, m_points.end() );
+    std::rotate( step.begin(), step.begin() + start, step.end() );
+    std::rotate( centers.begin(), centers.begin() + start, centers.end() );
+    std::rotate( tags.begin(), tags.begin() + start, tags.end() );
+
+    for( int first = 0; first < count; )
+    {
+        int    len = 1;
+        double sweep = step[first];
+
+        while( first + len < count && linked( first + len - 1, first + len ) )
+        {
+            sweep += step[first + len];
+            len++;
+        }
+
+        // A single edge is just as well described by its end points
+        if( len >= 2 )
+        {
+            SHAPE_ARC arc( centers[first], arcStart( first, len + 1 ), sweep );
+            ssize_t   arcIndex = m_arcs.size();
+
+            m_arcs.push_back( arc );
+
+            // The closing edge of the last run stays a plain edge, to keep its arc contiguous
+            for( int ii = first; ii <= first + len && ii < count; ii++ )
+            {
+                if( m_shapes[ii] == SHAPE_IS_PT )
+                    m_shapes[ii] = arcIndex;
+            }
+        }
+
+        first += len;
+    }
+}
+
+
+void SHAPE_LINE_CHAIN::MarkArc( int aStartIndex, int aEndIndex, const SHAPE_ARC& aArc )
+{
+    if( aEndIndex < 0 )
+        aEndIndex += PointCount();
+
+    if( aStartIndex < 0 )
+        aStartIndex += PointCount();
+
+    for( int i = aStartIndex; i <= aEndIndex; i++ )
+    {
+        if( m_shapes[i] != SHAPE_IS_PT )
+            convertArc( m_shapes[i] );
+    }
+
+    for( int i = aStartIndex; i <= aEndIndex; i++ )
+        m_shapes[i] = m_arcs.size();
+
+    m_arcs.push_back( aArc );
+
+    assert( m_shapes.size() == m_points.size() );
+}
+
+
+SHAPE_ARC SHAPE_LINE_CHAIN::ArcInside( int aStartIndex, int aEndIndex, bool aCounterClockwise,
+                                      int aMargin ) const
+{
+    VECTOR2I center = m_arcs[m_shapes[aStartIndex]].GetCenter();
+    double   sweep = 0.0;
+    double   minRadius = std::numeric_limits<double>::max();
+    double   maxRadius = 0.0;
+
+    for( int i = aStartIndex; i <= aEndIndex; i++ )
+    {
+        VECTOR2D d( m_points[i] - center );
+
+        minRadius = std::min( minRadius, d.EuclideanNorm() );
+        maxRadius = std::max( maxRadius, d.EuclideanNorm() );
+
+        if( i < aEndIndex )
+        {
+            VECTOR2D next( m_points[i + 1] - center );
+
+            sweep += RAD2DEG( atan2( d.x * next.y - d.y * next.x, d.x * next.x + d.y * next.y ) );
+        }
+    }
+
+    // An arc turning with the chain has the inside of the chain towards its center
+    bool   convex = ( sweep > 0 ) == aCounterClockwise;
+    double radius = convex ? minRadius - aMargin : maxRadius + aMargin;
+
+    VECTOR2D d( m_points[aStartIndex] - center );
+    VECTOR2I start = center + VECTOR2I( KiROUND( d.x * radius / d.EuclideanNorm() ),
+                                        KiROUND( d.y * radius / d.EuclideanNorm() ) );
+
+    return SHAPE_ARC( center, start, sweep );
+}
+
+
 //TODO(SH): Adjust this into two functions: one to convert and one to split the arc into two arcs
 void SHAPE_LINE_CHAIN::convertArc( ssize_t aArcIndex )
 {
@@ -300,7 +541,10 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE
     auto   new_shapes = aLine.m_shapes;
 
     for( auto& shape : new_shapes )
-        shape += prev_arc_count;
+    {
+        if( shape != SHAPE_IS_PT )
+            shape += prev_arc_count;
+    }
 
     m_shapes.insert( m_shapes.begin() + aStartIndex, new_shapes.begin(), new_shapes.end() );
     m_points.insert( m_points.begin() + aStartIndex, aLine.m_points.begin(), aLine.m_points.end() );
@@ -895,6 +1139,95 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify()
 }
 
 
+SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Decimate( int aMaxError ) const
+{
+    int              n = PointCount();
+    SHAPE_LINE_CHAIN result( m_points, m_closed );
+
+    result.SetWidth( m_width );
+
+    if( n < 3 )
+        return result;
+
+    std::vector<bool>                keep( n, false );
+    std::vector<std::pair<int, int>> ranges;
+
+    keep[0] = true;
+
+    if( m_closed )
+    {
+        // Split the ring at the point furthest from the first one; index n stands for the
+        // first point again
+        int         split = 1;
+        SEG::ecoord splitDist = 0;
+
+        for( int ii = 1; ii < n; ++ii )
+        {
+            SEG::ecoord dist = ( m_points[ii] - m_points[0] ).SquaredEuclideanNorm();
+
+            if( dist > splitDist )
+            {
+                split = ii;
+                splitDist = dist;
+            }
+        }
+
+        keep[split] = true;
+        ranges.emplace_back( 0, split );
+        ranges.emplace_back( split, n );
+    }
+    else
+    {
+        keep[n - 1] = true;
+        ranges.emplace_back( 0, n - 1 );
+    }
+
+    const SEG::ecoord maxErrorSq = SEG::Square( aMaxError );
+
+    while( !ranges.empty() )
+    {
+        int first = ranges.back().first;
+        int last = ranges.back().second;
+
+        ranges.pop_back();
+
+        SEG         chord( m_points[first], m_points[last % n] );
+        int         furthest = -1;
+        SEG::ecoord furthestDist = maxErrorSq;
+
+        for( int ii = first + 1; ii < last; ++ii )
+        {
+            SEG::ecoord dist = chord.SquaredDistance( m_points[ii] );
+
+            if( dist > furthestDist )
+            {
+                furthest = ii;
+                furthestDist = dist;
+            }
+        }
+
+        if( furthest >= 0 )
+        {
+            keep[furthest] = true;
+            ranges.emplace_back( first, furthest );
+            ranges.emplace_back( furthest, last );
+        }
+    }
+
+    result.Clear();
+
+    for( int ii = 0; ii < n; ++ii )
+    {
+        if( keep[ii] )
+            result.Append( m_points[ii] );
+    }
+
+    result.SetClosed( m_closed );
+
+    return result;
+}
+
+
 const VECTOR2I SHAPE_LINE_CHAIN::NearestPoint( const VECTOR2I& aP ) const
 {
     int min_d = INT_MAX;
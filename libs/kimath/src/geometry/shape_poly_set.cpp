@@ -50,6 +50,7 @@
 #include <math/util.h>                       // for KiROUND, rescale
 #include <math/vector2d.h>                   // for VECTOR2I, VECTOR2D, VECTOR2
 #include <md5_hash.h>
+#include <trigo.h>                           // for RAD2DEG
 #include <geometry/shape_segment.h>
 #include <geometry/shape_circle.h>
 #include <geometry/shape_simple.h>
@@ -462,32 +463,50 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET
 }
 
 
+/**
+ * Clipper callback giving the Z value (arc tag) of a new intersection point: a point on an
+ * edge between two vertices of the same arc belongs to that arc.
+ */
+static void arcZFill( IntPoint& e1bot, IntPoint& e1top, IntPoint& e2bot, IntPoint& e2top,
+                      IntPoint& pt )
+{
+    if( e1bot.Z != 0 && e1bot.Z == e1top.Z )
+        pt.Z = e1bot.Z;
+    else if( e2bot.Z != 0 && e2bot.Z == e2top.Z )
+        pt.Z = e2bot.Z;
+    else
+        pt.Z = 0;
+}
+
+
 void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
         const SHAPE_POLY_SET& aShape,
         const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
-    Clipper c;
+    Clipper                c;
+    std::vector<SHAPE_ARC> arcBuffer;
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
+    c.ZFillFunction( arcZFill );
 
-    for( auto poly : aShape.m_polys )
+    for( const POLYGON& poly : aShape.m_polys )
     {
         for( size_t i = 0 ; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
+            c.AddPath( poly[i].convertToClipper( i == 0, arcBuffer ), ptSubject, true );
     }
 
-    for( auto poly : aOtherShape.m_polys )
+    for( const POLYGON& poly : aOtherShape.m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
+            c.AddPath( poly[i].convertToClipper( i == 0, arcBuffer ), ptClip, true );
     }
 
     PolyTree solution;
 
     c.Execute( aType, solution, pftNonZero, pftNonZero );
 
-    importTree( &solution );
+    importTree( &solution, arcBuffer );
 }
 
 
@@ -589,10 +608,17 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
         break;
     }
 
+    std::vector<SHAPE_ARC> arcBuffer;
+
+    c.ZFillFunction( arcZFill );
+
     for( const POLYGON& poly : m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
+        {
+            c.AddPath( poly[i].convertToClipper( i == 0, arcBuffer ), joinType,
+                       etClosedPolygon );
+        }
     }
 
     PolyTree solution;
@@ -621,11 +647,11 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     c.MiterFallback = miterFallback;
     c.Execute( solution, aAmount );
 
-    importTree( &solution );
+    importTree( &solution, arcBuffer );
 }
 
 
-void SHAPE_POLY_SET::importTree( PolyTree* tree )
+void SHAPE_POLY_SET::importTree( PolyTree* tree, const std::vector<SHAPE_ARC>& aArcBuffer )
 {
     m_polys.clear();
 
@@ -635,10 +661,10 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
         {
             POLYGON paths;
             paths.reserve( n->Childs.size() + 1 );
-            paths.push_back( n->Contour );
+            paths.emplace_back( n->Contour, aArcBuffer );
 
             for( unsigned int i = 0; i < n->Childs.size(); i++ )
-                paths.push_back( n->Childs[i]->Contour );
+                paths.emplace_back( n->Childs[i]->Contour, aArcBuffer );
 
             m_polys.push_back( paths );
         }
@@ -650,15 +676,17 @@ struct FractureEdge
 {
     FractureEdge( int y = 0 ) :
         m_connected( false ),
+        m_arc( -1 ),
         m_next( NULL )
     {
         m_p1.x = m_p2.y = y;
     }
 
-    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2 ) :
+    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2, int arc = -1 ) :
         m_connected( connected ),
         m_p1( p1 ),
         m_p2( p2 ),
+        m_arc( arc ),
         m_next( NULL )
     {
     }
@@ -670,6 +698,7 @@ struct FractureEdge
 
     bool m_connected;
     VECTOR2I m_p1, m_p2;
+    int m_arc;      ///< arc of the source polygon m_p1 belongs to, or -1
     FractureEdge* m_next;
 };
 
@@ -718,7 +747,8 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         int count = 0;
 
         FractureEdge* lead1 = new FractureEdge( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
-        FractureEdge* lead2 = new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
+        FractureEdge* lead2 = new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ),
+                                                edge->m_arc );
         FractureEdge* split_2 = new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
 
         edges.push_back( split_2 );
@@ -751,6 +781,74 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 }
 
 
+/**
+ * Record the arcs of a fractured polygon: consecutive points which were part of the same arc of
+ * the source polygon become a part of that arc.  The bridges to the holes cut arcs in two.
+ *
+ * @param aPath is the fractured outline.
+ * @param aPointArcs gives for each point of aPath the index of its source arc in aArcs, or -1.
+ * @param aArcs are the arcs of the source polygon.
+ */
+static void markFracturedArcs( SHAPE_LINE_CHAIN& aPath, const std::vector<int>& aPointArcs,
+                               const std::vector<SHAPE_ARC>& aArcs )
+{
+    // Coarsest arc approximation we ever generate, as in SHAPE_LINE_CHAIN( Path, arcBuffer )
+    const double maxStep = 360.0 / 8 + 0.5;
+
+    int count = aPath.PointCount();
+
+    // Signed angle of the edge from point aIndex to the next one, seen from aCenter
+    auto stepAngle =
+            [&]( const VECTOR2I& aCenter, int aIndex ) -> double
+            {
+                VECTOR2D da( aPath.CPoint( aIndex ) - aCenter );
+                VECTOR2D db( aPath.CPoint( aIndex + 1 ) - aCenter );
+
+                return RAD2DEG( atan2( da.x * db.y - da.y * db.x, da.x * db.x + da.y * db.y ) );
+            };
+
+    for( int first = 0; first < count; )
+    {
+        int arcIndex = aPointArcs[first];
+        int last = first;
+
+        if( arcIndex < 0 )
+        {
+            first++;
+            continue;
+        }
+
+        VECTOR2I center = aArcs[arcIndex].GetCenter();
+        double   sweep = 0.0;
+        double   radius = ( aPath.CPoint( first ) - center ).EuclideanNorm();
+
+        while( last + 1 < count && aPointArcs[last + 1] == arcIndex )
+        {
+            double angle = stepAngle( center, last );
+
+            if( angle == 0.0 || std::abs( angle ) > maxStep || ( sweep * angle < 0.0 ) )
+                break;
+
+            sweep += angle;
+            last++;
+            radius = std::max( radius, (double) ( aPath.CPoint( last ) - center ).EuclideanNorm() );
+        }
+
+        // A single edge is just as well described by its end points
+        if( last - first >= 2 )
+        {
+            VECTOR2D d( aPath.CPoint( first ) - center );
+            VECTOR2I arcStart = center + VECTOR2I( KiROUND( d.x * radius / d.EuclideanNorm() ),
+                                                   KiROUND( d.y * radius / d.EuclideanNorm() ) );
+
+            aPath.MarkArc( first, last, SHAPE_ARC( center, arcStart, sweep ) );
+        }
+
+        first = last + 1;
+    }
+}
+
+
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
     FractureEdgeSet edges;
@@ -764,10 +862,16 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     int num_unconnected = 0;
 
+    // The arcs of all paths; edges refer to them by their index in this list
+    std::vector<SHAPE_ARC> arcs;
+
     for( const SHAPE_LINE_CHAIN& path : paths )
     {
         const std::vector<VECTOR2I>& points = path.CPoints();
         int pointCount = points.size();
+        int arcOffset = arcs.size();
+
+        arcs.insert( arcs.end(), path.CArcs().begin(), path.CArcs().end() );
 
         FractureEdge* prev = NULL, * first_edge = NULL;
 
@@ -783,8 +887,10 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         {
             // Do not use path.CPoint() here; open-coding it using the local variables "points"
             // and "pointCount" gives a non-trivial performance boost to zone fill times.
+            ssize_t arcIndex = path.ArcIndex( i );
             FractureEdge* fe = new FractureEdge( first, points[ i ],
-                                                        points[ i+1 == pointCount ? 0 : i+1 ] );
+                                                        points[ i+1 == pointCount ? 0 : i+1 ],
+                                                        arcIndex < 0 ? -1 : arcOffset + arcIndex );
 
             if( !root )
                 root = fe;
@@ -841,16 +947,38 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.SetClosed( true );
 
-    FractureEdge* e;
+    // Start at the beginning of an arc (if any), so that no arc wraps around the end
+    FractureEdge* start = root;
+
+    for( FractureEdge* e = root->m_next; e != root; e = e->m_next )
+    {
+        if( e->m_arc != start->m_arc )
+            break;
+
+        start = e;
+    }
+
+    start = start->m_next;
+
+    std::vector<int> pointArcs;
+    FractureEdge*    e = start;
 
-    for( e = root; e->m_next != root; e = e->m_next )
+    do
+    {
         newPath.Append( e->m_p1 );
 
-    newPath.Append( e->m_p1 );
+        // Append() skips duplicated points
+        if( (int) pointArcs.size() < newPath.PointCount() )
+            pointArcs.push_back( e->m_arc );
+
+        e = e->m_next;
+    } while( e != start );
 
     for( FractureEdge* edge : edges )
         delete edge;
 
+    markFracturedArcs( newPath, pointArcs, arcs );
+
     paths.push_back( std::move( newPath ) );
 }
 
@@ -41,7 +41,11 @@
 #include "ar_autoplacer.h"
 #include "ar_matrix.h"
 #include <memory>
+#include <profile.h>
 #include <ratsnest/ratsnest_data.h>
+#include <core/parallel_for.h>
+
+#include <algorithm>
 
 #define AR_GAIN            16
 #define AR_KEEPOUT_MARGIN  500
@@ -471,18 +475,17 @@ int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
+    int row, col;
+
+    // The placement maps give the first cell which is not free
+    if( m_matrix.FindBlockedCell( row_min, row_max, col_min, col_max, side, row, col ) )
     {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
+        unsigned int data = m_matrix.GetCell( row, col, side );
 
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
+        if( ( data & CELL_IS_ZONE ) == 0 )
+            return AR_OUT_OF_BOARD;
 
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
+        return AR_OCCUIPED_BY_MODULE;
     }
 
     return AR_FREE_CELL;
@@ -524,21 +527,9 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
-
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
-
-    return keepOutCost;
+    // The distance cells hold the "cost" of the cells; in autoplace this is the cost of the
+    // cells inside aRect
+    return (unsigned int) m_matrix.GetDistSum( row_min, row_max, col_min, col_max, side );
 }
 
 
@@ -546,8 +537,8 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
  * Returns the value TstRectangle().
  * Module is known by its bounding box
  */
-int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSide,
-                                         const wxPoint& aOffset )
+int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, const EDA_RECT& aFpRect,
+                                         bool TstOtherSide, const wxPoint& aOffset )
 {
     int side = AR_SIDE_TOP;
     int otherside = AR_SIDE_BOTTOM;
@@ -557,11 +548,9 @@ int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSid
         side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
     }
 
-    EDA_RECT    fpBBox = aFootprint->GetFootprintRect();
+    EDA_RECT    fpBBox = aFpRect;
     fpBBox.Move( -aOffset );
 
-    buildFpAreas( aFootprint, 0 );
-
     int diag = //testModuleByPolygon( aFootprint, side, aOffset );
         testRectangle( fpBBox, side );
 
@@ -588,7 +577,7 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
 {
     int     error = 1;
     wxPoint lastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    testOtherSide;
 
     aFootprint->CalculateBoundingBox();
@@ -596,7 +585,8 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
     lastPosOK = m_matrix.m_BrdBox.GetOrigin();
 
     wxPoint  fpPos = aFootprint->GetPosition();
-    EDA_RECT fpBBox  = aFootprint->GetFootprintRect();
+    EDA_RECT fpRect = aFootprint->GetFootprintRect();
+    EDA_RECT fpBBox = fpRect;
 
     // Move fpBBox to have the footprint position at (0,0)
     fpBBox.Move( -fpPos );
@@ -611,9 +601,6 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    wxPoint fpOffset = fpPos - m_curPosition;
-
     // Examine pads, and set testOtherSide to true if a footprint has at least 1 pad through.
     testOtherSide = false;
 
@@ -631,42 +618,61 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-
-    min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
-
+    std::vector<RATSNEST_TARGETS> ratsnestTargets = buildRatsnestTargets( aFootprint );
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    // The candidate positions are scanned column by column; each column keeps its best
+    // position, the last one of the lowest cost as in a serial scan.
+    struct COLUMN_BEST
     {
-        m_curPosition.y = initialPos.y;
+        bool    m_Found = false;
+        double  m_Cost = 0.0;
+        wxPoint m_Pos;
+    };
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    int grid = m_matrix.m_GridRouting;
+    int columnCount = std::max( 0, ( xylimit.x - initialPos.x + grid - 1 ) / grid );
+    int rowCount = std::max( 0, ( xylimit.y - initialPos.y + grid - 1 ) / grid );
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            fpOffset = fpPos - m_curPosition;
-            int keepOutCost = testFootprintOnBoard( aFootprint, testOtherSide, fpOffset );
+    std::vector<COLUMN_BEST> columns( columnCount );
 
-            if( keepOutCost >= 0 )    // i.e. if the footprint can be put here
+    ParallelFor( columns.size(),
+            [&]( size_t aColumn )
             {
-                error = 0;
-                // m_frame->build_ratsnest_footprint( aFootprint ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aFootprint, fpOffset );
-                Score       = curr_cost + keepOutCost;
+                COLUMN_BEST& best = columns[aColumn];
+                wxPoint      curPosition( initialPos.x + (int) aColumn * grid, initialPos.y );
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                for( ; curPosition.y < xylimit.y; curPosition.y += grid )
                 {
-                    lastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
+                    wxPoint fpOffset = fpPos - curPosition;
+                    int     keepOutCost = testFootprintOnBoard( aFootprint, fpRect, testOtherSide,
+                                                                fpOffset );
+
+                    if( keepOutCost >= 0 )    // i.e. if the footprint can be put here
+                    {
+                        double score = computePlacementRatsnestCost( ratsnestTargets, fpOffset )
+                                       + keepOutCost;
+
+                        if( !best.m_Found || best.m_Cost >= score )
+                        {
+                            best.m_Found = true;
+                            best.m_Cost = score;
+                            best.m_Pos = curPosition;
+                        }
+                    }
                 }
-            }
+            } );
+
+    m_stats.m_CandidateCount += (int64_t) columnCount * rowCount;
+
+    min_cost = -1.0;
+
+    for( const COLUMN_BEST& best : columns )
+    {
+        if( best.m_Found && ( min_cost >= best.m_Cost || min_cost < 0 ) )
+        {
+            error = 0;
+            lastPosOK = best.m_Pos;
+            min_cost = best.m_Cost;
         }
     }
 
@@ -678,39 +684,43 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
 }
 
 
-const PAD* AR_AUTOPLACER::nearestPad( FOOTPRINT *aRefFP, PAD* aRefPad, const wxPoint& aOffset)
+std::vector<AR_AUTOPLACER::RATSNEST_TARGETS>
+AR_AUTOPLACER::buildRatsnestTargets( FOOTPRINT* aFootprint )
 {
-    const PAD* nearest = nullptr;
-    int64_t    nearestDist = INT64_MAX;
+    std::vector<RATSNEST_TARGETS> pads;
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    for( PAD* refPad : aFootprint->Pads() )
     {
-        if ( footprint == aRefFP )
-            continue;
-
-        if( !m_matrix.m_BrdBox.Contains( footprint->GetPosition() ) )
-            continue;
+        RATSNEST_TARGETS entry;
+        entry.m_PadPos = VECTOR2I( refPad->GetPosition() );
 
-        for( PAD* pad: footprint->Pads() )
+        for( FOOTPRINT* footprint : m_board->Footprints() )
         {
-            if( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
+            if ( footprint == aFootprint )
                 continue;
 
-            auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+            if( !m_matrix.m_BrdBox.Contains( footprint->GetPosition() ) )
+                continue;
 
-            if ( dist < nearestDist )
+            for( PAD* pad: footprint->Pads() )
             {
-                nearestDist = dist;
-                nearest = pad;
+                if( pad->GetNetCode() != refPad->GetNetCode() || pad->GetNetCode() <= 0 )
+                    continue;
+
+                entry.m_Targets.emplace_back( pad->GetPosition() );
             }
         }
+
+        if( !entry.m_Targets.empty() )
+            pads.push_back( std::move( entry ) );
     }
 
-    return nearest;
+    return pads;
 }
 
 
-double AR_AUTOPLACER::computePlacementRatsnestCost( FOOTPRINT *aFootprint, const wxPoint& aOffset )
+double AR_AUTOPLACER::computePlacementRatsnestCost( const std::vector<RATSNEST_TARGETS>& aPads,
+                                                    const wxPoint& aOffset )
 {
     double  curr_cost;
     VECTOR2I start;      // start point of a ratsnest
@@ -719,19 +729,23 @@ double AR_AUTOPLACER::computePlacementRatsnestCost( FOOTPRINT *aFootprint, const
 
     curr_cost = 0;
 
-    for( PAD* pad : aFootprint->Pads() )
+    for( const RATSNEST_TARGETS& pad : aPads )
     {
-        const PAD* nearest = nearestPad( aFootprint, pad, aOffset );
+        start   = pad.m_PadPos - VECTOR2I( aOffset );
 
-        if( !nearest )
-            continue;
+        // The nearest pad of the same net
+        int64_t nearestDist = INT64_MAX;
 
-        start   = VECTOR2I( pad->GetPosition() ) - VECTOR2I(aOffset);
-        end     = VECTOR2I( nearest->GetPosition() );
+        for( const VECTOR2I& target : pad.m_Targets )
+        {
+            auto dist = ( start - target ).EuclideanNorm();
 
-        //m_overlay->SetIsStroke( true );
-        //m_overlay->SetStrokeColor( COLOR4D(0.0, 1.0, 0.0, 1.0) );
-        //m_overlay->Line( start, end );
+            if ( dist < nearestDist )
+            {
+                nearestDist = dist;
+                end = target;
+            }
+        }
 
         // Cost of the ratsnest.
         dx  = end.x - start.x;
@@ -845,6 +859,9 @@ FOOTPRINT* AR_AUTOPLACER::pickFootprint( )
 
 void AR_AUTOPLACER::drawPlacementRoutingMatrix( )
 {
+    if( !m_overlay )
+        return;
+
     // Draw the board free area
     m_overlay->Clear();
     m_overlay->SetIsFill( true );
@@ -883,6 +900,7 @@ AR_RESULT AR_AUTOPLACER::AutoplaceFootprints( std::vector<FOOTPRINT*>& aFootprin
     bool    cancelled = false;
 
     memopos = m_curPosition;
+    m_stats = AR_PLACEMENT_STATS();
 
     m_matrix.m_GridRouting = m_gridSize; //(int) m_frame->GetScreen()->GetGridSize().x;
 
@@ -913,13 +931,17 @@ AR_RESULT AR_AUTOPLACER::AutoplaceFootprints( std::vector<FOOTPRINT*>& aFootprin
     for( FOOTPRINT* footprint : aFootprints )
     {
         footprint->SetNeedsPlaced( true );
-        aCommit->Modify( footprint );
+
+        if( aCommit )
+            aCommit->Modify( footprint );
     }
 
     for( FOOTPRINT* footprint : offboardMods )
     {
         footprint->SetNeedsPlaced( true );
-        aCommit->Modify( footprint );
+
+        if( aCommit )
+            aCommit->Modify( footprint );
     }
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
@@ -958,6 +980,11 @@ AR_RESULT AR_AUTOPLACER::AutoplaceFootprints( std::vector<FOOTPRINT*>& aFootprin
 
         double initialOrient = footprint->GetOrientation();
 
+        // The matrix is modified by each placed footprint
+        m_matrix.BuildPlacementMaps( CELL_IS_ZONE, CELL_IS_MODULE );
+
+        PROF_COUNTER searchTimer;
+
         error = getOptimalFPPlacement( footprint );
         double bestScore = m_minCost;
         double bestRotation = 0.0;
@@ -1035,9 +1062,18 @@ AR_RESULT AR_AUTOPLACER::AutoplaceFootprints( std::vector<FOOTPRINT*>& aFootprin
 
 end_of_tst:
 
+        m_stats.m_SearchTime += searchTimer.msecs();
+
         if( error == AR_ABORT_PLACEMENT )
             break;
 
+        if( bestScore < 0 )
+            m_stats.m_NoFreePositionCount++;
+        else
+            m_stats.m_TotalCost += bestScore;
+
+        m_stats.m_PlacedCount++;
+
 
         bestRotation += initialOrient;
 
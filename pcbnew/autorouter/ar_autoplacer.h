@@ -52,6 +52,18 @@ enum AR_RESULT
     AR_FAILURE
 };
 
+/**
+ * Metrics of an autoplace run.
+ */
+struct AR_PLACEMENT_STATS
+{
+    int     m_PlacedCount = 0;          ///< footprints placed
+    int     m_NoFreePositionCount = 0;  ///< footprints placed without a free position
+    int64_t m_CandidateCount = 0;       ///< positions evaluated, for all the orientations
+    double  m_SearchTime = 0.0;         ///< time spent evaluating positions, in ms
+    double  m_TotalCost = 0.0;          ///< sum of the costs of the chosen positions
+};
+
 class PROGRESS_REPORTER;
 
 class AR_AUTOPLACER
@@ -59,9 +71,24 @@ class AR_AUTOPLACER
 public:
     AR_AUTOPLACER( BOARD* aBoard );
 
+    /**
+     * Place \a aFootprints (and the footprints outside the board if \a aPlaceOffboardModules)
+     * on the board.
+     *
+     * @param aCommit stores the modified footprints.  Can be nullptr to modify the board
+     *                without undo, e.g. when running without a frame.
+     */
     AR_RESULT AutoplaceFootprints( std::vector<FOOTPRINT*>& aFootprints, BOARD_COMMIT* aCommit,
                                    bool aPlaceOffboardModules = false );
 
+    /**
+     * @return the metrics of the last AutoplaceFootprints() run.
+     */
+    const AR_PLACEMENT_STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
     /**
      * Set a VIEW overlay to draw items during a autoplace session.
      */
@@ -85,6 +112,13 @@ public:
     }
 
 private:
+    /// A pad of the footprint to place, and the positions of the pads it can connect to
+    struct RATSNEST_TARGETS
+    {
+        VECTOR2I              m_PadPos;
+        std::vector<VECTOR2I> m_Targets;
+    };
+
     void drawPlacementRoutingMatrix();  // draw the working area (shows free and occupied areas)
     void rotateFootprint( FOOTPRINT* aFootprint, double angle, bool incremental );
     int genPlacementRoutingMatrix();
@@ -97,9 +131,16 @@ private:
 
     int testRectangle( const EDA_RECT& aRect, int side );
     unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
-    int testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSide, const wxPoint& aOffset );
+    int testFootprintOnBoard( FOOTPRINT* aFootprint, const EDA_RECT& aFpRect, bool TstOtherSide,
+                              const wxPoint& aOffset );
+
+    /**
+     * Search the best position of \a aFootprint in its current orientation.  The candidate
+     * positions are evaluated in parallel.
+     */
     int getOptimalFPPlacement( FOOTPRINT* aFootprint );
-    double computePlacementRatsnestCost( FOOTPRINT* aFootprint, const wxPoint& aOffset );
+    double computePlacementRatsnestCost( const std::vector<RATSNEST_TARGETS>& aPads,
+                                         const wxPoint& aOffset );
 
     /**
      * Find the "best" footprint place. The criteria are:
@@ -110,7 +151,11 @@ private:
 
     void placeFootprint( FOOTPRINT* aFootprint, bool aDoNotRecreateRatsnest, const wxPoint& aPos );
 
-    const PAD* nearestPad( FOOTPRINT* aRefFP, PAD* aRefPad, const wxPoint& aOffset );
+    /**
+     * Collect, for each pad of \a aFootprint, the pads of the same net in the other footprints
+     * of the board area, which the ratsnest cost is computed with.
+     */
+    std::vector<RATSNEST_TARGETS> buildRatsnestTargets( FOOTPRINT* aFootprint );
 
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void addFpBody( wxPoint aStart, wxPoint aEnd, LSET aLayerMask );
@@ -139,6 +184,7 @@ private:
     std::unique_ptr<CONNECTIVITY_DATA>          m_connectivity;
     std::function<int( FOOTPRINT* aFootprint )> m_refreshCallback;
     PROGRESS_REPORTER*                          m_progressReporter;
+    AR_PLACEMENT_STATS                          m_stats;
 };
 
 #endif
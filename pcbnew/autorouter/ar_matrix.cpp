@@ -48,6 +48,7 @@ AR_MATRIX::AR_MATRIX()
     m_RouteCount         = 0;
     m_routeLayerBottom   = B_Cu;
     m_routeLayerTop      = F_Cu;
+    m_blockedWordsPerRow = 0;
 }
 
 
@@ -144,6 +145,9 @@ void AR_MATRIX::UnInitRoutingMatrix()
             delete[] m_BoardSide[ii];
             m_BoardSide[ii] = nullptr;
         }
+
+        m_blockedCells[ii].clear();
+        m_distSums[ii].clear();
     }
 
     m_Nrows = m_Ncols = 0;
@@ -250,6 +254,99 @@ void AR_MATRIX::SetDist( int aRow, int aCol, int aSide, DIST_CELL x )
 }
 
 
+void AR_MATRIX::BuildPlacementMaps( MATRIX_CELL aFreeMask, MATRIX_CELL aOccupiedMask )
+{
+    m_blockedWordsPerRow = ( m_Ncols + 63 ) / 64;
+
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        m_blockedCells[side].clear();
+        m_distSums[side].clear();
+
+        if( !m_BoardSide[side] || !m_DistSide[side] )
+            continue;
+
+        m_blockedCells[side].assign( (size_t) m_Nrows * m_blockedWordsPerRow, 0 );
+        m_distSums[side].assign( (size_t) ( m_Nrows + 1 ) * ( m_Ncols + 1 ), 0 );
+
+        for( int row = 0; row < m_Nrows; row++ )
+        {
+            const MATRIX_CELL* cells = m_BoardSide[side] + row * m_Ncols;
+            const DIST_CELL*   dists = m_DistSide[side] + row * m_Ncols;
+            uint64_t*          blocked = &m_blockedCells[side][row * m_blockedWordsPerRow];
+            int64_t*           sums = &m_distSums[side][( row + 1 ) * ( m_Ncols + 1 )];
+            const int64_t*     sumsAbove = sums - ( m_Ncols + 1 );
+            int64_t            rowSum = 0;
+
+            for( int col = 0; col < m_Ncols; col++ )
+            {
+                if( !( cells[col] & aFreeMask ) || ( cells[col] & aOccupiedMask ) )
+                    blocked[col / 64] |= uint64_t( 1 ) << ( col % 64 );
+
+                rowSum += dists[col];
+                sums[col + 1] = sumsAbove[col + 1] + rowSum;
+            }
+        }
+    }
+}
+
+
+bool AR_MATRIX::FindBlockedCell( int aRowMin, int aRowMax, int aColMin, int aColMax, int aSide,
+                                 int& aRow, int& aCol ) const
+{
+    if( aRowMin > aRowMax || aColMin > aColMax )
+        return false;
+
+    int      firstWord = aColMin / 64;
+    int      lastWord = aColMax / 64;
+    uint64_t firstMask = ~uint64_t( 0 ) << ( aColMin % 64 );
+    uint64_t lastMask = ~uint64_t( 0 ) >> ( 63 - aColMax % 64 );
+
+    for( int row = aRowMin; row <= aRowMax; row++ )
+    {
+        const uint64_t* blocked = &m_blockedCells[aSide][row * m_blockedWordsPerRow];
+
+        for( int word = firstWord; word <= lastWord; word++ )
+        {
+            uint64_t bits = blocked[word];
+
+            if( word == firstWord )
+                bits &= firstMask;
+
+            if( word == lastWord )
+                bits &= lastMask;
+
+            if( bits )
+            {
+                aRow = row;
+                aCol = word * 64;
+
+                for( ; !( bits & 1 ); bits >>= 1 )
+                    aCol++;
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+int64_t AR_MATRIX::GetDistSum( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                               int aSide ) const
+{
+    if( aRowMin > aRowMax || aColMin > aColMax )
+        return 0;
+
+    const int64_t* sums = m_distSums[aSide].data();
+    int            stride = m_Ncols + 1;
+
+    return sums[( aRowMax + 1 ) * stride + aColMax + 1] - sums[aRowMin * stride + aColMax + 1]
+           - sums[( aRowMax + 1 ) * stride + aColMin] + sums[aRowMin * stride + aColMin];
+}
+
+
 /*
 ** x is the direction to enter the cell of interest.
 ** y is the direction to exit the cell of interest.
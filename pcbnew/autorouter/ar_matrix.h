@@ -32,6 +32,9 @@
 #include <eda_rect.h>
 #include <layers_id_colors_and_visibility.h>
 
+#include <cstdint>
+#include <vector>
+
 class PCB_SHAPE;
 class TRACK;
 class PAD;
@@ -69,6 +72,11 @@ private:
     // a pointer to the current selected cell operation
     void ( AR_MATRIX::*m_opWriteCell )( int aRow, int aCol, int aSide, MATRIX_CELL aCell );
 
+    // The placement maps, see BuildPlacementMaps()
+    std::vector<uint64_t> m_blockedCells[AR_MAX_ROUTING_LAYERS_COUNT];  // 1 bit per cell
+    std::vector<int64_t>  m_distSums[AR_MAX_ROUTING_LAYERS_COUNT];      // (m_Nrows+1)*(m_Ncols+1)
+    int                   m_blockedWordsPerRow;
+
 public:
     enum CELL_OP
     {
@@ -130,6 +138,31 @@ public:
     DIST_CELL   GetDist( int aRow, int aCol, int aSide );
     void        SetDist( int aRow, int aCol, int aSide, DIST_CELL );
 
+    /**
+     * Function BuildPlacementMaps
+     * packs the cells which cannot hold a footprint in one bit per cell, and builds the
+     * summed area table of the distance cells, used by FindBlockedCell() and GetDistSum().
+     * Must be called again after the cells are modified.
+     * @param aFreeMask are the cell bits which must be set for a free cell.
+     * @param aOccupiedMask are the cell bits which must be cleared for a free cell.
+     */
+    void BuildPlacementMaps( MATRIX_CELL aFreeMask, MATRIX_CELL aOccupiedMask );
+
+    /**
+     * Function FindBlockedCell
+     * searches the cells of a rectangle, row by row, for the first one which is not free,
+     * testing 64 cells at a time.
+     * @return true if a cell was found, and its position in \a aRow and \a aCol.
+     */
+    bool FindBlockedCell( int aRowMin, int aRowMax, int aColMin, int aColMax, int aSide,
+                          int& aRow, int& aCol ) const;
+
+    /**
+     * Function GetDistSum
+     * @return the sum of the distance cells of a rectangle, in constant time.
+     */
+    int64_t GetDistSum( int aRowMin, int aRowMax, int aColMin, int aColMax, int aSide ) const;
+
     void TraceSegmentPcb( PCB_SHAPE* pt_segm, int color, int marge, AR_MATRIX::CELL_OP op_logic );
 
     void CreateKeepOutRectangle( int ux0, int uy0, int ux1, int uy1, int marge, int aKeepOut,
@@ -46,8 +46,9 @@ BOARD_COMMIT::BOARD_COMMIT( PCB_TOOL_BASE* aTool )
 
 BOARD_COMMIT::BOARD_COMMIT( EDA_DRAW_FRAME* aFrame )
 {
-    m_toolMgr = aFrame->GetToolManager();
-    m_isFootprintEditor = aFrame->IsType( FRAME_FOOTPRINT_EDITOR );
+    // Without a frame the commit cannot be pushed, e.g. in netlist update dry runs
+    m_toolMgr = aFrame ? aFrame->GetToolManager() : nullptr;
+    m_isFootprintEditor = aFrame && aFrame->IsType( FRAME_FOOTPRINT_EDITOR );
 }
 
 
@@ -189,9 +189,18 @@ public:
         return m_itemMap.find( aItem ) != m_itemMap.end();
     }
 
-    ITEM_MAP_ENTRY& ItemEntry( const BOARD_CONNECTED_ITEM* aItem )
+    /**
+     * @return the connectivity items of \a aItem, or an empty entry if \a aItem is not in the
+     *         connectivity (e.g. a preview item).  Never modifies the map, so that it can be
+     *         called from several threads (e.g. painters).
+     */
+    const ITEM_MAP_ENTRY& ItemEntry( const BOARD_CONNECTED_ITEM* aItem ) const
     {
-        return m_itemMap[ aItem ];
+        static const ITEM_MAP_ENTRY emptyEntry;
+
+        auto it = m_itemMap.find( aItem );
+
+        return it != m_itemMap.end() ? it->second : emptyEntry;
     }
 
     bool IsNetDirty( int aNet ) const
@@ -344,7 +344,7 @@ void CONNECTIVITY_DATA::PropagateNets()
 bool CONNECTIVITY_DATA::IsConnectedOnLayer( const BOARD_CONNECTED_ITEM *aItem, int aLayer,
                                             std::vector<KICAD_T> aTypes ) const
 {
-    CN_CONNECTIVITY_ALGO::ITEM_MAP_ENTRY &entry = m_connAlgo->ItemEntry( aItem );
+    const CN_CONNECTIVITY_ALGO::ITEM_MAP_ENTRY& entry = m_connAlgo->ItemEntry( aItem );
 
     auto matchType = [&]( KICAD_T aItemType )
     {
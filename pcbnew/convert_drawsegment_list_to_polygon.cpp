@@ -37,6 +37,8 @@
 
 #include <wx/log.h>
 
+#include <mutex>
+
 
 /**
  * Flag to enable debug tracing for the board outline creation
@@ -47,6 +49,12 @@
  */
 const wxChar* traceBoardOutline = wxT( "KICAD_BOARD_OUTLINE" );
 
+/**
+ * The SKIP_STRUCT flag of the shapes marks the ones already used by an outline, so outlines
+ * must not be built from several threads at the same time (e.g. when plotting layers).
+ */
+static std::mutex s_outlineConversionLock;
+
 /**
  * Function close_ness
  * is a non-exact distance (also called Manhattan distance) used to approximate
@@ -194,6 +202,8 @@ bool ConvertOutlineToPolygon( std::vector<PCB_SHAPE*>& aSegList, SHAPE_POLY_SET&
     if( aSegList.size() == 0 )
         return true;
 
+    std::lock_guard<std::mutex> lock( s_outlineConversionLock );
+
     bool polygonComplete = false;
 
     wxString   msg;
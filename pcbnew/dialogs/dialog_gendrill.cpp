@@ -90,6 +90,7 @@ bool DIALOG_GENDRILL::m_Merge_PTH_NPTH  = false;    // Only for Excellon format
 int DIALOG_GENDRILL::m_mapFileType      = 1;
 int DIALOG_GENDRILL::m_drillFileType    = 0;
 bool DIALOG_GENDRILL::m_UseRouteModeForOvalHoles = true;    // Use G00 route mode to "drill" oval holes
+bool DIALOG_GENDRILL::m_OptimizeDrillPath = false;
 
 DIALOG_GENDRILL::~DIALOG_GENDRILL()
 {
@@ -105,6 +106,7 @@ void DIALOG_GENDRILL::initDialog()
     m_Mirror                   = cfg->m_GenDrill.mirror;
     m_UnitDrillIsInch          = cfg->m_GenDrill.unit_drill_is_inch;
     m_UseRouteModeForOvalHoles = cfg->m_GenDrill.use_route_for_oval_holes;
+    m_OptimizeDrillPath        = cfg->m_GenDrill.optimize_path;
     m_drillFileType            = cfg->m_GenDrill.drill_file_type;
     m_mapFileType              = cfg->m_GenDrill.map_file_type;
     m_ZerosFormat              = cfg->m_GenDrill.zeros_format;
@@ -133,6 +135,7 @@ void DIALOG_GENDRILL::InitDisplayParams()
     m_Check_Merge_PTH_NPTH->SetValue( m_Merge_PTH_NPTH );
     m_Choice_Drill_Map->SetSelection( m_mapFileType );
     m_radioBoxOvalHoleMode->SetSelection( m_UseRouteModeForOvalHoles ? 0 : 1 );
+    m_Check_Optimize_Path->SetValue( m_OptimizeDrillPath );
 
     m_platedPadsHoleCount    = 0;
     m_notplatedPadsHoleCount = 0;
@@ -232,6 +235,7 @@ void DIALOG_GENDRILL::UpdateConfig()
     cfg->m_GenDrill.mirror                   = m_Mirror;
     cfg->m_GenDrill.unit_drill_is_inch       = m_UnitDrillIsInch;
     cfg->m_GenDrill.use_route_for_oval_holes = m_UseRouteModeForOvalHoles;
+    cfg->m_GenDrill.optimize_path            = m_OptimizeDrillPath;
     cfg->m_GenDrill.drill_file_type          = m_drillFileType;
     cfg->m_GenDrill.map_file_type            = m_mapFileType;
     cfg->m_GenDrill.zeros_format             = m_ZerosFormat;
@@ -333,6 +337,7 @@ void DIALOG_GENDRILL::UpdateDrillParams()
     m_Merge_PTH_NPTH = m_Check_Merge_PTH_NPTH->IsChecked();
     m_ZerosFormat = m_Choice_Zeros_Format->GetSelection();
     m_UseRouteModeForOvalHoles = m_radioBoxOvalHoleMode->GetSelection() == 0;
+    m_OptimizeDrillPath = m_Check_Optimize_Path->IsChecked();
 
     if( m_Choice_Drill_Offset->GetSelection() == 0 )
         m_FileDrillOffset = wxPoint( 0, 0 );
@@ -388,6 +393,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
                                   m_Precision.m_Lhs, m_Precision.m_Rhs );
         excellonWriter.SetOptions( m_Mirror, m_MinimalHeader, m_FileDrillOffset, m_Merge_PTH_NPTH );
         excellonWriter.SetRouteModeForOvalHoles( m_UseRouteModeForOvalHoles );
+        excellonWriter.SetOptimizeDrillPathOption( m_OptimizeDrillPath );
         excellonWriter.SetMapFileFormat( filefmt[choice] );
 
         excellonWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(), aGenDrill, aGenMap,
@@ -401,6 +407,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
         // the integer part precision is always 4, and units always mm
         gerberWriter.SetFormat( m_plotOpts.GetGerberPrecision() );
         gerberWriter.SetOptions( m_FileDrillOffset );
+        gerberWriter.SetOptimizeDrillPathOption( m_OptimizeDrillPath );
         gerberWriter.SetMapFileFormat( filefmt[choice] );
 
         gerberWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(),
@@ -438,11 +445,13 @@ void DIALOG_GENDRILL::OnGenReportFile( wxCommandEvent& event )
     {
         EXCELLON_WRITER excellonWriter( m_board );
         excellonWriter.SetMergeOption( m_Merge_PTH_NPTH );
+        excellonWriter.SetOptimizeDrillPathOption( m_OptimizeDrillPath );
         success = excellonWriter.GenDrillReportFile( dlg.GetPath() );
     }
     else
     {
         GERBER_WRITER gerberWriter( m_board );
+        gerberWriter.SetOptimizeDrillPathOption( m_OptimizeDrillPath );
         success = gerberWriter.GenDrillReportFile( dlg.GetPath() );
     }
 
@@ -87,6 +87,11 @@ DIALOG_GENDRILL_BASE::DIALOG_GENDRILL_BASE( wxWindow* parent, wxWindowID id, con
 
 	bMiddleSizer->Add( m_Choice_Drill_Map, 0, wxALL|wxEXPAND, 5 );
 
+	m_Check_Optimize_Path = new wxCheckBox( this, wxID_ANY, _("Optimize drill path"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_Check_Optimize_Path->SetToolTip( _("Order the holes of each tool to shorten the travel of the drill head.") );
+
+	bMiddleSizer->Add( m_Check_Optimize_Path, 0, wxALL, 5 );
+
 
 	bmiddlerSizer->Add( bMiddleSizer, 1, wxEXPAND, 5 );
 
@@ -51,6 +51,7 @@ class DIALOG_GENDRILL_BASE : public DIALOG_SHIM
 		wxRadioBox* m_radioBoxOvalHoleMode;
 		wxRadioButton* m_rbGerberX2;
 		wxRadioBox* m_Choice_Drill_Map;
+		wxCheckBox* m_Check_Optimize_Path;
 		wxRadioBox* m_Choice_Drill_Offset;
 		wxRadioBox* m_Choice_Unit;
 		wxRadioBox* m_Choice_Zeros_Format;
@@ -32,7 +32,6 @@
 #include <reporter.h>
 #include <wildcards_and_files_ext.h>
 #include <layers_id_colors_and_visibility.h>
-#include <locale_io.h>
 #include <bitmaps.h>
 #include <board.h>
 #include <dialog_plot.h>
@@ -857,6 +856,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<PLOT_LAYER_JOB> jobs;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -882,30 +883,29 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
+        PLOT_LAYER_JOB job;
+        job.m_Layer = layer;
+        job.m_FileName = fn.GetFullPath();
+        jobs.push_back( job );
+    }
 
-        PLOTTER* plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    PlotBoardLayers( board, &m_plotOpts, jobs );
 
-        // Print diags in messages box:
+    // Print diags in messages box:
+    for( const PLOT_LAYER_JOB& job : jobs )
+    {
         wxString msg;
 
-        if( plotter )
+        if( job.m_Plotted )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter->RenderSettings();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), fn.GetFullPath() );
+            msg.Printf( _( "Plot file \"%s\" created." ), job.m_FileName );
             reporter.Report( msg, RPT_SEVERITY_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file \"%s\"." ), fn.GetFullPath() );
+            msg.Printf( _( "Unable to create file \"%s\"." ), job.m_FileName );
             reporter.Report( msg, RPT_SEVERITY_ERROR );
         }
-
-        wxSafeYield();      // displays report message.
     }
 
     if( m_plotOpts.GetFormat() == PLOT_FORMAT::GERBER && m_plotOpts.GetCreateGerberJobFile() )
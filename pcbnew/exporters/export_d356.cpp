@@ -40,10 +40,12 @@
 #include <board.h>
 #include <footprint.h>
 #include <track.h>
+#include <memory>
 #include <vector>
 #include <cctype>
 #include <math/util.h>      // for KiROUND
 #include <export_d356.h>
+#include <exporters/fabrication_view.h>
 
 
 
@@ -90,51 +92,51 @@ static int iu_to_d356(int iu, int clamp)
 }
 
 /* Extract the D356 record from the footprints (pads) */
-static void build_pad_testpoints( BOARD *aPcb, std::vector <D356_RECORD>& aRecords )
+static void build_pad_testpoints( const FABRICATION_VIEW& aView,
+                                  std::vector <D356_RECORD>& aRecords )
 {
-    wxPoint origin = aPcb->GetDesignSettings().m_AuxOrigin;
+    BOARD*  pcb = aView.GetBoard();
+    wxPoint origin = pcb->GetDesignSettings().m_AuxOrigin;
 
-    for( FOOTPRINT* footprint : aPcb->Footprints() )
+    for( const FAB_PAD& fabPad : aView.Pads() )
     {
-        for( PAD* pad : footprint->Pads() )
+        PAD*        pad = fabPad.m_Pad;
+        D356_RECORD rk;
+        rk.access = compute_pad_access_code( pcb, fabPad.m_CopperLayers );
+
+        // It could be a mask only pad, we only handle pads with copper here
+        if( rk.access != -1 )
         {
-            D356_RECORD rk;
-            rk.access = compute_pad_access_code( aPcb, pad->GetLayerSet() );
-
-            // It could be a mask only pad, we only handle pads with copper here
-            if( rk.access != -1 )
-            {
-                rk.netname = pad->GetNetname();
-                rk.pin = pad->GetName();
-                rk.refdes = footprint->GetReference();
-                rk.midpoint = false; // XXX MAYBE need to be computed (how?)
-                const wxSize& drill = pad->GetDrillSize();
-                rk.drill = std::min( drill.x, drill.y );
-                rk.hole = (rk.drill != 0);
-                rk.smd = pad->GetAttribute() == PAD_ATTRIB_SMD;
-                rk.mechanical = ( pad->GetAttribute() == PAD_ATTRIB_NPTH );
-                rk.x_location = pad->GetPosition().x - origin.x;
-                rk.y_location = origin.y - pad->GetPosition().y;
-                rk.x_size = pad->GetSize().x;
-
-                // Rule: round pads have y = 0
-                if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-                    rk.y_size = 0;
-                else
-                    rk.y_size = pad->GetSize().y;
-
-                rk.rotation = -KiROUND( pad->GetOrientation() ) / 10;
-                if( rk.rotation < 0 ) rk.rotation += 360;
-
-                // the value indicates which sides are *not* accessible
-                rk.soldermask = 3;
-                if( pad->GetLayerSet()[F_Mask] )
-                    rk.soldermask &= ~1;
-                if( pad->GetLayerSet()[B_Mask] )
-                    rk.soldermask &= ~2;
-
-                aRecords.push_back( rk );
-            }
+            rk.netname = fabPad.m_Netname;
+            rk.pin = fabPad.m_Name;
+            rk.refdes = aView.GetFootprint( fabPad ).m_Reference;
+            rk.midpoint = false; // XXX MAYBE need to be computed (how?)
+            const wxSize& drill = pad->GetDrillSize();
+            rk.drill = std::min( drill.x, drill.y );
+            rk.hole = (rk.drill != 0);
+            rk.smd = pad->GetAttribute() == PAD_ATTRIB_SMD;
+            rk.mechanical = ( pad->GetAttribute() == PAD_ATTRIB_NPTH );
+            rk.x_location = fabPad.m_Position.x - origin.x;
+            rk.y_location = origin.y - fabPad.m_Position.y;
+            rk.x_size = pad->GetSize().x;
+
+            // Rule: round pads have y = 0
+            if( pad->GetShape() == PAD_SHAPE_CIRCLE )
+                rk.y_size = 0;
+            else
+                rk.y_size = pad->GetSize().y;
+
+            rk.rotation = -KiROUND( pad->GetOrientation() ) / 10;
+            if( rk.rotation < 0 ) rk.rotation += 360;
+
+            // the value indicates which sides are *not* accessible
+            rk.soldermask = 3;
+            if( fabPad.m_FrontMask )
+                rk.soldermask &= ~1;
+            if( fabPad.m_BackMask )
+                rk.soldermask &= ~2;
+
+            aRecords.push_back( rk );
         }
     }
 }
@@ -163,45 +165,32 @@ static int via_access_code( BOARD *aPcb, int top_layer, int bottom_layer )
 }
 
 /* Extract the D356 record from the vias */
-static void build_via_testpoints( BOARD *aPcb, std::vector <D356_RECORD>& aRecords )
+static void build_via_testpoints( const FABRICATION_VIEW& aView,
+                                  std::vector <D356_RECORD>& aRecords )
 {
-    wxPoint origin = aPcb->GetDesignSettings().m_AuxOrigin;
+    BOARD*  pcb = aView.GetBoard();
+    wxPoint origin = pcb->GetDesignSettings().m_AuxOrigin;
 
-    // Enumerate all the track segments and keep the vias
-    for( auto track : aPcb->Tracks() )
+    for( const FAB_VIA& via : aView.Vias() )
     {
-        if( track->Type() == PCB_VIA_T )
-        {
-            VIA *via = (VIA*) track;
-            NETINFO_ITEM *net = track->GetNet();
-
-            D356_RECORD rk;
-            rk.smd = false;
-            rk.hole = true;
-            if( net )
-                rk.netname = net->GetNetname();
-            else
-                rk.netname = wxEmptyString;
-            rk.refdes = wxT("VIA");
-            rk.pin = wxT("");
-            rk.midpoint = true; // Vias are always midpoints
-            rk.drill = via->GetDrillValue();
-            rk.mechanical = false;
-
-            PCB_LAYER_ID top_layer, bottom_layer;
-
-            via->LayerPair( &top_layer, &bottom_layer );
-
-            rk.access = via_access_code( aPcb, top_layer, bottom_layer );
-            rk.x_location = via->GetPosition().x - origin.x;
-            rk.y_location = origin.y - via->GetPosition().y;
-            rk.x_size = via->GetWidth();
-            rk.y_size = 0; // Round so height = 0
-            rk.rotation = 0;
-            rk.soldermask = 3; // XXX always tented?
-
-            aRecords.push_back( rk );
-        }
+        D356_RECORD rk;
+        rk.smd = false;
+        rk.hole = true;
+        rk.netname = via.m_Netname;
+        rk.refdes = wxT("VIA");
+        rk.pin = wxT("");
+        rk.midpoint = true; // Vias are always midpoints
+        rk.drill = via.m_Drill;
+        rk.mechanical = false;
+        rk.access = via_access_code( pcb, via.m_TopLayer, via.m_BottomLayer );
+        rk.x_location = via.m_Position.x - origin.x;
+        rk.y_location = origin.y - via.m_Position.y;
+        rk.x_size = via.m_Width;
+        rk.y_size = 0; // Round so height = 0
+        rk.rotation = 0;
+        rk.soldermask = 3; // XXX always tented?
+
+        aRecords.push_back( rk );
     }
 }
 
@@ -340,12 +329,22 @@ void IPC356D_WRITER::Write( const wxString& aFilename )
         return;
     }
 
+    // Extract the pads and vias, unless they are shared with other exporters
+    std::unique_ptr<FABRICATION_VIEW> ownView;
+    const FABRICATION_VIEW*           view = m_view;
+
+    if( !view )
+    {
+        ownView.reset( new FABRICATION_VIEW( m_pcb ) );
+        view = ownView.get();
+    }
+
     // This will contain everything needed for the 356 file
     std::vector<D356_RECORD> d356_records;
 
-    build_via_testpoints( m_pcb, d356_records );
+    build_via_testpoints( *view, d356_records );
 
-    build_pad_testpoints( m_pcb, d356_records );
+    build_pad_testpoints( *view, d356_records );
 
     // Code 00 AFAIK is ASCII, CUST 0 is decimils/degrees
     // CUST 1 would be metric but gerbtool simply ignores it!
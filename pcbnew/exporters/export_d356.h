@@ -22,6 +22,7 @@
 
 class BOARD;
 class wxWindow;
+class FABRICATION_VIEW;
 
 
 /* Structure for holding the D-356 record fields.
@@ -59,7 +60,7 @@ public:
      * @param aParent will be used as the parent for any warning dialogs
      */
     IPC356D_WRITER( BOARD* aPcb, wxWindow* aParent = nullptr ) :
-            m_pcb( aPcb ), m_parent( aParent )
+            m_pcb( aPcb ), m_parent( aParent ), m_view( nullptr )
     {}
 
     virtual ~IPC356D_WRITER() {}
@@ -70,9 +71,16 @@ public:
      */
     void Write( const wxString& aFilename );
 
+    /**
+     * Use the pads and vias of \a aView, shared with other exporters, instead of extracting
+     * them from the board.  The view must be kept alive until the file is written.
+     */
+    void SetFabricationView( const FABRICATION_VIEW* aView ) { m_view = aView; }
+
 private:
-    BOARD*    m_pcb;
-    wxWindow* m_parent;
+    BOARD*                  m_pcb;
+    wxWindow*               m_parent;
+    const FABRICATION_VIEW* m_view;
 
     /// Writes a list of records to the given output stream
     void write_D356_records( std::vector<D356_RECORD> &aRecords, FILE* aFile );
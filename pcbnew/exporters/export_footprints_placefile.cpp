@@ -30,15 +30,18 @@
 #include <locale_io.h>
 #include <build_version.h>
 #include <export_footprints_placefile.h>
+#include <exporters/fabrication_view.h>
+
+#include <memory>
 
 
 class LIST_MOD      // An helper class used to build a list of useful footprints.
 {
 public:
-    FOOTPRINT*    m_Footprint;      // Link to the actual footprint
-    wxString      m_Reference;      // Its schematic reference
-    wxString      m_Value;          // Its schematic value
-    LAYER_NUM     m_Layer;          // its side (B_Cu, or F_Cu)
+    const FAB_FOOTPRINT* m_Footprint;   // Link to the footprint data
+    wxString             m_Reference;   // Its schematic reference
+    wxString             m_Value;       // Its schematic value
+    LAYER_NUM            m_Layer;       // its side (B_Cu, or F_Cu)
 };
 
 
@@ -87,6 +90,21 @@ PLACE_FILE_EXPORTER::PLACE_FILE_EXPORTER( BOARD* aBoard, bool aUnitsMM, bool aEx
         m_side = PCB_NO_SIDE;
 
     m_formatCSV = aFormatCSV;
+    m_view = nullptr;
+}
+
+
+/**
+ * @return \a aView, or a view of \a aBoard owned by \a aOwnView if \a aView is null.
+ */
+static const FABRICATION_VIEW* getView( BOARD* aBoard, const FABRICATION_VIEW* aView,
+                                        std::unique_ptr<FABRICATION_VIEW>& aOwnView )
+{
+    if( aView )
+        return aView;
+
+    aOwnView.reset( new FABRICATION_VIEW( aBoard ) );
+    return aOwnView.get();
 }
 
 
@@ -110,37 +128,41 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
     double conv_unit = m_unitsMM ? conv_unit_mm : conv_unit_inch;
     const char *unit_text = m_unitsMM ? unit_text_mm : unit_text_inch;
 
+    std::unique_ptr<FABRICATION_VIEW> ownView;
+    const FABRICATION_VIEW*           view = getView( m_board, m_view, ownView );
+
     // Build and sort the list of footprints alphabetically
     std::vector<LIST_MOD> list;
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    for( const FAB_FOOTPRINT& footprint : view->Footprints() )
     {
         if( m_side != PCB_BOTH_SIDES )
         {
-            if( footprint->GetLayer() == B_Cu && m_side != PCB_BACK_SIDE )
+            if( footprint.m_Layer == B_Cu && m_side != PCB_BACK_SIDE )
                 continue;
-            if( footprint->GetLayer() == F_Cu && m_side != PCB_FRONT_SIDE )
+            if( footprint.m_Layer == F_Cu && m_side != PCB_FRONT_SIDE )
                 continue;
         }
 
-        if( footprint->GetAttributes() & FP_EXCLUDE_FROM_POS_FILES )
+        if( footprint.m_Attributes & FP_EXCLUDE_FROM_POS_FILES )
             continue;
 
-        if( m_excludeAllTH && footprint->HasThroughHolePads() )
+        if( m_excludeAllTH && footprint.m_HasThroughHolePads )
             continue;
 
         m_fpCount++;
 
         LIST_MOD item;
-        item.m_Footprint    = footprint;
-        item.m_Reference = footprint->Reference().GetShownText();
-        item.m_Value     = footprint->Value().GetShownText();
-        item.m_Layer     = footprint->GetLayer();
+        item.m_Footprint    = &footprint;
+        item.m_Reference = footprint.m_ShownReference;
+        item.m_Value     = footprint.m_ShownValue;
+        item.m_Layer     = footprint.m_Layer;
         list.push_back( item );
 
         lenRefText = std::max( lenRefText, (int) item.m_Reference.length() );
         lenValText = std::max( lenValText, (int) item.m_Value.length() );
-        lenPkgText = std::max( lenPkgText, (int) item.m_Footprint->GetFPID().GetLibItemName().length() );
+        lenPkgText = std::max( lenPkgText,
+                               (int) footprint.m_Footprint->GetFPID().GetLibItemName().length() );
     }
 
     if( list.size() > 1 )
@@ -162,10 +184,10 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
         for( int ii = 0; ii < m_fpCount; ii++ )
         {
             wxPoint  footprint_pos;
-            footprint_pos  = list[ii].m_Footprint->GetPosition();
+            footprint_pos  = list[ii].m_Footprint->m_Position;
             footprint_pos -= m_place_Offset;
 
-            LAYER_NUM layer = list[ii].m_Footprint->GetLayer();
+            LAYER_NUM layer = list[ii].m_Layer;
             wxASSERT( layer == F_Cu || layer == B_Cu );
 
             if( layer == B_Cu )
@@ -175,7 +197,7 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
             tmp << "\"" << csv_sep;
             tmp << "\"" << list[ii].m_Value;
             tmp << "\"" << csv_sep;
-            tmp << "\"" << list[ii].m_Footprint->GetFPID().GetLibItemName().wx_str();
+            tmp << "\"" << list[ii].m_Footprint->m_Footprint->GetFPID().GetLibItemName().wx_str();
             tmp << "\"" << csv_sep;
 
             tmp << wxString::Format( "%f%c%f%c%f",
@@ -183,7 +205,7 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
                                     // Keep the Y axis oriented from bottom to top,
                                     // ( change y coordinate sign )
                                     -footprint_pos.y * conv_unit, csv_sep,
-                                     list[ii].m_Footprint->GetOrientation() / 10.0 );
+                                     list[ii].m_Footprint->m_Orientation / 10.0 );
             tmp << csv_sep;
 
             tmp << ( (layer == F_Cu ) ? PLACE_FILE_EXPORTER::GetFrontSideName()
@@ -228,10 +250,10 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
         for( int ii = 0; ii < m_fpCount; ii++ )
         {
             wxPoint  footprint_pos;
-            footprint_pos  = list[ii].m_Footprint->GetPosition();
+            footprint_pos  = list[ii].m_Footprint->m_Position;
             footprint_pos -= m_place_Offset;
 
-            LAYER_NUM layer = list[ii].m_Footprint->GetLayer();
+            LAYER_NUM layer = list[ii].m_Layer;
             wxASSERT( layer == F_Cu || layer == B_Cu );
 
             if( layer == B_Cu )
@@ -239,7 +261,7 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
 
             wxString ref = list[ii].m_Reference;
             wxString val = list[ii].m_Value;
-            wxString pkg = list[ii].m_Footprint->GetFPID().GetLibItemName();
+            wxString pkg = list[ii].m_Footprint->m_Footprint->GetFPID().GetLibItemName();
             ref.Replace( wxT( " " ), wxT( "_" ) );
             val.Replace( wxT( " " ), wxT( "_" ) );
             pkg.Replace( wxT( " " ), wxT( "_" ) );
@@ -251,7 +273,7 @@ std::string PLACE_FILE_EXPORTER::GenPositionData()
                     // Keep the coordinates in the first quadrant,
                     // (i.e. change y sign
                     -footprint_pos.y * conv_unit,
-                    list[ii].m_Footprint->GetOrientation() / 10.0,
+                    list[ii].m_Footprint->m_Orientation / 10.0,
                     (layer == F_Cu ) ? GetFrontSideName().c_str() : GetBackSideName().c_str() );
             buffer += line;
         }
@@ -303,26 +325,29 @@ std::string PLACE_FILE_EXPORTER::GenReportData()
 
     buffer += "$EndBOARD\n\n";
 
-    std::vector<FOOTPRINT*> sortedFootprints;
+    std::unique_ptr<FABRICATION_VIEW> ownView;
+    const FABRICATION_VIEW*           view = getView( m_board, m_view, ownView );
+    std::vector<const FAB_FOOTPRINT*> sortedFootprints;
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
-        sortedFootprints.push_back( footprint );
+    for( const FAB_FOOTPRINT& footprint : view->Footprints() )
+        sortedFootprints.push_back( &footprint );
 
     std::sort( sortedFootprints.begin(), sortedFootprints.end(),
-               []( FOOTPRINT* a, FOOTPRINT* b ) -> bool
+               []( const FAB_FOOTPRINT* a, const FAB_FOOTPRINT* b ) -> bool
                {
-                   return StrNumCmp( a->GetReference(), b->GetReference(), true ) < 0;
+                   return StrNumCmp( a->m_Reference, b->m_Reference, true ) < 0;
                });
 
-    for( FOOTPRINT* footprint : sortedFootprints )
+    for( const FAB_FOOTPRINT* fabFootprint : sortedFootprints )
     {
-        wxString ref = footprint->Reference().GetShownText();
+        FOOTPRINT* footprint = fabFootprint->m_Footprint;
+        wxString   ref = fabFootprint->m_ShownReference;
 
         sprintf( line, "$MODULE %s\n", TO_UTF8( ref ) );
         buffer += line;
 
         sprintf( line, "reference %s\n", TO_UTF8( ref ) );
-        sprintf( line, "value %s\n", EscapedUTF8( footprint->Value().GetShownText() ).c_str() );
+        sprintf( line, "value %s\n", EscapedUTF8( fabFootprint->m_ShownValue ).c_str() );
         sprintf( line, "footprint %s\n", footprint->GetFPID().Format().c_str() );
         buffer += line;
 
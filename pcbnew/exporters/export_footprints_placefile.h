@@ -28,6 +28,8 @@
 #include <board.h>
 #include <footprint.h>
 
+class FABRICATION_VIEW;
+
 /**
  * The ASCII format of the kicad place file is:
  *      ### Module positions - created on 04/12/2012 15:24:24 ###
@@ -77,6 +79,12 @@ public:
      */
     std::string GenReportData();
 
+    /**
+     * Use the footprints of \a aView, shared with other exporters, instead of extracting them
+     * from the board.  The view must be kept alive until the data is generated.
+     */
+    void SetFabricationView( const FABRICATION_VIEW* aView ) { m_view = aView; }
+
     /** @return the footprint count found on board by GenPositionData()
      * must be called only after GenPositionData() is run
      */
@@ -95,6 +103,8 @@ private:
     bool    m_formatCSV;      // true for csv format, false for ascii (utf8) format
     int     m_fpCount;        // Number of footprints in list, for info
     wxPoint m_place_Offset;   // Offset for coordinates in generated data.
+
+    const FABRICATION_VIEW* m_view;   // Shared footprint data, or nullptr
 };
 
 #endif      // #ifndef EXPORT_FOOTPRINTS_PLACEFILE_H
@@ -37,6 +37,7 @@
 #include <confirm.h>
 #include <core/arraydim.h>
 #include <dialogs/dialog_gencad_export_options.h>
+#include <exporters/fabrication_view.h>
 #include <locale_io.h>
 #include <hash_eda.h>
 #include <pcb_edit_frame.h>
@@ -51,7 +52,7 @@ static void CreateBoardSection( FILE* aFile, BOARD* aPcb );
 static void CreateComponentsSection( FILE* aFile, BOARD* aPcb );
 static void CreateDevicesSection( FILE* aFile, BOARD* aPcb );
 static void CreateRoutesSection( FILE* aFile, BOARD* aPcb );
-static void CreateSignalsSection( FILE* aFile, BOARD* aPcb );
+static void CreateSignalsSection( FILE* aFile, const FABRICATION_VIEW& aView );
 static void CreateShapesSection( FILE* aFile, BOARD* aPcb );
 static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb );
 static void FootprintWriteShape( FILE* File, FOOTPRINT* aFootprint, const wxString& aShapeName );
@@ -305,7 +306,7 @@ void PCB_EDIT_FRAME::ExportToGenCAD( wxCommandEvent& aEvent )
     CreateDevicesSection( file, pcb );
 
     // In a similar way the netlist is split in net, track and route
-    CreateSignalsSection( file, pcb );
+    CreateSignalsSection( file, FABRICATION_VIEW( pcb ) );
     CreateTracksInfoData( file, pcb );
     CreateRoutesSection( file, pcb );
 
@@ -873,17 +874,18 @@ static void CreateComponentsSection( FILE* aFile, BOARD* aPcb )
 
 /* Emit the netlist (which is actually the thing for which GenCAD is used these
  * days!); tracks are handled later */
-static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
+static void CreateSignalsSection( FILE* aFile, const FABRICATION_VIEW& aView )
 {
+    BOARD*        pcb = aView.GetBoard();
     wxString      msg;
     NETINFO_ITEM* net;
     int           NbNoConn = 1;
 
     fputs( "$SIGNALS\n", aFile );
 
-    for( unsigned ii = 0; ii < aPcb->GetNetCount(); ii++ )
+    for( unsigned ii = 0; ii < pcb->GetNetCount(); ii++ )
     {
-        net = aPcb->FindNet( ii );
+        net = pcb->FindNet( ii );
 
         if( net->GetNetname() == wxEmptyString ) // dummy netlist (no connection)
         {
@@ -898,20 +900,16 @@ static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
         fputs( TO_UTF8( msg ), aFile );
         fputs( "\n", aFile );
 
-        for( FOOTPRINT* footprint : aPcb->Footprints() )
+        for( size_t padId : aView.PadsInNet( net->GetNet() ) )
         {
-            for( PAD* pad : footprint->Pads() )
-            {
-                if( pad->GetNetCode() != net->GetNet() )
-                    continue;
+            const FAB_PAD& pad = aView.Pads()[padId];
 
-                msg.Printf( wxT( "NODE \"%s\" \"%s\"" ),
-                            escapeString( footprint->GetReference() ),
-                            escapeString( pad->GetName() ) );
+            msg.Printf( wxT( "NODE \"%s\" \"%s\"" ),
+                        escapeString( aView.GetFootprint( pad ).m_Reference ),
+                        escapeString( pad.m_Name ) );
 
-                fputs( TO_UTF8( msg ), aFile );
-                fputs( "\n", aFile );
-            }
+            fputs( TO_UTF8( msg ), aFile );
+            fputs( "\n", aFile );
         }
     }
 
@@ -29,12 +29,16 @@
 #include <track.h>
 #include <zone.h>
 #include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <ki_exception.h>
 #include <locale_io.h>
 #include <reporter.h>
 
 #include <exporters/board_exporter_base.h>
+#include <exporters/fabrication_view.h>
 
 static double iu2hyp( double iu )
 {
@@ -144,12 +148,21 @@ private:
 class HYPERLYNX_EXPORTER : public BOARD_EXPORTER_BASE
 {
 public:
-    HYPERLYNX_EXPORTER() : m_polyId( 1 )
+    HYPERLYNX_EXPORTER() : m_view( nullptr ), m_polyId( 1 )
     {
     }
 
     ~HYPERLYNX_EXPORTER(){};
 
+    /**
+     * Use the pads and vias of \a aView, shared with other exporters, instead of extracting
+     * them from the board.
+     */
+    void SetFabricationView( const FABRICATION_VIEW* aView )
+    {
+        m_view = aView;
+    }
+
     virtual bool Run() override;
 
 private:
@@ -216,6 +229,13 @@ private:
     std::vector<HYPERLYNX_PAD_STACK*>           m_padStacks;
     std::map<BOARD_ITEM*, HYPERLYNX_PAD_STACK*> m_padMap;
 
+    const FABRICATION_VIEW*                     m_view;
+    std::unique_ptr<FABRICATION_VIEW>           m_ownView;
+
+    /// Copper tracks, vias and zones by net, in board order; the null nets are all in net 0
+    std::unordered_map<int, std::vector<BOARD_ITEM*>> m_netTracks;
+    std::unordered_map<int, std::vector<BOARD_ITEM*>> m_netZones;
+
 
     std::shared_ptr<FILE_OUTPUTFORMATTER> m_out;
     int                                   m_polyId;
@@ -384,10 +404,10 @@ bool HYPERLYNX_EXPORTER::writeDevices()
 {
     m_out->Print( 0, "{DEVICES\n" );
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    for( const FAB_FOOTPRINT& footprint : m_view->Footprints() )
     {
-        wxString ref = footprint->GetReference();
-        wxString layerName = m_board->GetLayerName( footprint->GetLayer() );
+        wxString ref = footprint.m_Reference;
+        wxString layerName = m_board->GetLayerName( footprint.m_Layer );
 
         if( ref.IsEmpty() )
             ref = "EMPTY";
@@ -403,22 +423,16 @@ bool HYPERLYNX_EXPORTER::writeDevices()
 
 bool HYPERLYNX_EXPORTER::writePadStacks()
 {
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    for( const FAB_PAD& pad : m_view->Pads() )
     {
-        for( PAD* pad : footprint->Pads() )
-        {
-            HYPERLYNX_PAD_STACK* ps = addPadStack( HYPERLYNX_PAD_STACK( m_board, pad ) );
-            m_padMap[pad] = ps;
-        }
+        HYPERLYNX_PAD_STACK* ps = addPadStack( HYPERLYNX_PAD_STACK( m_board, pad.m_Pad ) );
+        m_padMap[pad.m_Pad] = ps;
     }
 
-    for( TRACK* trk : m_board->Tracks() )
+    for( const FAB_VIA& via : m_view->Vias() )
     {
-        if( VIA* via = dyn_cast<VIA*>( trk ) )
-        {
-            HYPERLYNX_PAD_STACK* ps = addPadStack( HYPERLYNX_PAD_STACK( m_board, via ) );
-            m_padMap[via] = ps;
-        }
+        HYPERLYNX_PAD_STACK* ps = addPadStack( HYPERLYNX_PAD_STACK( m_board, via.m_Via ) );
+        m_padMap[via.m_Via] = ps;
     }
 
     for( HYPERLYNX_PAD_STACK* pstack : m_padStacks )
@@ -535,39 +549,37 @@ const std::vector<BOARD_ITEM*> HYPERLYNX_EXPORTER::collectNetObjects( int netcod
 {
     std::vector<BOARD_ITEM*> rv;
 
-    auto check =
-            [&]( BOARD_CONNECTED_ITEM* item ) -> bool
-            {
-                if( ( item->GetLayerSet() & LSET::AllCuMask() ).none() )
-                    return false;
-
-                if( item->GetNetCode() == netcode || ( netcode < 0 && item->GetNetCode() <= 0 ) )
-                    return true;
-
-                return false;
-            };
-
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    if( netcode < 0 )
     {
-        for( PAD* pad : footprint->Pads() )
+        for( const FAB_PAD& pad : m_view->Pads() )
         {
-            if( check( pad ) )
-                rv.push_back( pad );
+            if( pad.m_NetCode <= 0 && pad.m_CopperLayers.any() )
+                rv.push_back( pad.m_Pad );
         }
     }
-
-    for( TRACK* item : m_board->Tracks() )
+    else
     {
-        if( check( item ) )
-            rv.push_back( item );
-    }
+        for( size_t padId : m_view->PadsInNet( netcode ) )
+        {
+            const FAB_PAD& pad = m_view->Pads()[padId];
 
-    for( ZONE* zone : m_board->Zones() )
-    {
-        if( check( zone ) )
-            rv.push_back( zone );
+            if( pad.m_CopperLayers.any() )
+                rv.push_back( pad.m_Pad );
+        }
     }
 
+    auto append =
+            [&]( const std::unordered_map<int, std::vector<BOARD_ITEM*>>& aMap )
+            {
+                auto it = aMap.find( std::max( netcode, 0 ) );
+
+                if( it != aMap.end() )
+                    rv.insert( rv.end(), it->second.begin(), it->second.end() );
+            };
+
+    append( m_netTracks );
+    append( m_netZones );
+
     return rv;
 }
 
@@ -576,6 +588,23 @@ bool HYPERLYNX_EXPORTER::writeNets()
 {
     m_polyId = 1;
 
+    // Sort the copper items by net once, instead of scanning the board for each net
+    auto addItem =
+            [&]( std::unordered_map<int, std::vector<BOARD_ITEM*>>& aMap,
+                 BOARD_CONNECTED_ITEM* aItem )
+            {
+                if( ( aItem->GetLayerSet() & LSET::AllCuMask() ).none() )
+                    return;
+
+                aMap[ std::max( aItem->GetNetCode(), 0 ) ].push_back( aItem );
+            };
+
+    for( TRACK* item : m_board->Tracks() )
+        addItem( m_netTracks, item );
+
+    for( ZONE* zone : m_board->Zones() )
+        addItem( m_netZones, zone );
+
     for( const auto netInfo : m_board->GetNetInfo() )
     {
         int netcode = netInfo->GetNet();
@@ -614,6 +643,12 @@ bool HYPERLYNX_EXPORTER::Run()
 {
     LOCALE_IO toggle; // toggles on, then off, the C locale.
 
+    if( !m_view )
+    {
+        m_ownView.reset( new FABRICATION_VIEW( m_board ) );
+        m_view = m_ownView.get();
+    }
+
     try
     {
         m_out.reset( new FILE_OUTPUTFORMATTER( m_outputFilePath.GetFullPath() ) );
@@ -634,10 +669,12 @@ bool HYPERLYNX_EXPORTER::Run()
 }
 
 
-bool ExportBoardToHyperlynx( BOARD* aBoard, const wxFileName& aPath )
+bool ExportBoardToHyperlynx( BOARD* aBoard, const wxFileName& aPath,
+                             const FABRICATION_VIEW* aView )
 {
     HYPERLYNX_EXPORTER exporter;
     exporter.SetBoard( aBoard );
+    exporter.SetFabricationView( aView );
     exporter.SetOutputFilename( aPath );
     return exporter.Run();
 }
@@ -0,0 +1,139 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board.h>
+#include <footprint.h>
+#include <pad.h>
+#include <track.h>
+#include <core/parallel_for.h>
+
+#include <exporters/fabrication_view.h>
+
+#include <algorithm>
+
+
+FABRICATION_VIEW::FABRICATION_VIEW( BOARD* aBoard ) :
+        m_board( aBoard )
+{
+    build();
+}
+
+
+const std::vector<size_t>& FABRICATION_VIEW::PadsInNet( int aNetCode ) const
+{
+    static const std::vector<size_t> noPads;
+
+    auto it = m_padsByNet.find( aNetCode );
+
+    return it != m_padsByNet.end() ? it->second : noPads;
+}
+
+
+void FABRICATION_VIEW::build()
+{
+    std::vector<FOOTPRINT*> footprints( m_board->Footprints().begin(),
+                                        m_board->Footprints().end() );
+    std::vector<VIA*>       vias;
+    size_t                  padCount = 0;
+
+    // The pad ranges are known beforehand, so that each footprint can be filled independently
+    m_footprints.resize( footprints.size() );
+
+    for( size_t ii = 0; ii < footprints.size(); ++ii )
+    {
+        m_footprints[ii].m_FirstPad = padCount;
+        m_footprints[ii].m_PadCount = footprints[ii]->Pads().size();
+        padCount += m_footprints[ii].m_PadCount;
+    }
+
+    m_pads.resize( padCount );
+
+    for( TRACK* track : m_board->Tracks() )
+    {
+        if( VIA* via = dyn_cast<VIA*>( track ) )
+            vias.push_back( via );
+    }
+
+    m_vias.resize( vias.size() );
+
+    // Footprints and vias are handed out in a single sequence: footprints first
+    size_t itemCount = footprints.size() + vias.size();
+
+    ParallelFor( itemCount,
+            [&]( size_t aItemId )
+            {
+                if( aItemId < footprints.size() )
+                {
+                    FOOTPRINT*     footprint = footprints[aItemId];
+                    FAB_FOOTPRINT& fp = m_footprints[aItemId];
+
+                    fp.m_Footprint = footprint;
+                    fp.m_Reference = footprint->GetReference();
+                    fp.m_ShownReference = footprint->Reference().GetShownText();
+                    fp.m_ShownValue = footprint->Value().GetShownText();
+                    fp.m_Position = footprint->GetPosition();
+                    fp.m_Orientation = footprint->GetOrientation();
+                    fp.m_Layer = footprint->GetLayer();
+                    fp.m_Attributes = footprint->GetAttributes();
+                    fp.m_HasThroughHolePads = false;
+
+                    size_t padId = fp.m_FirstPad;
+
+                    for( PAD* pad : footprint->Pads() )
+                    {
+                        FAB_PAD& fabPad = m_pads[padId++];
+                        LSET     layers = pad->GetLayerSet();
+
+                        fabPad.m_Pad = pad;
+                        fabPad.m_Footprint = aItemId;
+                        fabPad.m_Name = pad->GetName();
+                        fabPad.m_Netname = pad->GetNetname();
+                        fabPad.m_NetCode = pad->GetNetCode();
+                        fabPad.m_Position = pad->GetPosition();
+                        fabPad.m_CopperLayers = layers & LSET::AllCuMask();
+                        fabPad.m_FrontMask = layers[F_Mask];
+                        fabPad.m_BackMask = layers[B_Mask];
+
+                        if( pad->GetAttribute() != PAD_ATTRIB_SMD )
+                            fp.m_HasThroughHolePads = true;
+                    }
+                }
+                else
+                {
+                    size_t   viaId = aItemId - footprints.size();
+                    VIA*     via = vias[viaId];
+                    FAB_VIA& fabVia = m_vias[viaId];
+
+                    fabVia.m_Via = via;
+                    fabVia.m_Netname = via->GetNetname();
+                    fabVia.m_NetCode = via->GetNetCode();
+                    fabVia.m_Position = via->GetPosition();
+                    via->LayerPair( &fabVia.m_TopLayer, &fabVia.m_BottomLayer );
+                    fabVia.m_Width = via->GetWidth();
+                    fabVia.m_Drill = via->GetDrillValue();
+                }
+            } );
+
+    for( size_t ii = 0; ii < m_pads.size(); ++ii )
+        m_padsByNet[ m_pads[ii].m_NetCode ].push_back( ii );
+}
@@ -0,0 +1,139 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fabrication_view.h
+ * @brief Footprints, pads and vias of a board, as needed by the fabrication exporters.
+ */
+
+#ifndef FABRICATION_VIEW_H
+#define FABRICATION_VIEW_H
+
+#include <layers_id_colors_and_visibility.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+class BOARD;
+class FOOTPRINT;
+class PAD;
+class VIA;
+
+
+#ifndef SWIG
+/// A footprint, with the range of its pads in FABRICATION_VIEW::Pads()
+struct FAB_FOOTPRINT
+{
+    FOOTPRINT*   m_Footprint;
+    wxString     m_Reference;           ///< Reference, as stored
+    wxString     m_ShownReference;      ///< Reference, with the text variables expanded
+    wxString     m_ShownValue;          ///< Value, with the text variables expanded
+    wxPoint      m_Position;            ///< Placement position (the footprint anchor)
+    double       m_Orientation;         ///< In 0.1 degrees
+    PCB_LAYER_ID m_Layer;
+    int          m_Attributes;
+    bool         m_HasThroughHolePads;
+    size_t       m_FirstPad;
+    size_t       m_PadCount;
+};
+
+
+struct FAB_PAD
+{
+    PAD*     m_Pad;
+    size_t   m_Footprint;               ///< Index in FABRICATION_VIEW::Footprints()
+    wxString m_Name;
+    wxString m_Netname;
+    int      m_NetCode;
+    wxPoint  m_Position;
+    LSET     m_CopperLayers;            ///< Copper layers of the pad, enabled or not
+    bool     m_FrontMask;               ///< True if the front solder mask is open
+    bool     m_BackMask;                ///< True if the back solder mask is open
+};
+
+
+struct FAB_VIA
+{
+    VIA*         m_Via;
+    wxString     m_Netname;
+    int          m_NetCode;
+    wxPoint      m_Position;
+    PCB_LAYER_ID m_TopLayer;
+    PCB_LAYER_ID m_BottomLayer;
+    int          m_Width;
+    int          m_Drill;
+};
+#endif
+
+
+/**
+ * The footprints, pads and vias of a board, as needed by the fabrication exporters (IPC-D-356,
+ * position files, GenCAD, Hyperlynx).
+ *
+ * The view is built once, in parallel, and can be shared by several exporters run on an
+ * unchanged board.  It is a snapshot: it must be rebuilt when the board is modified.
+ */
+class FABRICATION_VIEW
+{
+public:
+    FABRICATION_VIEW( BOARD* aBoard );
+
+    BOARD* GetBoard() const { return m_board; }
+
+#ifndef SWIG
+    /// Footprints, in board order
+    const std::vector<FAB_FOOTPRINT>& Footprints() const { return m_footprints; }
+
+    /// Pads, in board order and grouped by footprint
+    const std::vector<FAB_PAD>& Pads() const { return m_pads; }
+
+    /// Vias, in board order
+    const std::vector<FAB_VIA>& Vias() const { return m_vias; }
+
+    /**
+     * @return the indices in Pads() of the pads of net \a aNetCode, in board order.
+     */
+    const std::vector<size_t>& PadsInNet( int aNetCode ) const;
+
+    const FAB_FOOTPRINT& GetFootprint( const FAB_PAD& aPad ) const
+    {
+        return m_footprints[aPad.m_Footprint];
+    }
+#endif
+
+private:
+    void build();
+
+    BOARD*                                          m_board;
+#ifndef SWIG
+    std::vector<FAB_FOOTPRINT>                      m_footprints;
+    std::vector<FAB_PAD>                            m_pads;
+    std::vector<FAB_VIA>                            m_vias;
+    std::unordered_map<int, std::vector<size_t>>    m_padsByNet;
+#endif
+};
+
+#endif  // FABRICATION_VIEW_H
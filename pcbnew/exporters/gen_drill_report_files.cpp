@@ -387,6 +387,7 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
             out.Print( 0, separator );
             totalHoleCount = printToolSummary( out, false );
             out.Print( 0, "    Total plated holes count %u\n", totalHoleCount );
+            printDrillPathLength( out );
         }
         else    // blind/buried
         {
@@ -402,6 +403,7 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
             out.Print( 0, separator );
             totalHoleCount = printToolSummary( out, false );
             out.Print( 0, "    Total plated holes count %u\n", totalHoleCount );
+            printDrillPathLength( out );
         }
 
         out.Print( 0, "\n\n" );
@@ -426,6 +428,7 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
     out.Print( 0, separator );
     totalHoleCount = printToolSummary( out, true );
     out.Print( 0, "    Total unplated holes count %u\n", totalHoleCount );
+    printDrillPathLength( out );
 
     return true;
 }
@@ -460,6 +463,18 @@ bool GENDRILL_WRITER_BASE::plotDrillMarks( PLOTTER* aPlotter )
 }
 
 
+void GENDRILL_WRITER_BASE::printDrillPathLength( OUTPUTFORMATTER& out ) const
+{
+    if( !m_optimizeDrillPath )
+        return;
+
+    out.Print( 0, "    Drill path length %.2fmm  %.3f\"  (%.2fmm  %.3f\" before optimization)\n",
+               diameter_in_mm( m_drillPathLength ), diameter_in_inches( m_drillPathLength ),
+               diameter_in_mm( m_initialDrillPathLength ),
+               diameter_in_inches( m_initialDrillPathLength ) );
+}
+
+
 unsigned GENDRILL_WRITER_BASE::printToolSummary( OUTPUTFORMATTER& out, bool aSummaryNPTH ) const
 {
     unsigned totalHoleCount = 0;
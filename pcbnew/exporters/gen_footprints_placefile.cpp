@@ -42,6 +42,7 @@
 #include <wx_html_report_panel.h>
 #include <dialog_gen_footprint_position_file_base.h>
 #include <export_footprints_placefile.h>
+#include <exporters/fabrication_view.h>
 #include "gerber_placefile_writer.h"
 
 
@@ -322,10 +323,14 @@ bool DIALOG_GEN_FOOTPRINT_POSITION::CreateAsciiFiles()
     int top_side = true;
     int bottom_side = true;
 
+    // The footprints are extracted once for all the files
+    FABRICATION_VIEW view( brd );
+
     // Test for any footprint candidate in list.
     {
         PLACE_FILE_EXPORTER exporter( brd, UnitsMM(), ExcludeAllTH(), top_side, bottom_side,
                                       useCSVfmt );
+        exporter.SetFabricationView( &view );
         exporter.GenPositionData();
 
         if( exporter.GetFootprintCount() == 0 )
@@ -376,7 +381,7 @@ bool DIALOG_GEN_FOOTPRINT_POSITION::CreateAsciiFiles()
 
     int fpcount = m_parent->DoGenFootprintsPositionFile( fn.GetFullPath(), UnitsMM(),
                                                          ExcludeAllTH(), top_side, bottom_side,
-                                                         useCSVfmt );
+                                                         useCSVfmt, &view );
     if( fpcount < 0 )
     {
         msg.Printf( _( "Unable to create \"%s\"." ), fn.GetFullPath() );
@@ -418,7 +423,7 @@ bool DIALOG_GEN_FOOTPRINT_POSITION::CreateAsciiFiles()
         fn.SetExt( FootprintPlaceFileExtension );
 
     fpcount = m_parent->DoGenFootprintsPositionFile( fn.GetFullPath(), UnitsMM(), ExcludeAllTH(),
-                                                     top_side, bottom_side, useCSVfmt );
+                                                     top_side, bottom_side, useCSVfmt, &view );
 
     if( fpcount < 0 )
     {
@@ -464,7 +469,8 @@ int PCB_EDITOR_CONTROL::GeneratePosFile( const TOOL_EVENT& aEvent )
 
 int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName, bool aUnitsMM,
                                                  bool aForceSmdItems, bool aTopSide,
-                                                 bool aBottomSide, bool aFormatCSV )
+                                                 bool aBottomSide, bool aFormatCSV,
+                                                 const FABRICATION_VIEW* aView )
 {
     FILE * file = NULL;
 
@@ -479,6 +485,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
     std::string data;
     PLACE_FILE_EXPORTER exporter( GetBoard(), aUnitsMM, aForceSmdItems, aTopSide, aBottomSide,
                                   aFormatCSV );
+    exporter.SetFabricationView( aView );
     data = exporter.GenPositionData();
 
     // if aFullFileName is empty, the file is not created, only the
@@ -28,8 +28,13 @@
 #include <track.h>
 #include <collectors.h>
 #include <reporter.h>
+#include <core/parallel_for.h>
 
 #include <gendrill_file_writer_base.h>
+#include <gendrill_path_optimizer.h>
+
+#include <algorithm>
+#include <numeric>
 
 
 /* Helper function for sorting hole list.
@@ -175,6 +180,70 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
         if( m_holeListBuffer[ii].m_Hole_Shape )
             m_toolListBuffer.back().m_OvalCount++;
     }
+
+    if( m_optimizeDrillPath )
+        optimizeDrillPath();
+}
+
+
+void GENDRILL_WRITER_BASE::optimizeDrillPath()
+{
+    // Ranges of hits drilled in one run: the round holes of a tool, then its slots
+    std::vector<std::pair<size_t, size_t>> runs;
+    auto                                   begin = m_holeListBuffer.begin();
+
+    for( size_t first = 0; first < m_holeListBuffer.size(); )
+    {
+        int    tool = m_holeListBuffer[first].m_Tool_Reference;
+        size_t end = first;
+
+        while( end < m_holeListBuffer.size() && m_holeListBuffer[end].m_Tool_Reference == tool )
+            end++;
+
+        size_t slots = std::stable_partition( begin + first, begin + end,
+                                              []( const HOLE_INFO& aHole )
+                                              {
+                                                  return aHole.m_Hole_Shape == 0;
+                                              } ) - begin;
+
+        if( slots > first )
+            runs.emplace_back( first, slots );
+
+        if( end > slots )
+            runs.emplace_back( slots, end );
+
+        first = end;
+    }
+
+    std::vector<double> initialLengths( runs.size(), 0.0 );
+    std::vector<double> lengths( runs.size(), 0.0 );
+
+    ParallelFor( runs.size(),
+            [&]( size_t aRunId )
+            {
+                size_t                 first = runs[aRunId].first;
+                std::vector<HOLE_INFO> holes( begin + first, begin + runs[aRunId].second );
+                std::vector<wxPoint>   hits;
+
+                for( const HOLE_INFO& hole : holes )
+                    hits.push_back( hole.m_Hole_Pos );
+
+                std::vector<int> order = OptimizeDrillPath( hits );
+
+                for( size_t jj = 0; jj < order.size(); ++jj )
+                    m_holeListBuffer[first + jj] = holes[order[jj]];
+
+                initialLengths[aRunId] = DrillPathLength( hits );
+
+                for( size_t jj = 0; jj < order.size(); ++jj )
+                    hits[jj] = holes[order[jj]].m_Hole_Pos;
+
+                lengths[aRunId] = DrillPathLength( hits );
+            } );
+
+    m_initialDrillPathLength = std::accumulate( initialLengths.begin(), initialLengths.end(),
+                                                0.0 );
+    m_drillPathLength = std::accumulate( lengths.begin(), lengths.end(), 0.0 );
 }
 
 
@@ -143,6 +143,11 @@ protected:
                                                         // Excellon/Gerber units (i.e inches or mm)
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizeDrillPath;       // True to order the hits of each tool
+                                                        // to shorten the drill path
+    double                   m_drillPathLength;         // Length of the drill path of the
+                                                        // hole list, when optimized
+    double                   m_initialDrillPathLength;  // The same, before optimization
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
@@ -154,13 +159,16 @@ protected:
     // Use derived classes to build a fully initialized GENDRILL_WRITER_BASE class.
     GENDRILL_WRITER_BASE( BOARD* aPcb )
     {
-        m_pcb             = aPcb;
-        m_conversionUnits = 1.0;
-        m_unitsMetric     = true;
-        m_mapFileFmt      = PLOT_FORMAT::PDF;
-        m_pageInfo        = NULL;
-        m_merge_PTH_NPTH  = false;
-        m_zeroFormat      = DECIMAL_FORMAT;
+        m_pcb                    = aPcb;
+        m_conversionUnits        = 1.0;
+        m_unitsMetric            = true;
+        m_mapFileFmt             = PLOT_FORMAT::PDF;
+        m_pageInfo               = NULL;
+        m_merge_PTH_NPTH         = false;
+        m_optimizeDrillPath      = false;
+        m_drillPathLength        = 0.0;
+        m_initialDrillPathLength = 0.0;
+        m_zeroFormat             = DECIMAL_FORMAT;
     }
 
 public:
@@ -175,6 +183,13 @@ public:
      */
     void SetMergeOption( bool aMerge ) { m_merge_PTH_NPTH = aMerge; }
 
+    /**
+     * set the option to order the hits of each tool to shorten the path of the drill
+     * (the default is to sort them by X then Y position)
+     * @param aOptimize = true to optimize the drill path
+     */
+    void SetOptimizeDrillPathOption( bool aOptimize ) { m_optimizeDrillPath = aOptimize; }
+
     /**
      * Return the plot offset (usually the position
      * of the auxiliary axis
@@ -280,7 +295,8 @@ protected:
     /**
      * Function BuildHolesList
      * Create the list of holes and tools for a given board
-     * The list is sorted by increasing drill size.
+     * The list is sorted by increasing drill size, then by position or, if the drill path
+     * optimization is enabled, along a short drill path.
      * Only holes included within aLayerPair are listed.
      * If aLayerPair identifies with [F_Cu, B_Cu], then
      * pad holes are always included also.
@@ -293,6 +309,14 @@ protected:
     void buildHolesList( DRILL_LAYER_PAIR aLayerPair,
                          bool aGenerateNPTH_list );
 
+    /**
+     * Reorder the hits of each tool in the hole list to shorten the path of the drill, and
+     * store the path length before and after in m_initialDrillPathLength and
+     * m_drillPathLength.  The round holes of a tool are moved before its slots, as they
+     * are drilled separately.  Tools are optimized in parallel.
+     */
+    void optimizeDrillPath();
+
     int  getHolesCount() const { return m_holeListBuffer.size(); }
 
     /** Helper function.
@@ -316,6 +340,13 @@ protected:
      */
     unsigned printToolSummary( OUTPUTFORMATTER& aOut, bool aSummaryNPTH ) const;
 
+    /**
+     * prints the length of the drill path of the hole list, before and after optimization,
+     * if the path is optimized.
+     * @param aOut = the current OUTPUTFORMATTER to print summary
+     */
+    void printDrillPathLength( OUTPUTFORMATTER& aOut ) const;
+
     /**
      * minor helper function.
      * @return a string from aPair to identify the layer layer pair.
@@ -0,0 +1,450 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+
+#include <gendrill_path_optimizer.h>
+
+
+/// Count of the nearest hits a hit can be linked to by a move
+static const int NEIGHBOUR_COUNT = 8;
+
+/// Longest run of hits moved by an Or-opt move
+static const int MAX_OR_OPT_LENGTH = 3;
+
+/// Moves shortening the path by less than this (in IU) are ignored, to not loop on rounding
+/// errors
+static const double MIN_GAIN = 1.0;
+
+
+static double hitDistance( const wxPoint& aA, const wxPoint& aB )
+{
+    return std::hypot( (double) aA.x - aB.x, (double) aA.y - aB.y );
+}
+
+
+double DrillPathLength( const std::vector<wxPoint>& aHits )
+{
+    double length = 0.0;
+
+    for( size_t ii = 1; ii < aHits.size(); ++ii )
+        length += hitDistance( aHits[ii - 1], aHits[ii] );
+
+    return length;
+}
+
+
+/**
+ * @return the distance of (aX, aY) along a Hilbert curve filling a 65536 x 65536 square.
+ */
+static uint64_t hilbertDistance( uint32_t aX, uint32_t aY )
+{
+    const uint32_t n = 1 << 16;
+    uint64_t       d = 0;
+
+    for( uint32_t s = n / 2; s > 0; s /= 2 )
+    {
+        uint32_t rx = ( aX & s ) > 0;
+        uint32_t ry = ( aY & s ) > 0;
+
+        d += (uint64_t) s * s * ( ( 3 * rx ) ^ ry );
+
+        // Rotate the quadrant to the orientation of the curve in it
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                aX = n - 1 - aX;
+                aY = n - 1 - aY;
+            }
+
+            std::swap( aX, aY );
+        }
+    }
+
+    return d;
+}
+
+
+/**
+ * @return the indices of \a aHits, sorted along a Hilbert curve filling their bounding box.
+ */
+static std::vector<int> hilbertOrder( const std::vector<wxPoint>& aHits )
+{
+    double xmin = aHits[0].x;
+    double ymin = aHits[0].y;
+    double xmax = xmin;
+    double ymax = ymin;
+
+    for( const wxPoint& hit : aHits )
+    {
+        xmin = std::min<double>( xmin, hit.x );
+        ymin = std::min<double>( ymin, hit.y );
+        xmax = std::max<double>( xmax, hit.x );
+        ymax = std::max<double>( ymax, hit.y );
+    }
+
+    double                scale = 65535.0 / std::max( { xmax - xmin, ymax - ymin, 1.0 } );
+    std::vector<uint64_t> keys( aHits.size() );
+
+    for( size_t ii = 0; ii < aHits.size(); ++ii )
+    {
+        keys[ii] = hilbertDistance( (uint32_t) ( ( aHits[ii].x - xmin ) * scale ),
+                                    (uint32_t) ( ( aHits[ii].y - ymin ) * scale ) );
+    }
+
+    std::vector<int> order( aHits.size() );
+    std::iota( order.begin(), order.end(), 0 );
+
+    std::stable_sort( order.begin(), order.end(),
+                      [&]( int a, int b )
+                      {
+                          return keys[a] < keys[b];
+                      } );
+
+    return order;
+}
+
+
+/**
+ * @return the NEIGHBOUR_COUNT nearest hits of each hit, nearest first, padded with -1 when
+ *         there are not enough hits.
+ */
+static std::vector<int> nearestHits( const std::vector<wxPoint>& aHits )
+{
+    const int        count = (int) aHits.size();
+    std::vector<int> byX( count );
+
+    std::iota( byX.begin(), byX.end(), 0 );
+
+    std::sort( byX.begin(), byX.end(),
+               [&]( int a, int b )
+               {
+                   return aHits[a].x < aHits[b].x
+                          || ( aHits[a].x == aHits[b].x && aHits[a].y < aHits[b].y );
+               } );
+
+    std::vector<int>                   neighbours( (size_t) count * NEIGHBOUR_COUNT, -1 );
+    std::vector<std::pair<double, int>> nearest;     // squared distance, hit
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        const wxPoint& hit = aHits[byX[ii]];
+
+        nearest.clear();
+
+        // Returns false when the hits further away along X cannot be nearer
+        auto consider = [&]( int aOther ) -> bool
+        {
+            const wxPoint& other = aHits[aOther];
+            double         dx = (double) other.x - hit.x;
+
+            if( nearest.size() == NEIGHBOUR_COUNT && dx * dx >= nearest.back().first )
+                return false;
+
+            double dy = (double) other.y - hit.y;
+            std::pair<double, int> candidate( dx * dx + dy * dy, aOther );
+
+            nearest.insert( std::upper_bound( nearest.begin(), nearest.end(), candidate ),
+                            candidate );
+
+            if( nearest.size() > NEIGHBOUR_COUNT )
+                nearest.pop_back();
+
+            return true;
+        };
+
+        for( int jj = ii - 1; jj >= 0 && consider( byX[jj] ); --jj )
+            ;
+
+        for( int jj = ii + 1; jj < count && consider( byX[jj] ); ++jj )
+            ;
+
+        for( size_t kk = 0; kk < nearest.size(); ++kk )
+            neighbours[(size_t) byX[ii] * NEIGHBOUR_COUNT + kk] = nearest[kk].second;
+    }
+
+    return neighbours;
+}
+
+
+/**
+ * An open path going through hits, shortened by local moves.
+ */
+class DRILL_PATH
+{
+public:
+    DRILL_PATH( const std::vector<wxPoint>& aHits, const std::vector<int>& aOrder ) :
+            m_hits( aHits ),
+            m_order( aOrder ),
+            m_position( aOrder.size() ),
+            m_queued( aOrder.size(), false )
+    {
+        updatePositions( 0, size() - 1 );
+    }
+
+    /**
+     * Apply 2-opt and Or-opt moves linking hits to their \a aNeighbours until the path
+     * cannot be shortened anymore.
+     */
+    void Optimize( const std::vector<int>& aNeighbours )
+    {
+        size_t moves = 0;
+        size_t maxMoves = 100 * m_order.size();     // Should not be reached
+
+        for( int hit : m_order )
+            queueHit( hit );
+
+        while( !m_queue.empty() && moves < maxMoves )
+        {
+            int hit = m_queue.front();
+
+            m_queue.pop_front();
+            m_queued[hit] = false;
+
+            const int* neighbours = &aNeighbours[(size_t) hit * NEIGHBOUR_COUNT];
+
+            if( twoOpt( hit, neighbours ) || orOpt( hit, neighbours ) )
+            {
+                queueHit( hit );
+                moves++;
+            }
+        }
+    }
+
+    double Length() const
+    {
+        double length = 0.0;
+
+        for( int ii = 0; ii < size() - 1; ++ii )
+            length += link( ii );
+
+        return length;
+    }
+
+    const std::vector<int>& GetOrder() const { return m_order; }
+
+private:
+    int size() const { return (int) m_order.size(); }
+
+    bool inPath( int aIdx ) const { return aIdx >= 0 && aIdx < size(); }
+
+    /// @return the distance from the hit at \a aIdx in the path to \a aHit, or 0 if \a aIdx
+    ///         is past an end of the path
+    double join( int aIdx, int aHit ) const
+    {
+        return inPath( aIdx ) ? hitDistance( m_hits[m_order[aIdx]], m_hits[aHit] ) : 0.0;
+    }
+
+    /// @return the distance between the hits at \a aIdxA and \a aIdxB in the path, or 0 if
+    ///         one of them is past an end of the path
+    double joinIdx( int aIdxA, int aIdxB ) const
+    {
+        return inPath( aIdxB ) ? join( aIdxA, m_order[aIdxB] ) : 0.0;
+    }
+
+    /// @return the length of the path from \a aIdx to the next hit
+    double link( int aIdx ) const { return joinIdx( aIdx, aIdx + 1 ); }
+
+    void queueHit( int aHit )
+    {
+        if( !m_queued[aHit] )
+        {
+            m_queued[aHit] = true;
+            m_queue.push_back( aHit );
+        }
+    }
+
+    void queueIdx( int aIdx )
+    {
+        if( inPath( aIdx ) )
+            queueHit( m_order[aIdx] );
+    }
+
+    void updatePositions( int aFirst, int aLast )
+    {
+        for( int ii = aFirst; ii <= aLast; ++ii )
+            m_position[m_order[ii]] = ii;
+    }
+
+    /**
+     * Try to link \a aHit to one of its neighbours by reversing the part of the path between
+     * them.
+     */
+    bool twoOpt( int aHit, const int* aNeighbours )
+    {
+        int    idx = m_position[aHit];
+        double bestGain = MIN_GAIN;
+        int    bestLo = 0;
+        int    bestHi = -1;
+
+        for( int kk = 0; kk < NEIGHBOUR_COUNT && aNeighbours[kk] >= 0; ++kk )
+        {
+            int other = m_position[aNeighbours[kk]];
+
+            // Reversing ]lo, hi] links lo to hi and lo + 1 to hi + 1: link the hits when
+            // they are at lo and hi, or at lo + 1 and hi + 1
+            for( int shift = 0; shift <= 1; ++shift )
+            {
+                int lo = std::min( idx, other ) - shift;
+                int hi = std::max( idx, other ) - shift;
+
+                if( hi - lo < 2 )
+                    continue;
+
+                double gain = link( lo ) + link( hi ) - joinIdx( lo, hi )
+                              - joinIdx( lo + 1, hi + 1 );
+
+                if( gain > bestGain )
+                {
+                    bestGain = gain;
+                    bestLo = lo;
+                    bestHi = hi;
+                }
+            }
+        }
+
+        if( bestHi < 0 )
+            return false;
+
+        queueIdx( bestLo );
+        queueIdx( bestLo + 1 );
+        queueIdx( bestHi );
+        queueIdx( bestHi + 1 );
+
+        std::reverse( m_order.begin() + bestLo + 1, m_order.begin() + bestHi + 1 );
+        updatePositions( bestLo + 1, bestHi );
+
+        return true;
+    }
+
+    /**
+     * Try to move a short run of hits starting at \a aHit next to one of its neighbours.
+     */
+    bool orOpt( int aHit, const int* aNeighbours )
+    {
+        int    first = m_position[aHit];
+        double bestGain = MIN_GAIN;
+        int    bestLast = -1;
+        int    bestAfter = 0;
+        bool   bestReversed = false;
+
+        for( int last = first; last < first + MAX_OR_OPT_LENGTH && last < size(); ++last )
+        {
+            double removeGain = link( first - 1 ) + link( last ) - joinIdx( first - 1, last + 1 );
+
+            if( removeGain <= MIN_GAIN )
+                continue;
+
+            for( int kk = 0; kk < NEIGHBOUR_COUNT && aNeighbours[kk] >= 0; ++kk )
+            {
+                int other = m_position[aNeighbours[kk]];
+
+                // Insert the run between after and after + 1, on either side of the neighbour
+                for( int after = other - 1; after <= other; ++after )
+                {
+                    if( after >= first - 1 && after <= last )
+                        continue;
+
+                    double linkAfter = link( after );
+                    double forward = join( after, m_order[first] )
+                                     + join( after + 1, m_order[last] ) - linkAfter;
+                    double backward = join( after, m_order[last] )
+                                      + join( after + 1, m_order[first] ) - linkAfter;
+
+                    double gain = removeGain - std::min( forward, backward );
+
+                    if( gain > bestGain )
+                    {
+                        bestGain = gain;
+                        bestLast = last;
+                        bestAfter = after;
+                        bestReversed = backward < forward;
+                    }
+                }
+            }
+        }
+
+        if( bestLast < 0 )
+            return false;
+
+        int count = bestLast - first + 1;
+        auto begin = m_order.begin();
+
+        queueIdx( first - 1 );
+        queueIdx( first );
+        queueIdx( bestLast );
+        queueIdx( bestLast + 1 );
+        queueIdx( bestAfter );
+        queueIdx( bestAfter + 1 );
+
+        if( bestAfter < first )
+        {
+            std::rotate( begin + bestAfter + 1, begin + first, begin + bestLast + 1 );
+
+            if( bestReversed )
+                std::reverse( begin + bestAfter + 1, begin + bestAfter + 1 + count );
+
+            updatePositions( bestAfter + 1, bestLast );
+        }
+        else
+        {
+            std::rotate( begin + first, begin + bestLast + 1, begin + bestAfter + 1 );
+
+            if( bestReversed )
+                std::reverse( begin + bestAfter + 1 - count, begin + bestAfter + 1 );
+
+            updatePositions( first, bestAfter );
+        }
+
+        return true;
+    }
+
+    const std::vector<wxPoint>& m_hits;
+    std::vector<int>            m_order;     ///< Indices of the hits, in path order
+    std::vector<int>            m_position;  ///< Index in the path of each hit
+    std::deque<int>             m_queue;     ///< Hits to try to link to their neighbours
+    std::vector<bool>           m_queued;
+};
+
+
+std::vector<int> OptimizeDrillPath( const std::vector<wxPoint>& aHits )
+{
+    std::vector<int> order( aHits.size() );
+    std::iota( order.begin(), order.end(), 0 );
+
+    if( aHits.size() < 3 )
+        return order;
+
+    DRILL_PATH path( aHits, hilbertOrder( aHits ) );
+    path.Optimize( nearestHits( aHits ) );
+
+    if( path.Length() < DrillPathLength( aHits ) )
+        return path.GetOrder();
+
+    return order;
+}
@@ -0,0 +1,53 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gendrill_path_optimizer.h
+ * @brief Ordering of the hits of a drill tool to shorten the travel of the drill head.
+ */
+
+#ifndef GENDRILL_PATH_OPTIMIZER_H
+#define GENDRILL_PATH_OPTIMIZER_H
+
+#include <vector>
+#include <wx/gdicmn.h>
+
+
+/**
+ * @return the length of the path going through \a aHits, in the given order.
+ */
+double DrillPathLength( const std::vector<wxPoint>& aHits );
+
+/**
+ * Find a short path going through all of \a aHits.
+ *
+ * The path is seeded by ordering the hits along a Hilbert curve, then refined by 2-opt and
+ * Or-opt moves between near hits.  The path is open: the drill doesn't go back to its first
+ * hit.  The result is reproducible for a given input order.
+ *
+ * @return the indices of \a aHits, in path order.  If the path cannot be shortened, it is the
+ *         input order.
+ */
+std::vector<int> OptimizeDrillPath( const std::vector<wxPoint>& aHits );
+
+#endif  // GENDRILL_PATH_OPTIMIZER_H
@@ -41,6 +41,7 @@
 #include <wildcards_and_files_ext.h>
 #include <tool/tool_manager.h>
 #include <board.h>
+#include <connectivity/connectivity_data.h>
 #include <wx/stdpaths.h>
 #include <ratsnest/ratsnest_data.h>
 #include <kiplatform/app.h>
@@ -54,6 +55,11 @@
 #include <plugins/cadstar/cadstar_pcb_archive_plugin.h>
 #include <plugins/eagle/eagle_plugin.h>
 #include <dialogs/dialog_imported_layers.h>
+#include <plugins/kicad/kicad_plugin.h>
+#include <widgets/progress_reporter.h>
+
+#include <future>
+#include <mutex>
 
 
 //#define     USE_INSTRUMENTATION     1
@@ -476,6 +482,75 @@ IO_MGR::PCB_FILE_T plugin_type( const wxString& aFileName, int aCtl )
 }
 
 
+/**
+ * Load a board with the KiCad plugin on a worker thread, while this (UI) thread refreshes a
+ * progress dialog and shows the dialogs the plugin raises while loading.
+ *
+ * The board is handed over only once completely loaded: it is never shared between the threads.
+ *
+ * @throw IO_ERROR as PLUGIN::Load().
+ */
+static BOARD* loadBoardInBackground( wxWindow* aParent, PCB_IO* aPlugin, const wxString& aFileName,
+                                     const PROPERTIES* aProperties )
+{
+    WX_PROGRESS_REPORTER progressReporter( aParent, _( "Loading PCB" ), 1 );
+
+    // The dialog raised by the worker thread, if any, and the promise to fulfill once shown
+    std::mutex             dialogMutex;
+    std::function<void()>  pendingDialog;
+    std::promise<void>*    pendingDialogShown = nullptr;
+
+    aPlugin->SetProgressReporter( &progressReporter );
+    aPlugin->SetDialogRunner(
+            [&]( const std::function<void()>& aShowDialog )
+            {
+                std::promise<void> shown;
+                std::future<void>  done = shown.get_future();
+
+                {
+                    std::lock_guard<std::mutex> lock( dialogMutex );
+                    pendingDialog = aShowDialog;
+                    pendingDialogShown = &shown;
+                }
+
+                done.wait();
+            } );
+
+    std::future<BOARD*> loadedBoard = std::async( std::launch::async,
+            [&]() -> BOARD*
+            {
+                return aPlugin->Load( aFileName, nullptr, aProperties );
+            } );
+
+    // Here we balance the load with a 100ms timeout to allow UI updating
+    while( loadedBoard.wait_for( std::chrono::milliseconds( 100 ) ) != std::future_status::ready )
+    {
+        std::function<void()> showDialog;
+        std::promise<void>*   shown;
+
+        {
+            std::lock_guard<std::mutex> lock( dialogMutex );
+            showDialog.swap( pendingDialog );
+            shown = pendingDialogShown;
+            pendingDialogShown = nullptr;
+        }
+
+        if( showDialog )
+        {
+            showDialog();
+            shown->set_value();
+        }
+
+        progressReporter.KeepRefreshing();
+    }
+
+    aPlugin->SetProgressReporter( nullptr );
+    aPlugin->SetDialogRunner( nullptr );
+
+    return loadedBoard.get();
+}
+
+
 int PCB_EDIT_FRAME::inferLegacyEdgeClearance( BOARD* aBoard )
 {
     PCB_LAYER_COLLECTOR collector;
@@ -653,7 +728,11 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             unsigned startTime = GetRunningMicroSecs();
 #endif
 
-            loadedBoard = pi->Load( fullFileName, NULL, &props );
+            // The KiCad plugin never asks for layer mappings, so it can load in the background
+            if( PCB_IO* kicadPlugin = dynamic_cast<PCB_IO*>( (PLUGIN*) pi ) )
+                loadedBoard = loadBoardInBackground( this, kicadPlugin, fullFileName, &props );
+            else
+                loadedBoard = pi->Load( fullFileName, NULL, &props );
 
 #if USE_INSTRUMENTATION
             unsigned stopTime = GetRunningMicroSecs();
@@ -675,7 +754,8 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             return false;
         }
 
-        SetBoard( loadedBoard );
+        // The connectivity is built once the nets and the netclasses are set up
+        SetBoard( loadedBoard, false );
 
         if( loadedBoard->m_LegacyDesignSettingsLoaded )
         {
@@ -744,16 +824,23 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
     if( !converted )
         UpdateFileHistory( GetBoard()->GetFileName() );
 
-    // Rebuild list of nets (full ratsnest rebuild)
-    GetBoard()->BuildConnectivity();
-    Compile_Ratsnest( true );
-
     // Load project settings after setting up board; some of them depend on the nets list
     LoadProjectSettings();
 
+    // Build the connectivity with the nets and the project netclasses, and before the board
+    // is displayed: the painters query it
+    {
+        WX_PROGRESS_REPORTER progressReporter( this, _( "Building Connectivity" ), 1, false );
+
+        GetBoard()->GetConnectivity()->Build( GetBoard(), &progressReporter );
+    }
+
     // Syncs the UI (appearance panel, etc) with the loaded board and project
     onBoardLoaded();
 
+    Compile_Ratsnest( true );
+    GetCanvas()->RedrawRatsnest();
+
     // Refresh the 3D view, if any
     EDA_3D_VIEWER* draw3DFrame = Get3DViewerFrame();
 
@@ -397,6 +397,10 @@ double FP_TEXT::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
     if( IsBackLayer( m_layer ) && !aView->IsLayerVisible( LAYER_MOD_TEXT_BK ) )
         return HIDE;
 
+    // Text too small to be read is skipped, except when printing
+    if( aView->GetPrintMode() <= 0 )
+        return (double) Millimeter2iu( 0.5 ) / ( GetTextHeight() + 1 );
+
     // Other layers are shown without any conditions
     return 0.0;
 }
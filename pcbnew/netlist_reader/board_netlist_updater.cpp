@@ -50,6 +50,13 @@
 
 #include <pcb_edit_frame.h>
 
+#ifdef PROFILE
+#include <profile.h>
+#endif
+
+#include <unordered_map>
+#include <unordered_set>
+
 
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard ) :
     m_frame( aFrame ),
@@ -245,13 +252,22 @@ FOOTPRINT* BOARD_NETLIST_UPDATER::replaceComponent( NETLIST& aNetlist, FOOTPRINT
 bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
                                                        COMPONENT* aNewComponent )
 {
-    wxString msg;
-
-    // Create a copy only if the footprint has not been added during this update
-    FOOTPRINT* copy = m_commit.GetStatus( aPcbComponent ) ? nullptr
-                                                          : (FOOTPRINT*) aPcbComponent->Clone();
+    wxString   msg;
+    FOOTPRINT* copy = nullptr;
     bool       changed = false;
 
+    // Called before each change: the copy is created on the first one, so unchanged
+    // footprints are not cloned, and only if the footprint has not been added during
+    // this update
+    auto beginChange =
+            [&]()
+            {
+                if( !changed && !m_commit.GetStatus( aPcbComponent ) )
+                    copy = (FOOTPRINT*) aPcbComponent->Clone();
+
+                changed = true;
+            };
+
     // Test for reference designator field change.
     if( aPcbComponent->GetReference() != aNewComponent->GetReference() )
     {
@@ -262,7 +278,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 
         if ( !m_isDryRun )
         {
-            changed = true;
+            beginChange();
             aPcbComponent->SetReference( aNewComponent->GetReference() );
         }
     }
@@ -278,7 +294,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 
         if( !m_isDryRun )
         {
-            changed = true;
+            beginChange();
             aPcbComponent->SetValue( aNewComponent->GetValue() );
         }
     }
@@ -294,7 +310,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 
         if( !m_isDryRun )
         {
-            changed = true;
+            beginChange();
             aPcbComponent->SetPath( aNewComponent->GetPath() );
         }
     }
@@ -307,7 +323,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 
         if( !m_isDryRun )
         {
-            changed = true;
+            beginChange();
             aPcbComponent->SetProperties( aNewComponent->GetProperties() );
         }
     }
@@ -334,7 +350,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 
         if( !m_isDryRun )
         {
-            changed = true;
+            beginChange();
             aPcbComponent->SetAttributes( attributes );
         }
     }
@@ -351,17 +367,36 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( FOOTPRINT* aPcbComponent,
 bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( FOOTPRINT* aPcbComponent,
                                                            COMPONENT* aNewComponent )
 {
-    wxString msg;
-
-    // Create a copy only if the footprint has not been added during this update
-    FOOTPRINT* copy = m_commit.GetStatus( aPcbComponent ) ? nullptr
-                                                          : (FOOTPRINT*) aPcbComponent->Clone();
+    wxString   msg;
+    FOOTPRINT* copy = nullptr;
     bool       changed = false;
 
+    // See updateComponentParameters()
+    auto beginChange =
+            [&]()
+            {
+                if( !changed && !m_commit.GetStatus( aPcbComponent ) )
+                    copy = (FOOTPRINT*) aPcbComponent->Clone();
+
+                changed = true;
+            };
+
+    // Index the component nets by pin name; the first net of a pin wins, as in
+    // COMPONENT::GetNet()
+    std::unordered_map<wxString, const COMPONENT_NET*> pinNets;
+
+    for( unsigned ii = 0; ii < aNewComponent->GetNetCount(); ii++ )
+    {
+        const COMPONENT_NET& net = aNewComponent->GetNet( ii );
+        pinNets.emplace( net.GetPinName(), &net );
+    }
+
     // At this point, the component footprint is updated.  Now update the nets.
     for( PAD* pad : aPcbComponent->Pads() )
     {
-        const COMPONENT_NET& net = aNewComponent->GetNet( pad->GetName() );
+        auto                 pinNet = pinNets.find( pad->GetName() );
+        const COMPONENT_NET& net = pinNet != pinNets.end() ? *pinNet->second
+                                                           : aNewComponent->GetNet( pad->GetName() );
 
         wxString pinFunction;
 
@@ -372,7 +407,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( FOOTPRINT* aPcbCompon
         {
             if( pad->GetPinFunction() != pinFunction )
             {
-                changed = true;
+                beginChange();
                 pad->SetPinFunction( pinFunction );
             }
         }
@@ -400,14 +435,18 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( FOOTPRINT* aPcbCompon
 
             if( !m_isDryRun )
             {
-                changed = true;
-                pad->SetNetCode( NETINFO_LIST::UNCONNECTED );
-
-                // If the pad has no net from netlist (i.e. not in netlist
-                // it cannot have a pin function
-                if( pad->GetNetname().IsEmpty() )
-                    pad->SetPinFunction( wxEmptyString );
+                // Nothing to do if the pad is already unconnected and without pin function
+                if( pad->GetNetCode() != NETINFO_LIST::UNCONNECTED
+                        || !pad->GetPinFunction().IsEmpty() )
+                {
+                    beginChange();
+                    pad->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
+                    // If the pad has no net from netlist (i.e. not in netlist
+                    // it cannot have a pin function
+                    if( pad->GetNetname().IsEmpty() )
+                        pad->SetPinFunction( wxEmptyString );
+                }
             }
             else
                 cacheNetname( pad, wxEmptyString );
@@ -437,7 +476,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( FOOTPRINT* aPcbCompon
                     // It is a new net, we have to add it
                     if( !m_isDryRun )
                     {
-                        changed = true;
+                        beginChange();
                         m_commit.Add( netinfo );
                     }
 
@@ -467,7 +506,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( FOOTPRINT* aPcbCompon
 
                 if( !m_isDryRun )
                 {
-                    changed = true;
+                    beginChange();
                     pad->SetNet( netinfo );
                 }
                 else
@@ -670,55 +709,69 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
 
     m_board->BuildListOfNets();
 
-    std::vector<PAD*> padlist = m_board->GetPads();
+    // Pads with their netlist name, sorted by name
+    std::vector<std::pair<wxString, PAD*>> padlist;
 
-    // Sort pads by netlist name
-    std::sort( padlist.begin(), padlist.end(), [ this ]( PAD* a, PAD* b ) -> bool
-                                               {
-                                                   return getNetname( a ) < getNetname( b );
-                                               } );
+    for( PAD* pad : m_board->GetPads() )
+        padlist.emplace_back( getNetname( pad ), pad );
 
-    for( PAD* pad : padlist )
+    std::sort( padlist.begin(), padlist.end(),
+               []( const std::pair<wxString, PAD*>& a, const std::pair<wxString, PAD*>& b )
+               {
+                   return a.first < b.first;
+               } );
+
+    // A copper zone attached to a pad means it is not really a single pad net
+    std::unordered_set<wxString> zoneNets;
+
+    for( ZONE* zone : m_board->Zones() )
     {
-        if( getNetname( pad ).IsEmpty() )
+        if( !zone->IsOnCopperLayer() )
             continue;
 
-        if( netname != getNetname( pad ) )  // End of net
-        {
-            if( previouspad && count == 1 )
-            {
-                // First, see if we have a copper zone attached to this pad.
-                // If so, this is not really a single pad net
+        if( zone->GetIsRuleArea() )
+            continue;
+
+        zoneNets.insert( zone->GetNetname() );
+    }
 
-                for( ZONE* zone : m_board->Zones() )
+    // The pads are modified in place, so save their footprint in the commit
+    auto disconnect =
+            [&]( PAD* aPad )
+            {
+                if( !m_isDryRun )
                 {
-                    if( !zone->IsOnCopperLayer() )
-                        continue;
+                    m_commit.Modify( aPad );
+                    aPad->SetNetCode( NETINFO_LIST::UNCONNECTED );
+                }
+                else
+                {
+                    cacheNetname( aPad, wxEmptyString );
+                }
+            };
 
-                    if( zone->GetIsRuleArea() )
-                        continue;
+    for( const std::pair<wxString, PAD*>& entry : padlist )
+    {
+        if( entry.first.IsEmpty() )
+            continue;
 
-                    if( zone->GetNetname() == getNetname( previouspad ) )
-                    {
-                        count++;
-                        break;
-                    }
-                }
+        if( netname != entry.first )  // End of net
+        {
+            if( previouspad && count == 1 )
+            {
+                if( zoneNets.count( netname ) )
+                    count++;
 
                 if( count == 1 )    // Really one pad, and nothing else
                 {
-                    msg.Printf( _( "Remove single pad net %s." ),
-                                UnescapeString( getNetname( previouspad ) ) );
+                    msg.Printf( _( "Remove single pad net %s." ), UnescapeString( netname ) );
                     m_reporter->Report( msg, RPT_SEVERITY_ACTION );
 
-                    if( !m_isDryRun )
-                        previouspad->SetNetCode( NETINFO_LIST::UNCONNECTED );
-                    else
-                        cacheNetname( previouspad, wxEmptyString );
+                    disconnect( previouspad );
                 }
             }
 
-            netname = getNetname( pad );
+            netname = entry.first;
             count = 1;
         }
         else
@@ -726,17 +779,12 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
             count++;
         }
 
-        previouspad = pad;
+        previouspad = entry.second;
     }
 
     // Examine last pad
     if( count == 1 )
-    {
-        if( !m_isDryRun )
-            previouspad->SetNetCode( NETINFO_LIST::UNCONNECTED );
-        else
-            cacheNetname( previouspad, wxEmptyString );
-    }
+        disconnect( previouspad );
 
     return true;
 }
@@ -759,13 +807,18 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist,
         if( !footprint )    // It can be missing in partial designs
             continue;
 
+        std::unordered_set<wxString> padNames;
+
+        for( PAD* pad : footprint->Pads() )
+            padNames.insert( pad->GetName() );
+
         // Explore all pins/pads in component
         for( unsigned jj = 0; jj < component->GetNetCount(); jj++ )
         {
             const COMPONENT_NET& net = component->GetNet( jj );
             padname = net.GetPinName();
 
-            if( footprint->FindPadByName( padname ) )
+            if( padNames.count( padname ) )
                 continue;   // OK, pad found
 
             // not found: bad footprint, report error
@@ -792,9 +845,49 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
 
     std::map<COMPONENT*, FOOTPRINT*> footprintMap;
 
+#ifdef PROFILE
+    PROF_COUNTER matchTimer( "netlist-update-components" );
+#endif
+
     if( !m_board->Footprints().empty() )
         lastPreexistingFootprint = m_board->Footprints().back();
 
+    // Index the footprints already on the board by path or by reference, in board order.
+    // The footprints added during the update are not matched.
+    std::map<KIID_PATH, std::vector<FOOTPRINT*>>          footprintsByPath;
+    std::unordered_map<wxString, std::vector<FOOTPRINT*>> footprintsByReference;
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        if( footprint )
+        {
+            if( m_lookupByTimestamp )
+                footprintsByPath[ footprint->GetPath() ].push_back( footprint );
+            else
+                footprintsByReference[ footprint->GetReference().Lower() ].push_back( footprint );
+        }
+
+        if( footprint == lastPreexistingFootprint )
+            break;
+    }
+
+    static const std::vector<FOOTPRINT*> noFootprints;
+
+    auto findFootprints =
+            [&]( COMPONENT* aComponent ) -> const std::vector<FOOTPRINT*>&
+            {
+                if( m_lookupByTimestamp )
+                {
+                    auto it = footprintsByPath.find( aComponent->GetPath() );
+                    return it != footprintsByPath.end() ? it->second : noFootprints;
+                }
+                else
+                {
+                    auto it = footprintsByReference.find( aComponent->GetReference().Lower() );
+                    return it != footprintsByReference.end() ? it->second : noFootprints;
+                }
+            };
+
     cacheCopperZoneConnections();
 
     if( !m_isDryRun )
@@ -821,41 +914,22 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
                     component->GetFPID().Format().wx_str() );
         m_reporter->Report( msg, RPT_SEVERITY_INFO );
 
-        for( FOOTPRINT* footprint : m_board->Footprints() )
+        for( FOOTPRINT* footprint : findFootprints( component ) )
         {
-            bool     match = false;
+            tmp = footprint;
 
-            if( footprint )
-            {
-                if( m_lookupByTimestamp )
-                    match = footprint->GetPath() == component->GetPath();
-                else
-                    match = footprint->GetReference().CmpNoCase( component->GetReference() ) == 0;
-            }
+            if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
+                tmp = replaceComponent( aNetlist, footprint, component );
 
-            if( match )
+            if( tmp )
             {
-                tmp = footprint;
-
-                if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
-                    tmp = replaceComponent( aNetlist, footprint, component );
-
-                if( tmp )
-                {
-                    footprintMap[ component ] = tmp;
-
-                    updateComponentParameters( tmp, component );
-                    updateComponentPadConnections( tmp, component );
-                }
+                footprintMap[ component ] = tmp;
 
-                matchCount++;
+                updateComponentParameters( tmp, component );
+                updateComponentPadConnections( tmp, component );
             }
 
-            if( footprint == lastPreexistingFootprint )
-            {
-                // No sense going through the newly-created footprints: end of loop
-                break;
-            }
+            matchCount++;
         }
 
         if( matchCount == 0 )
@@ -878,17 +952,27 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
         }
     }
 
+#ifdef PROFILE
+    matchTimer.Show();
+    PROF_COUNTER zonesTimer( "netlist-update-zones-and-unused" );
+#endif
+
     updateCopperZoneNets( aNetlist );
 
     if( m_deleteUnusedComponents )
         deleteUnusedComponents( aNetlist );
 
+#ifdef PROFILE
+    zonesTimer.Show();
+    PROF_COUNTER commitTimer( "netlist-update-commit" );
+#endif
+
     if( !m_isDryRun )
     {
-        m_board->GetConnectivity()->Build( m_board );
+        // All the changes are in the commit, which updates the connectivity of the changed
+        // items and the ratsnest once, on push: no full rebuild needed here.
         testConnectivity( aNetlist, footprintMap );
 
-        // Now the connectivity data is rebuilt, we can delete single pads nets
         if( m_deleteSinglePadNets )
             deleteSinglePadNets();
 
@@ -904,6 +988,10 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
 
         m_board->GetNetInfo().RemoveUnusedNets();
         m_commit.Push( _( "Update netlist" ) );
+
+#ifdef PROFILE
+        commitTimer.Show();
+#endif
     }
     else if( m_deleteSinglePadNets && !m_newFootprintsCount )
     {
@@ -72,6 +72,11 @@ class PCB_EDIT_FRAME;
 class BOARD_NETLIST_UPDATER
 {
 public:
+    /**
+     * @param aFrame is the frame which loads the footprints and gets the changes.  It can be
+     *               null for dry runs which add or replace no footprint.
+     * @param aBoard is the board to update.
+     */
     BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard );
     ~BOARD_NETLIST_UPDATER();
 
@@ -138,35 +138,42 @@ void NETLIST::Format( const char* aDocName, OUTPUTFORMATTER* aOut, int aNestLeve
 void NETLIST::AddComponent( COMPONENT* aComponent )
 {
     m_components.push_back( aComponent );
+    clearIndexes();
 }
 
 
-COMPONENT* NETLIST::GetComponentByReference( const wxString& aReference )
+void NETLIST::buildIndexes()
 {
-    COMPONENT* component = NULL;
-
-    for( unsigned i = 0;  i < m_components.size();  i++ )
+    for( COMPONENT& component : m_components )
     {
-        if( m_components[i].GetReference() == aReference )
-        {
-            component = &m_components[i];
-            break;
-        }
+        // The first component wins, as in a linear search
+        m_componentsByReference.emplace( component.GetReference(), &component );
+        m_componentsByPath.emplace( component.GetPath(), &component );
     }
 
-    return component;
+    m_indexed = true;
+}
+
+
+COMPONENT* NETLIST::GetComponentByReference( const wxString& aReference )
+{
+    if( !m_indexed )
+        buildIndexes();
+
+    auto it = m_componentsByReference.find( aReference );
+
+    return it != m_componentsByReference.end() ? it->second : nullptr;
 }
 
 
 COMPONENT* NETLIST::GetComponentByPath( const KIID_PATH& aUuidPath )
 {
-    for( COMPONENT& component : m_components )
-    {
-        if( component.GetPath() == aUuidPath )
-            return &component;
-    }
+    if( !m_indexed )
+        buildIndexes();
+
+    auto it = m_componentsByPath.find( aUuidPath );
 
-    return nullptr;
+    return it != m_componentsByPath.end() ? it->second : nullptr;
 }
 
 
@@ -183,6 +190,7 @@ static bool ByFPID( const COMPONENT& ref, const COMPONENT& cmp )
 void NETLIST::SortByFPID()
 {
     m_components.sort( ByFPID );
+    clearIndexes();
 }
 
 
@@ -199,6 +207,7 @@ bool operator < ( const COMPONENT& item1, const COMPONENT& item2 )
 void NETLIST::SortByReference()
 {
     m_components.sort();
+    clearIndexes();
 }
 
 
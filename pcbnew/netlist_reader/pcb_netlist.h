@@ -29,6 +29,9 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <wx/arrstr.h>
 
+#include <map>
+#include <unordered_map>
+
 #include <lib_id.h>
 #include <footprint.h>
 
@@ -198,10 +201,26 @@ class NETLIST
     bool       m_findByTimeStamp;     // Associate components by KIID (or refdes if false)
     bool       m_replaceFootprints;   // Update footprints to match footprints defined in netlist
 
+    // Indexes of the first component of each reference and path, built on first lookup
+    // and cleared when the component list changes.
+    std::unordered_map<wxString, COMPONENT*> m_componentsByReference;
+    std::map<KIID_PATH, COMPONENT*>          m_componentsByPath;
+    bool                                     m_indexed;
+
+    void buildIndexes();
+
+    void clearIndexes()
+    {
+        m_componentsByReference.clear();
+        m_componentsByPath.clear();
+        m_indexed = false;
+    }
+
 public:
     NETLIST() :
         m_findByTimeStamp( false ),
-        m_replaceFootprints( false )
+        m_replaceFootprints( false ),
+        m_indexed( false )
     {
     }
 
@@ -215,7 +234,11 @@ public:
      * Function Clear
      * removes all components from the netlist.
      */
-    void Clear() { m_components.clear(); }
+    void Clear()
+    {
+        m_components.clear();
+        clearIndexes();
+    }
 
     /**
      * Function GetCount
@@ -170,6 +170,7 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 {
 
     m_view->Clear();
+    GetView()->SetBoard( aBoard );
 
     auto zones = aBoard->Zones();
     std::atomic<size_t> next( 0 );
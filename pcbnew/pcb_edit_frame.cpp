@@ -372,7 +372,7 @@ PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
 }
 
 
-void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard )
+void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard, bool aBuildConnectivity )
 {
     if( m_pcb )
         m_pcb->ClearProject();
@@ -380,7 +380,9 @@ void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard )
     PCB_BASE_EDIT_FRAME::SetBoard( aBoard );
 
     aBoard->SetProject( &Prj() );
-    aBoard->GetConnectivity()->Build( aBoard );
+
+    if( aBuildConnectivity )
+        aBoard->GetConnectivity()->Build( aBoard );
 
     // reload the worksheet
     SetPageSettings( aBoard->GetPageSettings() );
@@ -1618,7 +1620,8 @@ void PCB_EDIT_FRAME::ProjectChanged()
 }
 
 
-bool ExportBoardToHyperlynx( BOARD* aBoard, const wxFileName& aPath );
+bool ExportBoardToHyperlynx( BOARD* aBoard, const wxFileName& aPath,
+                             const FABRICATION_VIEW* aView = nullptr );
 
 
 void PCB_EDIT_FRAME::OnExportHyperlynx( wxCommandEvent& event )
@@ -58,6 +58,7 @@ struct PARSE_ERROR;
 class IO_ERROR;
 class FP_LIB_TABLE;
 class BOARD_NETLIST_UPDATER;
+class FABRICATION_VIEW;
 class ACTION_MENU;
 enum LAST_PATH_TYPE : unsigned int;
 
@@ -486,11 +487,14 @@ public:
      * @param aBottomSide true to list footprints on back (bottom) side,
      * if aTopSide and aTopSide are true, list footprints on both sides
      * @param aFormatCSV = true to use a comma separated file (CSV) format; defautl = false
+     * @param aView = the footprint data to use, shared between several files, or nullptr
+     *                to extract it from the board
      * @return the number of footprints found on aSide side,
      *    or -1 if the file could not be created
      */
     int DoGenFootprintsPositionFile( const wxString& aFullFileName, bool aUnitsMM,
-                                     bool aForceSmdItems, bool aTopSide, bool aBottomSide, bool aFormatCSV = false );
+                                     bool aForceSmdItems, bool aTopSide, bool aBottomSide, bool aFormatCSV = false,
+                                     const FABRICATION_VIEW* aView = nullptr );
 
     /**
      * Function GenFootprintsReport
@@ -591,7 +595,16 @@ public:
     bool Clear_Pcb( bool aQuery, bool aFinal = false );
 
     ///> @copydoc PCB_BASE_FRAME::SetBoard()
-    void SetBoard( BOARD* aBoard ) override;
+    void SetBoard( BOARD* aBoard ) override
+    {
+        SetBoard( aBoard, true );
+    }
+
+    /**
+     * Set the board, building its connectivity only if \a aBuildConnectivity is true (a loaded
+     * board has it built once its nets and project netclasses are set up).
+     */
+    void SetBoard( BOARD* aBoard, bool aBuildConnectivity );
 
     ///> @copydoc PCB_BASE_FRAME::GetModel()
     BOARD_ITEM_CONTAINER* GetModel() const override;
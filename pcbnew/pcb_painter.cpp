@@ -392,6 +392,37 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    // Copies with their own GAL can draw side by side: items are only read, and connectivity
+    // lookups (e.g. FlashLayer) never insert into the item map
+    PCB_PAINTER* painter = new PCB_PAINTER( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
+int PCB_PAINTER::GetZoneSimplificationError( double aWorldScale )
+{
+    // Half a pixel is not visible; below the arc approximation error there is nothing to gain
+    double maxError = 0.5 / aWorldScale;
+
+    if( aWorldScale <= 0.0 || maxError < ARC_HIGH_DEF
+            || maxError > std::numeric_limits<int>::max() )
+    {
+        return 0;
+    }
+
+    int error = ARC_HIGH_DEF;
+
+    while( error <= maxError / 2 )
+        error *= 2;
+
+    return error;
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -1526,7 +1557,16 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
     // Draw the filling
     if( displayMode != ZONE_DISPLAY_MODE::HIDE_FILLED )
     {
-        const SHAPE_POLY_SET& polySet = aZone->GetFilledPolysList( layer );
+        int maxError = 0;
+
+        // Fills drawn far below their resolution are decimated; outlined ones are left alone
+        // as they are mostly looked at closely
+        if( displayMode == ZONE_DISPLAY_MODE::SHOW_FILLED )
+            maxError = GetZoneSimplificationError( m_gal->GetWorldScale() );
+
+        const SHAPE_POLY_SET& polySet = maxError > 0
+                                        ? aZone->GetSimplifiedFilledPolysList( layer, maxError )
+                                        : aZone->GetFilledPolysList( layer );
 
         if( polySet.OutlineCount() == 0 )  // Nothing to draw
             return;
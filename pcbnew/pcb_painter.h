@@ -277,6 +277,16 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
+    /**
+     * Return the error allowed when decimating zone fills drawn at \a aWorldScale (pixels per
+     * internal unit), or 0 when they must be drawn as they are.  Errors are rounded down to a
+     * power of two so zooming only changes them once per octave.
+     */
+    static int GetZoneSimplificationError( double aWorldScale );
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
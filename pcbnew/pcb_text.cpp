@@ -32,6 +32,7 @@
 #include <pcb_text.h>
 #include <pcb_painter.h>
 #include <trigo.h>
+#include <view/view.h>
 
 using KIGFX::PCB_RENDER_SETTINGS;
 
@@ -135,6 +136,16 @@ const EDA_RECT PCB_TEXT::GetBoundingBox() const
 }
 
 
+double PCB_TEXT::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Text too small to be read is skipped, except when printing
+    if( aView && aView->GetPrintMode() <= 0 )
+        return (double) Millimeter2iu( 0.5 ) / ( GetTextHeight() + 1 );
+
+    return 0.0;
+}
+
+
 void PCB_TEXT::Rotate( const wxPoint& aRotCentre, double aAngle )
 {
     wxPoint pt = GetTextPos();
@@ -137,6 +137,8 @@ public:
     // Virtual function
     const EDA_RECT GetBoundingBox() const override;
 
+    double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
     EDA_ITEM* Clone() const override;
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
@@ -28,15 +28,19 @@
 using namespace std::placeholders;
 
 #include <pcb_view.h>
+#include <board.h>
 #include <pcb_display_options.h>
 #include <pcb_painter.h>
+#include <gal/graphics_abstraction_layer.h>
 
 #include <pcb_group.h>
 #include <footprint.h>
+#include <zone.h>
 
 namespace KIGFX {
 PCB_VIEW::PCB_VIEW( bool aIsDynamic ) :
-    VIEW( aIsDynamic )
+    VIEW( aIsDynamic ),
+    m_board( nullptr )
 {
     // Set m_boundary to define the max area size. The default value
     // is acceptable for Pcbnew and Gerbview.
@@ -115,6 +119,27 @@ void PCB_VIEW::Update( const KIGFX::VIEW_ITEM* aItem ) const
 }
 
 
+void PCB_VIEW::SetScale( double aScale, VECTOR2D aAnchor )
+{
+    GAL* gal = GetGAL();
+    int  oldError = PCB_PAINTER::GetZoneSimplificationError( gal->GetWorldScale() );
+
+    VIEW::SetScale( aScale, aAnchor );
+
+    if( m_board && PCB_PAINTER::GetZoneSimplificationError( gal->GetWorldScale() ) != oldError )
+    {
+        for( ZONE* zone : m_board->Zones() )
+            Update( zone, KIGFX::REPAINT );
+
+        for( FOOTPRINT* footprint : m_board->Footprints() )
+        {
+            for( FP_ZONE* zone : footprint->Zones() )
+                Update( zone, KIGFX::REPAINT );
+        }
+    }
+}
+
+
 void PCB_VIEW::UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions )
 {
     auto    painter     = static_cast<KIGFX::PCB_PAINTER*>( GetPainter() );
@@ -29,6 +29,7 @@
 #include <view/view.h>
 #include <board_item.h>
 
+class BOARD;
 class PCB_DISPLAY_OPTIONS;
 
 namespace KIGFX {
@@ -51,7 +52,21 @@ public:
     /// @copydoc VIEW::Update()
     virtual void Update( const VIEW_ITEM* aItem ) const override;
 
+    /**
+     * @copydoc VIEW::SetScale()
+     * Zones are redrawn when the scale changes how much their fills are decimated.
+     */
+    virtual void SetScale( double aScale, VECTOR2D aAnchor = { 0, 0 } ) override;
+
     void UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions );
+
+    /**
+     * Set the board shown by the view, whose zones are redrawn on scale changes.
+     */
+    void SetBoard( BOARD* aBoard ) { m_board = aBoard; }
+
+private:
+    BOARD* m_board;
 };
 
 }
@@ -98,6 +98,8 @@ public:
         m_drillMarkSize = aSize;
     }
 
+    PAINTER* Clone( GAL* aGal ) const override;
+
 protected:
     int getDrillShape( const PAD* aPad ) const override;
 
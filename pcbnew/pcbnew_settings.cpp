@@ -229,6 +229,9 @@ PCBNEW_SETTINGS::PCBNEW_SETTINGS()
     m_params.emplace_back( new PARAM<bool>( "gen_drill.use_route_for_oval_holes",
             &m_GenDrill.use_route_for_oval_holes, true ) );
 
+    m_params.emplace_back( new PARAM<bool>( "gen_drill.optimize_path",
+            &m_GenDrill.optimize_path, false ) );
+
     m_params.emplace_back( new PARAM<int>(
             "gen_drill.drill_file_type", &m_GenDrill.drill_file_type, 0 ) );
 
@@ -37,6 +37,8 @@
 #include <settings/color_settings.h>
 #include <settings/settings_manager.h>
 
+#include <vector>
+
 class PLOTTER;
 class PCB_TEXT;
 class PAD;
@@ -168,6 +170,29 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt );
 
+/**
+ * A layer to plot by PlotBoardLayers(), and the file to plot it to.
+ */
+struct PLOT_LAYER_JOB
+{
+    PCB_LAYER_ID m_Layer;
+    wxString     m_FileName;        ///< Full file name of the plot file
+    wxString     m_SheetDesc;       ///< Sheet description used by the drawing sheet
+    bool         m_Plotted = false; ///< Set if the plot file was created
+};
+
+/**
+ * Plot several layers of a board, each one in its own file.
+ *
+ * The board items are prepared once, then the layers are plotted on several threads.  The
+ * plot files are the same as the ones created by StartPlotBoard() and PlotOneBoardLayer().
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options, including the format
+ * @param aJobs = the layers to plot.  m_Plotted is set for the plot files created
+ */
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs );
+
 /**
  * Function PlotStandardLayer
  * plot copper or technical layers.
@@ -29,6 +29,7 @@
  */
 
 
+
 #include <eda_item.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/shape_segment.h>
@@ -37,6 +38,7 @@
 
 #include <board.h>
 #include <core/arraydim.h>
+#include <core/parallel_for.h>
 #include <footprint.h>
 #include <track.h>
 #include <fp_shape.h>
@@ -49,6 +51,7 @@
 #include <pcbplot.h>
 #include <pcb_painter.h>
 #include <gbr_metadata.h>
+#include <locale_io.h>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -278,58 +281,59 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
             // Now offset the pad size by margin + width_adj
             wxSize padPlotsSize = pad->GetSize() + margin * 2 + wxSize( width_adj, width_adj );
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            PAD_SHAPE_T padShape = pad->GetShape();
-            wxSize      padSize = pad->GetSize();
-            wxSize      padDelta = pad->GetDelta(); // has meaning only for trapezoidal pads
-            double      padCornerRadius = pad->GetRoundRectCornerRadius();
-
             // Don't draw a null size item :
             if( padPlotsSize.x <= 0 || padPlotsSize.y <= 0 )
                 continue;
 
-            switch( pad->GetShape() )
+            // Inflated/deflated pads are plotted from a copy: the board is left untouched, so
+            // several layers of a board can be plotted at the same time
+            std::unique_ptr<PAD> resizedPad;
+
+            if( pad->GetShape() != PAD_SHAPE_CUSTOM && ( margin != wxSize( 0, 0 ) || width_adj ) )
             {
-            case PAD_SHAPE_CIRCLE:
-            case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                resizedPad = std::make_unique<PAD>( *pad );
+                resizedPad->SetSize( padPlotsSize );
+
+                switch( pad->GetShape() )
+                {
+                case PAD_SHAPE_RECT:
+                    if( margin.x > 0 )
+                    {
+                        resizedPad->SetShape( PAD_SHAPE_ROUNDRECT );
+                        resizedPad->SetRoundRectCornerRadius( margin.x );
+                    }
 
-                if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_NPTH ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
-                break;
+                case PAD_SHAPE_TRAPEZOID:
+                {
+                    wxSize padSize = pad->GetSize();
+                    wxSize padDelta = pad->GetDelta();
+                    wxSize scale( padPlotsSize.x / padSize.x, padPlotsSize.y / padSize.y );
 
-            case PAD_SHAPE_RECT:
-                pad->SetSize( padPlotsSize );
+                    resizedPad->SetDelta( wxSize( padDelta.x * scale.x, padDelta.y * scale.y ) );
+                }
+                    break;
 
-                if( margin.x > 0 )
-                {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetRoundRectCornerRadius( margin.x );
+                default:
+                    // Chamfer and rounding are stored as a percent and so don't need scaling
+                    break;
                 }
+            }
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
-                break;
+            PAD* plotPad = resizedPad ? resizedPad.get() : pad;
 
-            case PAD_SHAPE_TRAPEZOID:
+            switch( pad->GetShape() )
             {
-                wxSize scale( padPlotsSize.x / padSize.x, padPlotsSize.y / padSize.y );
-                pad->SetDelta( wxSize( padDelta.x * scale.x, padDelta.y * scale.y ) );
-                pad->SetSize( padPlotsSize );
-
-                itemplotter.PlotPad( pad, color, padPlotMode );
-            }
-                break;
+            case PAD_SHAPE_CIRCLE:
+            case PAD_SHAPE_OVAL:
+                if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
+                    ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
+                    ( plotPad->GetSize() == plotPad->GetDrillSize() ) &&
+                    ( plotPad->GetAttribute() == PAD_ATTRIB_NPTH ) )
+                    break;
 
-            case PAD_SHAPE_ROUNDRECT:
-            case PAD_SHAPE_CHAMFERED_RECT:
-                // Chamfer and rounding are stored as a percent and so don't need scaling
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( plotPad, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
@@ -356,13 +360,11 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
                 itemplotter.PlotPad( &dummy, color, padPlotMode );
             }
                 break;
-            }
 
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( padSize );
-            pad->SetDelta( padDelta );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
+            default:
+                itemplotter.PlotPad( plotPad, color, padPlotMode );
+                break;
+            }
         }
 
         aPlotter->EndBlock( NULL );
@@ -1130,3 +1132,77 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+/**
+ * Build the data cached by the board items on first use, so the items are only read when
+ * several layers are plotted at the same time.
+ */
+static void preparePlotItems( BOARD* aBoard, const std::vector<PLOT_LAYER_JOB>& aJobs )
+{
+    LSET copperLayers;
+
+    for( const PLOT_LAYER_JOB& job : aJobs )
+    {
+        if( IsCopperLayer( job.m_Layer ) )
+            copperLayers.set( job.m_Layer );
+    }
+
+    for( FOOTPRINT* footprint : aBoard->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            // Effective shapes
+            pad->GetBoundingBox();
+
+            // Connectivity entries, used to remove the unconnected layers
+            for( PCB_LAYER_ID layer : copperLayers.Seq() )
+                pad->FlashLayer( layer );
+        }
+    }
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        VIA* via = dyn_cast<VIA*>( track );
+
+        if( !via )
+            continue;
+
+        for( PCB_LAYER_ID layer : copperLayers.Seq() )
+            via->FlashLayer( layer );
+    }
+}
+
+
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs )
+{
+    // Switch the locale to standard C once for all the threads
+    LOCALE_IO toggle;
+
+    preparePlotItems( aBoard, aJobs );
+
+    // Files are opened here: the drawing sheet is not thread safe
+    std::vector<PLOTTER*> plotters;
+
+    for( PLOT_LAYER_JOB& job : aJobs )
+    {
+        plotters.push_back( StartPlotBoard( aBoard, aPlotOpts, job.m_Layer, job.m_FileName,
+                                            job.m_SheetDesc ) );
+        job.m_Plotted = plotters.back() != nullptr;
+    }
+
+    ParallelFor( aJobs.size(),
+            [&]( size_t aJobId )
+            {
+                PLOTTER* plotter = plotters[aJobId];
+
+                if( !plotter )
+                    return;
+
+                PlotOneBoardLayer( aBoard, plotter, aJobs[aJobId].m_Layer, *aPlotOpts );
+                plotter->EndPlot();
+                delete plotter->RenderSettings();
+                delete plotter;
+            } );
+}
@@ -819,8 +819,9 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE* aZone, SHAPE_POLY_SET& polysList )
                         m_plotter->PlotPoly( cornerList, FILL_TYPE::NO_FILL,
                                              outline_thickness, &gbr_metadata );
 
+                    // The region keeps the arcs of the fill (e.g. around pads)
                     static_cast<GERBER_PLOTTER*>( m_plotter )->PlotGerberRegion(
-                                                        cornerList, &gbr_metadata );
+                                                        outline, &gbr_metadata );
                 }
                 else
                     m_plotter->PlotPoly( cornerList, FILL_TYPE::FILLED_SHAPE,
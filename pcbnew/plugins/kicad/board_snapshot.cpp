@@ -0,0 +1,680 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board.h>
+#include <locale_io.h>
+#include <macros.h>
+#include <richio.h>
+#include <track.h>
+#include <zone.h>
+#include <plugins/kicad/board_snapshot.h>
+#include <plugins/kicad/kicad_plugin.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+
+/*
+ * Layout of a snapshot file.  All the offsets are from the start of the file, and all the
+ * sections are 8-byte aligned, so that the records can be used in place once the file is
+ * mapped in memory.  The values are in the byte order of the machine that wrote the snapshot;
+ * a snapshot written on a machine of another byte order is ignored.
+ */
+
+#define SNAPSHOT_VERSION    2           ///< Change it whenever the layout or the content changes
+
+static const char     SNAPSHOT_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', 'S', 'N', 'P' };
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SNAPSHOT_SECTION
+{
+    uint64_t m_Offset;
+    uint64_t m_Count;               ///< Count of records (of bytes for strings)
+};
+
+struct SNAPSHOT_HEADER
+{
+    char             m_Magic[8];
+    uint32_t         m_ByteOrder;
+    uint32_t         m_Version;
+    uint32_t         m_BoardFileVersion;    ///< SEXPR_BOARD_FILE_VERSION of the writer
+    uint32_t         m_Reserved;
+    uint64_t         m_SourceSize;          ///< Size of the board file
+    uint64_t         m_SourceHash;          ///< Hash of the board file
+    SNAPSHOT_SECTION m_BoardText;           ///< The board file without tracks and zone fills
+    SNAPSHOT_SECTION m_NetNameOffsets;      ///< uint64_t, m_Count + 1 offsets in m_NetNames
+    SNAPSHOT_SECTION m_NetNames;            ///< UTF-8 net names, one after the other
+    SNAPSHOT_SECTION m_Tracks;              ///< SNAPSHOT_TRACK
+    SNAPSHOT_SECTION m_ZoneFills;           ///< SNAPSHOT_ZONE_FILL
+    SNAPSHOT_SECTION m_Outlines;            ///< SNAPSHOT_OUTLINE
+    SNAPSHOT_SECTION m_Points;              ///< SNAPSHOT_POINT
+    SNAPSHOT_SECTION m_Segments;            ///< SNAPSHOT_SEGMENT
+};
+
+/// A track, arc or via
+struct SNAPSHOT_TRACK
+{
+    int32_t  m_Type;                ///< KICAD_T
+    int32_t  m_StartX;
+    int32_t  m_StartY;
+    int32_t  m_EndX;
+    int32_t  m_EndY;
+    int32_t  m_MidX;                ///< Arcs only
+    int32_t  m_MidY;
+    int32_t  m_Width;
+    int32_t  m_Layer;               ///< Top layer of vias
+    int32_t  m_BottomLayer;         ///< Vias only
+    int32_t  m_Drill;               ///< Vias only
+    int32_t  m_ViaType;             ///< Vias only
+    int32_t  m_Net;                 ///< Index in the net names
+    uint32_t m_Status;
+    uint32_t m_ViaFlags;            ///< Vias only: VIA_REMOVE_UNCONNECTED, VIA_KEEP_TOP_BOTTOM
+    char     m_Uuid[36];
+};
+
+/// The filled areas of a zone on one layer
+struct SNAPSHOT_ZONE_FILL
+{
+    char     m_ZoneUuid[36];
+    int32_t  m_Layer;
+    uint64_t m_FirstOutline;
+    uint64_t m_OutlineCount;
+    uint64_t m_FirstSegment;
+    uint64_t m_SegmentCount;
+};
+
+struct SNAPSHOT_OUTLINE
+{
+    uint64_t m_FirstPoint;
+    uint32_t m_PointCount;
+    uint32_t m_Island;
+};
+
+struct SNAPSHOT_POINT
+{
+    int32_t m_X;
+    int32_t m_Y;
+};
+
+struct SNAPSHOT_SEGMENT
+{
+    int32_t m_AX;
+    int32_t m_AY;
+    int32_t m_BX;
+    int32_t m_BY;
+};
+
+#define VIA_REMOVE_UNCONNECTED  (1 << 0)
+#define VIA_KEEP_TOP_BOTTOM     (1 << 1)
+
+static_assert( sizeof( SNAPSHOT_HEADER ) == 168, "unexpected padding in snapshot header" );
+static_assert( sizeof( SNAPSHOT_TRACK ) == 96, "unexpected padding in snapshot tracks" );
+static_assert( sizeof( SNAPSHOT_ZONE_FILL ) == 72, "unexpected padding in snapshot zone fills" );
+static_assert( sizeof( SNAPSHOT_OUTLINE ) == 16, "unexpected padding in snapshot outlines" );
+
+
+/**
+ * Get the size and the (FNV-1a) hash of the content of \a aFileName.
+ *
+ * @return false if the file cannot be read.
+ */
+static bool hashFile( const wxString& aFileName, uint64_t& aSize, uint64_t& aHash )
+{
+    using namespace boost::interprocess;
+
+    try
+    {
+        file_mapping  mapping( aFileName.fn_str(), read_only );
+        mapped_region region( mapping, read_only );
+
+        const unsigned char* data = static_cast<const unsigned char*>( region.get_address() );
+
+        aSize = region.get_size();
+        aHash = 0xcbf29ce484222325ULL;
+
+        for( uint64_t ii = 0; ii < aSize; ++ii )
+        {
+            aHash ^= data[ii];
+            aHash *= 0x100000001b3ULL;
+        }
+    }
+    catch( const interprocess_exception& )
+    {
+        // Missing or empty file
+        return false;
+    }
+
+    return true;
+}
+
+
+static void copyUuid( const KIID& aUuid, char* aDest )
+{
+    std::string uuid = aUuid.AsString().ToStdString();
+
+    memset( aDest, 0, 36 );
+    memcpy( aDest, uuid.data(), std::min<size_t>( uuid.size(), 36 ) );
+}
+
+
+static KIID readUuid( const char* aSource )
+{
+    return KIID( wxString::FromAscii( aSource, 36 ) );
+}
+
+
+/**
+ * Append a section to \a aBuffer, at the next 8-byte boundary.
+ */
+static void appendSection( std::string& aBuffer, SNAPSHOT_SECTION& aSection, const void* aData,
+                           size_t aSize, size_t aCount )
+{
+    aBuffer.resize( ( aBuffer.size() + 7 ) & ~size_t( 7 ), '\0' );
+
+    aSection.m_Offset = aBuffer.size();
+    aSection.m_Count = aCount;
+
+    aBuffer.append( static_cast<const char*>( aData ), aSize );
+}
+
+
+template <typename T>
+static void appendSection( std::string& aBuffer, SNAPSHOT_SECTION& aSection,
+                           const std::vector<T>& aRecords )
+{
+    appendSection( aBuffer, aSection, aRecords.data(), aRecords.size() * sizeof( T ),
+                   aRecords.size() );
+}
+
+
+/**
+ * @return the records of \a aSection in the snapshot \a aData, or nullptr if the section is
+ *         not in the snapshot.
+ */
+template <typename T>
+static const T* getSection( const char* aData, size_t aSize, const SNAPSHOT_SECTION& aSection )
+{
+    if( aSection.m_Offset % 8 || aSection.m_Offset > aSize
+            || aSection.m_Count > ( aSize - aSection.m_Offset ) / sizeof( T ) )
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const T*>( aData + aSection.m_Offset );
+}
+
+
+wxString BoardSnapshotFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + wxT( "-snapshot" );
+}
+
+
+bool WriteBoardSnapshot( BOARD* aBoard, const wxString& aBoardFileName )
+{
+    // The board text is stored in the current format, which loses what the caller migrates
+    // from older files (legacy settings, file version).  Old files are read from the file.
+    if( aBoard->GetFileFormatVersionAtLoad() < SEXPR_BOARD_FILE_VERSION
+            || aBoard->m_LegacyDesignSettingsLoaded
+            || aBoard->m_LegacyCopperEdgeClearanceLoaded
+            || aBoard->m_LegacyNetclassesLoaded
+            || !aBoard->m_LegacyVisibleLayers.test( Rescue )
+            || !aBoard->m_LegacyVisibleItems.test( GAL_LAYER_INDEX( GAL_LAYER_ID_BITMASK_END ) ) )
+    {
+        return false;
+    }
+
+    // Groups are resolved when the board text is parsed, before the tracks are restored
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        if( track->GetParentGroup() )
+            return false;
+    }
+
+    SNAPSHOT_HEADER header;
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.m_Magic, SNAPSHOT_MAGIC, sizeof( header.m_Magic ) );
+    header.m_ByteOrder = SNAPSHOT_BYTE_ORDER;
+    header.m_Version = SNAPSHOT_VERSION;
+    header.m_BoardFileVersion = SEXPR_BOARD_FILE_VERSION;
+
+    if( !hashFile( aBoardFileName, header.m_SourceSize, header.m_SourceHash ) )
+        return false;
+
+    std::unordered_map<NETINFO_ITEM*, int32_t> netIndices;
+    std::vector<uint64_t>                      netNameOffsets = { 0 };
+    std::string                                netNames;
+    std::vector<SNAPSHOT_TRACK>                tracks;
+    std::vector<SNAPSHOT_ZONE_FILL>            zoneFills;
+    std::vector<SNAPSHOT_OUTLINE>              outlines;
+    std::vector<SNAPSHOT_POINT>                points;
+    std::vector<SNAPSHOT_SEGMENT>              segments;
+
+    auto netIndex =
+            [&]( NETINFO_ITEM* aNet ) -> int32_t
+            {
+                auto it = netIndices.find( aNet );
+
+                if( it != netIndices.end() )
+                    return it->second;
+
+                int32_t index = netIndices.size();
+
+                netIndices[aNet] = index;
+                netNames += aNet ? TO_UTF8( aNet->GetNetname() ) : "";
+                netNameOffsets.push_back( netNames.size() );
+
+                return index;
+            };
+
+    tracks.reserve( aBoard->Tracks().size() );
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        SNAPSHOT_TRACK rec;
+
+        memset( &rec, 0, sizeof( rec ) );
+        rec.m_Type = track->Type();
+        rec.m_StartX = track->GetStart().x;
+        rec.m_StartY = track->GetStart().y;
+        rec.m_EndX = track->GetEnd().x;
+        rec.m_EndY = track->GetEnd().y;
+        rec.m_Width = track->GetWidth();
+        rec.m_Layer = track->GetLayer();
+        rec.m_Net = netIndex( track->GetNet() );
+        rec.m_Status = track->GetStatus();
+        copyUuid( track->m_Uuid, rec.m_Uuid );
+
+        if( track->Type() == PCB_ARC_T )
+        {
+            ARC* arc = static_cast<ARC*>( track );
+
+            rec.m_MidX = arc->GetMid().x;
+            rec.m_MidY = arc->GetMid().y;
+        }
+        else if( track->Type() == PCB_VIA_T )
+        {
+            VIA*         via = static_cast<VIA*>( track );
+            PCB_LAYER_ID top, bottom;
+
+            via->LayerPair( &top, &bottom );
+            rec.m_Layer = top;
+            rec.m_BottomLayer = bottom;
+            rec.m_Drill = via->GetDrill();
+            rec.m_ViaType = static_cast<int32_t>( via->GetViaType() );
+
+            if( via->GetRemoveUnconnected() )
+                rec.m_ViaFlags |= VIA_REMOVE_UNCONNECTED;
+
+            if( via->GetKeepTopBottom() )
+                rec.m_ViaFlags |= VIA_KEEP_TOP_BOTTOM;
+        }
+
+        tracks.push_back( rec );
+    }
+
+    // The filled areas are stored as in the board file: the outlines of the polygons only
+    for( ZONE* zone : aBoard->Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            const SHAPE_POLY_SET&    fill = zone->GetFilledPolysList( layer );
+            const ZONE_SEGMENT_FILL& segs = zone->FillSegments( layer );
+
+            if( fill.IsEmpty() && segs.empty() )
+                continue;
+
+            SNAPSHOT_ZONE_FILL rec;
+
+            memset( &rec, 0, sizeof( rec ) );
+            copyUuid( zone->m_Uuid, rec.m_ZoneUuid );
+            rec.m_Layer = layer;
+            rec.m_FirstOutline = outlines.size();
+            rec.m_FirstSegment = segments.size();
+
+            int polyIndex = 0;
+
+            for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+            {
+                const SHAPE_LINE_CHAIN& chain = fill.COutline( ii );
+
+                if( chain.PointCount() == 0 )
+                    continue;
+
+                SNAPSHOT_OUTLINE outline;
+
+                outline.m_FirstPoint = points.size();
+                outline.m_PointCount = chain.PointCount();
+                outline.m_Island = zone->IsIsland( layer, polyIndex++ );
+                outlines.push_back( outline );
+
+                for( int jj = 0; jj < chain.PointCount(); ++jj )
+                    points.push_back( { chain.CPoint( jj ).x, chain.CPoint( jj ).y } );
+            }
+
+            for( const SEG& seg : segs )
+                segments.push_back( { seg.A.x, seg.A.y, seg.B.x, seg.B.y } );
+
+            rec.m_OutlineCount = outlines.size() - rec.m_FirstOutline;
+            rec.m_SegmentCount = segments.size() - rec.m_FirstSegment;
+            zoneFills.push_back( rec );
+        }
+    }
+
+    std::string buffer( sizeof( header ), '\0' );
+
+    try
+    {
+        LOCALE_IO        toggle;
+        PCB_IO           io( CTL_FOR_BOARD | CTL_OMIT_TRACKS | CTL_OMIT_ZONE_FILLS );
+        STRING_FORMATTER formatter;
+
+        io.FormatBoardFile( aBoard, &formatter );
+
+        const std::string& text = formatter.GetString();
+
+        appendSection( buffer, header.m_BoardText, text.data(), text.size(), text.size() );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    appendSection( buffer, header.m_NetNameOffsets, netNameOffsets.data(),
+                   netNameOffsets.size() * sizeof( uint64_t ), netIndices.size() );
+    appendSection( buffer, header.m_NetNames, netNames.data(), netNames.size(),
+                   netNames.size() );
+    appendSection( buffer, header.m_Tracks, tracks );
+    appendSection( buffer, header.m_ZoneFills, zoneFills );
+    appendSection( buffer, header.m_Outlines, outlines );
+    appendSection( buffer, header.m_Points, points );
+    appendSection( buffer, header.m_Segments, segments );
+
+    memcpy( &buffer[0], &header, sizeof( header ) );
+
+    // Write a temporary file first, so that a concurrent load never sees a partial snapshot
+    wxString fileName = BoardSnapshotFileName( aBoardFileName );
+    wxString tempFileName = fileName + wxT( ".tmp" );
+    wxFFile  file( tempFileName, wxT( "wb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    bool ok = file.Write( buffer.data(), buffer.size() ) == buffer.size();
+
+    ok &= file.Close();
+
+    if( !ok || !wxRenameFile( tempFileName, fileName, true ) )
+    {
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+BOARD* LoadBoardSnapshot( const wxString& aBoardFileName, const PROPERTIES* aProperties )
+{
+    using namespace boost::interprocess;
+
+    wxString fileName = BoardSnapshotFileName( aBoardFileName );
+
+    if( !wxFileExists( fileName ) )
+        return nullptr;
+
+    try
+    {
+        file_mapping  mapping( fileName.fn_str(), read_only );
+        mapped_region region( mapping, read_only );
+
+        const char* data = static_cast<const char*>( region.get_address() );
+        size_t      size = region.get_size();
+
+        if( size < sizeof( SNAPSHOT_HEADER ) )
+            return nullptr;
+
+        const SNAPSHOT_HEADER* header = reinterpret_cast<const SNAPSHOT_HEADER*>( data );
+
+        if( memcmp( header->m_Magic, SNAPSHOT_MAGIC, sizeof( header->m_Magic ) ) != 0
+                || header->m_ByteOrder != SNAPSHOT_BYTE_ORDER
+                || header->m_Version != SNAPSHOT_VERSION
+                || header->m_BoardFileVersion != SEXPR_BOARD_FILE_VERSION )
+        {
+            return nullptr;
+        }
+
+        uint64_t sourceSize;
+        uint64_t sourceHash;
+
+        if( !hashFile( aBoardFileName, sourceSize, sourceHash )
+                || sourceSize != header->m_SourceSize || sourceHash != header->m_SourceHash )
+        {
+            return nullptr;
+        }
+
+        // There is one more offset than net names
+        SNAPSHOT_SECTION offsetsSection = header->m_NetNameOffsets;
+        offsetsSection.m_Count++;
+
+        const char*     text = getSection<char>( data, size, header->m_BoardText );
+        const uint64_t* netNameOffsets = getSection<uint64_t>( data, size, offsetsSection );
+        const char*     netNames = getSection<char>( data, size, header->m_NetNames );
+
+        const SNAPSHOT_TRACK*     tracks = getSection<SNAPSHOT_TRACK>( data, size,
+                                                                       header->m_Tracks );
+        const SNAPSHOT_ZONE_FILL* zoneFills = getSection<SNAPSHOT_ZONE_FILL>( data, size,
+                                                                              header->m_ZoneFills );
+        const SNAPSHOT_OUTLINE*   outlines = getSection<SNAPSHOT_OUTLINE>( data, size,
+                                                                           header->m_Outlines );
+        const SNAPSHOT_POINT*     points = getSection<SNAPSHOT_POINT>( data, size,
+                                                                       header->m_Points );
+        const SNAPSHOT_SEGMENT*   segments = getSection<SNAPSHOT_SEGMENT>( data, size,
+                                                                           header->m_Segments );
+
+        if( !text || !netNameOffsets || !netNames || !tracks || !zoneFills || !outlines
+                || !points || !segments )
+        {
+            return nullptr;
+        }
+
+        // The board without its tracks and zone fills
+        STRING_LINE_READER     reader( std::string( text, header->m_BoardText.m_Count ),
+                                       aBoardFileName );
+        PCB_IO                 io;
+        std::unique_ptr<BOARD> board( io.DoLoad( reader, nullptr, aProperties ) );
+
+        std::vector<NETINFO_ITEM*> nets;
+
+        for( uint64_t ii = 0; ii < header->m_NetNameOffsets.m_Count; ++ii )
+        {
+            uint64_t first = netNameOffsets[ii];
+            uint64_t last = netNameOffsets[ii + 1];
+
+            if( first > last || last > header->m_NetNames.m_Count )
+                return nullptr;
+
+            NETINFO_ITEM* net = board->FindNet( FROM_UTF8( std::string( netNames + first,
+                                                                        last - first ).c_str() ) );
+
+            if( !net )
+                return nullptr;
+
+            nets.push_back( net );
+        }
+
+        for( uint64_t ii = 0; ii < header->m_Tracks.m_Count; ++ii )
+        {
+            const SNAPSHOT_TRACK& rec = tracks[ii];
+            TRACK*                track;
+
+            if( rec.m_Net < 0 || rec.m_Net >= (int32_t) nets.size()
+                    || !IsValidLayer( rec.m_Layer ) )
+            {
+                return nullptr;
+            }
+
+            switch( rec.m_Type )
+            {
+            case PCB_TRACE_T:
+                track = new TRACK( board.get() );
+                track->SetLayer( ToLAYER_ID( rec.m_Layer ) );
+                break;
+
+            case PCB_ARC_T:
+            {
+                ARC* arc = new ARC( board.get() );
+
+                arc->SetMid( wxPoint( rec.m_MidX, rec.m_MidY ) );
+                arc->SetLayer( ToLAYER_ID( rec.m_Layer ) );
+                track = arc;
+                break;
+            }
+
+            case PCB_VIA_T:
+            {
+                if( !IsValidLayer( rec.m_BottomLayer ) )
+                    return nullptr;
+
+                VIA* via = new VIA( board.get() );
+
+                via->SetViaType( static_cast<VIATYPE>( rec.m_ViaType ) );
+                via->SetLayerPair( ToLAYER_ID( rec.m_Layer ), ToLAYER_ID( rec.m_BottomLayer ) );
+                via->SetDrill( rec.m_Drill );
+                via->SetRemoveUnconnected( rec.m_ViaFlags & VIA_REMOVE_UNCONNECTED );
+                via->SetKeepTopBottom( rec.m_ViaFlags & VIA_KEEP_TOP_BOTTOM );
+                track = via;
+                break;
+            }
+
+            default:
+                return nullptr;
+            }
+
+            track->SetStart( wxPoint( rec.m_StartX, rec.m_StartY ) );
+            track->SetEnd( wxPoint( rec.m_EndX, rec.m_EndY ) );
+            track->SetWidth( rec.m_Width );
+            track->SetNet( nets[rec.m_Net] );
+            track->SetStatus( rec.m_Status );
+            const_cast<KIID&>( track->m_Uuid ) = readUuid( rec.m_Uuid );
+
+            board->Add( track, ADD_MODE::APPEND );
+        }
+
+        std::map<KIID, ZONE*> zones;
+        std::vector<ZONE*>    filledZones;
+
+        for( ZONE* zone : board->Zones() )
+            zones[zone->m_Uuid] = zone;
+
+        for( uint64_t ii = 0; ii < header->m_ZoneFills.m_Count; ++ii )
+        {
+            const SNAPSHOT_ZONE_FILL& rec = zoneFills[ii];
+            auto                      zoneIt = zones.find( readUuid( rec.m_ZoneUuid ) );
+
+            if( zoneIt == zones.end() || !IsValidLayer( rec.m_Layer )
+                    || rec.m_FirstOutline > header->m_Outlines.m_Count
+                    || rec.m_OutlineCount > header->m_Outlines.m_Count - rec.m_FirstOutline
+                    || rec.m_FirstSegment > header->m_Segments.m_Count
+                    || rec.m_SegmentCount > header->m_Segments.m_Count - rec.m_FirstSegment )
+            {
+                return nullptr;
+            }
+
+            ZONE*          zone = zoneIt->second;
+            PCB_LAYER_ID   layer = ToLAYER_ID( rec.m_Layer );
+            SHAPE_POLY_SET fill;
+
+            for( uint64_t jj = 0; jj < rec.m_OutlineCount; ++jj )
+            {
+                const SNAPSHOT_OUTLINE& outline = outlines[rec.m_FirstOutline + jj];
+
+                if( outline.m_FirstPoint > header->m_Points.m_Count
+                        || outline.m_PointCount > header->m_Points.m_Count - outline.m_FirstPoint )
+                {
+                    return nullptr;
+                }
+
+                std::vector<VECTOR2I> pts( outline.m_PointCount );
+
+                for( uint32_t kk = 0; kk < outline.m_PointCount; ++kk )
+                {
+                    const SNAPSHOT_POINT& pt = points[outline.m_FirstPoint + kk];
+                    pts[kk] = VECTOR2I( pt.m_X, pt.m_Y );
+                }
+
+                int idx = fill.AddOutline( SHAPE_LINE_CHAIN( pts, true ) );
+
+                if( outline.m_Island )
+                    zone->SetIsIsland( layer, idx );
+            }
+
+            if( !fill.IsEmpty() )
+            {
+                zone->SetFilledPolysList( layer, fill );
+                filledZones.push_back( zone );
+            }
+
+            if( rec.m_SegmentCount )
+            {
+                ZONE_SEGMENT_FILL segs;
+
+                for( uint64_t jj = 0; jj < rec.m_SegmentCount; ++jj )
+                {
+                    const SNAPSHOT_SEGMENT& seg = segments[rec.m_FirstSegment + jj];
+                    segs.emplace_back( VECTOR2I( seg.m_AX, seg.m_AY ),
+                                       VECTOR2I( seg.m_BX, seg.m_BY ) );
+                }
+
+                zone->SetFillSegments( layer, segs );
+            }
+        }
+
+        for( ZONE* zone : filledZones )
+            zone->CalculateFilledArea();
+
+        board->SetFileName( aBoardFileName );
+
+        return board.release();
+    }
+    catch( const interprocess_exception& )
+    {
+        return nullptr;
+    }
+    catch( const IO_ERROR& )
+    {
+        // An outdated or damaged snapshot: the board file will be read instead
+        return nullptr;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_snapshot.h
+ * @brief Binary snapshots of board files, to reload unchanged boards faster.
+ *
+ * A snapshot is written next to a board file, and is keyed by the size and hash of the board
+ * file.  The tracks, vias and zone fills, which are the bulk of large boards, are stored as
+ * flat arrays read in place from the memory-mapped snapshot.  The rest of the board is stored
+ * as a board file without them, still read by PCB_PARSER.
+ *
+ * The snapshot is only a cache: it is ignored when it doesn't match the board file or the
+ * current snapshot version, and errors while writing it are not reported.
+ */
+
+#ifndef BOARD_SNAPSHOT_H
+#define BOARD_SNAPSHOT_H
+
+#include <wx/string.h>
+
+class BOARD;
+class PROPERTIES;
+
+
+/**
+ * @return the name of the snapshot file of the board file \a aBoardFileName.
+ */
+wxString BoardSnapshotFileName( const wxString& aBoardFileName );
+
+/**
+ * Write the snapshot of \a aBoard, as just loaded from \a aBoardFileName.
+ *
+ * Boards loaded from files older than the current format, or with legacy settings still to
+ * migrate, have no snapshot.
+ *
+ * @return true if the snapshot was written.
+ */
+bool WriteBoardSnapshot( BOARD* aBoard, const wxString& aBoardFileName );
+
+/**
+ * Load the board file \a aBoardFileName from its snapshot.
+ *
+ * @return the board, or nullptr if there is no usable snapshot for the current content of the
+ *         board file.
+ */
+BOARD* LoadBoardSnapshot( const wxString& aBoardFileName, const PROPERTIES* aProperties );
+
+#endif  // BOARD_SNAPSHOT_H
@@ -40,6 +40,7 @@
 #include <core/arraydim.h>
 #include <locale_io.h>
 #include <zones.h>
+#include <plugins/kicad/board_snapshot.h>
 #include <plugins/kicad/kicad_plugin.h>
 #include <plugins/kicad/pcb_parser.h>
 #include <pcbnew_settings.h>
@@ -47,6 +48,7 @@
 #include <convert_basic_shapes_to_polygon.h>    // for enum RECT_CHAMFER_POSITIONS definition
 #include <kiface_i.h>
 #include <wx_filename.h>
+#include <widgets/progress_reporter.h>
 
 using namespace PCB_KEYS_T;
 
@@ -345,14 +347,20 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
 
     init( aProperties );
 
-    m_board = aBoard;       // after init()
+    FILE_OUTPUTFORMATTER    formatter( aFileName );
+
+    FormatBoardFile( aBoard, &formatter );
+}
+
+
+void PCB_IO::FormatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter )
+{
+    m_board = aBoard;
 
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
-
-    m_out = &formatter;     // no ownership
+    m_out = aFormatter;     // no ownership
 
     m_out->Print( 0, "(kicad_pcb (version %d) (generator pcbnew)\n", SEXPR_BOARD_FILE_VERSION );
 
@@ -651,11 +659,14 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     // Do not save PCB_MARKERs, they can be regenerated easily.
 
     // Save the tracks and vias.
-    for( TRACK* track : sorted_tracks )
-        Format( track, aNestLevel );
+    if( !( m_ctl & CTL_OMIT_TRACKS ) )
+    {
+        for( TRACK* track : sorted_tracks )
+            Format( track, aNestLevel );
 
-    if( sorted_tracks.size() )
-        m_out->Print( 0, "\n" );
+        if( sorted_tracks.size() )
+            m_out->Print( 0, "\n" );
+    }
 
     // Save the polygon (which are the newer technology) zones.
     for( auto zone : sorted_zones )
@@ -1974,68 +1985,117 @@ void PCB_IO::format( ZONE* aZone, int aNestLevel ) const
     }
 
     // Save the PolysList (filled areas)
-    for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
+    LSEQ filledLayers;
+
+    if( !( m_ctl & CTL_OMIT_ZONE_FILLS ) )
+        filledLayers = aZone->GetLayerSet().Seq();
+
+    for( PCB_LAYER_ID layer : filledLayers )
     {
         const SHAPE_POLY_SET& fv = aZone->GetFilledPolysList( layer );
         newLine                  = 0;
 
-        if( !fv.IsEmpty() )
-        {
-            int  poly_index  = 0;
-            bool new_polygon = true;
-            bool is_closed   = false;
+        // Arcs are written through their end points and are tessellated again when loading.
+        // Keep the new segments inside the filled area, as the points were: half of the load
+        // accuracy (see SHAPE_ARC::ConvertToPolyline()) covers the tessellation, the rest the
+        // rounding of the written arc points.
+        const int arcMargin = KiROUND( 0.005 * PCB_IU_PER_MM );
+
+        int poly_index = 0;
 
-            for( auto it = fv.CIterate(); it; ++it )
+        for( int ii = 0; ii < fv.OutlineCount(); ++ii )
+        {
+            for( const SHAPE_LINE_CHAIN& chain : fv.CPolygon( ii ) )
             {
-                if( new_polygon )
+                bool ccw = chain.Area() > 0.0;
+
+                newLine = 0;
+                m_out->Print( aNestLevel + 1, "(filled_polygon\n" );
+                m_out->Print( aNestLevel + 2, "(layer %s)\n",
+                              m_out->Quotew( LSET::Name( layer ) ).c_str() );
+
+                if( aZone->IsIsland( layer, poly_index ) )
+                    m_out->Print( aNestLevel + 2, "(island)\n" );
+
+                m_out->Print( aNestLevel + 2, "(pts\n" );
+                poly_index++;
+
+                // Items are grouped by 5 on a line for a compact save
+                auto nextItem =
+                        [&]()
+                        {
+                            if( newLine < 4 && ADVANCED_CFG::GetCfg().m_CompactSave )
+                            {
+                                newLine += 1;
+                            }
+                            else
+                            {
+                                newLine = 0;
+                                m_out->Print( 0, "\n" );
+                            }
+                        };
+
+                for( int jj = 0; jj < chain.PointCount(); ++jj )
                 {
-                    newLine = 0;
-                    m_out->Print( aNestLevel + 1, "(filled_polygon\n" );
-                    m_out->Print( aNestLevel + 2, "(layer %s)\n",
-                                  m_out->Quotew( LSET::Name( layer ) ).c_str() );
-
-                    if( aZone->IsIsland( layer, poly_index ) )
-                        m_out->Print( aNestLevel + 2, "(island)\n" );
-
-                    m_out->Print( aNestLevel + 2, "(pts\n" );
-                    new_polygon = false;
-                    is_closed   = false;
-                    poly_index++;
-                }
+                    const VECTOR2I& pt = chain.CPoint( jj );
+                    ssize_t         arcIndex = chain.ArcIndex( jj );
+                    int             last = jj;
 
-                if( newLine == 0 )
-                    m_out->Print( aNestLevel + 3, "(xy %s %s)",
-                            FormatInternalUnits( it->x ).c_str(),
-                            FormatInternalUnits( it->y ).c_str() );
-                else
-                    m_out->Print( 0, " (xy %s %s)", FormatInternalUnits( it->x ).c_str(),
-                            FormatInternalUnits( it->y ).c_str() );
+                    m_out->Print( newLine == 0 ? aNestLevel + 3 : 0, "%s(xy %s %s)",
+                                  newLine == 0 ? "" : " ",
+                                  FormatInternalUnits( pt.x ).c_str(),
+                                  FormatInternalUnits( pt.y ).c_str() );
+                    nextItem();
 
-                if( newLine < 4 && ADVANCED_CFG::GetCfg().m_CompactSave )
-                {
-                    newLine += 1;
-                }
-                else
-                {
-                    newLine = 0;
-                    m_out->Print( 0, "\n" );
-                }
+                    if( chain.isArc( jj ) )
+                    {
+                        while( last + 1 < chain.PointCount()
+                                && chain.ArcIndex( last + 1 ) == arcIndex )
+                        {
+                            last++;
+                        }
+                    }
 
-                if( it.IsEndContour() )
-                {
-                    is_closed = true;
+                    // The ends of the run are written as they are, as moving them could cut
+                    // into a neighbouring knockout.  The arc needs at least 2 segments between
+                    // them to save anything.
+                    if( last - jj < 4 )
+                        continue;
 
-                    if( newLine != 0 )
-                        m_out->Print( 0, "\n" );
+                    SHAPE_ARC              arc = chain.ArcInside( jj + 1, last - 1, ccw, arcMargin );
+                    std::vector<SHAPE_ARC> arcs = { arc };
 
-                    m_out->Print( aNestLevel + 2, ")\n" );
-                    m_out->Print( aNestLevel + 1, ")\n" );
-                    new_polygon = true;
+                    // The three points of a (nearly) complete circle don't tell its direction,
+                    // so write it as two halves
+                    if( std::abs( arc.GetCentralAngle() ) > 180.0 )
+                    {
+                        double half = arc.GetCentralAngle() / 2.0;
+
+                        arcs[0] = SHAPE_ARC( arc.GetCenter(), arc.GetP0(), half );
+                        arcs.emplace_back( arc.GetCenter(), arcs[0].GetP1(), half );
+                    }
+
+                    for( const SHAPE_ARC& part : arcs )
+                    {
+                        m_out->Print( newLine == 0 ? aNestLevel + 3 : 0,
+                                      "%s(arc (start %s) (mid %s) (end %s))",
+                                      newLine == 0 ? "" : " ",
+                                      FormatInternalUnits( part.GetP0() ).c_str(),
+                                      FormatInternalUnits( part.GetArcMid() ).c_str(),
+                                      FormatInternalUnits( part.GetP1() ).c_str() );
+                        nextItem();
+                    }
+
+                    // Continue with the last point of the run
+                    jj = last - 1;
                 }
-            }
 
-            if( !is_closed ) // Should not happen, but...
+                if( newLine != 0 )
+                    m_out->Print( 0, "\n" );
+
+                m_out->Print( aNestLevel + 2, ")\n" );
                 m_out->Print( aNestLevel + 1, ")\n" );
+            }
         }
 
         // Save the filling segments list
@@ -2066,7 +2126,8 @@ PCB_IO::PCB_IO( int aControlFlags ) :
     m_cache( 0 ),
     m_ctl( aControlFlags ),
     m_parser( new PCB_PARSER() ),
-    m_mapping( new NETINFO_MAPPING() )
+    m_mapping( new NETINFO_MAPPING() ),
+    m_progressReporter( nullptr )
 {
     init( 0 );
     m_out = &m_sf;
@@ -2083,14 +2144,34 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
+    bool useSnapshot = !aAppendToMe && ADVANCED_CFG::GetCfg().m_BoardSnapshots;
+
+    if( useSnapshot )
+    {
+        if( BOARD* board = LoadBoardSnapshot( aFileName, aProperties ) )
+            return board;
+    }
+
     FILE_LINE_READER reader( aFileName );
 
+    if( m_progressReporter )
+    {
+        m_progressReporter->Report( wxString::Format( _( "Loading %s..." ), aFileName ) );
+        m_parser->SetProgressReporter( m_progressReporter, &reader );
+    }
+
     BOARD* board = DoLoad( reader, aAppendToMe, aProperties );
 
+    m_parser->SetProgressReporter( nullptr, nullptr );
+
     // Give the filename to the board if it's new
     if( !aAppendToMe )
         board->SetFileName( aFileName );
 
+    // Best effort: the next load reads the board file if there is no snapshot
+    if( useSnapshot )
+        WriteBoardSnapshot( board, aFileName );
+
     return board;
 }
 
@@ -2101,6 +2182,7 @@ BOARD* PCB_IO::DoLoad( LINE_READER& aReader, BOARD* aAppendToMe, const PROPERTIE
 
     m_parser->SetLineReader( &aReader );
     m_parser->SetBoard( aAppendToMe );
+    m_parser->SetDialogRunner( m_dialogRunner );
 
     BOARD* board;
 
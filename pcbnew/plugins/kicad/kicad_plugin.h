@@ -26,6 +26,7 @@
 #define KICAD_PLUGIN_H_
 
 #include <io_mgr.h>
+#include <functional>
 #include <string>
 #include <layers_id_colors_and_visibility.h>
 
@@ -33,6 +34,7 @@ class BOARD;
 class BOARD_ITEM;
 class FP_CACHE;
 class PCB_PARSER;
+class PROGRESS_REPORTER;
 class NETINFO_MAPPING;
 class BOARD_DESIGN_SETTINGS;
 class DIMENSION_BASE;
@@ -91,7 +93,8 @@ class PCB_TEXT;
 //#define SEXPR_BOARD_FILE_VERSION    20201002  // Add groups in footprints (for footprint editor).
 //#define SEXPR_BOARD_FILE_VERSION    20201114  // Add first-class support for filled shapes.
 //#define SEXPR_BOARD_FILE_VERSION    20201115  // module -> footprint and change fill syntax.
-#define SEXPR_BOARD_FILE_VERSION    20201116  // Write version and generator string in footprint files.
+//#define SEXPR_BOARD_FILE_VERSION    20201116  // Write version and generator string in footprint files.
+#define SEXPR_BOARD_FILE_VERSION    20210106  // Arcs in zone fill polygons.
 
 #define BOARD_FILE_HOST_VERSION       20200825  ///< Earlier files than this include the host tag
 
@@ -104,6 +107,8 @@ class PCB_TEXT;
 //#define CTL_OMIT_HIDE             (1 << 6)    // found and defined in eda_text.h
 #define CTL_OMIT_LIBNAME            (1 << 7)    ///< Omit lib alias when saving (used for board/not library)
 #define CTL_OMIT_FOOTPRINT_VERSION  (1 << 8)    ///< Omit the version string from the (footprint ) sexpr group
+#define CTL_OMIT_TRACKS             (1 << 9)    ///< Omit the tracks and vias of a board
+#define CTL_OMIT_ZONE_FILLS         (1 << 10)   ///< Omit the filled areas of zones
 
 // common combinations of the above:
 
@@ -198,6 +203,13 @@ public:
      */
     void Format( BOARD_ITEM* aItem, int aNestLevel = 0 ) const;
 
+    /**
+     * Output \a aBoard to \a aFormatter as a complete board file, as saved by Save().
+     *
+     * @throw IO_ERROR on write error.
+     */
+    void FormatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter );
+
     std::string GetStringOutput( bool doClear )
     {
         std::string ret = m_sf.GetString();
@@ -210,6 +222,22 @@ public:
 
     void SetOutputFormatter( OUTPUTFORMATTER* aFormatter ) { m_out = aFormatter; }
 
+    /**
+     * Report the progress of the next Load()s to \a aReporter.  The reporter is only updated,
+     * so that Load() may run on another thread than the one refreshing the reporter.  Load()
+     * throws an IO_ERROR "CANCEL" when the reporter is cancelled.
+     */
+    void SetProgressReporter( PROGRESS_REPORTER* aReporter ) { m_progressReporter = aReporter; }
+
+    /**
+     * Show the dialogs raised by the next Load()s with \a aRunner, which is given a function
+     * showing the dialog.  Used to show them on the UI thread when loading on another one.
+     */
+    void SetDialogRunner( const std::function<void( const std::function<void()>& )>& aRunner )
+    {
+        m_dialogRunner = aRunner;
+    }
+
     BOARD_ITEM* Parse( const wxString& aClipboardSourceInput );
 
 protected:
@@ -231,6 +259,9 @@ protected:
     NETINFO_MAPPING*    m_mapping;  ///< mapping for net codes, so only not empty net codes
                                     ///< are stored with consecutive integers as net codes
 
+    PROGRESS_REPORTER*  m_progressReporter;     ///< optional, for loads only
+    std::function<void( const std::function<void()>& )> m_dialogRunner;
+
     void validateCache( const wxString& aLibraryPath, bool checkModified = true );
 
     const FOOTPRINT* getFootprint( const wxString& aLibraryPath, const wxString& aFootprintName,
@@ -54,6 +54,7 @@
 #include <plugins/kicad/pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
 #include <template_fieldnames.h>
+#include <widgets/progress_reporter.h>
 
 using namespace PCB_KEYS_T;
 
@@ -61,6 +62,7 @@ using namespace PCB_KEYS_T;
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
+    m_lastProgressLine = 0;
     m_tooRecent = false;
     m_requiredVersion = 0;
     m_layerIndices.clear();
@@ -136,6 +138,37 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 }
 
 
+void PCB_PARSER::checkpoint()
+{
+    const unsigned PROGRESS_DELTA = 250;
+
+    if( m_progressReporter && m_progressReader )
+    {
+        unsigned curLine = CurLineNumber();
+
+        if( curLine > m_lastProgressLine + PROGRESS_DELTA )
+        {
+            m_progressReporter->SetCurrentProgress( double( m_progressReader->CurPos() )
+                                                    / std::max( 1L, m_fileLength ) );
+
+            if( m_progressReporter->IsCancelled() )
+                THROW_IO_ERROR( wxT( "CANCEL" ) );
+
+            m_lastProgressLine = curLine;
+        }
+    }
+}
+
+
+void PCB_PARSER::showDialog( const std::function<void()>& aShowDialog )
+{
+    if( m_dialogRunner )
+        m_dialogRunner( aShowDialog );
+    else
+        aShowDialog();
+}
+
+
 double PCB_PARSER::parseDouble()
 {
     char* tmp;
@@ -539,6 +572,8 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 
     for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
     {
+        checkpoint();
+
         if( token != T_LEFT )
             Expecting( T_LEFT );
 
@@ -648,12 +683,20 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         for( const wxString& undefinedLayer : m_undefinedLayers )
             details += wxT( "\n   " ) + undefinedLayer;
 
-        wxRichMessageDialog dlg( nullptr, msg, _( "Warning" ),
-                                 wxYES_NO | wxCANCEL | wxCENTRE | wxICON_WARNING | wxSTAY_ON_TOP );
-        dlg.ShowDetailedText( details );
-        dlg.SetYesNoCancelLabels( _( "Rescue" ), _( "Delete" ), _( "Cancel" ) );
+        int answer = wxID_CANCEL;
 
-        switch( dlg.ShowModal() )
+        showDialog( [&]()
+                {
+                    wxRichMessageDialog dlg( nullptr, msg, _( "Warning" ),
+                                             wxYES_NO | wxCANCEL | wxCENTRE | wxICON_WARNING
+                                                     | wxSTAY_ON_TOP );
+                    dlg.ShowDetailedText( details );
+                    dlg.SetYesNoCancelLabels( _( "Rescue" ), _( "Delete" ), _( "Cancel" ) );
+
+                    answer = dlg.ShowModal();
+                } );
+
+        switch( answer )
         {
         case wxID_YES:    deleteItems = false; break;
         case wxID_NO:     deleteItems = true;  break;
@@ -4515,15 +4558,22 @@ ZONE* PCB_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
                         if( m_showLegacyZoneWarning )
                         {
-                            KIDIALOG dlg( nullptr,
-                                          _( "The legacy segment fill mode is no longer supported.\n"
-                                             "Convert zones to polygon fills?"),
-                                          _( "Legacy Zone Warning" ),
-                                          wxYES_NO | wxICON_WARNING );
+                            int answer = wxID_NO;
+
+                            showDialog( [&]()
+                                    {
+                                        KIDIALOG dlg( nullptr,
+                                                      _( "The legacy segment fill mode is no longer supported.\n"
+                                                         "Convert zones to polygon fills?"),
+                                                      _( "Legacy Zone Warning" ),
+                                                      wxYES_NO | wxICON_WARNING );
+
+                                        dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
 
-                            dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
+                                        answer = dlg.ShowModal();
+                                    } );
 
-                            if( dlg.ShowModal() == wxID_NO )
+                            if( answer == wxID_NO )
                                 THROW_IO_ERROR( wxT( "CANCEL" ) );
 
                             m_showLegacyZoneWarning = false;
@@ -4791,7 +4841,47 @@ ZONE* PCB_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
 
                 for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
                 {
-                    poly.Append( parseXY() );
+                    if( token != T_LEFT )
+                        Expecting( T_LEFT );
+
+                    token = NextTok();
+
+                    if( token == T_arc )
+                    {
+                        // Arcs are saved by their end points since version 20210106
+                        wxPoint arcPts[3];
+
+                        for( int ii = 0; ii < 3; ++ii )
+                        {
+                            NeedLEFT();
+                            token = NextTok();
+
+                            if( token != T_start && token != T_mid && token != T_end )
+                                Expecting( "start, mid or end" );
+
+                            wxPoint& arcPt = arcPts[token == T_start ? 0 : token == T_mid ? 1 : 2];
+
+                            arcPt.x = parseBoardUnits( "X coordinate" );
+                            arcPt.y = parseBoardUnits( "Y coordinate" );
+                            NeedRIGHT();
+                        }
+
+                        NeedRIGHT();
+                        poly.Outline( idx ).Append( SHAPE_ARC( arcPts[0], arcPts[1],
+                                                               arcPts[2], 0 ) );
+                    }
+                    else if( token == T_xy )
+                    {
+                        int x = parseBoardUnits( "X coordinate" );
+                        int y = parseBoardUnits( "Y coordinate" );
+
+                        NeedRIGHT();
+                        poly.Append( x, y );
+                    }
+                    else
+                    {
+                        Expecting( "xy or arc" );
+                    }
                 }
 
                 NeedRIGHT();
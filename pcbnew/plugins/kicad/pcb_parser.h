@@ -36,6 +36,7 @@
 #include <math/util.h>                           // KiROUND, Clamp
 #include <pcb_lexer.h>
 
+#include <functional>
 #include <unordered_map>
 
 
@@ -58,6 +59,7 @@ class PCB_TARGET;
 class VIA;
 class ZONE;
 class FP_3DMODEL;
+class PROGRESS_REPORTER;
 struct LAYER;
 
 
@@ -84,6 +86,14 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    PROGRESS_REPORTER*  m_progressReporter;  ///< optional; may be updated from another thread
+    FILE_LINE_READER*   m_progressReader;    ///< the file whose position is the progress
+    long int            m_fileLength;        ///< for progress reporting
+    unsigned            m_lastProgressLine;
+
+    ///> Shows the dialogs, on the UI thread if the parser runs on another one
+    std::function<void( const std::function<void()>& )> m_dialogRunner;
+
     // Group membership info refers to other Uuids in the file.
     // We don't want to rely on group declarations being last in the file, so
     // we store info about the group declarations here during parsing and then resolve
@@ -125,6 +135,17 @@ class PCB_PARSER : public PCB_LEXER
      */
     void init();
 
+    /**
+     * Report the progress of the parsing, and throw an IO_ERROR "CANCEL" if the progress
+     * reporter was cancelled.
+     */
+    void checkpoint();
+
+    /**
+     * Run \a aShowDialog with the dialog runner, if any.
+     */
+    void showDialog( const std::function<void()>& aShowDialog );
+
     /**
      * Creates a mapping from the (short-lived) bug where layer names were translated
      * TODO: Remove this once we support custom layer names
@@ -336,7 +357,11 @@ public:
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
         m_board( 0 ),
-        m_resetKIIDs( false )
+        m_resetKIIDs( false ),
+        m_progressReporter( nullptr ),
+        m_progressReader( nullptr ),
+        m_fileLength( 0 ),
+        m_lastProgressLine( 0 )
     {
         init();
     }
@@ -365,6 +390,27 @@ public:
             m_resetKIIDs = true;
     }
 
+    /**
+     * Report the progress of the next boards parsed from \a aReader to \a aReporter, as the
+     * position in the file.  The reporter is only updated, so it may be refreshed by another
+     * thread.
+     */
+    void SetProgressReporter( PROGRESS_REPORTER* aReporter, FILE_LINE_READER* aReader )
+    {
+        m_progressReporter = aReporter;
+        m_progressReader = aReader;
+        m_fileLength = aReader ? aReader->FileLength() : 0;
+    }
+
+    /**
+     * Show the dialogs raised while parsing with \a aRunner, which is given a function
+     * showing the dialog.  Used to show them on the UI thread when parsing on another one.
+     */
+    void SetDialogRunner( const std::function<void( const std::function<void()>& )>& aRunner )
+    {
+        m_dialogRunner = aRunner;
+    }
+
     BOARD_ITEM* Parse();
     /**
      * Function parseFOOTPRINT
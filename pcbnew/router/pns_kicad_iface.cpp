@@ -47,6 +47,7 @@
 #include <drc/drc_engine.h>
 
 #include <memory>
+#include <mutex>
 
 #include <advanced_config.h>
 
@@ -97,6 +98,9 @@ private:
     VIA                m_dummyVia;
 
     std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_clearanceCache;
+
+    ///> Guards the cache and the dummy items when candidates are evaluated concurrently
+    std::mutex         m_mutex;
 };
 
 
@@ -218,6 +222,8 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
     BOARD_ITEM*    parentB = aItemB ? aItemB->Parent() : nullptr;
     DRC_CONSTRAINT hostConstraint;
 
+    std::unique_lock<std::mutex> lock( m_mutex );
+
     // A track being routed may not have a BOARD_ITEM associated yet.
     if( aItemA && !parentA )
     {
@@ -261,6 +267,8 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
                                                        (PCB_LAYER_ID) aLayer );
     }
 
+    lock.unlock();
+
     if( hostConstraint.IsNull() )
         return false;
 
@@ -285,10 +293,14 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
 int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
 {
     std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
-    auto it = m_clearanceCache.find( key );
 
-    if( it != m_clearanceCache.end() )
-        return it->second;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto it = m_clearanceCache.find( key );
+
+        if( it != m_clearanceCache.end() )
+            return it->second;
+    }
 
     PNS::CONSTRAINT constraint;
     bool ok = false;
@@ -319,6 +331,7 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
     if( !ok )
         rv = m_board->GetDesignSettings().m_MinClearance;
 
+    std::lock_guard<std::mutex> lock( m_mutex );
     m_clearanceCache[ key ] = rv;
 
     return rv;
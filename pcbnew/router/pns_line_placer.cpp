@@ -20,6 +20,7 @@
  */
 
 #include <core/optional.h>
+#include <future>
 #include <memory>
 
 #include "pns_arc.h"
@@ -387,8 +388,34 @@ VECTOR2I closestProjectedPoint( const SHAPE_LINE_CHAIN& line, const VECTOR2I& p
 }
 
 
+static int walkaroundOptimizerEffort( const ROUTING_SETTINGS& aSettings )
+{
+    int effort = 0;
+
+    switch( aSettings.OptimizerEffort() )
+    {
+    case OE_LOW:
+        effort = 0;
+        break;
+
+    case OE_MEDIUM:
+    case OE_FULL:
+        effort = OPTIMIZER::MERGE_SEGMENTS;
+        break;
+    }
+
+    if( aSettings.SmartPads() )
+        effort |= OPTIMIZER::SMART_PADS;
+
+    return effort;
+}
+
+
 bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
 {
+    if( Settings().SpeculativeThreads() > 1 )
+        return rhWalkSpeculative( aP, aNewHead );
+
     LINE initTrack( m_head );
     LINE walkFull( m_head );
     int effort = 0;
@@ -435,20 +462,7 @@ bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
 
     Dbg()->AddLine( walkFull.CLine(), 2, 100000, "walk-full" );
 
-    switch( Settings().OptimizerEffort() )
-    {
-    case OE_LOW:
-        effort = 0;
-        break;
-
-    case OE_MEDIUM:
-    case OE_FULL:
-        effort = OPTIMIZER::MERGE_SEGMENTS;
-        break;
-    }
-
-    if( Settings().SmartPads() )
-        effort |= OPTIMIZER::SMART_PADS;
+    effort = walkaroundOptimizerEffort( Settings() );
 
     if( wr.statusCw == WALKAROUND::STUCK || wr.statusCcw == WALKAROUND::STUCK )
     {
@@ -475,6 +489,109 @@ bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
 }
 
 
+bool LINE_PLACER::rhWalkSpeculative( const VECTOR2I& aP, LINE& aNewHead )
+{
+    LINE initTrack( m_head );
+    bool viaOk = buildInitialLine( aP, initTrack );
+    int  effort = walkaroundOptimizerEffort( Settings() );
+
+    TIME_LIMIT timeLimit = Settings().WalkaroundTimeLimit();
+
+    // Branching modifies the parent, so it is done here.  The workers only read their branch.
+    NODE* branches[2] = { m_currentNode->Branch(), m_currentNode->Branch() };
+    LINE  candidates[2];
+    bool  valid[2] = { false, false };
+
+    timeLimit.Restart();
+
+    auto walk =
+            [&]( int aIdx )
+            {
+                NODE*      node = branches[aIdx];
+                bool       cw = ( aIdx == 0 );
+                WALKAROUND walkaround( node, Router() );
+
+                // No debug decorator: it isn't thread safe
+                walkaround.SetSolidsOnly( false );
+                walkaround.SetIterationLimit( Settings().WalkaroundIterationLimit() );
+                walkaround.SetForceWinding( true, cw );
+                walkaround.SetTimeLimit( timeLimit );
+
+                WALKAROUND::RESULT            wr = walkaround.Route( initTrack );
+                WALKAROUND::WALKAROUND_STATUS status = cw ? wr.statusCw : wr.statusCcw;
+                SHAPE_LINE_CHAIN              path = cw ? wr.lineCw.CLine() : wr.lineCcw.CLine();
+
+                if( status == WALKAROUND::ALMOST_DONE )
+                    path = path.Slice( 0, path.Split( closestProjectedPoint( path, aP ) ) );
+
+                LINE& line = candidates[aIdx];
+
+                line = m_head;
+                line.SetShape( path );
+
+                if( line.PointCount() == 0 )
+                    return;
+
+                if( status == WALKAROUND::STUCK )
+                    line = line.ClipToNearestObstacle( node );
+                else if( m_placingVia && viaOk )
+                    line.AppendVia( makeVia( line.CPoint( -1 ) ) );
+
+                OPTIMIZER optimizer( node );
+
+                optimizer.SetEffortLevel( effort );
+                optimizer.SetCollisionMask( -1 );
+                optimizer.Optimize( &line );
+
+                valid[aIdx] = !node->CheckColliding( &line );
+            };
+
+    // Only two candidates, so a single extra thread is all we can use
+    std::future<void> cwWalk = std::async( std::launch::async, walk, 0 );
+
+    walk( 1 );
+    cwWalk.get();
+
+    delete branches[0];
+    delete branches[1];
+
+    int best = -1;
+
+    if( valid[0] && valid[1] )
+    {
+        COST_ESTIMATOR costCw, costCcw;
+
+        costCw.Add( candidates[0] );
+        costCcw.Add( candidates[1] );
+
+        if( costCw.IsBetter( costCcw, 1.0, 1.0 ) )
+            best = 1;
+        else if( costCcw.IsBetter( costCw, 1.0, 1.0 ) )
+            best = 0;
+        else
+            best = costCcw.GetLengthCost() < costCw.GetLengthCost() ? 1 : 0;
+    }
+    else if( valid[0] || valid[1] )
+    {
+        best = valid[0] ? 0 : 1;
+    }
+
+    if( best < 0 )
+    {
+        aNewHead = m_head;
+        return false;
+    }
+
+    m_head = candidates[best];
+    aNewHead = m_head;
+
+    if( Dbg() )
+        Dbg()->AddLine( m_head.CLine(), 2, 100000, "walk-full" );
+
+    return true;
+}
+
+
 bool LINE_PLACER::rhMarkObstacles( const VECTOR2I& aP, LINE& aNewHead )
 {
     LINE newHead( m_head ), bestHead( m_head );
@@ -411,6 +411,14 @@ private:
     ///> route step, walkaround mode
     bool rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead);
 
+    /**
+     * Route step, walkaround mode, with the clockwise and counter-clockwise candidates walked
+     * and optimized concurrently on their own branches of the current node (see
+     * ROUTING_SETTINGS::SpeculativeThreads()).  The cheapest candidate according to the
+     * COST_ESTIMATOR wins.
+     */
+    bool rhWalkSpeculative( const VECTOR2I& aP, LINE& aNewHead );
+
     ///> route step, shove mode
     bool rhShoveOnly( const VECTOR2I& aP, LINE& aNewHead);
 
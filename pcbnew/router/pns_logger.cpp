@@ -26,6 +26,9 @@
 #include "pns_segment.h"
 #include "pns_solid.h"
 
+#include <cstring>
+
+#include <board_item.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_rect.h>
@@ -47,6 +50,7 @@ LOGGER::~LOGGER()
 void LOGGER::Clear()
 {
     m_events.clear();
+    ClearStats();
 }
 
 
@@ -56,17 +60,92 @@ void LOGGER::Save( const std::string& aFilename )
 
     wxLogTrace( "PNS", "Saving to '%s' [%p]", aFilename.c_str(), f );
 
-    for( const auto evt : m_events )
+    if( !f )
+        return;
+
+    for( const EVENT_ENTRY& evt : m_events )
+    {
+        wxString id = "null";
+
+        if( evt.uuid != niluuid )
+            id = evt.uuid.AsString();
+
+        fprintf( f, "event %d %d %d %s\n", evt.p.x, evt.p.y, evt.type, (const char*) id.c_str() );
+    }
+
+    fclose( f );
+}
+
+
+bool LOGGER::Load( const std::string& aFilename )
+{
+    FILE* f = fopen( aFilename.c_str(), "rb" );
+
+    if( !f )
+        return false;
+
+    m_events.clear();
+
+    char line[1024];
+    bool ok = true;
+
+    while( fgets( line, sizeof( line ), f ) )
     {
-        uint64_t id = 0;
-        if( evt.item && evt.item->Parent() )
+        char     tag[32];
+        char     id[64];
+        int      x, y, type;
+
+        int n = sscanf( line, "%31s %d %d %d %63s", tag, &x, &y, &type, id );
+
+        if( n <= 0 )
+            continue;   // blank line
+
+        if( n != 5 || strcmp( tag, "event" ) != 0 || type < EVT_START_ROUTE || type > EVT_ABORT )
         {
-            const char* idString = evt.item->Parent()->m_Uuid.AsString().c_str();
-            fprintf( f, "event %d %d %d %s\n", evt.type, evt.p.x, evt.p.y, idString );
+            ok = false;
+            break;
         }
+
+        EVENT_ENTRY ent;
+
+        ent.p = VECTOR2I( x, y );
+        ent.type = static_cast<EVENT_TYPE>( type );
+        ent.item = nullptr;
+        ent.uuid = strcmp( id, "null" ) == 0 ? niluuid : KIID( wxString( id ) );
+
+        m_events.push_back( ent );
     }
 
     fclose( f );
+    return ok;
+}
+
+
+void LOGGER::AddShoveIterations( int aCount )
+{
+    std::lock_guard<std::mutex> lock( m_statsMutex );
+    m_stats.shoveIterations += aCount;
+}
+
+
+void LOGGER::AddOptimizerTime( double aMsecs )
+{
+    std::lock_guard<std::mutex> lock( m_statsMutex );
+    m_stats.optimizerTime += aMsecs;
+}
+
+
+LOGGER::STATS LOGGER::GetStats() const
+{
+    std::lock_guard<std::mutex> lock( m_statsMutex );
+    return m_stats;
+}
+
+
+void LOGGER::ClearStats()
+{
+    std::lock_guard<std::mutex> lock( m_statsMutex );
+    m_stats = STATS();
 }
 
 
@@ -77,6 +156,7 @@ void LOGGER::Log( LOGGER::EVENT_TYPE evt, VECTOR2I pos, const ITEM* item )
     ent.type = evt;
     ent.p = pos;
     ent.item = item;
+    ent.uuid = item && item->Parent() ? item->Parent()->m_Uuid : niluuid;
 
     m_events.push_back( ent );
 
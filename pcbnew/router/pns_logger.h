@@ -23,11 +23,13 @@
 #define __PNS_LOGGER_H
 
 #include <cstdio>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <sstream>
 
 #include <math/vector2d.h>
+#include <kiid.h>
 
 class SHAPE_LINE_CHAIN;
 class SHAPE;
@@ -52,12 +54,31 @@ public:
         VECTOR2I p;
         EVENT_TYPE type;
         const ITEM* item;
+        KIID uuid;      ///< uuid of the item's parent, niluuid if none.  Survives Save()/Load().
+    };
+
+    ///> Counters accumulated by the routing algorithms while the events are processed
+    struct STATS {
+        int    shoveIterations = 0;
+        double optimizerTime = 0.0;     ///< in milliseconds
     };
 
     LOGGER();
     ~LOGGER();
 
+    /**
+     * Write the event stream as "event x y type uuid" lines (uuid is "null" for events
+     * without an item), the same format the router tool dumps in debug builds.
+     */
     void Save( const std::string& aFilename );
+
+    /**
+     * Read an event stream written by Save().  Loaded events have no item, only its uuid.
+     *
+     * @return false if the file could not be read or is malformed.
+     */
+    bool Load( const std::string& aFilename );
+
     void Clear();
     void Log( EVENT_TYPE evt, VECTOR2I pos, const ITEM* item = nullptr );
 
@@ -66,8 +87,17 @@ public:
         return m_events;
     }
 
+    // The counters may be updated by candidates evaluated on worker threads
+    void AddShoveIterations( int aCount );
+    void AddOptimizerTime( double aMsecs );
+
+    STATS GetStats() const;
+    void ClearStats();
+
 private:
     std::vector<EVENT_ENTRY> m_events;
+    STATS                    m_stats;
+    mutable std::mutex       m_statsMutex;
 };
 
 }
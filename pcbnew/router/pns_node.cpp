@@ -52,7 +52,9 @@ NODE::NODE()
     m_parent = NULL;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
-    m_index = new INDEX;
+    m_joints = std::make_shared<JOINT_MAP>();
+    m_override = std::make_shared<ITEM_OVERRIDES>();
+    m_index = std::make_shared<INDEX>();
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -80,18 +82,19 @@ NODE::~NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
-
-    for( ITEM* item : *m_index )
+    // Items are owned by the node which added them, and adding an item detaches the index
+    // from the parent branch.  An index we still share can't hold any of our items.
+    if( m_index.use_count() == 1 )
     {
-        if( item->BelongsTo( this ) )
-            delete item;
+        for( ITEM* item : *m_index )
+        {
+            if( item->BelongsTo( this ) )
+                delete item;
+        }
     }
 
     releaseGarbage();
     unlinkParent();
-
-    delete m_index;
 }
 
 int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
@@ -117,26 +120,58 @@ NODE* NODE::Branch()
     child->m_root = isRoot() ? this : m_root;
     child->m_maxClearance = m_maxClearance;
 
-    // Immmediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // Immmediate offspring of the root branch needs not copy anything. The rest share joints,
+    // overridden item maps and stored items with this node; whichever of the two is modified
+    // first makes its own copy (see writableJoints(), writableOverrides() and writableIndex()).
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( ITEM* item : *m_index )
-            child->m_index->Add( item );
-
+        child->m_index = m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
 
     wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+            child->m_index->Size(), (int) child->m_joints->size(),
+            (int) child->m_override->size() );
 
     return child;
 }
 
 
+NODE::JOINT_MAP& NODE::writableJoints()
+{
+    if( m_joints.use_count() > 1 )
+        m_joints = std::make_shared<JOINT_MAP>( *m_joints );
+
+    return *m_joints;
+}
+
+
+NODE::ITEM_OVERRIDES& NODE::writableOverrides()
+{
+    if( m_override.use_count() > 1 )
+        m_override = std::make_shared<ITEM_OVERRIDES>( *m_override );
+
+    return *m_override;
+}
+
+
+INDEX& NODE::writableIndex()
+{
+    if( m_index.use_count() > 1 )
+    {
+        std::shared_ptr<INDEX> index = std::make_shared<INDEX>();
+
+        for( ITEM* item : *m_index )
+            index->Add( item );
+
+        m_index = std::move( index );
+    }
+
+    return *m_index;
+}
+
+
 void NODE::unlinkParent()
 {
     if( isRoot() )
@@ -541,7 +576,7 @@ void NODE::addSolid( SOLID* aSolid )
     if( aSolid->IsRoutable() )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
-    m_index->Add( aSolid );
+    writableIndex().Add( aSolid );
 }
 
 void NODE::Add( std::unique_ptr< SOLID > aSolid )
@@ -554,7 +589,7 @@ void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
 
-    m_index->Add( aVia );
+    writableIndex().Add( aVia );
 }
 
 void NODE::Add( std::unique_ptr< VIA > aVia )
@@ -619,7 +654,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
-    m_index->Add( aSeg );
+    writableIndex().Add( aSeg );
 }
 
 bool NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -644,7 +679,7 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 0 ), aArc->Layers(), aArc->Net(), aArc );
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
-    m_index->Add( aArc );
+    writableIndex().Add( aArc );
 }
 
 void NODE::Add( std::unique_ptr< ARC > aArc )
@@ -678,12 +713,12 @@ void NODE::doRemove( ITEM* aItem )
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+        writableOverrides().insert( aItem );
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
-        m_index->Remove( aItem );
+        writableIndex().Remove( aItem );
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -720,13 +755,15 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
     tag.net = net;
     tag.pos = aJoint->Pos();
 
+    JOINT_MAP& joints = writableJoints();
+
     bool split;
     do
     {
         split = false;
-        auto range = m_joints.equal_range( tag );
+        auto range = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         // find and remove all joints containing the via to be removed
@@ -735,7 +772,7 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
         {
             if( aItem->LayersOverlap( &f->second ) )
             {
-                m_joints.erase( f );
+                joints.erase( f );
                 split = true;
                 break;
             }
@@ -1039,12 +1076,12 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
+    JOINT_MAP::iterator f = m_joints->find( tag ), end = m_joints->end();
 
     if( f == end && !isRoot() )
     {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
+        end = m_root->m_joints->end();
+        f = m_root->m_joints->find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
     }
 
     if( f == end )
@@ -1076,18 +1113,20 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
+    JOINT_MAP& joints = writableJoints();
+
     // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
+    JOINT_MAP::iterator f = joints.find( tag );
 
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
     // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    if( f == joints.end() && !isRoot() )
     {
-        range = m_root->m_joints.equal_range( tag );
+        range = m_root->m_joints->equal_range( tag );
 
         for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
+            joints.insert( *f );
     }
 
     // now insert and combine overlapping joints
@@ -1098,9 +1137,9 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     do
     {
         merged  = false;
-        range   = m_joints.equal_range( tag );
+        range   = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         for( f = range.first; f != range.second; ++f )
@@ -1108,7 +1147,7 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
             if( aLayers.Overlaps( f->second.Layers() ) )
             {
                 jt.Merge( f->second );
-                m_joints.erase( f );
+                joints.erase( f );
                 merged = true;
                 break;
             }
@@ -1116,7 +1155,7 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     }
     while( merged );
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return joints.insert( TagJointPair( tag, jt ) )->second;
 }
 
 
@@ -1170,7 +1209,7 @@ void NODE::Dump( bool aLong )
     JOINT_MAP::iterator j;
 
     if( aLong )
-        for( j = m_joints.begin(); j != m_joints.end(); ++j )
+        for( j = m_joints->begin(); j != m_joints->end(); ++j )
         {
             wxLogTrace( "PNS", "joint : %s, links : %d\n",
                     j->second.GetPos().Format().c_str(), j->second.LinkCount() );
@@ -1222,7 +1261,7 @@ void NODE::Dump( bool aLong )
         lines_count++;
     }
 
-    wxLogTrace( "PNS", "Local joints: %d, lines : %d \n", m_joints.size(), lines_count );
+    wxLogTrace( "PNS", "Local joints: %d, lines : %d \n", m_joints->size(), lines_count );
 #endif
 }
 
@@ -1232,13 +1271,13 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
+    if( m_override->size() )
+        aRemoved.reserve( m_override->size() );
 
     if( m_index->Size() )
         aAdded.reserve( m_index->Size() );
 
-    for( ITEM* item : m_override )
+    for( ITEM* item : *m_override )
         aRemoved.push_back( item );
 
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
@@ -1278,7 +1317,7 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
+        for( ITEM* item : *aNode->m_override )
             Remove( item );
 
         for( auto i : *aNode->m_index )
@@ -1424,7 +1463,7 @@ int NODE::QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints, int aLay
 
     aJoints.clear();
 
-    for( auto j = m_joints.begin(); j != m_joints.end(); ++j )
+    for( auto j = m_joints->begin(); j != m_joints->end(); ++j )
     {
         if( aBox.Contains( j->second.Pos() ) && j->second.LinkCount( aKindMask ) )
         {
@@ -1436,7 +1475,7 @@ int NODE::QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints, int aLay
     if( isRoot() )
         return n;
 
-    for( auto j = m_root->m_joints.begin(); j != m_root->m_joints.end(); ++j )
+    for( auto j = m_root->m_joints->begin(); j != m_root->m_joints->end(); ++j )
     {
         if( !Overrides( &j->second) )
         {
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -205,7 +206,7 @@ public:
     ///> Returns the number of joints
     int JointCount() const
     {
-        return m_joints.size();
+        return m_joints->size();
     }
 
     ///> Returns the number of nodes in the inheritance chain (wrs to the root node)
@@ -357,6 +358,9 @@ public:
      * Creates a lightweight copy (called branch) of self that tracks
      * the changes (added/removed items) wrs to the root. Note that if there are
      * any branches in use, their parents must NOT be deleted.
+     *
+     * The branch shares the joints, overrides and index of its parent until either of them
+     * is modified, so branching (and killing a branch which was never modified) is cheap.
      * @return the new branch
      */
     NODE* Branch();
@@ -457,13 +461,14 @@ public:
     ///> from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override->find( aItem ) != m_override->end();
     }
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
     typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
     typedef JOINT_MAP::value_type TagJointPair;
+    typedef std::unordered_set<ITEM*> ITEM_OVERRIDES;
 
     /// nodes are not copyable
     NODE( const NODE& aB );
@@ -492,6 +497,12 @@ private:
     void removeViaIndex( VIA* aVia );
     void removeArcIndex( ARC* aVia );
 
+    ///> copy-on-write accessors: detach the joint map, overrides or index from the other
+    ///> branches sharing it before modifying it
+    JOINT_MAP& writableJoints();
+    ITEM_OVERRIDES& writableOverrides();
+    INDEX& writableIndex();
+
     void doRemove( ITEM* aItem );
     void unlinkParent();
     void releaseChildren();
@@ -516,8 +527,8 @@ private:
             LINKED_ITEM** aSegments, bool& aGuardHit, bool aStopAtLockedJoints );
 
     ///> hash table with the joints, linking the items. Joints are hashed by
-    ///> their position, layer set and net.
-    JOINT_MAP m_joints;
+    ///> their position, layer set and net. Shared with the parent branch until modified.
+    std::shared_ptr<JOINT_MAP> m_joints;
 
     ///> node this node was branched from
     NODE* m_parent;
@@ -528,8 +539,9 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    ///> hash of root's items that have been changed in this node. Shared with the parent
+    ///> branch until modified.
+    std::shared_ptr<ITEM_OVERRIDES> m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -537,8 +549,8 @@ private:
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
-    INDEX* m_index;
+    ///> Geometric/Net index of the items. Shared with the parent branch until modified.
+    std::shared_ptr<INDEX> m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
@@ -26,8 +26,11 @@
 
 #include <cmath>
 
+#include <profile.h>
+
 #include "pns_arc.h"
 #include "pns_line.h"
+#include "pns_logger.h"
 #include "pns_diff_pair.h"
 #include "pns_node.h"
 #include "pns_solid.h"
@@ -600,6 +603,8 @@ bool OPTIMIZER::mergeFull( LINE* aLine )
 
 bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 {
+    PROF_COUNTER timer;
+
     if( !aResult )
         aResult = aLine;
     else
@@ -642,6 +647,11 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
     if( m_effortLevel & FANOUT_CLEANUP )
         rv |= fanoutCleanup( aResult );
 
+    ROUTER* router = ROUTER::GetInstance();
+
+    if( router && router->Logger() )
+        router->Logger()->AddOptimizerTime( timer.msecs() );
+
     return rv;
 }
 
@@ -156,6 +156,9 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     m_dragger->SetLogger( m_logger );
     m_dragger->SetDebugDecorator ( m_iface->GetDebugDecorator () );
 
+    if( m_logger )
+        m_logger->Log( LOGGER::EVT_START_DRAG, aP, aStartItems[0] );
+
     if( m_dragger->Start ( aP, aStartItems ) )
     {
         m_state = DRAG_SEGMENT;
@@ -459,6 +462,9 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    if( m_logger )
+        m_logger->Log( LOGGER::EVT_ABORT, m_currentEnd, nullptr );
+
     m_placer.reset();
     m_dragger.reset();
 
@@ -132,6 +132,10 @@ public:
     int WalkaroundIterationLimit() const { return m_walkaroundIterationLimit; };
     TIME_LIMIT WalkaroundTimeLimit() const;
 
+    ///> Returns the number of threads evaluating routing candidates concurrently (1 = serial).
+    int SpeculativeThreads() const { return m_speculativeThreads; }
+    void SetSpeculativeThreads( int aThreads ) { m_speculativeThreads = aThreads; }
+
     void SetInlineDragEnabled ( bool aEnable ) { m_inlineDragEnabled = aEnable; }
     bool InlineDragEnabled() const { return m_inlineDragEnabled; }
 
@@ -193,6 +197,7 @@ private:
     int m_shoveIterationLimit;
     TIME_LIMIT m_shoveTimeLimit;
     TIME_LIMIT m_walkaroundTimeLimit;
+    int m_speculativeThreads;
 };
 
 }
@@ -1247,6 +1247,9 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         }
     }
 
+    if( LOGGER* logger = Router()->Logger() )
+        logger->AddShoveIterations( m_iter );
+
     return st;
 }
 
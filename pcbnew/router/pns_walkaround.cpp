@@ -157,7 +157,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
 
 
-bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
+bool clipToLoopStart( SHAPE_LINE_CHAIN& l, DEBUG_DECORATOR* aDbg )
 {
     auto ip = l.SelfIntersecting();
 
@@ -170,8 +170,8 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
         int pidx2 = tail.Split( ip->p );
 
-        auto dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-        dbg->AddPoint( ip->p, 5 );
+        if( aDbg )
+            aDbg->AddPoint( ip->p, 5 );
 
         l = lead;
         l.Append( tail.Slice( 0, pidx2 ) );
@@ -227,10 +227,10 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 
         auto old = path_cw.CLine();
 
-        if( clipToLoopStart( path_cw.Line() ) )
+        if( clipToLoopStart( path_cw.Line(), Dbg() ) )
             s_cw = ALMOST_DONE;
 
-        if( clipToLoopStart( path_ccw.Line() ) )
+        if( clipToLoopStart( path_ccw.Line(), Dbg() ) )
             s_ccw = ALMOST_DONE;
 
 
@@ -249,6 +249,9 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
         if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
             break;
 
+        if( m_timeLimit && m_timeLimit->Expired() )
+            break;
+
         m_iteration++;
     }
 
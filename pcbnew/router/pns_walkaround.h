@@ -29,6 +29,7 @@
 #include "pns_router.h"
 #include "pns_logger.h"
 #include "pns_algo_base.h"
+#include "time_limit.h"
 
 namespace PNS {
 
@@ -126,6 +127,15 @@ public:
         m_forceWinding = aEnabled;
     }
 
+    /**
+     * Stop walking when aLimit expires (only for the Route() variant returning a RESULT).
+     * The paths walked so far are returned as ALMOST_DONE.
+     */
+    void SetTimeLimit( const TIME_LIMIT& aLimit )
+    {
+        m_timeLimit = aLimit;
+    }
+
     void RestrictToSet( bool aEnabled, const std::set<ITEM*>& aSet )
     {
         if( aEnabled )
@@ -158,6 +168,7 @@ private:
     bool m_forceUniqueWindingDirection;
     VECTOR2I m_cursorPos;
     NODE::OPT_OBSTACLE m_currentObstacle[2];
+    OPT<TIME_LIMIT> m_timeLimit;
     bool m_recursiveCollision[2];
     std::set<ITEM*> m_restrictedSet;
 };
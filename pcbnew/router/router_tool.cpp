@@ -491,21 +491,10 @@ void ROUTER_TOOL::handleCommonEvents( const TOOL_EVENT& aEvent )
             if( ! logger )
                 return;
 
-            FILE *f = fopen("/tmp/pns.log", "wb");
             wxLogTrace( "PNS", "saving drag/route log...\n" );
 
-            const auto& events = logger->GetEvents();
-
-            for( auto evt : events)
-            {
-                wxString id = "null";
-                if( evt.item && evt.item->Parent() )
-                    id = evt.item->Parent()->m_Uuid.AsString();
-
-                fprintf(f, "event %d %d %d %s\n", evt.p.x, evt.p.y, evt.type, (const char*) id.c_str() );
-            }
-
-            fclose(f);
+            // Can be replayed with "qa_pcbnew_tools pns_replay /tmp/pns.dump /tmp/pns.log"
+            logger->Save( "/tmp/pns.log" );
 
             // Export as *.kicad_pcb format, using a strategy which is specifically chosen
             // as an example on how it could also be used to send it to the system clipboard.
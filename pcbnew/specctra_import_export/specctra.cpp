@@ -47,8 +47,12 @@
 */
 
 
+#include <algorithm>
+#include <cmath>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <build_version.h>
 
@@ -71,6 +75,97 @@ const char* GetTokenText( T aTok )
     return SPECCTRA_LEXER::TokenName( aTok );
 }
 
+
+const char* FormatNumber( char* aBuffer, double aValue )
+{
+    // The range of the fixed notation of "%.6g", and the scale giving 6 digits in each decade
+    static const double decades[] = { 1e-4, 1e-3, 1e-2, 1e-1, 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+    static const double scales[] = { 1e9, 1e8, 1e7, 1e6, 1e5, 1e4, 1e3, 1e2, 1e1, 1 };
+
+    double magnitude = std::fabs( aValue );
+
+    if( aValue == 0.0 && !std::signbit( aValue ) )
+    {
+        strcpy( aBuffer, "0" );
+        return aBuffer;
+    }
+
+    if( magnitude >= decades[0] && magnitude < decades[10] )
+    {
+        int decade = 0;
+
+        while( magnitude >= decades[decade + 1] )
+            decade++;
+
+        double scaled = magnitude * scales[decade];
+        int    exponent = decade - 4;
+
+        // printf rounds ties to even on the exact value, which the product may not be:
+        // leave them to printf
+        if( std::fabs( scaled - std::floor( scaled ) - 0.5 ) > 1e-6 )
+        {
+            uint32_t digits = (uint32_t) std::nearbyint( scaled );
+
+            if( digits == 1000000 )     // rounded up to the next decade
+            {
+                digits = 100000;
+                exponent++;
+            }
+
+            if( exponent < 6 )
+            {
+                char text[6];
+
+                for( int ii = 5; ii >= 0; --ii )
+                {
+                    text[ii] = '0' + digits % 10;
+                    digits /= 10;
+                }
+
+                // Strip the trailing zeros of the decimals
+                int last = 5;
+
+                while( last > std::max( exponent, 0 ) && text[last] == '0' )
+                    last--;
+
+                char* p = aBuffer;
+
+                if( aValue < 0 )
+                    *p++ = '-';
+
+                if( exponent < 0 )
+                {
+                    *p++ = '0';
+                    *p++ = '.';
+
+                    for( int ii = -1; ii > exponent; --ii )
+                        *p++ = '0';
+
+                    for( int ii = 0; ii <= last; ++ii )
+                        *p++ = text[ii];
+                }
+                else
+                {
+                    for( int ii = 0; ii <= last; ++ii )
+                    {
+                        *p++ = text[ii];
+
+                        if( ii == exponent && ii < last )
+                            *p++ = '.';
+                    }
+                }
+
+                *p = 0;
+                return aBuffer;
+            }
+        }
+    }
+
+    sprintf( aBuffer, "%.6g", aValue );
+    return aBuffer;
+}
+
+
 void SPECCTRA_DB::buildLayerMaps( BOARD* aBoard )
 {
     // specctra wants top physical layer first, then going down to the
@@ -3696,7 +3791,10 @@ void PLACE::Format( OUTPUTFORMATTER* out, int nestLevel )
 
     if( hasVertex )
     {
-        out->Print( 0, " %.6g %.6g", vertex.x, vertex.y );
+        char xText[32];
+        char yText[32];
+
+        out->Print( 0, " %s %s", FormatNumber( xText, vertex.x ), FormatNumber( yText, vertex.y ) );
 
         out->Print( 0, " %s", GetTokenText( side ) );
 
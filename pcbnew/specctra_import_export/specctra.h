@@ -36,6 +36,7 @@
 #include <pcbnew.h>
 
 #include <memory>
+#include <unordered_map>
 
 // all outside the DSN namespace:
 class BOARD;
@@ -85,6 +86,16 @@ class SPECCTRA_DB;
 const char* GetTokenText( T aTok );
 
 
+/**
+ * Function FormatNumber
+ * writes \a aValue to \a aBuffer as sprintf( "%.6g" ) does, but faster for the
+ * numbers commonly found in DSN files.
+ * @param aBuffer must hold at least 32 characters.
+ * @return aBuffer
+ */
+const char* FormatNumber( char* aBuffer, double aValue );
+
+
 /**
  * Struct POINT
  * is a holder for a point in the SPECCTRA DSN coordinate system.  It can also
@@ -150,7 +161,10 @@ struct POINT
      */
     void Format( OUTPUTFORMATTER* out, int nestLevel ) const
     {
-        out->Print( nestLevel, " %.6g %.6g", x, y );
+        char xText[32];
+        char yText[32];
+
+        out->Print( nestLevel, " %s %s", FormatNumber( xText, x ), FormatNumber( yText, y ) );
     }
 };
 
@@ -631,7 +645,11 @@ public:
             else
                 perLine += out->Print( 0, "  " );
 
-            perLine += out->Print( 0, "%.6g %.6g", points[i].x, points[i].y );
+            char xText[32];
+            char yText[32];
+
+            perLine += out->Print( 0, "%s %s", FormatNumber( xText, points[i].x ),
+                                   FormatNumber( yText, points[i].y ) );
         }
 
         if( aperture_type == T_square )
@@ -1793,12 +1811,18 @@ class PLACEMENT : public ELEM
 
     COMPONENTS  components;
 
+    /// Components by image id.  The parser appends directly to 'components', so the
+    /// index covers the first m_indexedComponents ones and is completed on lookup.
+    std::unordered_map<std::string, COMPONENT*> m_componentIndex;
+    unsigned                                    m_indexedComponents;
+
 public:
     PLACEMENT( ELEM* aParent ) :
         ELEM( T_placement, aParent )
     {
         unit = 0;
         flip_style = DSN_T( T_NONE );
+        m_indexedComponents = 0;
     }
 
     ~PLACEMENT()
@@ -1815,12 +1839,17 @@ public:
      */
     COMPONENT* LookupCOMPONENT( const std::string& imageName )
     {
-        for( unsigned i=0; i<components.size();  ++i )
+        for( ;  m_indexedComponents < components.size();  ++m_indexedComponents )
         {
-            if( 0 == components[i].GetImageId().compare( imageName ) )
-                return &components[i];
+            COMPONENT* comp = &components[m_indexedComponents];
+            m_componentIndex.emplace( comp->GetImageId(), comp );
         }
 
+        auto found = m_componentIndex.find( imageName );
+
+        if( found != m_componentIndex.end() )
+            return found->second;
+
         COMPONENT* added = new COMPONENT(this);
         components.push_back( added );
         added->SetImageId( imageName );
@@ -1963,9 +1992,12 @@ public:
         else
             out->Print( nestLevel, "(pin %s%s%s", quote, padstack_id.c_str(), quote );
 
+        char xText[32];
+        char yText[32];
+
         quote = out->GetQuoteChar( pin_id.c_str() );
-        out->Print( 0, " %s%s%s %.6g %.6g)\n", quote, pin_id.c_str(), quote,
-                   vertex.x, vertex.y );
+        out->Print( 0, " %s%s%s %s %s)\n", quote, pin_id.c_str(), quote,
+                   FormatNumber( xText, vertex.x ), FormatNumber( yText, vertex.y ) );
     }
 };
 typedef boost::ptr_vector<PIN>  PINS;
@@ -2021,6 +2053,17 @@ public:
      */
     static int Compare( IMAGE* lhs, IMAGE* rhs );
 
+    /**
+     * @return the hash used by Compare(), computed on first use.
+     */
+    const std::string& GetHash()
+    {
+        if( !hash.size() )
+            hash = makeHash();
+
+        return hash;
+    }
+
     std::string GetImageId()
     {
         if( duplicated )
@@ -2146,6 +2189,17 @@ public:
      */
     static int Compare( PADSTACK* lhs, PADSTACK* rhs );
 
+    /**
+     * @return the hash used by Compare(), computed on first use.
+     */
+    const std::string& GetHash()
+    {
+        if( !hash.size() )
+            hash = makeHash();
+
+        return hash;
+    }
+
 
     void SetPadstackId( const char* aPadstackId )
     {
@@ -2237,12 +2291,59 @@ class LIBRARY : public ELEM
     PADSTACKS       padstacks;      ///< all except vias, which are in 'vias'
     PADSTACKS       vias;
 
+    /*  Lookup indexes, so exporting a board with many footprints and vias is not
+        quadratic.  The parser appends directly to the containers, so each index only
+        covers the elements before its count and is completed on the next lookup.
+    */
+    std::unordered_map<std::string, int>        m_imageIndex;       ///< first image by hash
+    std::unordered_map<std::string, int>        m_imageIdCount;     ///< images by image_id
+    unsigned                                    m_indexedImages;
+    std::unordered_map<std::string, int>        m_viaIndex;         ///< by padstack_id and hash
+    unsigned                                    m_indexedVias;
+    std::unordered_map<std::string, PADSTACK*>  m_padstackIndex;    ///< first padstack by name
+    unsigned                                    m_indexedPadstacks;
+
+    void indexImages()
+    {
+        for( ;  m_indexedImages < images.size();  ++m_indexedImages )
+        {
+            IMAGE& image = images[m_indexedImages];
+
+            m_imageIndex.emplace( image.GetHash(), (int) m_indexedImages );
+            m_imageIdCount[image.image_id]++;
+        }
+    }
+
+    static std::string viaKey( PADSTACK* aVia )
+    {
+        // Via names hold the drill diameters, see PADSTACK::Compare()
+        return aVia->GetPadstackId() + '\n' + aVia->GetHash();
+    }
+
+    void indexVias()
+    {
+        for( ;  m_indexedVias < vias.size();  ++m_indexedVias )
+            m_viaIndex.emplace( viaKey( &vias[m_indexedVias] ), (int) m_indexedVias );
+    }
+
+    void indexPadstacks()
+    {
+        for( ;  m_indexedPadstacks < padstacks.size();  ++m_indexedPadstacks )
+        {
+            PADSTACK* ps = &padstacks[m_indexedPadstacks];
+            m_padstackIndex.emplace( ps->GetPadstackId(), ps );
+        }
+    }
+
 public:
 
     LIBRARY( ELEM* aParent, DSN_T aType = T_library ) :
         ELEM( aType, aParent )
     {
         unit = 0;
+        m_indexedImages = 0;
+        m_indexedVias = 0;
+        m_indexedPadstacks = 0;
 //        via_start_index = -1;       // 0 or greater means there is at least one via
     }
     ~LIBRARY()
@@ -2275,21 +2376,19 @@ public:
      */
     int FindIMAGE( IMAGE* aImage )
     {
-        unsigned i;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == IMAGE::Compare( aImage, &images[i] ) )
-                return (int) i;
-        }
+        indexImages();
+
+        auto found = m_imageIndex.find( aImage->GetHash() );
+
+        if( found != m_imageIndex.end() )
+            return found->second;
 
         // There is no match to the IMAGE contents, but now generate a unique
         // name for it.
-        int dups = 1;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == aImage->image_id.compare( images[i].image_id ) )
-                aImage->duplicated = dups++;
-        }
+        auto dups = m_imageIdCount.find( aImage->image_id );
+
+        if( dups != m_imageIdCount.end() )
+            aImage->duplicated = dups->second;
 
         return -1;
     }
@@ -2331,11 +2430,13 @@ public:
      */
     int FindVia( PADSTACK* aVia )
     {
-        for( unsigned i=0;  i<vias.size();  ++i )
-        {
-            if( 0 == PADSTACK::Compare( aVia, &vias[i] ) )
-                return int( i );
-        }
+        indexVias();
+
+        auto found = m_viaIndex.find( viaKey( aVia ) );
+
+        if( found != m_viaIndex.end() )
+            return found->second;
+
         return -1;
     }
 
@@ -2386,12 +2487,13 @@ public:
      */
     PADSTACK* FindPADSTACK( const std::string& aPadstackId )
     {
-        for( unsigned i=0;  i<padstacks.size();  ++i )
-        {
-            PADSTACK* ps = &padstacks[i];
-            if( 0 == ps->GetPadstackId().compare( aPadstackId ) )
-                return ps;
-        }
+        indexPadstacks();
+
+        auto found = m_padstackIndex.find( aPadstackId );
+
+        if( found != m_padstackIndex.end() )
+            return found->second;
+
         return NULL;
     }
 
@@ -3002,7 +3104,11 @@ public:
             else
                 perLine += out->Print( 0, "  " );
 
-            perLine += out->Print( 0, "%.6g %.6g", i->x, i->y );
+            char xText[32];
+            char yText[32];
+
+            perLine += out->Print( 0, "%s %s", FormatNumber( xText, i->x ),
+                                   FormatNumber( yText, i->y ) );
         }
 
         if( net_id.size() || via_number!=-1 || via_type!=T_NONE || attr!=T_NONE || supply)
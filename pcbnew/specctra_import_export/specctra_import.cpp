@@ -45,6 +45,9 @@
 #include "specctra.h"
 #include <math/util.h>      // for KiROUND
 #include <pcbnew_settings.h>
+#include <core/parallel_for.h>
+
+#include <algorithm>
 
 using namespace DSN;
 
@@ -403,111 +406,152 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
 
     m_routeResolution = m_session->route->GetUnits();
 
-    // Walk the NET_OUTs and create tracks and vias anew.
-    NET_OUTS& net_outs = m_session->route->net_outs;
-    for( NET_OUTS::iterator net = net_outs.begin(); net!=net_outs.end(); ++net )
+    NETCLASSPTR netclass = aBoard->GetDesignSettings().GetNetClasses().GetDefault();
+    int         via_drill_default = netclass->GetViaDrill();
+
+    // The tracks and vias of each net are built on worker threads, so the lookups in the
+    // board and the session library are made here.
+    struct NET_ROUTE
+    {
+        NET_OUT*                 m_Net;
+        int                      m_NetCode;
+        std::vector<PADSTACK*>   m_Padstacks;   ///< for each wire_via, nullptr if missing
+        std::vector<BOARD_ITEM*> m_Items;
+        bool                     m_Failed;
+        IO_ERROR                 m_Error;
+    };
+
+    NET_OUTS&              net_outs = m_session->route->net_outs;
+    LIBRARY&               library = *m_session->route->library;
+    std::vector<NET_ROUTE> routes( net_outs.size() );
+
+    for( unsigned n = 0; n < net_outs.size(); ++n )
     {
-        int netoutCode = 0;
+        NET_ROUTE& route = routes[n];
 
-        // page 143 of spec says wire's net_id is optional
-        if( net->net_id.size() )
+        route.m_Net = &net_outs[n];
+        route.m_NetCode = 0;
+        route.m_Failed = false;
+
+        // page 143 of spec says wire's net_id is optional, as is wire_via's on page 144
+        if( route.m_Net->net_id.size() )
         {
-            wxString netName = FROM_UTF8( net->net_id.c_str() );
+            wxString netName = FROM_UTF8( route.m_Net->net_id.c_str() );
             NETINFO_ITEM* netinfo = aBoard->FindNet( netName );
 
             if( netinfo )
-                netoutCode = netinfo->GetNet();
-            else  // else netCode remains 0
-            {
-                // int breakhere = 1;
-            }
-        }
-
-        WIRES& wires = net->wires;
-        for( unsigned i = 0; i<wires.size(); ++i )
-        {
-            WIRE*   wire  = &wires[i];
-            DSN_T   shape = wire->shape->Type();
+                route.m_NetCode = netinfo->GetNet();
 
-            if( shape != T_path )
-            {
-                /*  shape == T_polygon is expected from freerouter if you have
-                    a zone on a non "power" type layer, i.e. a T_signal layer
-                    and the design does a round trip back in as session here.
-                    We kept our own zones in the BOARD, so ignore this so called
-                    'wire'.
-
-                wxString netId = FROM_UTF8( wire->net_id.c_str() );
-                THROW_IO_ERROR( wxString::Format( _("Unsupported wire shape: \"%s\" for net: \"%s\""),
-                                                    DLEX::GetTokenString(shape).GetData(),
-                                                    netId.GetData()
-                    ) );
-                */
-            }
-            else
-            {
-                PATH*   path = (PATH*) wire->shape;
-                for( unsigned pt=0;  pt<path->points.size()-1;  ++pt )
-                {
-                    TRACK* track = makeTRACK( path, pt, netoutCode );
-                    aBoard->Add( track );
-                }
-            }
+            // else netCode remains 0
         }
 
-        WIRE_VIAS& wire_vias = net->wire_vias;
-        LIBRARY& library = *m_session->route->library;
-        for( unsigned i=0;  i<wire_vias.size();  ++i )
-        {
-            int         netCode = 0;
+        // example: (via Via_15:8_mil 149000 -71000 )
+        for( WIRE_VIA& wire_via : route.m_Net->wire_vias )
+            route.m_Padstacks.push_back( library.FindPADSTACK( wire_via.GetPadstackId() ) );
+    }
 
-            // page 144 of spec says wire_via's net_id is optional
-            if( net->net_id.size() )
+    // Walk the NET_OUTs and create tracks and vias anew.
+    auto buildRoute =
+            [&]( NET_ROUTE& aRoute )
             {
-                wxString netName = FROM_UTF8( net->net_id.c_str() );
-                NETINFO_ITEM* netvia = aBoard->FindNet( netName );
-
-                if( netvia )
-                    netCode = netvia->GetNet();
+                WIRES& wires = aRoute.m_Net->wires;
 
-                // else netCode remains 0
-            }
+                for( unsigned i = 0; i<wires.size(); ++i )
+                {
+                    WIRE*   wire  = &wires[i];
+                    DSN_T   shape = wire->shape->Type();
 
-            WIRE_VIA* wire_via = &wire_vias[i];
+                    if( shape != T_path )
+                    {
+                        /*  shape == T_polygon is expected from freerouter if you have
+                            a zone on a non "power" type layer, i.e. a T_signal layer
+                            and the design does a round trip back in as session here.
+                            We kept our own zones in the BOARD, so ignore this so called
+                            'wire'.
+
+                        wxString netId = FROM_UTF8( wire->net_id.c_str() );
+                        THROW_IO_ERROR( wxString::Format( _("Unsupported wire shape: \"%s\" for net: \"%s\""),
+                                                            DLEX::GetTokenString(shape).GetData(),
+                                                            netId.GetData()
+                            ) );
+                        */
+                    }
+                    else
+                    {
+                        PATH*   path = (PATH*) wire->shape;
+                        for( unsigned pt=0;  pt<path->points.size()-1;  ++pt )
+                            aRoute.m_Items.push_back( makeTRACK( path, pt, aRoute.m_NetCode ) );
+                    }
+                }
 
-            // example: (via Via_15:8_mil 149000 -71000 )
+                WIRE_VIAS& wire_vias = aRoute.m_Net->wire_vias;
 
-            PADSTACK* padstack = library.FindPADSTACK( wire_via->GetPadstackId() );
-            if( !padstack )
-            {
-                // Dick  Feb 29, 2008:
-                // Freerouter has a bug where it will not round trip all vias.
-                // Vias which have a (use_via) element will be round tripped.
-                // Vias which do not, don't come back in in the session library,
-                // even though they may be actually used in the pre-routed,
-                // protected wire_vias. So until that is fixed, create the
-                // padstack from its name as a work around.
+                for( unsigned i=0;  i<wire_vias.size();  ++i )
+                {
+                    WIRE_VIA* wire_via = &wire_vias[i];
+                    PADSTACK* padstack = aRoute.m_Padstacks[i];
 
+                    if( !padstack )
+                    {
+                        // Dick  Feb 29, 2008:
+                        // Freerouter has a bug where it will not round trip all vias.
+                        // Vias which have a (use_via) element will be round tripped.
+                        // Vias which do not, don't come back in in the session library,
+                        // even though they may be actually used in the pre-routed,
+                        // protected wire_vias. So until that is fixed, create the
+                        // padstack from its name as a work around.
 
-                // Could use a STRING_FORMATTER here and convert the entire
-                // wire_via to text and put that text into the exception.
-                wxString psid( FROM_UTF8( wire_via->GetPadstackId().c_str() ) );
 
-                THROW_IO_ERROR( wxString::Format(
-                        _( "A wire_via references a missing padstack \"%s\"" ), psid ) );
-            }
+                        // Could use a STRING_FORMATTER here and convert the entire
+                        // wire_via to text and put that text into the exception.
+                        wxString psid( FROM_UTF8( wire_via->GetPadstackId().c_str() ) );
 
-            NETCLASSPTR netclass = aBoard->GetDesignSettings().GetNetClasses().GetDefault();
+                        THROW_IO_ERROR( wxString::Format(
+                                _( "A wire_via references a missing padstack \"%s\"" ), psid ) );
+                    }
 
-            int via_drill_default = netclass->GetViaDrill();
+                    for( unsigned v=0;  v<wire_via->vertexes.size();  ++v )
+                    {
+                        aRoute.m_Items.push_back( makeVIA( padstack, wire_via->vertexes[v],
+                                                           aRoute.m_NetCode,
+                                                           via_drill_default ) );
+                    }
+                }
+            };
 
-            for( unsigned v=0;  v<wire_via->vertexes.size();  ++v )
+    ParallelFor( routes.size(),
+            [&]( size_t aRouteId )
             {
-                ::VIA* via = makeVIA( padstack, wire_via->vertexes[v], netCode, via_drill_default );
-                aBoard->Add( via );
-            }
+                try
+                {
+                    buildRoute( routes[aRouteId] );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    routes[aRouteId].m_Failed = true;
+                    routes[aRouteId].m_Error = ioe;
+                }
+            } );
+
+    // Add the items in net order, and stop at the first error as a serial import would.
+    const NET_ROUTE* failed = nullptr;
+
+    for( NET_ROUTE& route : routes )
+    {
+        for( BOARD_ITEM* item : route.m_Items )
+        {
+            if( failed )
+                delete item;
+            else
+                aBoard->Add( item );
         }
+
+        if( route.m_Failed && !failed )
+            failed = &route;
     }
+
+    if( failed )
+        throw failed->m_Error;
 }
 
 
@@ -36,6 +36,7 @@
 
 #include "specctra.h"
 #include <common.h>
+#include <profile.h>
 
 
 using namespace DSN;
@@ -58,6 +59,8 @@ int main( int argc, char** argv )
         filename = FROM_UTF8( argv[1] );
     }
 
+    PROF_COUNTER loadTimer;
+
     try
     {
 //        db.LoadPCB( filename );
@@ -70,23 +73,28 @@ int main( int argc, char** argv )
     }
 
     if( !failed )
-        fprintf( stderr, "loaded OK\n" );
+        fprintf( stderr, "loaded OK in %.2f ms\n", loadTimer.msecs() );
 
     // export what we read in, making this test program basically a beautifier
     // hose the beautified DSN file to stdout.  If an exception occurred,
     // we will be outputting only a portion of what we wanted to read in.
-    db.SetFILE( stdout );
+    STRING_FORMATTER    sf;
+    PROF_COUNTER        formatTimer;
 
 #if 0
     // export a PCB
     DSN::PCB* pcb = db.GetPCB();
-    pcb->Format( &db, 0 );
+    pcb->Format( &sf, 0 );
 
 #else
     // export a SESSION file.
     DSN::SESSION* ses = db.GetSESSION();
-    ses->Format( &db, 0 );
+    ses->Format( &sf, 0 );
 #endif
+
+    fprintf( stderr, "formatted in %.2f ms\n", formatTimer.msecs() );
+
+    fputs( sf.GetString().c_str(), stdout );
 }
 
 //-----<dummy code>---------------------------------------------------
@@ -72,6 +72,7 @@ class BASE_SET {};
 #include <pcb_plot_params.h>
 #include <exporters/export_d356.h>
 #include <exporters/export_vrml.h>
+#include <exporters/fabrication_view.h>
 #include <exporters/gendrill_file_writer_base.h>
 #include <exporters/gendrill_Excellon_writer.h>
 #include <exporters/gendrill_gerber_writer.h>
@@ -116,6 +117,7 @@ HANDLE_EXCEPTIONS(PLUGIN::FootprintDelete)
 %include <plotter.h>
 %include <exporters/export_d356.h>
 %include <exporters/export_vrml.h>
+%include <exporters/fabrication_view.h>
 %include <exporters/gendrill_file_writer_base.h>
 %include <exporters/gendrill_Excellon_writer.h>
 %include <exporters/gendrill_gerber_writer.h>
@@ -376,6 +376,55 @@ bool ZONE::GetFilledPolysUseThickness( PCB_LAYER_ID aLayer ) const
 static SHAPE_POLY_SET g_nullPoly;
 
 
+const SHAPE_POLY_SET& ZONE::GetSimplifiedFilledPolysList( PCB_LAYER_ID aLayer,
+                                                          int aMaxError ) const
+{
+    const SHAPE_POLY_SET& fill = GetFilledPolysList( aLayer );
+    MD5_HASH              hash = fill.GetHash();
+
+    // Several views may draw the zone at once; entries are never removed while the fill is
+    // unchanged, so the returned reference stays valid
+    std::lock_guard<std::mutex> lock( m_simplifiedPolysLock );
+
+    SIMPLIFIED_FILL& cache = m_simplifiedPolysList[aLayer];
+
+    if( cache.m_fillHash != hash )
+    {
+        cache.m_polys.clear();
+        cache.m_fillHash = hash;
+    }
+
+    auto it = cache.m_polys.find( aMaxError );
+
+    if( it != cache.m_polys.end() )
+        return it->second;
+
+    SHAPE_POLY_SET& simplified = cache.m_polys[aMaxError];
+
+    for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+    {
+        SHAPE_LINE_CHAIN outline = fill.COutline( ii ).Decimate( aMaxError );
+
+        if( outline.PointCount() < 3 )
+            continue;
+
+        int idx = simplified.AddOutline( outline );
+
+        for( int jj = 0; jj < fill.HoleCount( ii ); ++jj )
+        {
+            SHAPE_LINE_CHAIN hole = fill.CHole( ii, jj ).Decimate( aMaxError );
+
+            if( hole.PointCount() >= 3 )
+                simplified.AddHole( hole, idx );
+        }
+    }
+
+    simplified.CacheTriangulation();
+
+    return simplified;
+}
+
+
 MD5_HASH ZONE::GetHashValue( PCB_LAYER_ID aLayer )
 {
     if( !m_filledPolysHash.count( aLayer ) )
@@ -650,6 +650,15 @@ public:
         return m_FilledPolysList.at( aLayer );
     }
 
+    /**
+     * Return a decimated copy of the filled polygons, for drawing the zone when zoomed out.
+     * Copies are cached for each error value until the fill changes.
+     *
+     * @param aMaxError is the maximum distance between the filled areas and the copy.
+     */
+    const SHAPE_POLY_SET& GetSimplifiedFilledPolysList( PCB_LAYER_ID aLayer,
+                                                        int aMaxError ) const;
+
     /** (re)create a list of triangles that "fill" the solid areas.
      * used for instance to draw these solid areas on opengl
      */
@@ -935,6 +944,16 @@ protected:
     /// A hash value used in zone filling calculations to see if the filled areas are up to date
     std::map<PCB_LAYER_ID, MD5_HASH>       m_filledPolysHash;
 
+    /// Decimated copies of the filled areas, by layer and error, and the fill they were made from
+    struct SIMPLIFIED_FILL
+    {
+        MD5_HASH                       m_fillHash;
+        std::map<int, SHAPE_POLY_SET>  m_polys;
+    };
+
+    mutable std::map<PCB_LAYER_ID, SIMPLIFIED_FILL> m_simplifiedPolysList;
+    mutable std::mutex                              m_simplifiedPolysLock;
+
     ZONE_BORDER_DISPLAY_STYLE m_borderStyle;       // border display style, see enum above
     int                       m_borderHatchPitch;  // for DIAGONAL_EDGE, distance between 2 lines
     std::vector<SEG>          m_borderHatchLines;  // hatch lines
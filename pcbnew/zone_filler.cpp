@@ -43,9 +43,12 @@
 #include <geometry/shape_poly_set.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_union_builder.h>
+#include <geometry/shape_segment.h>
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <trigo.h>
 #include "zone_filler.h"
 
 static const double s_RoundPadThermalSpokeAngle = 450;      // in deci-degrees
@@ -57,7 +60,8 @@ ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
         m_commit( aCommit ),
         m_progressReporter( nullptr ),
         m_maxError( ARC_HIGH_DEF ),
-        m_worstClearance( 0 )
+        m_worstClearance( 0 ),
+        m_knockoutThreadCount( 1 )
 {
     // To enable add "DebugZoneFiller=1" to kicad_advanced settings file.
     m_debugZoneFiller = ADVANCED_CFG::GetCfg().m_DebugZoneFiller;
@@ -261,6 +265,10 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         size_t parallelThreadCount = std::min( cores, toFill.size() );
         std::vector<std::future<size_t>> returns( parallelThreadCount );
 
+        // Spare cores (if any) are given to the knockout union of each zone
+        m_knockoutThreadCount = std::max<int>( 1, cores / std::max<size_t>( parallelThreadCount,
+                                                                             1 ) );
+
         nextItem = 0;
 
         if( parallelThreadCount <= 1 )
@@ -562,6 +570,58 @@ void ZONE_FILLER::addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, SHAPE_P
 }
 
 
+/**
+ * Add a knockout for a pad to a union builder.  The common pad shapes are recorded as
+ * primitives so that their polygonization is deferred to (and parallelized by) the builder.
+ */
+void ZONE_FILLER::addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap,
+                               POLY_UNION_BUILDER& aHoles )
+{
+    wxPoint padShapePos = aPad->ShapePos();
+    int     dx = aPad->GetSize().x / 2;
+    int     dy = aPad->GetSize().y / 2;
+
+    switch( aPad->GetShape() )
+    {
+    case PAD_SHAPE_CIRCLE:
+    case PAD_SHAPE_OVAL:
+        if( dx == dy )
+        {
+            aHoles.AddCircle( padShapePos, dx + aGap );
+        }
+        else
+        {
+            int     half_width = std::min( dx, dy );
+            wxPoint delta( dx - half_width, dy - half_width );
+
+            RotatePoint( &delta, aPad->GetOrientation() );
+
+            aHoles.AddOval( padShapePos - delta, padShapePos + delta,
+                            ( half_width + aGap ) * 2 );
+        }
+
+        break;
+
+    case PAD_SHAPE_ROUNDRECT:
+    {
+        wxSize shapesize( aPad->GetSize().x + aGap * 2, aPad->GetSize().y + aGap * 2 );
+
+        aHoles.AddRoundChamferedRect( padShapePos, shapesize, aPad->GetOrientation(),
+                                      aPad->GetRoundRectCornerRadius() + aGap );
+    }
+        break;
+
+    default:
+    {
+        SHAPE_POLY_SET poly;
+        addKnockout( aPad, aLayer, aGap, poly );
+        aHoles.AddPolygon( poly );
+    }
+        break;
+    }
+}
+
+
 /**
  * Add a knockout for a graphic item.  The knockout is 'aGap' larger than the item (which
  * might be either the electrical clearance or the board edge clearance).
@@ -660,6 +720,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
     int extra_margin = Millimeter2iu( ADVANCED_CFG::GetCfg().m_ExtraClearance );
 
     BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    POLY_UNION_BUILDER     knockouts( m_maxError, ERROR_OUTSIDE );
     int                    zone_clearance = aZone->GetLocalClearance();
     EDA_RECT               zone_boundingbox = aZone->GetCachedBoundingBox();
 
@@ -705,12 +766,14 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                         if( aPad->GetAttribute() == PAD_ATTRIB_PTH )
                             gap += aPad->GetBoard()->GetDesignSettings().GetHolePlatingThickness();
 
-                        aPad->TransformHoleWithClearanceToPolygon( aHoles, gap, m_maxError,
-                                                                   ERROR_OUTSIDE );
+                        const SHAPE_SEGMENT* hole = aPad->GetEffectiveHoleShape();
+
+                        knockouts.AddOval( (wxPoint) hole->GetSeg().A, (wxPoint) hole->GetSeg().B,
+                                           hole->GetWidth() + gap * 2 );
                     }
                     else
                     {
-                        addKnockout( aPad, aLayer, gap, aHoles );
+                        addKnockout( aPad, aLayer, gap, knockouts );
                     }
                 }
             };
@@ -749,19 +812,24 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                         if( !via->FlashLayer( aLayer ) )
                         {
                             int radius = via->GetDrillValue() / 2 + bds.GetHolePlatingThickness();
-                            TransformCircleToPolygon( aHoles, via->GetPosition(), radius + gap,
-                                                      m_maxError, ERROR_OUTSIDE );
+                            knockouts.AddCircle( via->GetPosition(), radius + gap );
                         }
                         else
                         {
-                            via->TransformShapeWithClearanceToPolygon( aHoles, aLayer, gap,
-                                                                       m_maxError, ERROR_OUTSIDE );
+                            knockouts.AddCircle( via->GetPosition(), via->GetWidth() / 2 + gap );
                         }
                     }
+                    else if( aTrack->Type() == PCB_TRACE_T )
+                    {
+                        knockouts.AddOval( aTrack->GetStart(), aTrack->GetEnd(),
+                                           aTrack->GetWidth() + gap * 2 );
+                    }
                     else
                     {
-                        aTrack->TransformShapeWithClearanceToPolygon( aHoles, aLayer, gap,
+                        SHAPE_POLY_SET poly;
+                        aTrack->TransformShapeWithClearanceToPolygon( poly, aLayer, gap,
                                                                       m_maxError, ERROR_OUTSIDE );
+                        knockouts.AddPolygon( poly );
                     }
                 }
             };
@@ -807,7 +875,9 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                                                                     aZone, aItem, Margin ) );
                         }
 
-                        addKnockout( aItem, aLayer, gap, aItem->IsOnLayer( Edge_Cuts ), aHoles );
+                        SHAPE_POLY_SET poly;
+                        addKnockout( aItem, aLayer, gap, aItem->IsOnLayer( Edge_Cuts ), poly );
+                        knockouts.AddPolygon( poly );
                     }
                 }
             };
@@ -845,10 +915,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
 
                 if( aKnockout->GetCachedBoundingBox().Intersects( zone_boundingbox ) )
                 {
+                    SHAPE_POLY_SET poly;
+
                     if( aKnockout->GetIsRuleArea() )
                     {
                         // Keepouts use outline with no clearance
-                        aKnockout->TransformSmoothedOutlineToPolygon( aHoles, 0, nullptr );
+                        aKnockout->TransformSmoothedOutlineToPolygon( poly, 0, nullptr );
                     }
                     else if( bds.m_ZoneFillVersion == 5 )
                     {
@@ -856,7 +928,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                         int gap = evalRulesForItems( CLEARANCE_CONSTRAINT, aZone, aKnockout,
                                                      aLayer );
 
-                        aKnockout->TransformSmoothedOutlineToPolygon( aHoles, gap, nullptr );
+                        aKnockout->TransformSmoothedOutlineToPolygon( poly, gap, nullptr );
                     }
                     else
                     {
@@ -864,12 +936,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                         int gap = evalRulesForItems( CLEARANCE_CONSTRAINT, aZone, aKnockout,
                                                      aLayer );
 
-                        SHAPE_POLY_SET poly;
                         aKnockout->TransformShapeWithClearanceToPolygon( poly, aLayer, gap,
                                                                          m_maxError,
                                                                          ERROR_OUTSIDE );
-                        aHoles.Append( poly );
                     }
+
+                    knockouts.AddPolygon( poly );
                 }
             };
 
@@ -908,7 +980,8 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
         }
     }
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    // One hierarchical union instead of a Simplify() over thousands of appended outlines
+    knockouts.Build( aHoles, m_knockoutThreadCount );
 }
 
 
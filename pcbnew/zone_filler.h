@@ -34,6 +34,7 @@ class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+class POLY_UNION_BUILDER;
 
 
 class ZONE_FILLER
@@ -52,6 +53,8 @@ private:
 
     void addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, SHAPE_POLY_SET& aHoles );
 
+    void addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, POLY_UNION_BUILDER& aHoles );
+
     void addKnockout( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap, bool aIgnoreLineWidth,
                       SHAPE_POLY_SET& aHoles );
 
@@ -122,6 +125,7 @@ private:
 
     int                   m_maxError;
     int                   m_worstClearance;
+    int                   m_knockoutThreadCount; // threads available to each knockout union
 
     bool                  m_debugZoneFiller;
 };
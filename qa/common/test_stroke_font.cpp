@@ -0,0 +1,141 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the stroke font and its cache of line layouts
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gr_text.h>
+
+
+namespace
+{
+
+struct TEXT_SEGMENT
+{
+    int x0, y0, x1, y1;
+
+    bool operator==( const TEXT_SEGMENT& aOther ) const
+    {
+        return x0 == aOther.x0 && y0 == aOther.y0 && x1 == aOther.x1 && y1 == aOther.y1;
+    }
+};
+
+
+void addSegment( int x0, int y0, int xf, int yf, void* aData )
+{
+    static_cast<std::vector<TEXT_SEGMENT>*>( aData )->push_back( { x0, y0, xf, yf } );
+}
+
+
+/**
+ * Return the segments of a text, as they are given to plotters and to the conversion to
+ * polygons
+ */
+std::vector<TEXT_SEGMENT> textSegments( const wxString& aText, const wxSize& aSize,
+                                        EDA_TEXT_HJUSTIFY_T aHJustify, bool aItalic,
+                                        bool aBold = false )
+{
+    std::vector<TEXT_SEGMENT> segments;
+
+    GRText( nullptr, wxPoint( 1000, 2000 ), KIGFX::COLOR4D::BLACK, aText, 0.0, aSize,
+            aHJustify, GR_TEXT_VJUSTIFY_CENTER, 0, aItalic, aBold, addSegment, &segments );
+
+    return segments;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( StrokeFont )
+
+
+/**
+ * Drawing the same text again gives the same strokes
+ */
+BOOST_AUTO_TEST_CASE( RepeatedText )
+{
+    const wxSize size( 100000, 100000 );
+
+    std::vector<TEXT_SEGMENT> first = textSegments( "R1 ~OVER~ 10k", size,
+                                                    GR_TEXT_HJUSTIFY_LEFT, false );
+    std::vector<TEXT_SEGMENT> second = textSegments( "R1 ~OVER~ 10k", size,
+                                                     GR_TEXT_HJUSTIFY_LEFT, false );
+
+    BOOST_CHECK( !first.empty() );
+    BOOST_CHECK( first == second );
+
+    // Lines of a multiline text are laid out on their own
+    std::vector<TEXT_SEGMENT> lines = textSegments( "R1\nR1", size, GR_TEXT_HJUSTIFY_LEFT,
+                                                    false );
+    std::vector<TEXT_SEGMENT> line = textSegments( "R1", size, GR_TEXT_HJUSTIFY_LEFT, false );
+
+    BOOST_CHECK_EQUAL( lines.size(), 2 * line.size() );
+}
+
+
+/**
+ * Every attribute the layout depends on must be part of the cache key
+ */
+BOOST_AUTO_TEST_CASE( Attributes )
+{
+    const wxSize size( 100000, 100000 );
+    const wxString text = "U12";
+
+    std::vector<TEXT_SEGMENT> plain = textSegments( text, size, GR_TEXT_HJUSTIFY_LEFT, false );
+    std::vector<TEXT_SEGMENT> italic = textSegments( text, size, GR_TEXT_HJUSTIFY_LEFT, true );
+    std::vector<TEXT_SEGMENT> bold = textSegments( text, size, GR_TEXT_HJUSTIFY_LEFT, false,
+                                                   true );
+    std::vector<TEXT_SEGMENT> mirrored = textSegments( text, wxSize( -size.x, size.y ),
+                                                       GR_TEXT_HJUSTIFY_LEFT, false );
+    std::vector<TEXT_SEGMENT> larger = textSegments( text, size * 2, GR_TEXT_HJUSTIFY_LEFT,
+                                                     false );
+    std::vector<TEXT_SEGMENT> right = textSegments( text, size, GR_TEXT_HJUSTIFY_RIGHT, false );
+
+    BOOST_REQUIRE_EQUAL( italic.size(), plain.size() );
+    BOOST_CHECK( !( italic == plain ) );
+    BOOST_CHECK( !( bold == plain ) );
+    BOOST_CHECK( !( mirrored == plain ) );
+    BOOST_CHECK( !( larger == plain ) );
+
+    // Justification only moves the text
+    BOOST_REQUIRE_EQUAL( right.size(), plain.size() );
+
+    int dx = right[0].x0 - plain[0].x0;
+
+    BOOST_CHECK_LT( dx, 0 );
+
+    for( size_t ii = 0; ii < plain.size(); ++ii )
+    {
+        BOOST_CHECK_LE( std::abs( right[ii].x0 - plain[ii].x0 - dx ), 1 );
+        BOOST_CHECK_LE( std::abs( right[ii].x1 - plain[ii].x1 - dx ), 1 );
+        BOOST_CHECK_EQUAL( right[ii].y0, plain[ii].y0 );
+        BOOST_CHECK_EQUAL( right[ii].y1, plain[ii].y1 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <painter.h>
+#include <view/offscreen_renderer.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+#include <cstring>
+
+
+using namespace KIGFX;
+
+
+static const uint32_t BLACK_PIXEL = 0xFF000000;
+static const uint32_t RED_PIXEL = 0xFFFF0000;
+static const uint32_t BLUE_PIXEL = 0xFF0000FF;
+
+
+/**
+ * A square on a single layer
+ */
+class SQUARE_ITEM : public VIEW_ITEM
+{
+public:
+    SQUARE_ITEM( const BOX2I& aBox, int aLayer ) :
+            m_box( aBox ),
+            m_layer( aLayer )
+    {
+    }
+
+    const BOX2I ViewBBox() const override { return m_box; }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = m_layer;
+        aCount = 1;
+    }
+
+    BOX2I m_box;
+    int   m_layer;
+};
+
+
+/**
+ * Fills squares, in red on layer 1 and in blue on the other layers
+ */
+class SQUARE_PAINTER : public PAINTER
+{
+public:
+    SQUARE_PAINTER( GAL* aGal ) :
+            PAINTER( aGal )
+    {
+    }
+
+    void ApplySettings( const RENDER_SETTINGS* aSettings ) override {}
+
+    RENDER_SETTINGS* GetSettings() override { return nullptr; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const BOX2I& box = static_cast<const SQUARE_ITEM*>( aItem )->m_box;
+
+        m_gal->SetIsStroke( false );
+        m_gal->SetIsFill( true );
+        m_gal->SetFillColor( aLayer == 1 ? COLOR4D( 1.0, 0.0, 0.0, 1.0 )
+                                         : COLOR4D( 0.0, 0.0, 1.0, 1.0 ) );
+        m_gal->DrawRectangle( box.GetOrigin(), box.GetEnd() );
+
+        return true;
+    }
+
+    PAINTER* Clone( GAL* aGal ) const override
+    {
+        return new SQUARE_PAINTER( aGal );
+    }
+};
+
+
+static uint32_t getPixel( cairo_surface_t* aImage, int aX, int aY )
+{
+    unsigned char* data = cairo_image_surface_get_data( aImage );
+    int            stride = cairo_image_surface_get_stride( aImage );
+
+    return *reinterpret_cast<uint32_t*>( data + aY * stride + aX * 4 );
+}
+
+
+struct OFFSCREEN_RENDERER_FIXTURE
+{
+    OFFSCREEN_RENDERER_FIXTURE() :
+            m_gal( m_options ),
+            m_painter( &m_gal )
+    {
+        m_view.SetGAL( &m_gal );
+        m_view.SetPainter( &m_painter );
+    }
+
+    ~OFFSCREEN_RENDERER_FIXTURE()
+    {
+        m_view.Clear();
+    }
+
+    GAL_DISPLAY_OPTIONS m_options;
+    GAL                 m_gal;
+    SQUARE_PAINTER      m_painter;
+    VIEW                m_view;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( OffscreenRenderer, OFFSCREEN_RENDERER_FIXTURE )
+
+
+/**
+ * Squares end up where the viewport puts them, in the requested layer order
+ */
+BOOST_AUTO_TEST_CASE( LayersAndViewport )
+{
+    // 10 world units per pixel
+    SQUARE_ITEM red( BOX2I( VECTOR2I( 100, 100 ), VECTOR2I( 300, 300 ) ), 1 );
+    SQUARE_ITEM blue( BOX2I( VECTOR2I( 300, 300 ), VECTOR2I( 300, 300 ) ), 2 );
+
+    m_view.Add( &red );
+    m_view.Add( &blue );
+
+    OFFSCREEN_RENDERER renderer( m_view, m_painter );
+    renderer.SetViewport( BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( 1000, 1000 ) ) );
+    renderer.SetImageSize( 100, 100 );
+
+    renderer.SetLayers( { 2, 1 } );
+    BOOST_REQUIRE( renderer.Render() );
+
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 5, 5 ), BLACK_PIXEL );
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 20, 20 ), RED_PIXEL );
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 35, 35 ), BLUE_PIXEL );
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 50, 50 ), BLUE_PIXEL );
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 80, 80 ), BLACK_PIXEL );
+
+    renderer.SetLayers( { 1, 2 } );
+    BOOST_REQUIRE( renderer.Render() );
+
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 35, 35 ), RED_PIXEL );
+
+    renderer.SetLayers( { 1 } );
+    BOOST_REQUIRE( renderer.Render() );
+
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 35, 35 ), RED_PIXEL );
+    BOOST_CHECK_EQUAL( getPixel( renderer.GetImage(), 50, 50 ), BLACK_PIXEL );
+}
+
+
+/**
+ * Small tiles rendered on several threads make the same image as a single tile
+ */
+BOOST_AUTO_TEST_CASE( Tiles )
+{
+    std::vector<std::unique_ptr<SQUARE_ITEM>> squares;
+
+    for( int ii = 0; ii < 20; ++ii )
+    {
+        BOX2I box( VECTOR2I( ii * 470 % 1900, ii * 130 ), VECTOR2I( 250 + ii * 10, 300 ) );
+
+        squares.push_back( std::make_unique<SQUARE_ITEM>( box, 1 + ii % 2 ) );
+        m_view.Add( squares.back().get() );
+    }
+
+    OFFSCREEN_RENDERER renderer( m_view, m_painter );
+    renderer.SetViewport( BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( 2000, 3000 ) ) );
+    renderer.SetImageSize( 200, 300 );
+    renderer.SetLayers( { 1, 2 } );
+
+    renderer.SetThreadCount( 1 );
+    BOOST_REQUIRE( renderer.Render() );
+
+    std::vector<unsigned char> single( cairo_image_surface_get_data( renderer.GetImage() ),
+                                       cairo_image_surface_get_data( renderer.GetImage() )
+                                               + 300 * cairo_image_surface_get_stride(
+                                                       renderer.GetImage() ) );
+
+    renderer.SetTileSize( 16 );
+    renderer.SetThreadCount( 4 );
+    BOOST_REQUIRE( renderer.Render() );
+
+    BOOST_CHECK( memcmp( single.data(), cairo_image_surface_get_data( renderer.GetImage() ),
+                         single.size() ) == 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
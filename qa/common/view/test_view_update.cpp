@@ -0,0 +1,430 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/gal_recorder.h>
+#include <gal/graphics_abstraction_layer.h>
+#include <painter.h>
+#include <profile.h>
+#include <view/view.h>
+#include <view/view_item.h>
+
+
+using namespace KIGFX;
+
+
+/**
+ * A minimal item living on a single layer
+ */
+class TEST_VIEW_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_VIEW_ITEM( const VECTOR2I& aPos ) :
+            m_pos( aPos )
+    {
+    }
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( m_pos, VECTOR2I( 100, 100 ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 1;
+        aCount = 1;
+    }
+
+    const VECTOR2I& GetPosition() const { return m_pos; }
+
+private:
+    VECTOR2I m_pos;
+};
+
+
+/**
+ * A painter that only counts how many times it was asked to draw something
+ */
+class COUNTING_PAINTER : public PAINTER
+{
+public:
+    COUNTING_PAINTER( GAL* aGal ) :
+            PAINTER( aGal ),
+            m_drawCount( 0 )
+    {
+    }
+
+    void ApplySettings( const RENDER_SETTINGS* aSettings ) override {}
+
+    RENDER_SETTINGS* GetSettings() override { return nullptr; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        m_drawCount++;
+        return true;
+    }
+
+    int m_drawCount;
+};
+
+
+/**
+ * A GAL logging the circles drawn on it, with the group they went to and their fill color
+ */
+class LOGGING_GAL : public GAL
+{
+public:
+    struct CIRCLE
+    {
+        int     group;
+        double  x;
+        COLOR4D color;
+    };
+
+    LOGGING_GAL( GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions ),
+            m_nextGroup( 0 ),
+            m_currentGroup( -1 )
+    {
+    }
+
+    int BeginGroup() override
+    {
+        m_currentGroup = m_nextGroup++;
+        return m_currentGroup;
+    }
+
+    void EndGroup() override { m_currentGroup = -1; }
+
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override
+    {
+        m_circles.push_back( { m_currentGroup, aCenterPoint.x, fillColor } );
+    }
+
+    int                 m_nextGroup;
+    int                 m_currentGroup;
+    std::vector<CIRCLE> m_circles;
+};
+
+
+/**
+ * A painter drawing a circle for each item, which can be used from several threads
+ */
+class CIRCLE_PAINTER : public PAINTER
+{
+public:
+    CIRCLE_PAINTER( GAL* aGal ) :
+            PAINTER( aGal )
+    {
+    }
+
+    void ApplySettings( const RENDER_SETTINGS* aSettings ) override {}
+
+    RENDER_SETTINGS* GetSettings() override { return nullptr; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const TEST_VIEW_ITEM* item = dynamic_cast<const TEST_VIEW_ITEM*>( aItem );
+
+        if( !item )
+            return false;
+
+        if( ( item->GetPosition().x / 200 ) % 2 )
+            m_gal->SetFillColor( COLOR4D( 1.0, 0.0, 0.0, 1.0 ) );
+        else
+            m_gal->SetFillColor( COLOR4D( 0.0, 0.0, 1.0, 1.0 ) );
+
+        m_gal->DrawCircle( item->GetPosition(), 50 );
+        return true;
+    }
+
+    PAINTER* Clone( GAL* aGal ) const override
+    {
+        return new CIRCLE_PAINTER( aGal );
+    }
+};
+
+
+struct VIEW_UPDATE_FIXTURE
+{
+    VIEW_UPDATE_FIXTURE() :
+            m_gal( m_options ),
+            m_painter( &m_gal ),
+            m_view( true )
+    {
+        m_view.SetGAL( &m_gal );
+        m_view.SetPainter( &m_painter );
+    }
+
+    ~VIEW_UPDATE_FIXTURE()
+    {
+        m_view.Clear();
+    }
+
+    /**
+     * Add aCount items to the view and flush the initial updates
+     */
+    void AddItems( int aCount )
+    {
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            m_items.push_back( std::make_unique<TEST_VIEW_ITEM>( VECTOR2I( ii * 200, 0 ) ) );
+            m_view.Add( m_items.back().get() );
+        }
+
+        m_view.UpdateItems();
+        m_painter.m_drawCount = 0;
+    }
+
+    GAL_DISPLAY_OPTIONS                          m_options;
+    GAL                                          m_gal;
+    COUNTING_PAINTER                             m_painter;
+    VIEW                                         m_view;
+    std::vector<std::unique_ptr<TEST_VIEW_ITEM>> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewUpdate, VIEW_UPDATE_FIXTURE )
+
+
+/**
+ * Newly added items are drawn once, on the next update
+ */
+BOOST_AUTO_TEST_CASE( InitialAdd )
+{
+    m_items.push_back( std::make_unique<TEST_VIEW_ITEM>( VECTOR2I( 0, 0 ) ) );
+    m_items.push_back( std::make_unique<TEST_VIEW_ITEM>( VECTOR2I( 500, 0 ) ) );
+
+    m_view.Add( m_items[0].get() );
+    m_view.Add( m_items[1].get() );
+
+    // The preview group is drawn as well
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 3 );
+
+    m_painter.m_drawCount = 0;
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 0 );
+}
+
+
+/**
+ * Only the items that were updated are redrawn, and each of them only once
+ */
+BOOST_AUTO_TEST_CASE( OnlyDirtyItems )
+{
+    AddItems( 100 );
+
+    m_view.Update( m_items[3].get() );
+    m_view.Update( m_items[50].get(), GEOMETRY );
+    m_view.Update( m_items[50].get(), REPAINT );
+    m_view.Update( m_items[99].get(), REPAINT );
+
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 3 );
+
+    m_painter.m_drawCount = 0;
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 0 );
+}
+
+
+/**
+ * Items removed after being marked are not drawn
+ */
+BOOST_AUTO_TEST_CASE( RemovedItems )
+{
+    AddItems( 10 );
+
+    m_view.Update( m_items[2].get(), REPAINT );
+    m_view.Update( m_items[5].get(), REPAINT );
+    m_view.Remove( m_items[2].get() );
+
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 1 );
+
+    // Added back, it is drawn again
+    m_painter.m_drawCount = 0;
+    m_view.Add( m_items[2].get() );
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 1 );
+}
+
+
+/**
+ * Removing many dirty items keeps the others on the update list, each one only once
+ */
+BOOST_AUTO_TEST_CASE( RemovedManyItems )
+{
+    AddItems( 1000 );
+
+    for( const std::unique_ptr<TEST_VIEW_ITEM>& item : m_items )
+        m_view.Update( item.get(), REPAINT );
+
+    // Remove every other item, then free them
+    for( size_t ii = 0; ii < m_items.size(); ii += 2 )
+        m_view.Remove( m_items[ii].get() );
+
+    for( size_t ii = 0; ii < m_items.size(); ii += 2 )
+        m_items[ii].reset();
+
+    m_view.Update( m_items[1].get(), GEOMETRY );
+
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 500 );
+
+    m_painter.m_drawCount = 0;
+    m_view.UpdateItems();
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( AllItems )
+{
+    AddItems( 10 );
+
+    m_view.UpdateAllItems( REPAINT );
+    m_view.UpdateItems();
+
+    // The ten items and the preview group
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, 11 );
+}
+
+
+/**
+ * Measure the cost of a frame on a large view, with nothing or a handful of items to update
+ */
+BOOST_AUTO_TEST_CASE( FrameOverhead )
+{
+    const int itemCount = 200000;
+    const int frames = 100;
+
+    AddItems( itemCount );
+
+    PROF_COUNTER idle;
+
+    for( int ii = 0; ii < frames; ++ii )
+        m_view.UpdateItems();
+
+    idle.Stop();
+
+    PROF_COUNTER busy;
+
+    for( int ii = 0; ii < frames; ++ii )
+    {
+        for( int jj = 0; jj < 10; ++jj )
+            m_view.Update( m_items[( ii * 1237 + jj * 7919 ) % itemCount].get(), REPAINT );
+
+        m_view.UpdateItems();
+    }
+
+    busy.Stop();
+
+    BOOST_CHECK_EQUAL( m_painter.m_drawCount, frames * 10 );
+
+    BOOST_TEST_MESSAGE( "UpdateItems() with " << itemCount << " items: "
+                        << idle.msecs() * 1000.0 / frames << " us/frame idle, "
+                        << busy.msecs() * 1000.0 / frames << " us/frame with 10 dirty items" );
+}
+
+
+/**
+ * A recording replays the drawing calls, starting from the attributes the recorder had
+ */
+BOOST_AUTO_TEST_CASE( RecordAndReplay )
+{
+    LOGGING_GAL  target( m_options );
+    GAL_RECORDER recorder( target );
+
+    recorder.SetFillColor( COLOR4D( 0.0, 1.0, 0.0, 1.0 ) );
+    recorder.StartRecording();
+    recorder.DrawCircle( VECTOR2D( 10, 0 ), 5 );
+    recorder.SetFillColor( COLOR4D( 1.0, 0.0, 0.0, 1.0 ) );
+    recorder.DrawCircle( VECTOR2D( 20, 0 ), 5 );
+
+    GAL_RECORDER::RECORDING recording = recorder.FinishRecording();
+
+    BOOST_CHECK( target.m_circles.empty() );
+
+    GAL_RECORDER::Replay( recording, target );
+
+    BOOST_REQUIRE_EQUAL( target.m_circles.size(), 2 );
+    BOOST_CHECK_EQUAL( target.m_circles[0].x, 10 );
+    BOOST_CHECK( target.m_circles[0].color == COLOR4D( 0.0, 1.0, 0.0, 1.0 ) );
+    BOOST_CHECK_EQUAL( target.m_circles[1].x, 20 );
+    BOOST_CHECK( target.m_circles[1].color == COLOR4D( 1.0, 0.0, 0.0, 1.0 ) );
+}
+
+
+/**
+ * Painters that can be cloned draw large batches on worker threads.  The result must be the
+ * same as drawing them one by one: every item in its own group, in order, with its own colors.
+ */
+BOOST_AUTO_TEST_CASE( ParallelRecache )
+{
+    const int itemCount = 20000;
+
+    LOGGING_GAL    gal( m_options );
+    CIRCLE_PAINTER painter( &gal );
+    VIEW           view( true );
+
+    // Destroyed before the view they belong to
+    std::vector<std::unique_ptr<TEST_VIEW_ITEM>> items;
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    for( int ii = 0; ii < itemCount; ++ii )
+    {
+        items.push_back( std::make_unique<TEST_VIEW_ITEM>( VECTOR2I( ii * 200, 0 ) ) );
+        view.Add( items.back().get() );
+    }
+
+    PROF_COUNTER timer;
+    view.UpdateItems();
+    timer.Stop();
+
+    BOOST_TEST_MESSAGE( "Recached " << itemCount << " items in " << timer.msecs() << " ms" );
+
+    BOOST_REQUIRE_EQUAL( gal.m_circles.size(), itemCount );
+
+    for( int ii = 0; ii < itemCount; ++ii )
+    {
+        const LOGGING_GAL::CIRCLE& circle = gal.m_circles[ii];
+        COLOR4D expected = ( ii % 2 ) ? COLOR4D( 1.0, 0.0, 0.0, 1.0 )
+                                      : COLOR4D( 0.0, 0.0, 1.0, 1.0 );
+
+        BOOST_REQUIRE_EQUAL( circle.x, ii * 200 );
+        BOOST_REQUIRE( circle.color == expected );
+        BOOST_REQUIRE( circle.group >= 0 );
+
+        if( ii > 0 )
+            BOOST_REQUIRE( circle.group != gal.m_circles[ii - 1].group );
+    }
+
+    view.Clear();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
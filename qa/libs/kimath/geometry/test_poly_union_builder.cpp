@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/poly_union_builder.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Net area of a polygon set (outlines minus holes).
+ */
+static double netArea( const SHAPE_POLY_SET& aPoly )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aPoly.OutlineCount(); ++ii )
+    {
+        area += std::abs( aPoly.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aPoly.HoleCount( ii ); ++jj )
+            area -= std::abs( aPoly.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+struct UNION_BUILDER_FIXTURE
+{
+    static const int MAX_ERROR = 5000;
+
+    UNION_BUILDER_FIXTURE() :
+            m_builder( MAX_ERROR, ERROR_OUTSIDE )
+    {
+        // A grid of overlapping pads and tracks, similar to a BGA fan-out.  The same shapes
+        // are appended to m_reference so the union can be checked against a plain Simplify().
+        const int pitch = 800000;
+
+        for( int row = 0; row < 12; ++row )
+        {
+            for( int col = 0; col < 12; ++col )
+            {
+                wxPoint center( col * pitch, row * pitch );
+
+                m_builder.AddCircle( center, 300000 );
+                TransformCircleToPolygon( m_reference, center, 300000, MAX_ERROR,
+                                          ERROR_OUTSIDE );
+
+                wxPoint end = center + wxPoint( pitch / 2, pitch / 2 );
+
+                m_builder.AddOval( center, end, 200000 );
+                TransformOvalToPolygon( m_reference, center, end, 200000, MAX_ERROR,
+                                        ERROR_OUTSIDE );
+
+                if( ( row + col ) % 3 == 0 )
+                {
+                    wxSize size( 500000, 250000 );
+
+                    m_builder.AddRoundChamferedRect( end, size, 450.0, 60000 );
+                    TransformRoundChamferedRectToPolygon( m_reference, end, size, 450.0, 60000,
+                                                          0.0, 0, MAX_ERROR, ERROR_OUTSIDE );
+                }
+            }
+        }
+
+        m_reference.Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+
+    POLY_UNION_BUILDER m_builder;
+    SHAPE_POLY_SET     m_reference;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PolyUnionBuilder, UNION_BUILDER_FIXTURE )
+
+
+/**
+ * An empty builder gives an empty result
+ */
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    POLY_UNION_BUILDER builder( MAX_ERROR, ERROR_OUTSIDE );
+    SHAPE_POLY_SET     result;
+
+    result.NewOutline();
+    result.Append( 0, 0 );
+    result.Append( 10, 0 );
+    result.Append( 10, 10 );
+
+    builder.Build( result );
+
+    BOOST_CHECK_EQUAL( builder.GetCount(), 0 );
+    BOOST_CHECK_EQUAL( result.OutlineCount(), 0 );
+}
+
+
+/**
+ * The hierarchical union covers the same area as a single Simplify() of all shapes
+ */
+BOOST_AUTO_TEST_CASE( MatchesSimplify )
+{
+    SHAPE_POLY_SET result;
+    m_builder.Build( result );
+
+    BOOST_CHECK_EQUAL( result.OutlineCount(), m_reference.OutlineCount() );
+    BOOST_CHECK_CLOSE( netArea( result ), netArea( m_reference ), 1e-6 );
+}
+
+
+/**
+ * The merge tree doesn't depend on the number of threads
+ */
+BOOST_AUTO_TEST_CASE( ThreadCountIndependent )
+{
+    SHAPE_POLY_SET single;
+    SHAPE_POLY_SET multi;
+
+    m_builder.Build( single, 1 );
+    m_builder.Build( multi, 4 );
+
+    BOOST_CHECK_EQUAL( single.OutlineCount(), multi.OutlineCount() );
+    BOOST_CHECK_EQUAL( single.TotalVertices(), multi.TotalVertices() );
+    BOOST_CHECK_EQUAL( netArea( single ), netArea( multi ) );
+}
+
+
+/**
+ * Pre-polygonized shapes are merged along with the primitives
+ */
+BOOST_AUTO_TEST_CASE( Polygons )
+{
+    SHAPE_POLY_SET square;
+
+    square.NewOutline();
+    square.Append( -1000000, -1000000 );
+    square.Append( 1000000, -1000000 );
+    square.Append( 1000000, 1000000 );
+    square.Append( -1000000, 1000000 );
+
+    POLY_UNION_BUILDER builder( MAX_ERROR, ERROR_OUTSIDE );
+
+    builder.AddPolygon( square );
+    builder.AddPolygon( SHAPE_POLY_SET() );     // empty sets are ignored
+    builder.AddCircle( wxPoint( 0, 0 ), 500000 );
+
+    SHAPE_POLY_SET result;
+    builder.Build( result );
+
+    BOOST_CHECK_EQUAL( builder.GetCount(), 2 );
+    BOOST_CHECK_EQUAL( result.OutlineCount(), 1 );
+    BOOST_CHECK_CLOSE( netArea( result ), 4e12, 1e-6 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
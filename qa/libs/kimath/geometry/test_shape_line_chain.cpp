@@ -23,6 +23,7 @@
 
 #include <geometry/shape_arc.h>
 #include <geometry/shape_line_chain.h>
+#include <trigo.h>
 
 #include <unit_test_utils/geometry.h>
 #include <unit_test_utils/numeric.h>
@@ -59,4 +60,97 @@ BOOST_AUTO_TEST_CASE( ArcToPolyline )
 }
 
 
+BOOST_AUTO_TEST_CASE( ReplaceKeepsPoints )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( 0, 1000 ), VECTOR2I( 0, 500 ) } );
+
+    chain.Append( SHAPE_ARC( VECTOR2I( 0, -100 ), VECTOR2I( 0, -200 ), 1800 ) );
+
+    SHAPE_LINE_CHAIN points( { VECTOR2I( 0, 1500 ), VECTOR2I( 1500, 1500 ) } );
+
+    chain.Replace( 0, 0, points );
+
+    // Plain points must not be turned into references to an arc
+    BOOST_CHECK( !chain.isArc( 0 ) );
+    BOOST_CHECK( !chain.isArc( 1 ) );
+    BOOST_CHECK_EQUAL( chain.ArcCount(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( MarkArc )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( 0, 0 ), VECTOR2I( 1000, 0 ), VECTOR2I( 1707, 293 ),
+                              VECTOR2I( 2000, 1000 ), VECTOR2I( 2000, 2000 ) } );
+
+    chain.MarkArc( 1, 3, SHAPE_ARC( VECTOR2I( 1000, 0 ), VECTOR2I( 1707, 293 ),
+                                    VECTOR2I( 2000, 1000 ), 0 ) );
+
+    BOOST_CHECK_EQUAL( chain.ArcCount(), 1 );
+    BOOST_CHECK_EQUAL( chain.PointCount(), 5 );
+    BOOST_CHECK( !chain.isArc( 0 ) );
+    BOOST_CHECK( chain.isArc( 1 ) && chain.isArc( 2 ) && chain.isArc( 3 ) );
+    BOOST_CHECK( !chain.isArc( 4 ) );
+
+    // Marking an overlapping range replaces the previous arc
+    chain.MarkArc( 2, 4, SHAPE_ARC( VECTOR2I( 1707, 293 ), VECTOR2I( 2000, 1000 ),
+                                    VECTOR2I( 2000, 2000 ), 0 ) );
+
+    BOOST_CHECK_EQUAL( chain.ArcCount(), 1 );
+    BOOST_CHECK( !chain.isArc( 1 ) );
+    BOOST_CHECK_EQUAL( chain.ArcIndex( 4 ), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( DecimateOpen )
+{
+    // A shallow zig-zag along a straight line
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii <= 100; ++ii )
+        chain.Append( VECTOR2I( ii * 1000, ( ii % 2 ) ? 50 : 0 ), true );
+
+    chain.Append( VECTOR2I( 100000, 100000 ) );
+
+    SHAPE_LINE_CHAIN decimated = chain.Decimate( 100 );
+
+    // Only the corner and the ends are left
+    BOOST_REQUIRE_EQUAL( decimated.PointCount(), 3 );
+    BOOST_CHECK_EQUAL( decimated.CPoint( 0 ), VECTOR2I( 0, 0 ) );
+    BOOST_CHECK_EQUAL( decimated.CPoint( 1 ), VECTOR2I( 100000, 0 ) );
+    BOOST_CHECK_EQUAL( decimated.CPoint( 2 ), VECTOR2I( 100000, 100000 ) );
+    BOOST_CHECK( !decimated.IsClosed() );
+
+    // A smaller error keeps everything
+    BOOST_CHECK_EQUAL( chain.Decimate( 10 ).PointCount(), chain.PointCount() );
+}
+
+
+BOOST_AUTO_TEST_CASE( DecimateClosed )
+{
+    SHAPE_LINE_CHAIN circle;
+
+    for( int ii = 0; ii < 360; ++ii )
+    {
+        double angle = DEG2RAD( ii );
+        circle.Append( VECTOR2I( KiROUND( 1000000 * cos( angle ) ),
+                                 KiROUND( 1000000 * sin( angle ) ) ) );
+    }
+
+    circle.SetClosed( true );
+    circle.SetWidth( 10 );
+
+    const int        maxError = 5000;
+    SHAPE_LINE_CHAIN decimated = circle.Decimate( maxError );
+
+    BOOST_CHECK( decimated.IsClosed() );
+    BOOST_CHECK_EQUAL( decimated.Width(), 10 );
+    BOOST_CHECK_GT( decimated.PointCount(), 8 );
+    BOOST_CHECK_LT( decimated.PointCount(), circle.PointCount() / 4 );
+
+    // No original point is further from the decimated outline than the allowed error
+    for( const VECTOR2I& pt : circle.CPoints() )
+        BOOST_CHECK_LE( decimated.Distance( pt, true ), maxError );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,396 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/shape_arc.h>
+#include <geometry/shape_poly_set.h>
+#include <trigo.h>
+
+
+static const int MAX_ERROR = 5000;
+
+
+/**
+ * Check that every arc of a line chain is centered on one of aCenters, has the expected
+ * radius and starts and ends on the points it covers (give or take the approximation error
+ * for points Clipper put on a chord).
+ */
+static void checkArcs( const SHAPE_LINE_CHAIN& aChain, const std::vector<VECTOR2I>& aCenters,
+                       double aRadius )
+{
+    for( size_t ii = 0; ii < aChain.ArcCount(); ++ii )
+    {
+        const SHAPE_ARC& arc = aChain.Arc( ii );
+        VECTOR2I         center = arc.GetCenter();
+        bool             found = false;
+
+        for( const VECTOR2I& expected : aCenters )
+            found |= ( center - expected ).EuclideanNorm() <= 10;
+
+        BOOST_CHECK_MESSAGE( found, "Unexpected arc center " << center );
+        BOOST_CHECK_CLOSE( arc.GetRadius(), aRadius, 1.0 );
+
+        int first = -1;
+        int last = -1;
+
+        for( int jj = 0; jj < aChain.PointCount(); ++jj )
+        {
+            if( aChain.ArcIndex( jj ) == (ssize_t) ii )
+            {
+                if( first < 0 )
+                    first = jj;
+
+                last = jj;
+            }
+        }
+
+        BOOST_REQUIRE( first >= 0 );
+
+        // Runs don't wrap around the end of a closed chain
+        for( int jj = first; jj <= last; ++jj )
+            BOOST_CHECK_EQUAL( aChain.ArcIndex( jj ), (ssize_t) ii );
+
+        bool fullCircle = std::abs( arc.GetCentralAngle() ) > 359.0;
+
+        BOOST_CHECK_LE( ( arc.GetP0() - aChain.CPoint( first ) ).EuclideanNorm(), MAX_ERROR );
+
+        // The last run of a chain ends on its first point
+        if( !fullCircle )
+        {
+            int dist = ( arc.GetP1() - aChain.CPoint( last ) ).EuclideanNorm();
+
+            if( last == aChain.PointCount() - 1 )
+                dist = std::min( dist, ( arc.GetP1() - aChain.CPoint( 0 ) ).EuclideanNorm() );
+
+            BOOST_CHECK_LE( dist, MAX_ERROR );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetArcs )
+
+
+/**
+ * Circles come out of a boolean operation as full arcs
+ */
+BOOST_AUTO_TEST_CASE( DisjointCircles )
+{
+    SHAPE_POLY_SET circles;
+
+    TransformCircleToPolygon( circles, wxPoint( 0, 0 ), 500000, MAX_ERROR, ERROR_INSIDE );
+    TransformCircleToPolygon( circles, wxPoint( 2000000, 0 ), 500000, MAX_ERROR, ERROR_INSIDE );
+
+    int vertices = circles.TotalVertices();
+
+    circles.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( circles.OutlineCount(), 2 );
+
+    // The closing point is merged, but nothing else is changed
+    BOOST_CHECK_EQUAL( circles.TotalVertices(), vertices - 2 );
+
+    for( int ii = 0; ii < circles.OutlineCount(); ++ii )
+    {
+        const SHAPE_LINE_CHAIN& outline = circles.COutline( ii );
+
+        BOOST_CHECK_EQUAL( outline.ArcCount(), 1 );
+        BOOST_CHECK_CLOSE( std::abs( outline.Arc( 0 ).GetCentralAngle() ), 360.0, 0.1 );
+
+        for( int jj = 0; jj < outline.PointCount(); ++jj )
+            BOOST_CHECK_EQUAL( outline.ArcIndex( jj ), 0 );
+
+        checkArcs( outline, { VECTOR2I( 0, 0 ), VECTOR2I( 2000000, 0 ) }, 500000 );
+    }
+}
+
+
+/**
+ * Overlapping circles are cut, and each keeps the remaining part of its arc
+ */
+BOOST_AUTO_TEST_CASE( OverlappingCircles )
+{
+    SHAPE_POLY_SET a;
+    SHAPE_POLY_SET b;
+
+    TransformCircleToPolygon( a, wxPoint( 0, 0 ), 500000, MAX_ERROR, ERROR_INSIDE );
+    TransformCircleToPolygon( b, wxPoint( 600000, 0 ), 500000, MAX_ERROR, ERROR_INSIDE );
+
+    SHAPE_POLY_SET result;
+    result.BooleanAdd( a, b, SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( result.OutlineCount(), 1 );
+
+    const SHAPE_LINE_CHAIN& outline = result.COutline( 0 );
+
+    BOOST_CHECK_EQUAL( outline.ArcCount(), 2 );
+    checkArcs( outline, { VECTOR2I( 0, 0 ), VECTOR2I( 600000, 0 ) }, 500000 );
+
+    for( int ii = 0; ii < outline.PointCount(); ++ii )
+        BOOST_CHECK( outline.isArc( ii ) );
+}
+
+
+/**
+ * Inflating keeps the arcs, with a larger radius
+ */
+BOOST_AUTO_TEST_CASE( Inflate )
+{
+    SHAPE_POLY_SET circle;
+
+    TransformCircleToPolygon( circle, wxPoint( 100000, 200000 ), 500000, MAX_ERROR,
+                              ERROR_INSIDE );
+
+    circle.Inflate( 100000, 32 );
+
+    BOOST_REQUIRE_EQUAL( circle.OutlineCount(), 1 );
+    BOOST_CHECK_GE( circle.COutline( 0 ).ArcCount(), 1 );
+
+    checkArcs( circle.COutline( 0 ), { VECTOR2I( 100000, 200000 ) }, 600000 );
+}
+
+
+/**
+ * Offsetting an arc towards its center keeps it too, as the zone filler does when it deflates
+ * a fill and inflates it back around its knockouts
+ */
+BOOST_AUTO_TEST_CASE( InflateTowardsCenter )
+{
+    SHAPE_POLY_SET circle;
+
+    TransformCircleToPolygon( circle, wxPoint( 100000, 200000 ), 500000, MAX_ERROR,
+                              ERROR_INSIDE );
+
+    circle.Inflate( -100000, 32 );
+
+    BOOST_REQUIRE_EQUAL( circle.OutlineCount(), 1 );
+    BOOST_CHECK_GE( circle.COutline( 0 ).ArcCount(), 1 );
+
+    checkArcs( circle.COutline( 0 ), { VECTOR2I( 100000, 200000 ) }, 400000 );
+
+    SHAPE_POLY_SET fill;
+    SHAPE_POLY_SET holes;
+
+    fill.NewOutline();
+    fill.Append( -3000000, -3000000 );
+    fill.Append( 3000000, -3000000 );
+    fill.Append( 3000000, 3000000 );
+    fill.Append( -3000000, 3000000 );
+
+    TransformCircleToPolygon( holes, wxPoint( 0, 0 ), 500000, MAX_ERROR, ERROR_OUTSIDE );
+    TransformCircleToPolygon( holes, wxPoint( 800000, 0 ), 500000, MAX_ERROR, ERROR_OUTSIDE );
+
+    fill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    fill.Inflate( -100000, 32 );
+    fill.Inflate( 100000, 32 );
+
+    BOOST_REQUIRE_EQUAL( fill.OutlineCount(), 1 );
+    BOOST_REQUIRE_EQUAL( fill.HoleCount( 0 ), 1 );
+    BOOST_CHECK_GE( fill.CHole( 0, 0 ).ArcCount(), 2 );
+
+    // The corners rounded at the cusps of the knockout are not part of the arcs
+    checkArcs( fill.CHole( 0, 0 ), { VECTOR2I( 0, 0 ), VECTOR2I( 800000, 0 ) },
+               500000 + GetCircleToPolyCorrection( MAX_ERROR ) );
+}
+
+
+/**
+ * Ovals and rounded rectangles are clamped, rotated and moved; their corners must follow
+ */
+BOOST_AUTO_TEST_CASE( PadShapes )
+{
+    SHAPE_POLY_SET oval;
+
+    TransformOvalToPolygon( oval, wxPoint( 0, 0 ), wxPoint( 1000000, 1000000 ), 400000,
+                            MAX_ERROR, ERROR_OUTSIDE );
+
+    BOOST_REQUIRE_EQUAL( oval.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( oval.COutline( 0 ).ArcCount(), 2 );
+    checkArcs( oval.COutline( 0 ), { VECTOR2I( 0, 0 ), VECTOR2I( 1000000, 1000000 ) },
+               200000 + GetCircleToPolyCorrection( MAX_ERROR ) );
+
+    SHAPE_POLY_SET rect;
+    wxPoint        pos( 3000000, -2000000 );
+
+    TransformRoundChamferedRectToPolygon( rect, pos, wxSize( 2000000, 1000000 ), 300.0, 250000,
+                                          0.0, 0, MAX_ERROR, ERROR_OUTSIDE );
+
+    BOOST_REQUIRE_EQUAL( rect.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( rect.COutline( 0 ).ArcCount(), 4 );
+
+    std::vector<VECTOR2I> centers = { VECTOR2I( -750000, -250000 ), VECTOR2I( 750000, -250000 ),
+                                      VECTOR2I( 750000, 250000 ), VECTOR2I( -750000, 250000 ) };
+
+    for( VECTOR2I& center : centers )
+        center = center.Rotate( DEG2RAD( -30.0 ) ) + pos;
+
+    checkArcs( rect.COutline( 0 ), centers, 250000 + GetCircleToPolyCorrection( MAX_ERROR ) );
+}
+
+
+/**
+ * The union of many pads keeps (parts of) their arcs and doesn't change the vertices.  The end
+ * circles keep one arc each, the others are split in two.
+ */
+BOOST_AUTO_TEST_CASE( VerticesUnchanged )
+{
+    SHAPE_POLY_SET pads;
+
+    for( int ii = 0; ii < 10; ++ii )
+    {
+        TransformCircleToPolygon( pads, wxPoint( ii * 700000, 0 ), 400000, MAX_ERROR,
+                                  ERROR_OUTSIDE );
+    }
+
+    SHAPE_POLY_SET plain;
+
+    for( int ii = 0; ii < pads.OutlineCount(); ++ii )
+    {
+        plain.NewOutline();
+
+        for( const VECTOR2I& pt : pads.COutline( ii ).CPoints() )
+            plain.Append( pt );
+    }
+
+    pads.Simplify( SHAPE_POLY_SET::PM_FAST );
+    plain.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( pads.OutlineCount(), 1 );
+
+    // The chain with arcs may start at another point
+    std::vector<VECTOR2I> points = pads.COutline( 0 ).CPoints();
+    std::vector<VECTOR2I> plainPoints = plain.COutline( 0 ).CPoints();
+    auto                  it = std::find( points.begin(), points.end(), plainPoints[0] );
+
+    BOOST_REQUIRE( it != points.end() );
+    std::rotate( points.begin(), it, points.end() );
+
+    BOOST_CHECK( points == plainPoints );
+    BOOST_CHECK_EQUAL( pads.COutline( 0 ).ArcCount(), 18 );
+    BOOST_CHECK_EQUAL( plain.COutline( 0 ).ArcCount(), 0 );
+}
+
+
+/**
+ * Fracturing bridges the holes to the outline; the hole arcs survive, cut by the bridges
+ */
+BOOST_AUTO_TEST_CASE( Fracture )
+{
+    SHAPE_POLY_SET fill;
+    SHAPE_POLY_SET holes;
+
+    fill.NewOutline();
+    fill.Append( -3000000, -3000000 );
+    fill.Append( 3000000, -3000000 );
+    fill.Append( 3000000, 3000000 );
+    fill.Append( -3000000, 3000000 );
+
+    TransformCircleToPolygon( holes, wxPoint( -1000000, 0 ), 500000, MAX_ERROR, ERROR_OUTSIDE );
+    TransformCircleToPolygon( holes, wxPoint( 1000000, 500000 ), 500000, MAX_ERROR,
+                              ERROR_OUTSIDE );
+
+    fill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+
+    // The same polygon without arcs
+    SHAPE_POLY_SET plain;
+
+    for( int ii = -1; ii < fill.HoleCount( 0 ); ++ii )
+    {
+        const SHAPE_LINE_CHAIN& contour = ii < 0 ? fill.COutline( 0 ) : fill.CHole( 0, ii );
+        SHAPE_LINE_CHAIN        chain;
+
+        for( const VECTOR2I& pt : contour.CPoints() )
+            chain.Append( pt );
+
+        chain.SetClosed( true );
+
+        if( ii < 0 )
+            plain.AddOutline( chain );
+        else
+            plain.AddHole( chain );
+    }
+
+    fill.Fracture( SHAPE_POLY_SET::PM_FAST );
+    plain.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( fill.OutlineCount(), 1 );
+    BOOST_REQUIRE_EQUAL( fill.HoleCount( 0 ), 0 );
+
+    const SHAPE_LINE_CHAIN& outline = fill.COutline( 0 );
+
+    BOOST_CHECK_GE( outline.ArcCount(), 2 );
+    checkArcs( outline, { VECTOR2I( -1000000, 0 ), VECTOR2I( 1000000, 500000 ) },
+               500000 + GetCircleToPolyCorrection( MAX_ERROR ) );
+
+    // The arcs don't change the fractured polygon itself
+    BOOST_CHECK_EQUAL( outline.PointCount(), plain.COutline( 0 ).PointCount() );
+    BOOST_CHECK_CLOSE( outline.Area(), plain.COutline( 0 ).Area(), 0.001 );
+}
+
+
+/**
+ * The arc fitted to a run of points stays inside the chain: through the innermost point of a
+ * convex arc and the outermost one of a knockout, further inside with a margin.
+ */
+BOOST_AUTO_TEST_CASE( ArcInside )
+{
+    SHAPE_POLY_SET circle;
+
+    TransformCircleToPolygon( circle, wxPoint( 0, 0 ), 500000, MAX_ERROR, ERROR_OUTSIDE );
+    circle.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    SHAPE_LINE_CHAIN outline = circle.COutline( 0 );
+    int              last = outline.PointCount() - 1;
+
+    BOOST_REQUIRE_EQUAL( outline.ArcIndex( 0 ), outline.ArcIndex( last ) );
+
+    double minRadius = std::numeric_limits<double>::max();
+    double maxRadius = 0.0;
+
+    for( const VECTOR2I& pt : outline.CPoints() )
+    {
+        minRadius = std::min( minRadius, (double) pt.EuclideanNorm() );
+        maxRadius = std::max( maxRadius, (double) pt.EuclideanNorm() );
+    }
+
+    bool ccw = outline.Area() > 0.0;
+
+    BOOST_CHECK_CLOSE( outline.ArcInside( 0, last, ccw ).GetRadius(), minRadius, 0.01 );
+    BOOST_CHECK_CLOSE( outline.ArcInside( 0, last, ccw, 1000 ).GetRadius(), minRadius - 1000,
+                       0.01 );
+
+    // The same points, as seen from a chain with the circle as a knockout
+    BOOST_CHECK_CLOSE( outline.ArcInside( 0, last, !ccw ).GetRadius(), maxRadius, 0.01 );
+    BOOST_CHECK_CLOSE( outline.ArcInside( 0, last, !ccw, 1000 ).GetRadius(), maxRadius + 1000,
+                       0.01 );
+    BOOST_CHECK_LE( ( outline.ArcInside( 0, last, ccw ).GetP0() - outline.CPoint( 0 ) )
+                            .EuclideanNorm(), MAX_ERROR );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,246 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstring>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <3d-viewer/3d_cache/3d_render_cache.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+static const std::string PLUGIN_INFO = "PLUGIN-TST:1.0.0.0";
+
+
+/**
+ * A model with a mesh with all the optional arrays and a mesh without any of them.
+ */
+struct RENDER_CACHE_FIXTURE
+{
+    RENDER_CACHE_FIXTURE()
+    {
+        m_fileName = ( boost::filesystem::temp_directory_path()
+                       / "render_cache_tst.3dr" ).string();
+
+        m_model = S3D::New3DModel();
+
+        m_model->m_MaterialsSize = 2;
+        m_model->m_Materials = new SMATERIAL[2];
+
+        for( unsigned int i = 0; i < 2; ++i )
+        {
+            S3D::Init3DMaterial( m_model->m_Materials[i] );
+            m_model->m_Materials[i].m_Diffuse = SFVEC3F( 0.1f * i, 0.2f, 0.3f );
+            m_model->m_Materials[i].m_Transparency = 0.5f * i;
+        }
+
+        m_model->m_MeshesSize = 2;
+        m_model->m_Meshes = new SMESH[2];
+
+        for( unsigned int i = 0; i < 2; ++i )
+        {
+            SMESH& mesh = m_model->m_Meshes[i];
+
+            S3D::Init3DMesh( mesh );
+            mesh.m_VertexSize = 4 + i;
+            mesh.m_Positions = new SFVEC3F[mesh.m_VertexSize];
+            mesh.m_Normals = new SFVEC3F[mesh.m_VertexSize];
+            mesh.m_FaceIdxSize = 6;
+            mesh.m_FaceIdx = new unsigned int[mesh.m_FaceIdxSize];
+            mesh.m_MaterialIdx = 1 - i;
+
+            for( unsigned int j = 0; j < mesh.m_VertexSize; ++j )
+            {
+                mesh.m_Positions[j] = SFVEC3F( j, 2.0f * j, i + 0.5f );
+                mesh.m_Normals[j] = SFVEC3F( 0.0f, 0.0f, 1.0f );
+            }
+
+            for( unsigned int j = 0; j < mesh.m_FaceIdxSize; ++j )
+                mesh.m_FaceIdx[j] = ( j + i ) % mesh.m_VertexSize;
+
+            if( i == 0 )
+            {
+                mesh.m_Texcoords = new SFVEC2F[mesh.m_VertexSize];
+                mesh.m_Color = new SFVEC3F[mesh.m_VertexSize];
+
+                for( unsigned int j = 0; j < mesh.m_VertexSize; ++j )
+                {
+                    mesh.m_Texcoords[j] = SFVEC2F( 0.25f * j, 1.0f - 0.25f * j );
+                    mesh.m_Color[j] = SFVEC3F( 0.25f * j, 0.5f, 0.75f );
+                }
+            }
+        }
+    }
+
+    ~RENDER_CACHE_FIXTURE()
+    {
+        S3D::Destroy3DModel( &m_model );
+        wxRemoveFile( m_fileName );
+    }
+
+    /**
+     * Read the file back, with a tag check which accepts the tag of the model.
+     */
+    S3DMODEL* read( std::string& aPluginInfo )
+    {
+        return S3D::ReadRenderCache( m_fileName, aPluginInfo,
+                []( const std::string& aTag )
+                {
+                    return aTag == PLUGIN_INFO;
+                } );
+    }
+
+    /**
+     * Overwrite \a aSize bytes of the file at \a aOffset, or cut it there if \a aData is null.
+     */
+    void damage( size_t aOffset, const void* aData, size_t aSize )
+    {
+        wxFFile file( m_fileName, wxT( "rb" ) );
+        size_t  length = file.Length();
+
+        std::string data( length, 0 );
+
+        BOOST_REQUIRE( file.Read( &data[0], length ) == length );
+        file.Close();
+
+        if( aData )
+            data.replace( aOffset, aSize, static_cast<const char*>( aData ), aSize );
+        else
+            data.resize( aOffset );
+
+        BOOST_REQUIRE( file.Open( m_fileName, wxT( "wb" ) ) );
+        BOOST_REQUIRE( file.Write( data.data(), data.size() ) == data.size() );
+    }
+
+    wxString  m_fileName;
+    S3DMODEL* m_model;
+};
+
+
+template <typename T>
+static bool sameArray( const T* aExpected, const T* aActual, size_t aCount )
+{
+    if( !aExpected || !aActual )
+        return aExpected == aActual;
+
+    return !memcmp( aExpected, aActual, aCount * sizeof( T ) );
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( RenderCache3D, RENDER_CACHE_FIXTURE )
+
+
+/**
+ * The model read back is the model written, with the optional arrays of each mesh.
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+
+    std::string pluginInfo;
+    S3DMODEL*   model = read( pluginInfo );
+
+    BOOST_REQUIRE( model );
+    BOOST_CHECK_EQUAL( pluginInfo, PLUGIN_INFO );
+    BOOST_REQUIRE_EQUAL( model->m_MaterialsSize, m_model->m_MaterialsSize );
+    BOOST_CHECK( sameArray( m_model->m_Materials, model->m_Materials, model->m_MaterialsSize ) );
+    BOOST_REQUIRE_EQUAL( model->m_MeshesSize, m_model->m_MeshesSize );
+
+    for( unsigned int i = 0; i < model->m_MeshesSize; ++i )
+    {
+        const SMESH& expected = m_model->m_Meshes[i];
+        const SMESH& mesh = model->m_Meshes[i];
+
+        BOOST_TEST_CONTEXT( "Mesh " << i )
+        {
+            BOOST_REQUIRE_EQUAL( mesh.m_VertexSize, expected.m_VertexSize );
+            BOOST_REQUIRE_EQUAL( mesh.m_FaceIdxSize, expected.m_FaceIdxSize );
+            BOOST_CHECK_EQUAL( mesh.m_MaterialIdx, expected.m_MaterialIdx );
+            BOOST_CHECK( sameArray( expected.m_Positions, mesh.m_Positions, mesh.m_VertexSize ) );
+            BOOST_CHECK( sameArray( expected.m_Normals, mesh.m_Normals, mesh.m_VertexSize ) );
+            BOOST_CHECK( sameArray( expected.m_Texcoords, mesh.m_Texcoords, mesh.m_VertexSize ) );
+            BOOST_CHECK( sameArray( expected.m_Color, mesh.m_Color, mesh.m_VertexSize ) );
+            BOOST_CHECK( sameArray( expected.m_FaceIdx, mesh.m_FaceIdx, mesh.m_FaceIdxSize ) );
+        }
+    }
+
+    S3D::Destroy3DModel( &model );
+}
+
+
+/**
+ * Files written by another plugin version are not read, and models without a tag are not
+ * written.
+ */
+BOOST_AUTO_TEST_CASE( PluginTag )
+{
+    BOOST_CHECK( !S3D::WriteRenderCache( m_fileName, *m_model, "" ) );
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, "PLUGIN-TST:0.9.0.0" ) );
+
+    std::string pluginInfo = "unchanged";
+
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+    BOOST_CHECK_EQUAL( pluginInfo, "unchanged" );
+}
+
+
+/**
+ * Damaged files, and files which do not fit the model, are not read.
+ */
+BOOST_AUTO_TEST_CASE( DamagedFile )
+{
+    std::string pluginInfo;
+
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+    damage( 0, "K3DX", 4 );
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+    damage( wxFileName::GetSize( m_fileName ).ToULong() - 1, nullptr, 0 );
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+    damage( 20, nullptr, 0 );
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    m_model->m_Meshes[1].m_FaceIdx[3] = m_model->m_Meshes[1].m_VertexSize;
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    m_model->m_Meshes[1].m_FaceIdx[3] = 0;
+    m_model->m_Meshes[1].m_MaterialIdx = m_model->m_MaterialsSize;
+    BOOST_REQUIRE( S3D::WriteRenderCache( m_fileName, *m_model, PLUGIN_INFO ) );
+    BOOST_CHECK( read( pluginInfo ) == nullptr );
+
+    BOOST_CHECK( pluginInfo.empty() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <map>
+#include <vector>
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <netinfo.h>
+#include <pad.h>
+#include <reporter.h>
+#include <netlist_reader/board_netlist_updater.h>
+#include <netlist_reader/pcb_netlist.h>
+
+
+/**
+ * A reporter keeping the actions, i.e. the changes the update makes or would make.
+ */
+class ACTION_REPORTER : public REPORTER
+{
+public:
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity ) override
+    {
+        if( aSeverity == RPT_SEVERITY_ACTION && !aText.IsEmpty() )
+            m_actions.push_back( aText );
+
+        return *this;
+    }
+
+    bool HasMessage() const override { return !m_actions.empty(); }
+
+    std::vector<wxString> m_actions;
+};
+
+
+/**
+ * A board with the footprints R1, R2, C1 and U1, and the netlist of each test, which matches
+ * its components to the footprints by path.
+ */
+struct BOARD_NETLIST_UPDATER_FIXTURE
+{
+    BOARD_NETLIST_UPDATER_FIXTURE()
+    {
+        for( const wxString& name : { wxT( "GND" ), wxT( "/SIG" ), wxT( "/OUT" ) } )
+            m_board.Add( new NETINFO_ITEM( &m_board, name ) );
+
+        addFootprint( wxT( "R1" ), wxT( "10k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+        addFootprint( wxT( "R2" ), wxT( "1k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+        addFootprint( wxT( "C1" ), wxT( "100n" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+        addFootprint( wxT( "U1" ), wxT( "MCU" ),
+                      { wxT( "/SIG" ), wxT( "GND" ), wxT( "/OUT" ), wxEmptyString } );
+    }
+
+    /**
+     * Add a footprint with one pad per net, named from 1, and with a new path.
+     */
+    FOOTPRINT* addFootprint( const wxString& aReference, const wxString& aValue,
+                             const std::vector<wxString>& aNets )
+    {
+        FOOTPRINT* footprint = new FOOTPRINT( &m_board );
+        KIID_PATH  path;
+
+        path.push_back( KIID() );
+        path.push_back( KIID() );
+
+        footprint->SetFPID( LIB_ID( wxT( "lib" ), wxT( "fp" ) ) );
+        footprint->SetPath( path );
+        footprint->SetReference( aReference );
+        footprint->SetValue( aValue );
+
+        for( size_t ii = 0; ii < aNets.size(); ++ii )
+        {
+            PAD*    pad = new PAD( footprint );
+            wxPoint pos( (int) ii * 1270000, 0 );
+
+            pad->SetName( wxString::Format( wxT( "%d" ), (int) ii + 1 ) );
+            pad->SetPosition( pos );
+            pad->SetPos0( pos );
+            pad->SetShape( PAD_SHAPE_RECT );
+            pad->SetAttribute( PAD_ATTRIB_SMD );
+            pad->SetLayerSet( PAD::SMDMask() );
+            pad->SetSize( wxSize( 600000, 1000000 ) );
+
+            if( !aNets[ii].IsEmpty() )
+                pad->SetNet( m_board.FindNet( aNets[ii] ) );
+
+            footprint->Add( pad );
+        }
+
+        m_board.Add( footprint );
+        return footprint;
+    }
+
+    /**
+     * Add the component of a footprint to the netlist, with one net per pad.
+     */
+    void addComponent( const wxString& aOldReference, const wxString& aReference,
+                       const wxString& aValue, const std::vector<wxString>& aNets )
+    {
+        FOOTPRINT* footprint = m_board.FindFootprintByReference( aOldReference );
+
+        BOOST_REQUIRE( footprint );
+
+        COMPONENT* component = new COMPONENT( footprint->GetFPID(), aReference, aValue,
+                                              footprint->GetPath() );
+
+        for( size_t ii = 0; ii < aNets.size(); ++ii )
+            component->AddNet( wxString::Format( wxT( "%d" ), (int) ii + 1 ), aNets[ii],
+                               wxEmptyString );
+
+        m_netlist.AddComponent( component );
+    }
+
+    /**
+     * Run the update in dry run mode, with the default options of the Update PCB dialog.
+     */
+    void updateDryRun()
+    {
+        BOARD_NETLIST_UPDATER updater( nullptr, &m_board );
+
+        updater.SetReporter( &m_reporter );
+        updater.SetIsDryRun( true );
+        updater.SetLookupByTimestamp( true );
+        updater.SetDeleteUnusedComponents( false );
+        updater.SetReplaceFootprints( true );
+
+        BOOST_REQUIRE( updater.UpdateNetlist( m_netlist ) );
+    }
+
+    /**
+     * The reference, value and pad nets of the footprints, by footprint.
+     */
+    std::map<FOOTPRINT*, std::vector<wxString>> snapshot()
+    {
+        std::map<FOOTPRINT*, std::vector<wxString>> state;
+
+        for( FOOTPRINT* footprint : m_board.Footprints() )
+        {
+            std::vector<wxString>& fields = state[footprint];
+
+            fields.push_back( footprint->GetReference() );
+            fields.push_back( footprint->GetValue() );
+
+            for( PAD* pad : footprint->Pads() )
+                fields.push_back( pad->GetNetname() );
+        }
+
+        return state;
+    }
+
+    BOARD           m_board;
+    NETLIST         m_netlist;
+    ACTION_REPORTER m_reporter;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BoardNetlistUpdater, BOARD_NETLIST_UPDATER_FIXTURE )
+
+
+/**
+ * A netlist matching the board gives no action, so no footprint is changed.
+ */
+BOOST_AUTO_TEST_CASE( NoChanges )
+{
+    addComponent( wxT( "R1" ), wxT( "R1" ), wxT( "10k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+    addComponent( wxT( "R2" ), wxT( "R2" ), wxT( "1k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+    addComponent( wxT( "C1" ), wxT( "C1" ), wxT( "100n" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+    addComponent( wxT( "U1" ), wxT( "U1" ), wxT( "MCU" ),
+                  { wxT( "/SIG" ), wxT( "GND" ), wxT( "/OUT" ), wxEmptyString } );
+
+    auto before = snapshot();
+
+    updateDryRun();
+
+    BOOST_CHECK( m_reporter.m_actions.empty() );
+    BOOST_CHECK( snapshot() == before );
+}
+
+
+/**
+ * The changed reference and value, the pad moved to another net and the pad left alone on a
+ * new net are reported, the unchanged footprint is not, and the dry run leaves the board as it
+ * was.
+ */
+BOOST_AUTO_TEST_CASE( DryRunChanges )
+{
+    addComponent( wxT( "R1" ), wxT( "R3" ), wxT( "22k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+    addComponent( wxT( "R2" ), wxT( "R2" ), wxT( "1k" ), { wxT( "/SIG" ), wxT( "GND" ) } );
+    addComponent( wxT( "C1" ), wxT( "C1" ), wxT( "100n" ), { wxT( "/OUT" ), wxT( "GND" ) } );
+    addComponent( wxT( "U1" ), wxT( "U1" ), wxT( "MCU" ),
+                  { wxT( "/SIG" ), wxT( "GND" ), wxT( "/OUT" ), wxT( "/LONE" ) } );
+
+    auto before = snapshot();
+
+    updateDryRun();
+
+    const std::vector<wxString> expected = {
+        wxT( "Change R1 reference designator to R3." ),
+        wxT( "Change R1 value from 10k to 22k." ),
+        wxT( "Reconnect C1 pin 1 from /SIG to /OUT." ),
+        wxT( "Add net /LONE." ),
+        wxT( "Connect U1 pin 4 to /LONE." ),
+        wxT( "Remove single pad net /LONE." )
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( m_reporter.m_actions.begin(), m_reporter.m_actions.end(),
+                                   expected.begin(), expected.end() );
+
+    for( const wxString& action : m_reporter.m_actions )
+        BOOST_CHECK_MESSAGE( !action.Contains( wxT( "R2" ) ), action );
+
+    BOOST_CHECK( snapshot() == before );
+    BOOST_CHECK( m_board.FindNet( wxT( "/LONE" ) ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,208 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <board.h>
+#include <netinfo.h>
+#include <track.h>
+#include <zone.h>
+#include <plugins/kicad/board_snapshot.h>
+#include <plugins/kicad/kicad_plugin.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+
+
+/**
+ * A board file with tracks, a via and a filled zone, which are what the snapshot stores
+ * outside of the board text.
+ */
+struct BOARD_SNAPSHOT_FIXTURE
+{
+    BOARD_SNAPSHOT_FIXTURE()
+    {
+        m_fileName = ( boost::filesystem::temp_directory_path()
+                       / "board_snapshot_tst.kicad_pcb" ).string();
+
+        BOARD         board;
+        NETINFO_ITEM* gnd = new NETINFO_ITEM( &board, wxT( "GND" ) );
+        NETINFO_ITEM* sig = new NETINFO_ITEM( &board, wxT( "/SIG" ) );
+
+        board.Add( gnd );
+        board.Add( sig );
+
+        for( int ii = 0; ii < 10; ++ii )
+        {
+            TRACK* track = new TRACK( &board );
+
+            track->SetStart( wxPoint( ii * 1000000, 0 ) );
+            track->SetEnd( wxPoint( ii * 1000000, 5000000 ) );
+            track->SetWidth( 250000 );
+            track->SetLayer( ii % 2 ? B_Cu : F_Cu );
+            track->SetNet( ii % 2 ? gnd : sig );
+            board.Add( track );
+        }
+
+        VIA* via = new VIA( &board );
+
+        via->SetPosition( wxPoint( 3000000, 5000000 ) );
+        via->SetLayerPair( F_Cu, B_Cu );
+        via->SetWidth( 800000 );
+        via->SetDrill( 400000 );
+        via->SetNet( gnd );
+        board.Add( via );
+
+        ZONE* zone = new ZONE( &board );
+
+        zone->SetLayer( F_Cu );
+        zone->SetNet( gnd );
+        zone->Outline()->NewOutline();
+        zone->Outline()->Append( 0, 10000000 );
+        zone->Outline()->Append( 10000000, 10000000 );
+        zone->Outline()->Append( 10000000, 20000000 );
+        zone->Outline()->Append( 0, 20000000 );
+
+        SHAPE_POLY_SET fill;
+
+        fill.NewOutline();
+        fill.Append( 100000, 10100000 );
+        fill.Append( 9900000, 10100000 );
+        fill.Append( 9900000, 19900000 );
+        fill.Append( 100000, 19900000 );
+
+        zone->SetFilledPolysList( F_Cu, fill );
+        zone->SetIsFilled( true );
+        board.Add( zone );
+
+        KI_TEST::DumpBoardToFile( board, m_fileName.ToStdString() );
+
+        PCB_IO io;
+        m_board.reset( io.Load( m_fileName, nullptr, nullptr ) );
+    }
+
+    ~BOARD_SNAPSHOT_FIXTURE()
+    {
+        m_board.reset();
+        wxRemoveFile( BoardSnapshotFileName( m_fileName ) );
+        wxRemoveFile( m_fileName );
+    }
+
+    wxString               m_fileName;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BoardSnapshot, BOARD_SNAPSHOT_FIXTURE )
+
+
+/**
+ * The board loaded from its snapshot is the board loaded from the file.
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( m_board );
+    BOOST_REQUIRE( WriteBoardSnapshot( m_board.get(), m_fileName ) );
+
+    std::unique_ptr<BOARD> snapshot( LoadBoardSnapshot( m_fileName, nullptr ) );
+
+    BOOST_REQUIRE( snapshot );
+    BOOST_CHECK_EQUAL( snapshot->GetFileFormatVersionAtLoad(),
+                       m_board->GetFileFormatVersionAtLoad() );
+    BOOST_REQUIRE_EQUAL( snapshot->Tracks().size(), m_board->Tracks().size() );
+
+    auto it = snapshot->Tracks().begin();
+
+    for( TRACK* expected : m_board->Tracks() )
+    {
+        TRACK* track = *it++;
+
+        BOOST_TEST_CONTEXT( "Track " << expected->m_Uuid.AsString() )
+        {
+            BOOST_CHECK_EQUAL( track->m_Uuid.AsString(), expected->m_Uuid.AsString() );
+            BOOST_CHECK_EQUAL( track->Type(), expected->Type() );
+            BOOST_CHECK( track->GetStart() == expected->GetStart() );
+            BOOST_CHECK( track->GetEnd() == expected->GetEnd() );
+            BOOST_CHECK_EQUAL( track->GetWidth(), expected->GetWidth() );
+            BOOST_CHECK( track->GetLayerSet() == expected->GetLayerSet() );
+            BOOST_CHECK_EQUAL( track->GetNetname(), expected->GetNetname() );
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL( snapshot->Zones().size(), 1U );
+
+    const SHAPE_POLY_SET& fill = snapshot->Zones()[0]->GetFilledPolysList( F_Cu );
+    const SHAPE_POLY_SET& expectedFill = m_board->Zones()[0]->GetFilledPolysList( F_Cu );
+
+    BOOST_REQUIRE_EQUAL( fill.OutlineCount(), expectedFill.OutlineCount() );
+    BOOST_CHECK_EQUAL( fill.TotalVertices(), expectedFill.TotalVertices() );
+    BOOST_CHECK_EQUAL( fill.COutline( 0 ).Area(), expectedFill.COutline( 0 ).Area() );
+}
+
+
+/**
+ * A snapshot is not used once the board file changes.
+ */
+BOOST_AUTO_TEST_CASE( SourceChanged )
+{
+    BOOST_REQUIRE( m_board );
+    BOOST_REQUIRE( WriteBoardSnapshot( m_board.get(), m_fileName ) );
+
+    wxFFile file( m_fileName, wxT( "a" ) );
+
+    BOOST_REQUIRE( file.IsOpened() );
+    BOOST_REQUIRE( file.Write( wxT( "\n" ) ) );
+    file.Close();
+
+    BOOST_CHECK( LoadBoardSnapshot( m_fileName, nullptr ) == nullptr );
+}
+
+
+/**
+ * Boards which still have legacy settings to migrate have no snapshot, which would lose them.
+ */
+BOOST_AUTO_TEST_CASE( LegacySource )
+{
+    BOOST_REQUIRE( m_board );
+
+    int version = m_board->GetFileFormatVersionAtLoad();
+
+    m_board->SetFileFormatVersionAtLoad( 20200829 );
+    BOOST_CHECK( !WriteBoardSnapshot( m_board.get(), m_fileName ) );
+
+    m_board->SetFileFormatVersionAtLoad( version );
+    m_board->m_LegacyNetclassesLoaded = true;
+    BOOST_CHECK( !WriteBoardSnapshot( m_board.get(), m_fileName ) );
+
+    m_board->m_LegacyNetclassesLoaded = false;
+    m_board->m_LegacyDesignSettingsLoaded = true;
+    BOOST_CHECK( !WriteBoardSnapshot( m_board.get(), m_fileName ) );
+
+    BOOST_CHECK( !wxFileExists( BoardSnapshotFileName( m_fileName ) ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gendrill_path_optimizer.h>
+
+#include <algorithm>
+#include <random>
+
+
+/**
+ * @return \a aHits in \a aOrder, after checking it is a permutation of them
+ */
+static std::vector<wxPoint> reorder( const std::vector<wxPoint>& aHits,
+                                     const std::vector<int>& aOrder )
+{
+    std::vector<int> sorted = aOrder;
+    std::sort( sorted.begin(), sorted.end() );
+
+    BOOST_REQUIRE_EQUAL( sorted.size(), aHits.size() );
+
+    for( size_t ii = 0; ii < sorted.size(); ++ii )
+        BOOST_REQUIRE_EQUAL( sorted[ii], (int) ii );
+
+    std::vector<wxPoint> hits;
+
+    for( int idx : aOrder )
+        hits.push_back( aHits[idx] );
+
+    return hits;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrillPath )
+
+
+BOOST_AUTO_TEST_CASE( FewHits )
+{
+    BOOST_CHECK( OptimizeDrillPath( {} ).empty() );
+
+    std::vector<wxPoint> hits = { wxPoint( 0, 0 ), wxPoint( 1000, 0 ) };
+    BOOST_CHECK( OptimizeDrillPath( hits ) == std::vector<int>( { 0, 1 } ) );
+
+    // The middle hit is visited between the other ones
+    hits = { wxPoint( 0, 0 ), wxPoint( 2000, 0 ), wxPoint( 1000, 0 ) };
+    BOOST_CHECK_EQUAL( DrillPathLength( reorder( hits, OptimizeDrillPath( hits ) ) ), 2000.0 );
+}
+
+
+/**
+ * A shuffled grid is walked (nearly) row by row
+ */
+BOOST_AUTO_TEST_CASE( Grid )
+{
+    const int            pitch = 1000000;
+    std::vector<wxPoint> hits;
+
+    for( int ii = 0; ii < 40; ++ii )
+    {
+        for( int jj = 0; jj < 40; ++jj )
+            hits.emplace_back( jj * pitch, ii * pitch );
+    }
+
+    std::shuffle( hits.begin(), hits.end(), std::mt19937( 42 ) );
+
+    std::vector<wxPoint> path = reorder( hits, OptimizeDrillPath( hits ) );
+
+    double shortest = ( hits.size() - 1 ) * (double) pitch;
+
+    BOOST_CHECK_LE( DrillPathLength( path ), shortest * 1.05 );
+}
+
+
+/**
+ * Random hits, sorted as the drill files did before optimization
+ */
+BOOST_AUTO_TEST_CASE( RandomHits )
+{
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> coord( 0, 100000000 );
+    std::vector<wxPoint>               hits;
+
+    for( int ii = 0; ii < 2000; ++ii )
+        hits.emplace_back( coord( rng ), coord( rng ) );
+
+    std::sort( hits.begin(), hits.end(),
+               []( const wxPoint& a, const wxPoint& b )
+               {
+                   return a.x < b.x || ( a.x == b.x && a.y < b.y );
+               } );
+
+    std::vector<int>     order = OptimizeDrillPath( hits );
+    std::vector<wxPoint> path = reorder( hits, order );
+
+    BOOST_CHECK_LT( DrillPathLength( path ), DrillPathLength( hits ) / 5 );
+
+    // The result is reproducible
+    BOOST_CHECK( OptimizeDrillPath( hits ) == order );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
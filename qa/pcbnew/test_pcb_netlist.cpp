@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <netlist_reader/pcb_netlist.h>
+
+
+/**
+ * A netlist with the components R2, R1, C1 and a second R1, in this order.
+ */
+struct PCB_NETLIST_FIXTURE
+{
+    PCB_NETLIST_FIXTURE()
+    {
+        for( const wxString& ref : { wxT( "R2" ), wxT( "R1" ), wxT( "C1" ), wxT( "R1" ) } )
+            addComponent( ref );
+    }
+
+    COMPONENT* addComponent( const wxString& aReference )
+    {
+        KIID_PATH path;
+
+        path.push_back( KIID() );
+        path.push_back( KIID() );
+
+        COMPONENT* component = new COMPONENT( LIB_ID( wxT( "lib" ), wxT( "fp" ) ), aReference,
+                                              wxT( "val" ), path );
+
+        m_netlist.AddComponent( component );
+        return component;
+    }
+
+    NETLIST m_netlist;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PcbNetlist, PCB_NETLIST_FIXTURE )
+
+
+/**
+ * The lookups find the first component with a reference or a path, as a linear search would.
+ */
+BOOST_AUTO_TEST_CASE( Lookup )
+{
+    COMPONENT* r1 = m_netlist.GetComponent( 1 );
+    COMPONENT* c1 = m_netlist.GetComponent( 2 );
+
+    BOOST_CHECK_EQUAL( m_netlist.GetComponentByReference( wxT( "R1" ) ), r1 );
+    BOOST_CHECK_EQUAL( m_netlist.GetComponentByReference( wxT( "C1" ) ), c1 );
+    BOOST_CHECK( m_netlist.GetComponentByReference( wxT( "U1" ) ) == nullptr );
+
+    for( unsigned ii = 0; ii < m_netlist.GetCount(); ++ii )
+    {
+        COMPONENT* component = m_netlist.GetComponent( ii );
+        BOOST_CHECK_EQUAL( m_netlist.GetComponentByPath( component->GetPath() ), component );
+    }
+
+    BOOST_CHECK( m_netlist.GetComponentByPath( KIID_PATH() ) == nullptr );
+}
+
+
+/**
+ * Components added or reordered after a lookup are found by the next ones.
+ */
+BOOST_AUTO_TEST_CASE( LookupAfterChange )
+{
+    BOOST_CHECK( m_netlist.GetComponentByReference( wxT( "U1" ) ) == nullptr );
+
+    COMPONENT* u1 = addComponent( wxT( "U1" ) );
+
+    BOOST_CHECK_EQUAL( m_netlist.GetComponentByReference( wxT( "U1" ) ), u1 );
+    BOOST_CHECK_EQUAL( m_netlist.GetComponentByPath( u1->GetPath() ), u1 );
+
+    m_netlist.SortByReference();
+
+    for( const wxString& ref : { wxT( "C1" ), wxT( "R1" ), wxT( "R2" ), wxT( "U1" ) } )
+    {
+        COMPONENT* component = m_netlist.GetComponentByReference( ref );
+
+        BOOST_REQUIRE( component );
+        BOOST_CHECK_EQUAL( component->GetReference(), ref );
+    }
+
+    KIID_PATH u1Path = u1->GetPath();
+
+    m_netlist.Clear();
+
+    BOOST_CHECK( m_netlist.GetComponentByReference( wxT( "U1" ) ) == nullptr );
+    BOOST_CHECK( m_netlist.GetComponentByPath( u1Path ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,287 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <board.h>
+#include <footprint.h>
+#include <locale_io.h>
+#include <netinfo.h>
+#include <pad.h>
+#include <pcb_shape.h>
+#include <pcb_text.h>
+#include <pcbplot.h>
+#include <plotters_specific.h>
+#include <track.h>
+#include <zone.h>
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+
+/**
+ * A four layer board with tracks, vias, a filled zone, pads, texts and a board outline.
+ */
+struct PLOT_BOARD_LAYERS_FIXTURE
+{
+    PLOT_BOARD_LAYERS_FIXTURE()
+    {
+        m_board.SetCopperLayerCount( 4 );
+        m_board.SetEnabledLayers( LSET::AllCuMask( 4 ) | LSET::AllTechMask()
+                                  | LSET( Edge_Cuts ) );
+
+        NETINFO_ITEM* gnd = new NETINFO_ITEM( &m_board, wxT( "GND" ) );
+        NETINFO_ITEM* sig = new NETINFO_ITEM( &m_board, wxT( "/SIG" ) );
+
+        m_board.Add( gnd );
+        m_board.Add( sig );
+
+        const PCB_LAYER_ID copper[] = { F_Cu, In1_Cu, In2_Cu, B_Cu };
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            TRACK* track = new TRACK( &m_board );
+
+            track->SetStart( wxPoint( 1000000 + ii * 1000000, 2000000 ) );
+            track->SetEnd( wxPoint( 1000000 + ii * 1000000, 8000000 + ii * 100000 ) );
+            track->SetWidth( 200000 + ( ii % 3 ) * 50000 );
+            track->SetLayer( copper[ii % 4] );
+            track->SetNet( ii % 2 ? gnd : sig );
+            m_board.Add( track );
+
+            VIA* via = new VIA( &m_board );
+
+            via->SetPosition( track->GetEnd() );
+            via->SetLayerPair( F_Cu, B_Cu );
+            via->SetWidth( 600000 );
+            via->SetDrill( 300000 );
+            via->SetNet( track->GetNet() );
+            m_board.Add( via );
+        }
+
+        ZONE* zone = new ZONE( &m_board );
+
+        zone->SetLayer( In1_Cu );
+        zone->SetNet( gnd );
+        zone->Outline()->NewOutline();
+        zone->Outline()->Append( 0, 10000000 );
+        zone->Outline()->Append( 22000000, 10000000 );
+        zone->Outline()->Append( 22000000, 20000000 );
+        zone->Outline()->Append( 0, 20000000 );
+
+        SHAPE_POLY_SET fill;
+
+        fill.NewOutline();
+        fill.Append( 100000, 10100000 );
+        fill.Append( 21900000, 10100000 );
+        fill.Append( 21900000, 19900000 );
+        fill.Append( 100000, 19900000 );
+        fill.NewHole();
+        fill.Append( 5000000, 14000000 );
+        fill.Append( 5000000, 16000000 );
+        fill.Append( 7000000, 16000000 );
+        fill.Append( 7000000, 14000000 );
+        fill.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+        zone->SetFilledPolysList( In1_Cu, fill );
+        zone->SetIsFilled( true );
+        m_board.Add( zone );
+
+        FOOTPRINT* footprint = new FOOTPRINT( &m_board );
+
+        footprint->SetReference( wxT( "U1" ) );
+
+        for( int ii = 0; ii < 8; ++ii )
+        {
+            PAD*    pad = new PAD( footprint );
+            wxPoint pos( 2000000 + ii * 1270000, ii < 4 ? 22000000 : 25000000 );
+
+            pad->SetName( wxString::Format( wxT( "%d" ), ii + 1 ) );
+            pad->SetPosition( pos );
+            pad->SetPos0( pos );
+            pad->SetNet( ii % 2 ? gnd : sig );
+
+            if( ii < 4 )
+            {
+                pad->SetShape( ii % 2 ? PAD_SHAPE_RECT : PAD_SHAPE_ROUNDRECT );
+                pad->SetRoundRectRadiusRatio( 0.25 );
+                pad->SetAttribute( PAD_ATTRIB_SMD );
+                pad->SetLayerSet( PAD::SMDMask() );
+                pad->SetSize( wxSize( 600000, 1500000 ) );
+            }
+            else
+            {
+                pad->SetShape( ii % 2 ? PAD_SHAPE_CIRCLE : PAD_SHAPE_OVAL );
+                pad->SetAttribute( PAD_ATTRIB_PTH );
+                pad->SetLayerSet( PAD::PTHMask() );
+                pad->SetSize( wxSize( 1000000, 1200000 ) );
+                pad->SetDrillSize( wxSize( 500000, 500000 ) );
+            }
+
+            footprint->Add( pad );
+        }
+
+        m_board.Add( footprint );
+
+        for( PCB_LAYER_ID layer : { F_SilkS, B_SilkS } )
+        {
+            PCB_TEXT* text = new PCB_TEXT( &m_board );
+
+            text->SetText( wxT( "Plot test" ) );
+            text->SetLayer( layer );
+            text->SetTextPos( wxPoint( 10000000, 28000000 ) );
+            text->SetTextSize( wxSize( 1500000, 1500000 ) );
+            text->SetTextThickness( 200000 );
+            text->SetMirrored( layer == B_SilkS );
+            m_board.Add( text );
+        }
+
+        PCB_SHAPE* outline = new PCB_SHAPE( &m_board );
+
+        outline->SetShape( S_RECT );
+        outline->SetLayer( Edge_Cuts );
+        outline->SetStart( wxPoint( 0, 0 ) );
+        outline->SetEnd( wxPoint( 22000000, 30000000 ) );
+        outline->SetWidth( 100000 );
+        m_board.Add( outline );
+
+        m_board.BuildConnectivity();
+    }
+
+    ~PLOT_BOARD_LAYERS_FIXTURE()
+    {
+        for( const wxString& fileName : m_fileNames )
+            wxRemoveFile( fileName );
+    }
+
+    /**
+     * The jobs plotting the enabled layers to files named after \a aPrefix.
+     */
+    std::vector<PLOT_LAYER_JOB> makeJobs( const std::string& aPrefix )
+    {
+        std::vector<PLOT_LAYER_JOB> jobs;
+
+        for( PCB_LAYER_ID layer : m_board.GetEnabledLayers().UIOrder() )
+        {
+            std::string name = aPrefix + "_" + std::to_string( layer ) + ".gbr";
+
+            PLOT_LAYER_JOB job;
+            job.m_Layer = layer;
+            job.m_FileName = ( boost::filesystem::temp_directory_path() / name ).string();
+            jobs.push_back( job );
+
+            m_fileNames.push_back( job.m_FileName );
+        }
+
+        return jobs;
+    }
+
+    BOARD                 m_board;
+    std::vector<wxString> m_fileNames;
+};
+
+
+/**
+ * Read the bytes of a plot file, without the lines holding the date it was created.
+ */
+static std::string readPlot( const wxString& aFileName )
+{
+    wxFFile     file( aFileName, wxT( "rb" ) );
+    std::string content( file.IsOpened() ? file.Length() : 0, '\0' );
+
+    BOOST_REQUIRE( file.IsOpened() );
+    BOOST_REQUIRE( file.Read( &content[0], content.size() ) == content.size() );
+
+    std::string plot;
+    size_t      start = 0;
+
+    while( start < content.size() )
+    {
+        size_t      end = std::min( content.find( '\n', start ), content.size() - 1 );
+        std::string line = content.substr( start, end + 1 - start );
+
+        if( line.find( "CreationDate" ) == std::string::npos
+                && line.compare( 0, 14, "G04 Created by" ) )
+        {
+            plot += line;
+        }
+
+        start = end + 1;
+    }
+
+    return plot;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( PlotLayersInParallel, PLOT_BOARD_LAYERS_FIXTURE )
+
+
+/**
+ * The Gerber files of the layers plotted together are the files plotted one at a time, but
+ * for their creation date.
+ */
+BOOST_AUTO_TEST_CASE( SameAsSerialPlot )
+{
+    PCB_PLOT_PARAMS plotOpts;
+
+    plotOpts.SetFormat( PLOT_FORMAT::GERBER );
+
+    std::vector<PLOT_LAYER_JOB> serialJobs = makeJobs( "plot_layers_tst_serial" );
+    std::vector<PLOT_LAYER_JOB> parallelJobs = makeJobs( "plot_layers_tst_parallel" );
+
+    BOOST_REQUIRE_GE( serialJobs.size(), 10U );
+
+    for( const PLOT_LAYER_JOB& job : serialJobs )
+    {
+        LOCALE_IO toggle;
+        PLOTTER*  plotter = StartPlotBoard( &m_board, &plotOpts, job.m_Layer, job.m_FileName,
+                                            wxEmptyString );
+
+        BOOST_REQUIRE( plotter );
+
+        PlotOneBoardLayer( &m_board, plotter, job.m_Layer, plotOpts );
+        plotter->EndPlot();
+        delete plotter->RenderSettings();
+        delete plotter;
+    }
+
+    PlotBoardLayers( &m_board, &plotOpts, parallelJobs );
+
+    for( size_t ii = 0; ii < serialJobs.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Layer " << m_board.GetLayerName( serialJobs[ii].m_Layer ) )
+        {
+            BOOST_REQUIRE( parallelJobs[ii].m_Plotted );
+
+            BOOST_CHECK( readPlot( parallelJobs[ii].m_FileName )
+                         == readPlot( serialJobs[ii].m_FileName ) );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <specctra_import_export/specctra.h>
+
+
+/**
+ * Check that DSN::FormatNumber() writes \a aValue as sprintf( "%.6g" ) does.
+ */
+static void checkFormat( double aValue )
+{
+    char expected[64];
+    char buffer[64];
+
+    snprintf( expected, sizeof( expected ), "%.6g", aValue );
+
+    BOOST_CHECK_EQUAL( std::string( DSN::FormatNumber( buffer, aValue ) ),
+                       std::string( expected ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE( SpecctraFormatNumber )
+
+
+/**
+ * The values on, and on either side of, each decade of the fixed notation
+ */
+BOOST_AUTO_TEST_CASE( DecadeBoundaries )
+{
+    for( int exponent = -6; exponent <= 8; ++exponent )
+    {
+        double decade = std::pow( 10.0, exponent );
+
+        BOOST_TEST_CONTEXT( "Decade 1e" << exponent )
+        {
+            for( double value : { decade, std::nextafter( decade, 0.0 ),
+                                  std::nextafter( decade, 2 * decade ), decade * ( 1 - 1e-7 ),
+                                  decade * ( 1 - 4e-7 ), decade * ( 1 - 6e-7 ),
+                                  decade * ( 1 + 4e-7 ), decade * ( 1 + 6e-7 ) } )
+            {
+                checkFormat( value );
+                checkFormat( -value );
+            }
+        }
+    }
+}
+
+
+/**
+ * Values half way between two 6 digit numbers, which printf rounds on their exact value
+ */
+BOOST_AUTO_TEST_CASE( Ties )
+{
+    for( double value : { 0.5, 2.5, 1.0000005, 2.0000005, 1.2345650, 1.2345665, 12.345650,
+                          123.45650, 1234.5650, 12345.650, 123456.5, 123457.5, 999999.5,
+                          0.00012345650, 0.0012345650, 0.99999950, 9.9999950, 99999.950 } )
+    {
+        checkFormat( value );
+        checkFormat( -value );
+    }
+}
+
+
+/**
+ * Negative numbers and the negative zero, which keeps its sign
+ */
+BOOST_AUTO_TEST_CASE( Negatives )
+{
+    for( double value : { -0.0, 0.0, -1.0, -0.1, -1.5, -123.456, -10000.0, -0.000123,
+                          -999999.0, -1e6, -1e-5 } )
+    {
+        checkFormat( value );
+    }
+}
+
+
+/**
+ * The ends of the fixed notation, where printf switches to the exponent notation
+ */
+BOOST_AUTO_TEST_CASE( FixedNotationEnds )
+{
+    for( double value : { 1e-4, std::nextafter( 1e-4, 0.0 ), 9.99999e-5, 9.999995e-5,
+                          9.9999949e-5, 1e6, std::nextafter( 1e6, 0.0 ), 999999.4, 999999.49,
+                          999999.51, 1e-10, 1e20, std::numeric_limits<double>::min(),
+                          std::numeric_limits<double>::max(),
+                          std::numeric_limits<double>::denorm_min() } )
+    {
+        checkFormat( value );
+        checkFormat( -value );
+    }
+}
+
+
+/**
+ * Values which are not numbers
+ */
+BOOST_AUTO_TEST_CASE( NotFinite )
+{
+    checkFormat( std::numeric_limits<double>::quiet_NaN() );
+    checkFormat( std::numeric_limits<double>::infinity() );
+    checkFormat( -std::numeric_limits<double>::infinity() );
+}
+
+
+/**
+ * Coordinates as they are exported, in um with up to 4 decimals
+ */
+BOOST_AUTO_TEST_CASE( Coordinates )
+{
+    for( int ii = -200000; ii <= 200000; ii += 7 )
+    {
+        checkFormat( ii / 10.0 );
+        checkFormat( ii / 1000.0 );
+        checkFormat( ii * 1.2345 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <board.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <zone.h>
+#include <plugins/kicad/kicad_plugin.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+
+
+static const int      MAX_ERROR = 5000;
+static const int      HOLE_RADIUS = 500000;
+static const VECTOR2I HOLE_CENTER( 5000000, 15000000 );
+
+
+/**
+ * A board with a zone filled around a round knockout, as the zone filler leaves it.
+ */
+struct ZONE_FILL_ARCS_FIXTURE
+{
+    ZONE_FILL_ARCS_FIXTURE()
+    {
+        m_fileName = ( boost::filesystem::temp_directory_path()
+                       / "zone_fill_arcs_tst.kicad_pcb" ).string();
+
+        ZONE* zone = new ZONE( &m_board );
+
+        zone->SetLayer( F_Cu );
+        zone->Outline()->NewOutline();
+        zone->Outline()->Append( 0, 10000000 );
+        zone->Outline()->Append( 10000000, 10000000 );
+        zone->Outline()->Append( 10000000, 20000000 );
+        zone->Outline()->Append( 0, 20000000 );
+
+        SHAPE_POLY_SET hole;
+
+        m_fill.NewOutline();
+        m_fill.Append( 100000, 10100000 );
+        m_fill.Append( 9900000, 10100000 );
+        m_fill.Append( 9900000, 19900000 );
+        m_fill.Append( 100000, 19900000 );
+
+        TransformCircleToPolygon( hole, (wxPoint) HOLE_CENTER, HOLE_RADIUS, MAX_ERROR,
+                                  ERROR_OUTSIDE );
+
+        m_fill.BooleanSubtract( hole, SHAPE_POLY_SET::PM_FAST );
+        m_fill.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+        zone->SetFilledPolysList( F_Cu, m_fill );
+        zone->SetIsFilled( true );
+        m_board.Add( zone );
+    }
+
+    ~ZONE_FILL_ARCS_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    wxString       m_fileName;
+    BOARD          m_board;
+    SHAPE_POLY_SET m_fill;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillArcs, ZONE_FILL_ARCS_FIXTURE )
+
+
+/**
+ * The knockout is saved as an arc, and the reloaded fill does not cut into it.
+ */
+BOOST_AUTO_TEST_CASE( SaveLoad )
+{
+    BOOST_REQUIRE_EQUAL( m_fill.OutlineCount(), 1 );
+    BOOST_REQUIRE_GE( m_fill.COutline( 0 ).ArcCount(), 1 );
+
+    KI_TEST::DumpBoardToFile( m_board, m_fileName.ToStdString() );
+
+    wxFFile  file( m_fileName, wxT( "r" ) );
+    wxString content;
+
+    BOOST_REQUIRE( file.IsOpened() && file.ReadAll( &content ) );
+    file.Close();
+
+    auto count =
+            [&]( const wxString& aToken )
+            {
+                int n = 0;
+
+                for( size_t pos = content.find( aToken ); pos != wxString::npos;
+                     pos = content.find( aToken, pos + 1 ) )
+                {
+                    n++;
+                }
+
+                return n;
+            };
+
+    int arcs = count( wxT( "(arc (start" ) );
+
+    // Each arc is written as 3 points, which replace many more
+    BOOST_CHECK_GE( arcs, 1 );
+    BOOST_CHECK_LT( count( wxT( "(xy " ) ) + 3 * arcs, m_fill.TotalVertices() );
+
+    PCB_IO                 io;
+    std::unique_ptr<BOARD> board( io.Load( m_fileName, nullptr, nullptr ) );
+
+    BOOST_REQUIRE( board );
+    BOOST_REQUIRE_EQUAL( board->Zones().size(), 1U );
+
+    const SHAPE_POLY_SET& fill = board->Zones()[0]->GetFilledPolysList( F_Cu );
+
+    BOOST_REQUIRE_EQUAL( fill.OutlineCount(), 1 );
+
+    // The segments of the reloaded arc are at least as far from the knockout as the saved ones
+    const SHAPE_LINE_CHAIN& outline = fill.COutline( 0 );
+    const SHAPE_LINE_CHAIN& saved = m_fill.COutline( 0 );
+    int                     clearance = std::numeric_limits<int>::max();
+
+    for( int ii = 0; ii < saved.SegmentCount(); ++ii )
+        clearance = std::min( clearance, saved.CSegment( ii ).Distance( HOLE_CENTER ) );
+
+    for( int ii = 0; ii < outline.SegmentCount(); ++ii )
+        BOOST_CHECK_GE( outline.CSegment( ii ).Distance( HOLE_CENTER ), clearance );
+
+    double area = std::abs( outline.Area() );
+    double savedArea = std::abs( m_fill.COutline( 0 ).Area() );
+
+    BOOST_CHECK_LE( area, savedArea );
+    BOOST_CHECK_CLOSE( area, savedArea, 0.1 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
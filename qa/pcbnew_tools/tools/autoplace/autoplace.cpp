@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <autorouter/ar_autoplacer.h>
+#include <board.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <footprint.h>
+#include <profile.h>
+
+#include <cstdio>
+
+
+enum AUTOPLACE_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    PLACE_FAILED
+};
+
+
+/**
+ * @return the total length of the unrouted connections of \a aBoard.
+ */
+static double ratsnestLength( BOARD& aBoard )
+{
+    aBoard.BuildConnectivity();
+
+    std::vector<CN_EDGE> edges;
+    aBoard.GetConnectivity()->GetUnconnectedEdges( edges );
+
+    double length = 0.0;
+
+    for( const CN_EDGE& edge : edges )
+        length += ( edge.GetTargetPos() - edge.GetSourcePos() ).EuclideanNorm();
+
+    return length;
+}
+
+
+int autoplace_main_func( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <board.kicad_pcb> [placed_board.kicad_pcb]\n", argv[0] );
+        printf( "  Places all the footprints of the board, without a frame\n" );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return AUTOPLACE_RET_CODES::LOAD_FAILED;
+
+    double initialLength = ratsnestLength( *brd );
+
+    std::vector<FOOTPRINT*> footprints;
+
+    for( FOOTPRINT* footprint : brd->Footprints() )
+        footprints.push_back( footprint );
+
+    AR_AUTOPLACER autoplacer( brd.get() );
+    PROF_COUNTER  timer;
+
+    if( autoplacer.AutoplaceFootprints( footprints, nullptr ) != AR_COMPLETED )
+    {
+        printf( "Autoplace failed: are the board edges defined?\n" );
+        return AUTOPLACE_RET_CODES::PLACE_FAILED;
+    }
+
+    double                    totalTime = timer.msecs();
+    const AR_PLACEMENT_STATS& stats = autoplacer.GetStats();
+
+    printf( "placed: %d footprints (%d without a free position)\n", stats.m_PlacedCount,
+            stats.m_NoFreePositionCount );
+    printf( "candidates: %lld, %.2f ms, %.0f per second\n", (long long) stats.m_CandidateCount,
+            stats.m_SearchTime,
+            stats.m_SearchTime > 0 ? stats.m_CandidateCount / stats.m_SearchTime * 1000 : 0.0 );
+    printf( "placement cost: %.0f\n", stats.m_TotalCost );
+    printf( "ratsnest length: %.0f before, %.0f after\n", initialLength, ratsnestLength( *brd ) );
+    printf( "total: %.2f ms\n", totalTime );
+
+    if( argc > 2 )
+        KI_TEST::DumpBoardToFile( *brd, argv[2] );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "autoplace",
+        "Place the footprints of a PCB without a frame, and report placement metrics",
+        autoplace_main_func,
+} );
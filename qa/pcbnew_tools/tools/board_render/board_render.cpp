@@ -0,0 +1,195 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <macros.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+#include <profile.h>
+#include <settings/color_settings.h>
+#include <track.h>
+#include <view/offscreen_renderer.h>
+#include <zone.h>
+
+#include <wx/arrstr.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+
+/**
+ * Return the view layers showing the items of board layers listed from the top-most one,
+ * in the same order.
+ */
+static std::vector<int> viewLayersFor( const LSEQ& aLayers )
+{
+    std::vector<int> viewLayers;
+    bool             copperSeen = false;
+
+    for( PCB_LAYER_ID layer : aLayers )
+    {
+        if( IsCopperLayer( layer ) )
+        {
+            // Through items are drawn over all the copper layers
+            if( !copperSeen )
+            {
+                for( int item : { LAYER_PADS_TH, LAYER_VIA_THROUGH, LAYER_VIA_BBLIND,
+                                  LAYER_VIA_MICROVIA } )
+                {
+                    viewLayers.push_back( item );
+                }
+
+                copperSeen = true;
+            }
+
+            if( layer == F_Cu )
+                viewLayers.push_back( LAYER_PAD_FR );
+            else if( layer == B_Cu )
+                viewLayers.push_back( LAYER_PAD_BK );
+
+            viewLayers.push_back( layer );
+            viewLayers.push_back( ZONE_LAYER_FOR( layer ) );
+        }
+        else
+        {
+            viewLayers.push_back( layer );
+        }
+    }
+
+    // Nothing is drawn on these, but items check them to be visible
+    for( int item : { LAYER_MOD_TEXT_FR, LAYER_MOD_TEXT_BK, LAYER_MOD_FR, LAYER_MOD_BK,
+                      LAYER_MOD_VALUES, LAYER_MOD_REFERENCES, LAYER_TRACKS, LAYER_ZONES,
+                      LAYER_PADS, LAYER_VIAS } )
+    {
+        viewLayers.push_back( item );
+    }
+
+    return viewLayers;
+}
+
+
+enum BOARD_RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RENDER_FAILED,
+};
+
+
+int board_render_main_func( int argc, char** argv )
+{
+    if( argc < 3 )
+    {
+        printf( "usage: %s <board.kicad_pcb> <image.png> [width [layer,...]]\n", argv[0] );
+        printf( "  layers are listed from the top-most one, by default "
+                "Edge.Cuts,F.SilkS,F.Cu,B.Cu\n" );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    // The board as seen in the editor, without its canvas.  Items leave the view when they
+    // are destroyed, so it has to outlive the board.
+    KIGFX::PCB_VIEW view( false );
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return BOARD_RENDER_RET_CODES::LOAD_FAILED;
+
+    int      width = argc > 3 ? atoi( argv[3] ) : 2000;
+    wxString layerNames = argc > 4 ? argv[4] : "Edge.Cuts,F.SilkS,F.Cu,B.Cu";
+    LSEQ     layers;
+
+    for( const wxString& name : wxSplit( layerNames, ',' ) )
+    {
+        PCB_LAYER_ID layer = brd->GetLayerID( name );
+
+        if( layer == UNDEFINED_LAYER )
+        {
+            printf( "unknown layer: %s\n", TO_UTF8( name ) );
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        layers.push_back( layer );
+    }
+
+    for( BOARD_ITEM* drawing : brd->Drawings() )
+        view.Add( drawing );
+
+    for( TRACK* track : brd->Tracks() )
+        view.Add( track );
+
+    for( FOOTPRINT* footprint : brd->Footprints() )
+        view.Add( footprint );
+
+    for( ZONE* zone : brd->Zones() )
+        view.Add( zone );
+
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    KIGFX::PCB_PAINTER painter( nullptr );
+    painter.GetSettings()->LoadColors( &colors );
+
+    EDA_RECT bbox = brd->GetBoardEdgesBoundingBox();
+
+    if( bbox.GetWidth() == 0 || bbox.GetHeight() == 0 )
+        bbox = brd->GetBoundingBox();
+
+    int height = KiROUND( (double) width * bbox.GetHeight() / bbox.GetWidth() );
+
+    KIGFX::OFFSCREEN_RENDERER renderer( view, painter );
+    renderer.SetLayers( viewLayersFor( layers ) );
+    renderer.SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+    renderer.SetImageSize( width, height );
+
+    printf( "threads,render_ms\n" );
+
+    for( int threads : { 1, std::max<int>( std::thread::hardware_concurrency(), 1 ) } )
+    {
+        renderer.SetThreadCount( threads );
+
+        PROF_COUNTER timer;
+
+        if( !renderer.Render() )
+            return BOARD_RENDER_RET_CODES::RENDER_FAILED;
+
+        printf( "%d,%.2f\n", threads, timer.msecs() );
+    }
+
+    if( !renderer.SaveImage( argv[2] ) )
+        return BOARD_RENDER_RET_CODES::RENDER_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "board_render",
+        "Render PCB layers to a PNG image, without a window",
+        board_render_main_func,
+} );
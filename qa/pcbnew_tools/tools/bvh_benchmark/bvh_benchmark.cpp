@@ -0,0 +1,313 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d-viewer/3d_rendering/3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d-viewer/3d_rendering/3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d-viewer/3d_rendering/3d_render_raytracing/accelerators/ccontainer2d.h>
+#include <3d-viewer/3d_rendering/3d_render_raytracing/shapes2D/croundsegment2d.h>
+#include <3d-viewer/3d_rendering/3d_render_raytracing/shapes3D/cinstance.h>
+#include <3d-viewer/3d_rendering/3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <pcb_shape.h>
+#include <profile.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+/// Side of the square the random objects are spread on, in 3D units
+static const float BENCHMARK_AREA = 100.0f;
+
+/// Triangles of the model placed many times, about what an 0402 passive has
+static const int INSTANCED_MODEL_TRIANGLES = 1000;
+
+/// Placements of the model, on a square grid
+static const int INSTANCED_MODEL_PLACEMENTS = 2000;
+
+
+/**
+ * Build a 2D container of random short segments, which is what tracks look like to the
+ * raytracer.
+ */
+static void fill2DContainer( CBVHCONTAINER2D& aContainer, int aCount, const BOARD_ITEM& aItem )
+{
+    std::mt19937                          rng( 1 );
+    std::uniform_real_distribution<float> pos( 0.0f, BENCHMARK_AREA );
+    std::uniform_real_distribution<float> delta( -1.0f, 1.0f );
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        SFVEC2F start( pos( rng ), pos( rng ) );
+        SFVEC2F end = start + SFVEC2F( delta( rng ), delta( rng ) );
+
+        aContainer.Add( new CROUNDSEGMENT2D( start, end, 0.1f, aItem ) );
+    }
+}
+
+
+/**
+ * Fill a 3D container with random small triangles, spread over a board-like slab.
+ */
+static void fill3DContainer( CCONTAINER& aContainer, int aCount )
+{
+    std::mt19937                          rng( 2 );
+    std::uniform_real_distribution<float> pos( 0.0f, BENCHMARK_AREA );
+    std::uniform_real_distribution<float> delta( -0.5f, 0.5f );
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        SFVEC3F v1( pos( rng ), pos( rng ), delta( rng ) );
+        SFVEC3F v2 = v1 + SFVEC3F( delta( rng ), delta( rng ), delta( rng ) );
+        SFVEC3F v3 = v1 + SFVEC3F( delta( rng ), delta( rng ), delta( rng ) );
+
+        aContainer.Add( new CTRIANGLE( v1, v2, v3 ) );
+    }
+}
+
+
+/**
+ * Make the triangles of a random model fitting in a unit cube.
+ */
+static std::vector<SFVEC3F> makeModel( int aTriangleCount )
+{
+    std::mt19937                          rng( 5 );
+    std::uniform_real_distribution<float> pos( 0.0f, 1.0f );
+    std::uniform_real_distribution<float> delta( -0.1f, 0.1f );
+    std::vector<SFVEC3F>                  vertices;
+
+    for( int i = 0; i < aTriangleCount; ++i )
+    {
+        SFVEC3F v1( pos( rng ), pos( rng ), pos( rng ) );
+
+        vertices.push_back( v1 );
+        vertices.push_back( v1 + SFVEC3F( delta( rng ), delta( rng ), delta( rng ) ) );
+        vertices.push_back( v1 + SFVEC3F( delta( rng ), delta( rng ), delta( rng ) ) );
+    }
+
+    return vertices;
+}
+
+
+/**
+ * Transforms placing a model many times over the benchmark area, like the footprints of
+ * passives.
+ */
+static std::vector<glm::mat4> makePlacements( int aCount )
+{
+    std::mt19937                          rng( 6 );
+    std::uniform_real_distribution<float> angle( 0.0f, 2.0f * glm::pi<float>() );
+    std::vector<glm::mat4>                placements;
+
+    const int   columns = (int) std::ceil( std::sqrt( (float) aCount ) );
+    const float pitch = BENCHMARK_AREA / columns;
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        glm::mat4 placement = glm::translate( glm::mat4( 1.0f ),
+                                              SFVEC3F( ( i % columns + 0.5f ) * pitch,
+                                                       ( i / columns + 0.5f ) * pitch, 0.0f ) );
+
+        placement = glm::rotate( placement, angle( rng ), SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+        placement = glm::scale( placement, SFVEC3F( pitch * 0.5f ) );
+
+        placements.push_back( placement );
+    }
+
+    return placements;
+}
+
+
+static double queries2D( const CBVHCONTAINER2D& aContainer, int aQueries, int* aHits )
+{
+    std::mt19937                          rng( 3 );
+    std::uniform_real_distribution<float> pos( 0.0f, BENCHMARK_AREA );
+
+    *aHits = 0;
+
+    PROF_COUNTER timer;
+
+    for( int i = 0; i < aQueries; ++i )
+    {
+        RAYSEG2D segRay( SFVEC2F( pos( rng ), pos( rng ) ), SFVEC2F( pos( rng ), pos( rng ) ) );
+
+        if( aContainer.IntersectAny( segRay ) )
+            ( *aHits )++;
+    }
+
+    return aQueries / timer.msecs() * 1000.0;
+}
+
+
+static double queries3D( const CGENERICACCELERATOR& aAccelerator, int aQueries, int* aHits )
+{
+    std::mt19937                          rng( 4 );
+    std::uniform_real_distribution<float> pos( 0.0f, BENCHMARK_AREA );
+
+    *aHits = 0;
+
+    PROF_COUNTER timer;
+
+    for( int i = 0; i < aQueries; ++i )
+    {
+        // Rays shot down at the slab
+        RAY     ray;
+        HITINFO hitInfo;
+        SFVEC3F origin( pos( rng ), pos( rng ), 10.0f );
+        SFVEC3F target( pos( rng ), pos( rng ), 0.0f );
+
+        ray.Init( origin, glm::normalize( target - origin ) );
+        hitInfo.m_tHit = std::numeric_limits<float>::infinity();
+        hitInfo.m_acc_node_info = 0;
+
+        if( aAccelerator.Intersect( ray, hitInfo ) )
+            ( *aHits )++;
+    }
+
+    return aQueries / timer.msecs() * 1000.0;
+}
+
+
+int bvh_benchmark_main_func( int argc, char** argv )
+{
+    int objectCount = 200000;
+    int queryCount = 1000000;
+
+    if( argc > 1 )
+        objectCount = std::max( atoi( argv[1] ), 1 );
+
+    if( argc > 2 )
+        queryCount = std::max( atoi( argv[2] ), 1 );
+
+    unsigned int threads = std::max<unsigned int>( std::thread::hardware_concurrency(), 1 );
+    PCB_SHAPE    dummyItem;
+    int          hits;
+
+    printf( "bvh,method,objects,threads,build_ms,queries_per_s,hits\n" );
+
+    CBVHCONTAINER2D container2D;
+    fill2DContainer( container2D, objectCount, dummyItem );
+
+    for( unsigned int threadCount : { 1u, threads } )
+    {
+        PROF_COUNTER buildTimer;
+        container2D.BuildBVH( threadCount );
+        double buildTime = buildTimer.msecs();
+
+        double qps = queries2D( container2D, queryCount, &hits );
+
+        printf( "2d,sah,%d,%u,%.2f,%.0f,%d\n", objectCount, threadCount, buildTime, qps, hits );
+    }
+
+    CCONTAINER container3D;
+    fill3DContainer( container3D, objectCount );
+
+    for( SPLITMETHOD method : { SPLITMETHOD::MIDDLE, SPLITMETHOD::SAH } )
+    {
+        for( unsigned int threadCount : { 1u, threads } )
+        {
+            PROF_COUNTER buildTimer;
+            CBVH_PBRT    accelerator( container3D, 8, method, threadCount );
+            double       buildTime = buildTimer.msecs();
+
+            double qps = queries3D( accelerator, queryCount, &hits );
+
+            printf( "3d,%s,%d,%u,%.2f,%.0f,%d\n", method == SPLITMETHOD::SAH ? "sah" : "middle",
+                    objectCount, threadCount, buildTime, qps, hits );
+        }
+    }
+
+    // A model placed many times: copies of its triangles as placed, or instances of them
+    std::vector<SFVEC3F>   model = makeModel( INSTANCED_MODEL_TRIANGLES );
+    std::vector<glm::mat4> placements = makePlacements( INSTANCED_MODEL_PLACEMENTS );
+
+    printf( "\nmodels,triangles,placements,build_ms,queries_per_s,hits,object_bytes\n" );
+
+    {
+        PROF_COUNTER buildTimer;
+        CCONTAINER   container;
+
+        for( const glm::mat4& placement : placements )
+        {
+            for( size_t i = 0; i < model.size(); i += 3 )
+            {
+                SFVEC3F v1( placement * glm::vec4( model[i], 1.0f ) );
+                SFVEC3F v2( placement * glm::vec4( model[i + 1], 1.0f ) );
+                SFVEC3F v3( placement * glm::vec4( model[i + 2], 1.0f ) );
+
+                container.Add( new CTRIANGLE( v1, v2, v3 ) );
+            }
+        }
+
+        CBVH_PBRT accelerator( container, 8, SPLITMETHOD::SAH, threads );
+        double    buildTime = buildTimer.msecs();
+        double    qps = queries3D( accelerator, queryCount, &hits );
+
+        printf( "copied,%d,%d,%.2f,%.0f,%d,%zu\n", INSTANCED_MODEL_TRIANGLES,
+                INSTANCED_MODEL_PLACEMENTS, buildTime, qps, hits,
+                container.GetList().size() * sizeof( CTRIANGLE ) );
+    }
+
+    {
+        PROF_COUNTER buildTimer;
+        CCONTAINER   modelContainer;
+
+        for( size_t i = 0; i < model.size(); i += 3 )
+            modelContainer.Add( new CTRIANGLE( model[i], model[i + 1], model[i + 2] ) );
+
+        CBVH_PBRT  modelAccelerator( modelContainer, 4, SPLITMETHOD::SAH, threads );
+        CCONTAINER container;
+
+        for( const glm::mat4& placement : placements )
+        {
+            container.Add( new CINSTANCE( &modelAccelerator, modelContainer.GetBBox(),
+                                          placement ) );
+        }
+
+        CBVH_PBRT accelerator( container, 8, SPLITMETHOD::SAH, threads );
+        double    buildTime = buildTimer.msecs();
+        double    qps = queries3D( accelerator, queryCount, &hits );
+
+        printf( "instanced,%d,%d,%.2f,%.0f,%d,%zu\n", INSTANCED_MODEL_TRIANGLES,
+                INSTANCED_MODEL_PLACEMENTS, buildTime, qps, hits,
+                modelContainer.GetList().size() * sizeof( CTRIANGLE )
+                        + container.GetList().size() * sizeof( CINSTANCE ) );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "bvh_benchmark",
+        "Benchmark building and traversing the 3D raytracer bounding volume hierarchies",
+        bvh_benchmark_main_func,
+} );
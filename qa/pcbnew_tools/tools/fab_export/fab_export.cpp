@@ -0,0 +1,122 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <exporters/export_d356.h>
+#include <exporters/export_footprints_placefile.h>
+#include <exporters/fabrication_view.h>
+#include <profile.h>
+
+#include <wx/filename.h>
+
+#include <cstdio>
+
+
+bool ExportBoardToHyperlynx( BOARD* aBoard, const wxFileName& aPath,
+                             const FABRICATION_VIEW* aView );
+
+
+enum FAB_EXPORT_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    EXPORT_FAILED
+};
+
+
+/**
+ * Write the IPC-D-356, position, footprint report and Hyperlynx files of a board.
+ *
+ * @param aView is the view shared by the exporters, or nullptr to let each one build its own.
+ */
+static bool exportAll( BOARD* aBoard, const wxString& aOutputDir, const FABRICATION_VIEW* aView )
+{
+    wxFileName fn( aOutputDir, "fab_export" );
+
+    fn.SetExt( "d356" );
+    IPC356D_WRITER d356( aBoard );
+    d356.SetFabricationView( aView );
+    d356.Write( fn.GetFullPath() );
+
+    // The position files of the front, the back and both sides, and the footprint report
+    for( int side = 0; side < 3; ++side )
+    {
+        PLACE_FILE_EXPORTER exporter( aBoard, true, false, side != 1, side != 0, false );
+        exporter.SetFabricationView( aView );
+        exporter.GenPositionData();
+    }
+
+    PLACE_FILE_EXPORTER report( aBoard, true, false, true, true, false );
+    report.SetFabricationView( aView );
+    report.GenReportData();
+
+    fn.SetExt( "hyp" );
+    return ExportBoardToHyperlynx( aBoard, fn, aView );
+}
+
+
+int fab_export_main_func( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <board.kicad_pcb> [output_dir]\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return FAB_EXPORT_RET_CODES::LOAD_FAILED;
+
+    wxString outputDir = argc > 2 ? wxString( argv[2] ) : wxFileName::GetTempDir();
+
+    PROF_COUNTER separateTimer;
+
+    if( !exportAll( brd.get(), outputDir, nullptr ) )
+        return FAB_EXPORT_RET_CODES::EXPORT_FAILED;
+
+    printf( "separate views: %.2f ms\n", separateTimer.msecs() );
+
+    PROF_COUNTER     sharedTimer;
+    FABRICATION_VIEW view( brd.get() );
+
+    printf( "view: %d footprints, %d pads, %d vias, %.2f ms\n", (int) view.Footprints().size(),
+            (int) view.Pads().size(), (int) view.Vias().size(), sharedTimer.msecs() );
+
+    if( !exportAll( brd.get(), outputDir, &view ) )
+        return FAB_EXPORT_RET_CODES::EXPORT_FAILED;
+
+    printf( "shared view: %.2f ms\n", sharedTimer.msecs() );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "fab_export",
+        "Benchmark the fabrication exporters, with and without a shared board view",
+        fab_export_main_func,
+} );
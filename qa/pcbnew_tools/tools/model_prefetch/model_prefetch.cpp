@@ -0,0 +1,217 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d-viewer/3d_cache/3d_cache.h>
+
+#include <profile.h>
+
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+enum MODEL_PREFETCH_RET_CODES
+{
+    CACHE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    LOAD_FAILED,
+    MODELS_DIFFER
+};
+
+
+/**
+ * Create a 3D cache with its cache files in \a aCacheHome, which is empty for a cold load.
+ *
+ * The cache directory is found from XDG_CACHE_HOME, so the cache files are only kept apart
+ * from the user's ones on Linux.
+ */
+static std::unique_ptr<S3D_CACHE> createCache( const wxString& aCacheHome )
+{
+    std::unique_ptr<S3D_CACHE> cache( new S3D_CACHE );
+
+    wxSetEnv( wxT( "XDG_CACHE_HOME" ), aCacheHome );
+
+    if( !cache->Set3DConfigDir( aCacheHome + wxT( "/config" ) ) )
+        return nullptr;
+
+    return cache;
+}
+
+
+template <typename T>
+static bool sameArray( const T* aExpected, const T* aActual, size_t aCount )
+{
+    if( !aExpected || !aActual )
+        return aExpected == aActual;
+
+    return !memcmp( aExpected, aActual, aCount * sizeof( T ) );
+}
+
+
+static bool sameModel( const S3DMODEL* aExpected, const S3DMODEL* aActual )
+{
+    if( !aExpected || !aActual )
+        return aExpected == aActual;
+
+    if( aExpected->m_MeshesSize != aActual->m_MeshesSize
+            || aExpected->m_MaterialsSize != aActual->m_MaterialsSize
+            || !sameArray( aExpected->m_Materials, aActual->m_Materials,
+                           aActual->m_MaterialsSize ) )
+    {
+        return false;
+    }
+
+    for( unsigned int i = 0; i < aActual->m_MeshesSize; ++i )
+    {
+        const SMESH& expected = aExpected->m_Meshes[i];
+        const SMESH& mesh = aActual->m_Meshes[i];
+
+        if( expected.m_VertexSize != mesh.m_VertexSize
+                || expected.m_FaceIdxSize != mesh.m_FaceIdxSize
+                || expected.m_MaterialIdx != mesh.m_MaterialIdx
+                || !sameArray( expected.m_Positions, mesh.m_Positions, mesh.m_VertexSize )
+                || !sameArray( expected.m_Normals, mesh.m_Normals, mesh.m_VertexSize )
+                || !sameArray( expected.m_Texcoords, mesh.m_Texcoords, mesh.m_VertexSize )
+                || !sameArray( expected.m_Color, mesh.m_Color, mesh.m_VertexSize )
+                || !sameArray( expected.m_FaceIdx, mesh.m_FaceIdx, mesh.m_FaceIdxSize ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int model_prefetch_main_func( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <model file> [<model file>...]\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::vector<wxString> files;
+
+    for( int ii = 1; ii < argc; ++ii )
+    {
+        wxFileName fn( wxString::FromUTF8( argv[ii] ) );
+
+        fn.MakeAbsolute();
+        files.push_back( fn.GetFullPath() );
+    }
+
+    wxFileName tmpDir( wxFileName::CreateTempFileName( wxT( "model_prefetch" ) ) );
+
+    wxRemoveFile( tmpDir.GetFullPath() );
+    tmpDir.AssignDir( tmpDir.GetFullPath() );
+
+    wxString serialHome = tmpDir.GetPathWithSep() + wxT( "serial" );
+    wxString prefetchHome = tmpDir.GetPathWithSep() + wxT( "prefetch" );
+
+    std::unique_ptr<S3D_CACHE> serial = createCache( serialHome );
+    std::unique_ptr<S3D_CACHE> prefetch = createCache( prefetchHome );
+
+    if( !serial || !prefetch )
+    {
+        printf( "Unable to create the cache directories in \"%s\"\n",
+                (const char*) tmpDir.GetFullPath().c_str() );
+        return MODEL_PREFETCH_RET_CODES::CACHE_FAILED;
+    }
+
+    // Cold loads, the models are loaded by their plugins
+    PROF_COUNTER serialTimer;
+    int          loaded = 0;
+
+    for( const wxString& file : files )
+    {
+        if( serial->GetModel( file ) )
+            loaded++;
+    }
+
+    double serialTime = serialTimer.msecs();
+
+    PROF_COUNTER prefetchTimer;
+    prefetch->PrefetchModels( files );
+    double prefetchTime = prefetchTimer.msecs();
+
+    int ret = loaded ? KI_TEST::RET_CODES::OK : MODEL_PREFETCH_RET_CODES::LOAD_FAILED;
+
+    // The prefetched models are in the cache, and they are the serially loaded ones
+    for( const wxString& file : files )
+    {
+        if( !sameModel( serial->GetModel( file ), prefetch->GetModel( file ) ) )
+        {
+            printf( "Prefetched model differs: \"%s\"\n", (const char*) file.c_str() );
+            ret = MODEL_PREFETCH_RET_CODES::MODELS_DIFFER;
+        }
+    }
+
+    // Warm loads, the models are read from the render cache files of the prefetch
+    std::unique_ptr<S3D_CACHE> warm = createCache( prefetchHome );
+    double                     warmTime = 0.0;
+
+    if( warm )
+    {
+        PROF_COUNTER warmTimer;
+        warm->PrefetchModels( files );
+        warmTime = warmTimer.msecs();
+
+        for( const wxString& file : files )
+        {
+            if( !sameModel( serial->GetModel( file ), warm->GetModel( file ) ) )
+            {
+                printf( "Model read from the cache differs: \"%s\"\n",
+                        (const char*) file.c_str() );
+                ret = MODEL_PREFETCH_RET_CODES::MODELS_DIFFER;
+            }
+        }
+    }
+
+    printf( "%d of %d models loaded\n", loaded, (int) files.size() );
+    printf( "serial cold load: %.2f ms\n", serialTime );
+    printf( "prefetch cold load: %.2f ms (x%.2f)\n", prefetchTime,
+            prefetchTime > 0.0 ? serialTime / prefetchTime : 0.0 );
+    printf( "prefetch warm load: %.2f ms (x%.2f)\n", warmTime,
+            warmTime > 0.0 ? serialTime / warmTime : 0.0 );
+
+    warm.reset();
+    prefetch.reset();
+    serial.reset();
+
+    tmpDir.Rmdir( wxPATH_RMDIR_RECURSIVE );
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "model_prefetch",
+        "Compare and time loading 3D models one by one and with S3D_CACHE::PrefetchModels()",
+        model_prefetch_main_func,
+} );
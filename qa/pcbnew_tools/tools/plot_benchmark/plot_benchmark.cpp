@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <locale_io.h>
+#include <pcbplot.h>
+#include <plotters_specific.h>
+#include <profile.h>
+
+#include <wx/filename.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+
+enum PLOT_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    PLOT_FAILED
+};
+
+
+/**
+ * Flash many pads of a few sizes, to time the search of existing apertures.
+ */
+static bool flashPads( const wxString& aFileName, int aPadCount, int aVariants )
+{
+    GERBER_PLOTTER plotter;
+    LOCALE_IO      toggle;
+
+    plotter.SetViewport( wxPoint( 0, 0 ), IU_PER_MILS / 10, 1.0, false );
+    plotter.SetGerberCoordinatesFormat( 6 );
+
+    if( !plotter.OpenFile( aFileName ) || !plotter.StartPlot() )
+        return false;
+
+    PROF_COUNTER timer;
+
+    for( int ii = 0; ii < aPadCount; ++ii )
+    {
+        int     variant = ii % aVariants;
+        wxPoint pos( ( ii % 1000 ) * Millimeter2iu( 2 ), ( ii / 1000 ) * Millimeter2iu( 2 ) );
+        wxSize  size( Millimeter2iu( 0.5 ) + variant * 1000, Millimeter2iu( 1 ) );
+
+        plotter.FlashPadRect( pos, size, 0.0, FILLED, nullptr );
+    }
+
+    double flashTime = timer.msecs();
+    int    apertures = plotter.GetApertureCount();
+
+    plotter.EndPlot();
+
+    printf( "flash: %d pads, %d apertures, %.2f ms\n", aPadCount, apertures, flashTime );
+
+    return true;
+}
+
+
+int plot_benchmark_main_func( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <board.kicad_pcb> [output_dir]\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return PLOT_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    brd->BuildConnectivity();
+
+    wxString outputDir = argc > 2 ? wxString( argv[2] ) : wxFileName::GetTempDir();
+
+    PCB_PLOT_PARAMS plotOpts;
+    plotOpts.SetFormat( PLOT_FORMAT::GERBER );
+
+    std::vector<PLOT_LAYER_JOB> jobs;
+
+    for( PCB_LAYER_ID layer : brd->GetEnabledLayers().UIOrder() )
+    {
+        wxFileName fn( brd->GetFileName() );
+        BuildPlotFileName( &fn, outputDir, brd->GetLayerName( layer ),
+                           GERBER_PLOTTER::GetDefaultFileExtension() );
+
+        PLOT_LAYER_JOB job;
+        job.m_Layer = layer;
+        job.m_FileName = fn.GetFullPath();
+        jobs.push_back( job );
+    }
+
+    // Each layer on its own, to get the count of apertures
+    printf( "layer,apertures,plot_ms\n" );
+
+    PROF_COUNTER serialTimer;
+
+    for( const PLOT_LAYER_JOB& job : jobs )
+    {
+        LOCALE_IO toggle;
+
+        PROF_COUNTER layerTimer;
+        PLOTTER*     plotter = StartPlotBoard( brd.get(), &plotOpts, job.m_Layer, job.m_FileName,
+                                               wxEmptyString );
+
+        if( !plotter )
+        {
+            printf( "Unable to create file \"%s\"\n", (const char*) job.m_FileName.c_str() );
+            return PLOT_BENCHMARK_RET_CODES::PLOT_FAILED;
+        }
+
+        PlotOneBoardLayer( brd.get(), plotter, job.m_Layer, plotOpts );
+
+        int apertures = static_cast<GERBER_PLOTTER*>( plotter )->GetApertureCount();
+
+        plotter->EndPlot();
+        delete plotter->RenderSettings();
+        delete plotter;
+
+        printf( "%s,%d,%.2f\n", (const char*) brd->GetLayerName( job.m_Layer ).c_str(),
+                apertures, layerTimer.msecs() );
+    }
+
+    printf( "serial plot: %d layers, %.2f ms\n", (int) jobs.size(), serialTimer.msecs() );
+
+    PROF_COUNTER parallelTimer;
+    PlotBoardLayers( brd.get(), &plotOpts, jobs );
+
+    printf( "parallel plot: %d layers, %.2f ms\n", (int) jobs.size(), parallelTimer.msecs() );
+
+    wxFileName flashFile( outputDir, "flash_benchmark", GERBER_PLOTTER::GetDefaultFileExtension() );
+
+    if( !flashPads( flashFile.GetFullPath(), 100000, 2000 ) )
+        return PLOT_BENCHMARK_RET_CODES::PLOT_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "plot_benchmark",
+        "Benchmark plotting the layers of a PCB to Gerber files",
+        plot_benchmark_main_func,
+} );
@@ -0,0 +1,289 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <drc/drc_engine.h>
+#include <profile.h>
+#include <track.h>
+
+#include <router/pns_debug_decorator.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_sizes_settings.h>
+
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    LOG_LOAD_FAILED,
+};
+
+
+/**
+ * Timings and algorithm counters of all replayed events of one type.
+ */
+struct EVENT_STATS
+{
+    std::vector<double> latencies;          ///< in milliseconds
+    int                 shoveIterations = 0;
+    double              optimizerTime = 0.0;
+};
+
+
+static const char* eventName( PNS::LOGGER::EVENT_TYPE aType )
+{
+    switch( aType )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE: return "start_route";
+    case PNS::LOGGER::EVT_START_DRAG:  return "start_drag";
+    case PNS::LOGGER::EVT_FIX:         return "fix";
+    case PNS::LOGGER::EVT_MOVE:        return "move";
+    case PNS::LOGGER::EVT_ABORT:       return "abort";
+    }
+
+    return "unknown";
+}
+
+
+/**
+ * Nearest-rank percentile of a sorted, non-empty vector.
+ */
+static double percentile( const std::vector<double>& aSorted, double aPercent )
+{
+    size_t rank = (size_t) std::ceil( aPercent / 100.0 * aSorted.size() );
+
+    return aSorted[ std::max<size_t>( rank, 1 ) - 1 ];
+}
+
+
+static void printStats( const char* aName, EVENT_STATS& aStats )
+{
+    std::vector<double>& lat = aStats.latencies;
+
+    std::sort( lat.begin(), lat.end() );
+
+    double total = 0.0;
+
+    for( double t : lat )
+        total += t;
+
+    printf( "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.3f\n", aName, (int) lat.size(),
+            percentile( lat, 50 ), percentile( lat, 90 ), percentile( lat, 99 ), lat.back(),
+            total, aStats.shoveIterations, aStats.optimizerTime );
+}
+
+
+/**
+ * Find the router item a logged event referred to.  The GUI picks the item under the cursor,
+ * so look under the logged position for an item with the logged parent.
+ */
+static PNS::ITEM* findItem( PNS::ROUTER& aRouter, const PNS::LOGGER::EVENT_ENTRY& aEvent )
+{
+    if( aEvent.uuid == niluuid )
+        return nullptr;
+
+    for( PNS::ITEM* item : aRouter.QueryHoverItems( aEvent.p ).Items() )
+    {
+        if( item->Parent() && item->Parent()->m_Uuid == aEvent.uuid )
+            return item;
+    }
+
+    return nullptr;
+}
+
+
+int pns_replay_main_func( int argc, char** argv )
+{
+    if( argc < 3 )
+    {
+        printf( "usage: %s <board.kicad_pcb> <pns.log> [shove|walkaround|smart|mark] "
+                "[threads]\n", argv[0] );
+        printf( "  Replays a router session saved by PNS::LOGGER (debug builds dump it to\n"
+                "  /tmp/pns.log and the board to /tmp/pns.dump) and prints the latency of the\n"
+                "  events as CSV.\n" );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    PNS::PNS_MODE mode = PNS::RM_Shove;
+
+    if( argc > 3 )
+    {
+        std::map<std::string, PNS::PNS_MODE> modes = { { "shove", PNS::RM_Shove },
+                                                       { "walkaround", PNS::RM_Walkaround },
+                                                       { "smart", PNS::RM_Smart },
+                                                       { "mark", PNS::RM_MarkObstacles } };
+
+        auto it = modes.find( argv[3] );
+
+        if( it == modes.end() )
+        {
+            printf( "unknown routing mode '%s'\n", argv[3] );
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        mode = it->second;
+    }
+
+    int threads = argc > 4 ? atoi( argv[4] ) : 1;
+
+    if( threads < 1 )
+    {
+        printf( "invalid thread count '%s'\n", argv[4] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    PNS::LOGGER replayLog;
+
+    if( !replayLog.Load( argv[2] ) )
+    {
+        printf( "cannot read router log '%s'\n", argv[2] );
+        return PNS_REPLAY_RET_CODES::LOG_LOAD_FAILED;
+    }
+
+    BOARD_DESIGN_SETTINGS& bds = brd->GetDesignSettings();
+
+    bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( brd.get(), &bds );
+    bds.m_DRCEngine->InitEngine( wxFileName() );
+
+    PNS::DEBUG_DECORATOR  decorator;
+    PNS_KICAD_IFACE_BASE  iface;
+    PNS::ROUTER           router;
+    PNS::ROUTING_SETTINGS settings( nullptr, "" );
+
+    settings.SetMode( mode );
+    settings.SetSpeculativeThreads( threads );
+
+    iface.SetBoard( brd.get() );
+    iface.SetDebugDecorator( &decorator );
+
+    router.SetInterface( &iface );
+    router.ClearWorld();
+
+    PROF_COUNTER syncTimer;
+    router.SyncWorld();
+    double syncTime = syncTimer.msecs();
+
+    router.LoadSettings( &settings );
+
+    std::map<PNS::LOGGER::EVENT_TYPE, EVENT_STATS> stats;
+    EVENT_STATS                                    all;
+    int                                            failed = 0;
+
+    for( const PNS::LOGGER::EVENT_ENTRY& evt : replayLog.GetEvents() )
+    {
+        PNS::ITEM* item = findItem( router, evt );
+        bool       ok = true;
+
+        router.Logger()->ClearStats();
+
+        PROF_COUNTER timer;
+
+        switch( evt.type )
+        {
+        case PNS::LOGGER::EVT_START_ROUTE:
+        {
+            PNS::SIZES_SETTINGS sizes( router.Sizes() );
+
+            iface.ImportSizes( sizes, item, -1 );
+            sizes.AddLayerPair( F_Cu, B_Cu );
+            router.UpdateSizes( sizes );
+
+            // The log doesn't record the routing layer; use the first layer of the start item
+            ok = router.StartRouting( evt.p, item, item ? item->Layers().Start() : F_Cu );
+            break;
+        }
+
+        case PNS::LOGGER::EVT_START_DRAG:
+            ok = item && router.StartDragging( evt.p, item );
+            break;
+
+        case PNS::LOGGER::EVT_MOVE:
+            router.Move( evt.p, item );
+            break;
+
+        case PNS::LOGGER::EVT_FIX:
+            router.FixRoute( evt.p, item );
+            break;
+
+        case PNS::LOGGER::EVT_ABORT:
+            router.StopRouting();
+            break;
+        }
+
+        double                    elapsed = timer.msecs();
+        PNS::LOGGER::STATS        counters = router.Logger()->GetStats();
+
+        for( EVENT_STATS* s : { &stats[evt.type], &all } )
+        {
+            s->latencies.push_back( elapsed );
+            s->shoveIterations += counters.shoveIterations;
+            s->optimizerTime += counters.optimizerTime;
+        }
+
+        if( !ok )
+            failed++;
+    }
+
+    printf( "event,count,p50_ms,p90_ms,p99_ms,max_ms,total_ms,shove_iterations,optimizer_ms\n" );
+
+    for( std::pair<const PNS::LOGGER::EVENT_TYPE, EVENT_STATS>& s : stats )
+        printStats( eventName( s.first ), s.second );
+
+    if( !all.latencies.empty() )
+        printStats( "all", all );
+
+    printf( "sync_world,1,%.3f,%.3f,%.3f,%.3f,%.3f,0,0.000\n", syncTime, syncTime, syncTime,
+            syncTime, syncTime );
+
+    if( failed )
+        fprintf( stderr, "%d events could not be replayed\n", failed );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_replay",
+        "Replay a logged router session on a PCB and report event latencies",
+        pns_replay_main_func,
+} );
@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/kiglew.h>    // Must be included first
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_viewer/3d_viewer_settings.h>
+
+#include <board.h>
+#include <profile.h>
+#include <settings/color_settings.h>
+
+#include <wx/image.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+
+/**
+ * Point the camera the way the 3D viewer does for its view commands.
+ *
+ * @return false if the preset is unknown.
+ */
+static bool setCameraPreset( CCAMERA& aCamera, const std::string& aPreset )
+{
+    aCamera.Reset();
+
+    if( aPreset == "top" )
+    {
+    }
+    else if( aPreset == "bottom" )
+    {
+        aCamera.RotateY( glm::radians( 179.999f ) );
+    }
+    else if( aPreset == "front" )
+    {
+        aCamera.RotateX( glm::radians( -90.0f ) );
+    }
+    else if( aPreset == "back" )
+    {
+        aCamera.RotateX( glm::radians( -90.0f ) );
+        aCamera.RotateZ( glm::radians( 179.999f ) );
+    }
+    else if( aPreset == "left" )
+    {
+        aCamera.RotateZ( glm::radians( 90.0f ) );
+        aCamera.RotateX( glm::radians( -90.0f ) );
+    }
+    else if( aPreset == "right" )
+    {
+        aCamera.RotateZ( glm::radians( -90.0f ) );
+        aCamera.RotateX( glm::radians( -90.0f ) );
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+enum RAYTRACE_RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    SAVE_FAILED,
+};
+
+
+int raytrace_render_main_func( int argc, char** argv )
+{
+    if( argc < 3 )
+    {
+        printf( "usage: %s <board.kicad_pcb> <image.png> [top|bottom|front|back|left|right "
+                "[width [height]]]\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string preset = argc > 3 ? argv[3] : "top";
+    int         width = argc > 4 ? atoi( argv[4] ) : 1920;
+    int         height = argc > 5 ? atoi( argv[5] ) : width * 9 / 16;
+
+    if( width < RAYTRACING_MIN_IMAGE_SIZE || height < RAYTRACING_MIN_IMAGE_SIZE )
+    {
+        printf( "invalid image size: %dx%d, the minimum is %dx%d\n", width, height,
+                RAYTRACING_MIN_IMAGE_SIZE, RAYTRACING_MIN_IMAGE_SIZE );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    PROF_COUNTER           loadTimer;
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return RAYTRACE_RENDER_RET_CODES::LOAD_FAILED;
+
+    double loadTime = loadTimer.msecs();
+
+    // The default colors and options of the 3D viewer.  There is no project here, so the
+    // footprints are rendered without their 3D models.
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    EDA_3D_VIEWER_SETTINGS cfg;
+    cfg.ResetToDefaults();
+
+    BOARD_ADAPTER adapter;
+    adapter.SetBoard( brd.get() );
+    adapter.SetColorSettings( &colors );
+    adapter.LoadSettings( cfg );
+    adapter.RenderEngineSet( RENDER_ENGINE::RAYTRACING );
+
+    CTRACK_BALL camera( RANGE_SCALE_3D );
+
+    if( !setCameraPreset( camera, preset ) )
+    {
+        printf( "unknown camera preset: %s\n", preset.c_str() );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    C3D_RENDER_RAYTRACING renderer( adapter, camera );
+
+    PROF_COUNTER renderTimer;
+    wxImage      image = renderer.RenderToImage( wxSize( width, height ) );
+    double       renderTime = renderTimer.msecs();
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    if( !image.SaveFile( argv[2], wxBITMAP_TYPE_PNG ) )
+        return RAYTRACE_RENDER_RET_CODES::SAVE_FAILED;
+
+    printf( "load_ms,render_ms,width,height\n" );
+    printf( "%.2f,%.2f,%d,%d\n", loadTime, renderTime, width, height );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_render",
+        "Raytrace a PCB in 3D to a PNG image, without OpenGL",
+        raytrace_render_main_func,
+} );
@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <drc/drc_engine.h>
+#include <footprint.h>
+#include <geometry/poly_union_builder.h>
+#include <geometry/shape_poly_set.h>
+#include <pad.h>
+#include <profile.h>
+#include <track.h>
+#include <zone.h>
+#include <zone_filler.h>
+
+#include <wx/filename.h>
+
+#include <cstdio>
+#include <thread>
+
+
+/**
+ * Collect the clearance shapes of all pads, vias and tracks on a layer, both as a single
+ * appended polygon set (the way the zone filler used to accumulate them) and in a
+ * #POLY_UNION_BUILDER.
+ */
+static void collectKnockouts( BOARD* aBoard, PCB_LAYER_ID aLayer, int aClearance,
+                              SHAPE_POLY_SET& aAppended, POLY_UNION_BUILDER& aBuilder )
+{
+    int maxError = aBoard->GetDesignSettings().m_MaxError;
+
+    for( FOOTPRINT* footprint : aBoard->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( !pad->FlashLayer( aLayer ) )
+                continue;
+
+            SHAPE_POLY_SET poly;
+            pad->TransformShapeWithClearanceToPolygon( poly, aLayer, aClearance, maxError,
+                                                       ERROR_OUTSIDE );
+            aAppended.Append( poly );
+            aBuilder.AddPolygon( poly );
+        }
+    }
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        if( !track->IsOnLayer( aLayer ) )
+            continue;
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            int radius = track->GetWidth() / 2 + aClearance;
+
+            TransformCircleToPolygon( aAppended, track->GetStart(), radius, maxError,
+                                      ERROR_OUTSIDE );
+            aBuilder.AddCircle( track->GetStart(), radius );
+        }
+        else if( track->Type() == PCB_TRACE_T )
+        {
+            int width = track->GetWidth() + 2 * aClearance;
+
+            TransformOvalToPolygon( aAppended, track->GetStart(), track->GetEnd(), width,
+                                    maxError, ERROR_OUTSIDE );
+            aBuilder.AddOval( track->GetStart(), track->GetEnd(), width );
+        }
+    }
+}
+
+
+enum ZONE_FILL_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int zone_fill_main_func( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s <board.kicad_pcb>\n", argv[0] );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return ZONE_FILL_RET_CODES::LOAD_FAILED;
+
+    BOARD_DESIGN_SETTINGS& bds = brd->GetDesignSettings();
+
+    bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( brd.get(), &bds );
+    bds.m_DRCEngine->InitEngine( wxFileName() );
+
+    brd->BuildConnectivity();
+
+    int threads = std::max<int>( std::thread::hardware_concurrency(), 1 );
+    int clearance = bds.GetDefault()->GetClearance();
+
+    printf( "layer,shapes,appended_simplify_ms,union_1_thread_ms,union_%d_threads_ms,"
+            "result_vertices\n", threads );
+
+    // Knockout accumulation: old (append + Simplify) vs. hierarchical union
+    for( PCB_LAYER_ID layer : LSET::AllCuMask( brd->GetCopperLayerCount() ).Seq() )
+    {
+        SHAPE_POLY_SET     appended;
+        POLY_UNION_BUILDER builder( bds.m_MaxError, ERROR_OUTSIDE );
+
+        collectKnockouts( brd.get(), layer, clearance, appended, builder );
+
+        if( builder.GetCount() == 0 )
+            continue;
+
+        PROF_COUNTER simplifyTimer;
+        appended.Simplify( SHAPE_POLY_SET::PM_FAST );
+        double simplifyTime = simplifyTimer.msecs();
+
+        SHAPE_POLY_SET result;
+
+        PROF_COUNTER singleTimer;
+        builder.Build( result, 1 );
+        double singleTime = singleTimer.msecs();
+
+        PROF_COUNTER multiTimer;
+        builder.Build( result, threads );
+        double multiTime = multiTimer.msecs();
+
+        printf( "%s,%d,%.2f,%.2f,%.2f,%d\n", (const char*) brd->GetLayerName( layer ).c_str(),
+                builder.GetCount(), simplifyTime, singleTime, multiTime,
+                result.TotalVertices() );
+    }
+
+    // And the complete fill, for reference
+    std::vector<ZONE*> zones = brd->Zones();
+
+    for( FOOTPRINT* footprint : brd->Footprints() )
+        zones.insert( zones.end(), footprint->Zones().begin(), footprint->Zones().end() );
+
+    ZONE_FILLER filler( brd.get(), nullptr );
+
+    PROF_COUNTER fillTimer;
+    filler.Fill( zones );
+
+    printf( "zone fill: %d zones, %.2f ms\n", (int) zones.size(), fillTimer.msecs() );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "zone_fill",
+        "Benchmark zone knockout accumulation and zone filling on a PCB",
+        zone_fill_main_func,
+} );
@@ -4923,6 +4923,9 @@ ClipperOffset::ClipperOffset( double miterLimit, double arcTolerance )
     m_sin = 0.0;
     m_cos = 0.0;
     m_miterLim = 1.0;
+#ifdef use_xyz
+    m_ZFill = 0;
+#endif
     m_StepsPerRad = 1.0;
 }
 
@@ -4949,6 +4952,16 @@ void ClipperOffset::Clear()
 
 // ------------------------------------------------------------------------------
 
+#ifdef use_xyz
+void ClipperOffset::ZFillFunction( ZFillCallback zFillFunc )
+{
+    m_ZFill = zFillFunc;
+}
+
+
+#endif
+// ------------------------------------------------------------------------------
+
 void ClipperOffset::AddPath( const Path& path, JoinType joinType, EndType endType )
 {
     int highI = (int) path.size() - 1;
@@ -5059,6 +5072,9 @@ void ClipperOffset::Execute( Paths& solution, double delta )
 
     // now clean up 'corners' ...
     Clipper clpr;
+#ifdef use_xyz
+    clpr.ZFillFunction( m_ZFill );
+#endif
     clpr.AddPaths( m_destPolys, ptSubject, true );
 
     if( delta > 0 )
@@ -5094,6 +5110,9 @@ void ClipperOffset::Execute( PolyTree& solution, double delta )
 
     // now clean up 'corners' ...
     Clipper clpr;
+#ifdef use_xyz
+    clpr.ZFillFunction( m_ZFill );
+#endif
     clpr.AddPaths( m_destPolys, ptSubject, true );
 
     if( delta > 0 )
@@ -5251,7 +5270,28 @@ void ClipperOffset::DoOffset( double delta )
             int k = len - 1;
 
             for( int j = 0; j < len; ++j )
+            {
+#ifdef use_xyz
+                size_t first = m_destPoly.size();
+                cInt   prevZ = m_srcPoly[k].Z;
+                cInt   nextZ = m_srcPoly[( j + 1 ) % len].Z;
+#endif
                 OffsetPoint( j, k, node.m_jointype );
+#ifdef use_xyz
+                // Offset points keep the Z value of their vertex along edges sharing it.  The
+                // points of a joint between two differently tagged edges are not on either one.
+                cInt z = m_srcPoly[j].Z;
+
+                for( size_t n = first; n < m_destPoly.size(); ++n )
+                    m_destPoly[n].Z = ( prevZ == z && nextZ == z ) ? z : 0;
+
+                if( first < m_destPoly.size() && prevZ == z )
+                    m_destPoly[first].Z = z;
+
+                if( first < m_destPoly.size() && nextZ == z )
+                    m_destPoly.back().Z = z;
+#endif
+            }
 
             m_destPolys.push_back( m_destPoly );
         }
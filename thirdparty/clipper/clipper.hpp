@@ -41,7 +41,8 @@
 // #define use_int32
 
 // use_xyz: adds a Z member to IntPoint. Adds a minor cost to perfomance.
-// #define use_xyz
+// KiCad uses Z to tag vertices belonging to arcs (see SHAPE_POLY_SET)
+#define use_xyz
 
 // use_lines: Enables line clipping. Adds a very minor cost to performance.
 #define use_lines
@@ -416,12 +417,20 @@ public:
     void    Execute( Paths& solution, double delta );
     void    Execute( PolyTree& solution, double delta );
     void    Clear();
+    // set the callback function for z value filling on the intersections left by the offset
+#ifdef use_xyz
+    void    ZFillFunction( ZFillCallback zFillFunc );
+
+#endif
 
     double MiterLimit;
     JoinType MiterFallback;
     double ArcTolerance;
 
 private:
+#ifdef use_xyz
+    ZFillCallback m_ZFill; // custom callback
+#endif
     Paths m_destPolys;
     Path m_srcPoly;
     Path m_destPoly;